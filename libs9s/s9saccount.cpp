@@ -155,9 +155,14 @@ S9sAccount::setWithDatabase(
         bool value)
 {
     if (value)
-        m_properties["own_database"] = m_properties["user_name"];
-    else
+    {
+        // The insert would invalidate the reference to the user name.
+        S9sVariant userName = m_properties["user_name"];
+
+        m_properties["own_database"] = userName;
+    } else {
         m_properties.erase("own_database");
+    }
 }
 
 void
@@ -0,0 +1,110 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2018  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "s9sarena.h"
+
+//#define DEBUG
+//#define WARNING
+#include "s9sdebug.h"
+
+/**
+ * Creates an arena with one reference, the creator has to call unRef() when
+ * the arena is not needed any more.
+ */
+S9sArena::S9sArena() :
+    m_blocks(NULL),
+    m_position(NULL),
+    m_end(NULL),
+    m_nBlocks(0),
+    m_referenceCounter(1)
+{
+}
+
+S9sArena::~S9sArena()
+{
+    while (m_blocks != NULL)
+    {
+        Block *next = m_blocks->next;
+
+        ::operator delete(m_blocks);
+        m_blocks = next;
+    }
+}
+
+void
+S9sArena::ref()
+{
+    __sync_add_and_fetch(&m_referenceCounter, 1);
+}
+
+/**
+ * Releases one reference, the arena with all its memory is destroyed when the
+ * last reference is released.
+ */
+void
+S9sArena::unRef()
+{
+    if (__sync_sub_and_fetch(&m_referenceCounter, 1) == 0)
+        delete this;
+}
+
+/**
+ * \returns How many memory blocks the arena allocated.
+ */
+size_t
+S9sArena::nBlocks() const
+{
+    return m_nBlocks;
+}
+
+/**
+ * Private method to allocate a new block when the current one is full. The
+ * allocations that are larger than the block size get a block of their own
+ * and the current block remains in use.
+ */
+void *
+S9sArena::allocateBlock(
+        size_t size,
+        size_t alignment)
+{
+    size_t  header    = (sizeof(Block) + alignment - 1) & ~(alignment - 1);
+    size_t  blockSize = header + size;
+    bool    oversized = blockSize > S9S_ARENA_BLOCK_SIZE;
+    Block  *block;
+    char   *retval;
+
+    if (!oversized)
+        blockSize = S9S_ARENA_BLOCK_SIZE;
+
+    block = (Block *) ::operator new(blockSize);
+    ++m_nBlocks;
+    S9S_DEBUG("Block %lu with %lu bytes.", m_nBlocks, blockSize);
+
+    block->next = m_blocks;
+    m_blocks    = block;
+    retval      = (char *) block + header;
+
+    if (!oversized)
+    {
+        m_position = retval + size;
+        m_end      = (char *) block + blockSize;
+    }
+
+    return retval;
+}
@@ -0,0 +1,302 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2018  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <stdint.h>
+
+/**
+ * The size of the memory blocks the arena allocates.
+ */
+#define S9S_ARENA_BLOCK_SIZE (64 * 1024)
+
+/**
+ * A monotonic memory pool for one document, e.g. a parsed reply. The memory is
+ * allocated from large blocks by moving a pointer, the allocations are never
+ * released one by one. All the blocks are released together when the last
+ * reference to the arena is gone.
+ *
+ * Every container and value allocated in the arena holds a reference, so the
+ * values can be shared with variables outside the document and they remain
+ * valid after the document is destroyed. The arena itself is not thread safe,
+ * the values of one document should be changed in one thread.
+ */
+class S9sArena
+{
+    public:
+        S9sArena();
+
+        void ref();
+        void unRef();
+
+        inline void *allocate(size_t size, size_t alignment);
+        size_t nBlocks() const;
+
+    private:
+        ~S9sArena();
+        S9sArena(const S9sArena &orig);
+        S9sArena &operator=(const S9sArena &rhs);
+
+        void *allocateBlock(size_t size, size_t alignment);
+
+    private:
+        struct Block
+        {
+            Block *next;
+        };
+
+        Block          *m_blocks;
+        char           *m_position;
+        char           *m_end;
+        size_t          m_nBlocks;
+        volatile int    m_referenceCounter;
+};
+
+/**
+ * \returns The memory of the given size, it is valid until the arena is
+ *   destroyed.
+ */
+inline void *
+S9sArena::allocate(
+        size_t size,
+        size_t alignment)
+{
+    char *retval;
+
+    if (m_position == NULL)
+        return allocateBlock(size, alignment);
+
+    retval = (char *) 
+        (((uintptr_t) m_position + alignment - 1) & ~(alignment - 1));
+
+    if (retval + size > m_end)
+        return allocateBlock(size, alignment);
+
+    m_position = retval + size;
+    return retval;
+}
+
+/**
+ * An allocator for the standard containers that allocates the memory in an
+ * arena. The default constructed allocator has no arena, it uses the heap like
+ * the std::allocator, so the containers using it work the same way as the
+ * standard containers when no arena is set.
+ *
+ * The copies of the containers are always allocated on the heap, so the
+ * copies don't keep the arena of the original alive.
+ */
+template <typename T>
+class S9sArenaAllocator
+{
+    public:
+        typedef T              value_type;
+        typedef T             *pointer;
+        typedef const T       *const_pointer;
+        typedef T             &reference;
+        typedef const T       &const_reference;
+        typedef size_t         size_type;
+        typedef ptrdiff_t      difference_type;
+
+        typedef std::false_type propagate_on_container_copy_assignment;
+        typedef std::true_type  propagate_on_container_move_assignment;
+        typedef std::true_type  propagate_on_container_swap;
+
+        template <typename U>
+        struct rebind 
+        {
+            typedef S9sArenaAllocator<U> other;
+        };
+
+        S9sArenaAllocator();
+        S9sArenaAllocator(S9sArena *arena);
+        S9sArenaAllocator(const S9sArenaAllocator<T> &orig);
+
+        template <typename U>
+        S9sArenaAllocator(const S9sArenaAllocator<U> &orig);
+
+        ~S9sArenaAllocator();
+
+        S9sArenaAllocator<T> &operator=(const S9sArenaAllocator<T> &rhs);
+
+        T *allocate(size_t n);
+        void deallocate(T *pointer, size_t n);
+
+        template <typename U, typename... Args>
+        void construct(U *pointer, Args&&... args);
+
+        template <typename U>
+        void destroy(U *pointer);
+
+        size_t max_size() const;
+        S9sArenaAllocator<T> select_on_container_copy_construction() const;
+        S9sArena *arena() const;
+
+    private:
+        S9sArena   *m_arena;
+};
+
+template <typename T>
+inline
+S9sArenaAllocator<T>::S9sArenaAllocator() :
+    m_arena(NULL)
+{
+}
+
+template <typename T>
+inline
+S9sArenaAllocator<T>::S9sArenaAllocator(
+        S9sArena *arena) :
+    m_arena(arena)
+{
+    if (m_arena != NULL)
+        m_arena->ref();
+}
+
+template <typename T>
+inline
+S9sArenaAllocator<T>::S9sArenaAllocator(
+        const S9sArenaAllocator<T> &orig) :
+    m_arena(orig.arena())
+{
+    if (m_arena != NULL)
+        m_arena->ref();
+}
+
+template <typename T>
+template <typename U>
+inline
+S9sArenaAllocator<T>::S9sArenaAllocator(
+        const S9sArenaAllocator<U> &orig) :
+    m_arena(orig.arena())
+{
+    if (m_arena != NULL)
+        m_arena->ref();
+}
+
+template <typename T>
+inline
+S9sArenaAllocator<T>::~S9sArenaAllocator()
+{
+    if (m_arena != NULL)
+        m_arena->unRef();
+}
+
+template <typename T>
+inline S9sArenaAllocator<T> &
+S9sArenaAllocator<T>::operator=(
+        const S9sArenaAllocator<T> &rhs)
+{
+    if (rhs.m_arena != NULL)
+        rhs.m_arena->ref();
+
+    if (m_arena != NULL)
+        m_arena->unRef();
+
+    m_arena = rhs.m_arena;
+    return *this;
+}
+
+template <typename T>
+inline T *
+S9sArenaAllocator<T>::allocate(
+        size_t n)
+{
+    if (m_arena != NULL)
+        return (T *) m_arena->allocate(n * sizeof(T), alignof(T));
+
+    return (T *) ::operator new(n * sizeof(T));
+}
+
+/**
+ * The memory allocated in the arena is released together with the arena.
+ */
+template <typename T>
+inline void
+S9sArenaAllocator<T>::deallocate(
+        T      *pointer,
+        size_t  n)
+{
+    if (m_arena == NULL)
+        ::operator delete(pointer);
+}
+
+template <typename T>
+template <typename U, typename... Args>
+inline void
+S9sArenaAllocator<T>::construct(
+        U          *pointer,
+        Args&&...   args)
+{
+    ::new ((void *) pointer) U(std::forward<Args>(args)...);
+}
+
+template <typename T>
+template <typename U>
+inline void
+S9sArenaAllocator<T>::destroy(
+        U *pointer)
+{
+    pointer->~U();
+}
+
+template <typename T>
+inline size_t
+S9sArenaAllocator<T>::max_size() const
+{
+    return size_t(-1) / sizeof(T);
+}
+
+template <typename T>
+inline S9sArenaAllocator<T>
+S9sArenaAllocator<T>::select_on_container_copy_construction() const
+{
+    return S9sArenaAllocator<T>();
+}
+
+/**
+ * \returns The arena where the memory is allocated or NULL if the allocator
+ *   uses the heap.
+ */
+template <typename T>
+inline S9sArena *
+S9sArenaAllocator<T>::arena() const
+{
+    return m_arena;
+}
+
+template <typename T, typename U>
+inline bool
+operator==(
+        const S9sArenaAllocator<T> &lhs,
+        const S9sArenaAllocator<U> &rhs)
+{
+    return lhs.arena() == rhs.arena();
+}
+
+template <typename T, typename U>
+inline bool
+operator!=(
+        const S9sArenaAllocator<T> &lhs,
+        const S9sArenaAllocator<U> &rhs)
+{
+    return lhs.arena() != rhs.arena();
+}
@@ -0,0 +1,249 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2018  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "s9satom.h"
+
+#include <pthread.h>
+#include <stdint.h>
+
+//#define DEBUG
+//#define WARNING
+#include "s9sdebug.h"
+
+/**
+ * The number of slots of the table when the first atom is created.
+ */
+#define ATOM_INITIAL_SIZE  1024
+
+/**
+ * The number of C strings every thread remembers, so that the atoms created
+ * from the same string literal are found without searching the table.
+ */
+#define ATOM_CACHE_SIZE    256
+
+/**
+ * An open addressing hash table of the interned strings. The slots are only
+ * changed from NULL to a string, so the table can be searched without locking.
+ * When the table is full a bigger table replaces it, the old tables are kept
+ * because other threads might still be searching them.
+ */
+struct S9sAtomTable
+{
+    S9sAtomTable       *previous;
+    size_t              mask;
+    const S9sString   **slots;
+};
+
+static pthread_mutex_t  sm_mutex  = PTHREAD_MUTEX_INITIALIZER;
+static S9sAtomTable    *sm_table  = NULL;
+static size_t           sm_nAtoms = 0;
+
+static __thread const char      *sm_cacheKeys[ATOM_CACHE_SIZE];
+static __thread const S9sString *sm_cacheValues[ATOM_CACHE_SIZE];
+
+static inline uint64_t
+hashOf(
+        const char *name,
+        size_t      length)
+{
+    uint64_t retval = 14695981039346656037ull;
+
+    for (size_t idx = 0u; idx < length; ++idx)
+    {
+        retval ^= (unsigned char) name[idx];
+        retval *= 1099511628211ull;
+    }
+
+    return retval;
+}
+
+/**
+ * \returns The interned string from the table or NULL if it is not there.
+ */
+static const S9sString *
+findAtom(
+        const S9sAtomTable *table,
+        const char         *name,
+        size_t              length,
+        uint64_t            hash)
+{
+    const S9sString *slot;
+
+    for (size_t idx = hash & table->mask;; idx = (idx + 1) & table->mask)
+    {
+        slot = __atomic_load_n(&table->slots[idx], __ATOMIC_ACQUIRE);
+        if (slot == NULL)
+            return NULL;
+
+        if (slot->length() == length && memcmp(slot->data(), name, length) == 0)
+            return slot;
+    }
+}
+
+static void
+insertAtom(
+        S9sAtomTable     *table,
+        const S9sString  *name)
+{
+    uint64_t hash = hashOf(name->data(), name->length());
+    size_t   idx;
+
+    for (idx = hash & table->mask; table->slots[idx] != NULL; 
+            idx = (idx + 1) & table->mask)
+        ;
+
+    __atomic_store_n(&table->slots[idx], name, __ATOMIC_RELEASE);
+}
+
+/**
+ * Creates the table with twice the size of the current table and moves the
+ * strings there. Must be called with the mutex locked.
+ */
+static S9sAtomTable *
+growTable()
+{
+    S9sAtomTable *table = new S9sAtomTable;
+    size_t        size;
+
+    size = sm_table == NULL ? ATOM_INITIAL_SIZE : (sm_table->mask + 1) * 2;
+
+    table->previous = sm_table;
+    table->mask     = size - 1;
+    table->slots    = new const S9sString *[size]();
+
+    if (sm_table != NULL)
+    {
+        for (size_t idx = 0u; idx <= sm_table->mask; ++idx)
+        {
+            if (sm_table->slots[idx] != NULL)
+                insertAtom(table, sm_table->slots[idx]);
+        }
+    }
+
+    S9S_DEBUG("Atom table with %lu slots.", (unsigned long) size);
+    __atomic_store_n(&sm_table, table, __ATOMIC_RELEASE);
+
+    return table;
+}
+
+/**
+ * The atom of the empty string.
+ */
+S9sAtom::S9sAtom() :
+    m_name(intern("", 0))
+{
+}
+
+/**
+ * The atoms are usually created from string literals (e.g. 
+ * m_properties.at("hostname")), the last ones are remembered by their address,
+ * so they are found by comparing the strings without hashing.
+ */
+S9sAtom::S9sAtom(
+        const char *name)
+{
+    size_t slot;
+
+    if (name == NULL)
+        name = "";
+
+    slot = (((uintptr_t) name) ^ ((uintptr_t) name >> 8)) & 
+        (ATOM_CACHE_SIZE - 1);
+
+    if (sm_cacheKeys[slot] == name && 
+            strcmp(sm_cacheValues[slot]->c_str(), name) == 0)
+    {
+        m_name = sm_cacheValues[slot];
+        return;
+    }
+
+    m_name               = intern(name, strlen(name));
+    sm_cacheKeys[slot]   = name;
+    sm_cacheValues[slot] = m_name;
+}
+
+S9sAtom::S9sAtom(
+        const std::string &name) :
+    m_name(intern(name.data(), name.length()))
+{
+}
+
+S9sAtom::S9sAtom(
+        const char *name,
+        size_t      length) :
+    m_name(intern(name, length))
+{
+}
+
+/**
+ * \returns The number of the distinct strings that were interned.
+ */
+size_t
+S9sAtom::nAtoms()
+{
+    size_t retval;
+
+    pthread_mutex_lock(&sm_mutex);
+    retval = sm_nAtoms;
+    pthread_mutex_unlock(&sm_mutex);
+
+    return retval;
+}
+
+/**
+ * Private function to find the string in the table or add it if it is not
+ * there yet.
+ */
+const S9sString *
+S9sAtom::intern(
+        const char *name,
+        size_t      length)
+{
+    uint64_t          hash = hashOf(name, length);
+    S9sAtomTable     *table;
+    const S9sString  *retval = NULL;
+
+    table = __atomic_load_n(&sm_table, __ATOMIC_ACQUIRE);
+    if (table != NULL)
+        retval = findAtom(table, name, length, hash);
+
+    if (retval != NULL)
+        return retval;
+
+    pthread_mutex_lock(&sm_mutex);
+
+    if (sm_table != NULL)
+        retval = findAtom(sm_table, name, length, hash);
+
+    if (retval == NULL)
+    {
+        // The table is kept at most half full.
+        table = sm_table;
+        if (table == NULL || (sm_nAtoms + 1) * 2 > table->mask + 1)
+            table = growTable();
+
+        retval = new S9sString(std::string(name, length));
+        insertAtom(table, retval);
+        ++sm_nAtoms;
+    }
+
+    pthread_mutex_unlock(&sm_mutex);
+
+    return retval;
+}
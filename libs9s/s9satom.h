@@ -0,0 +1,148 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2018  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "S9sString"
+
+#include <cstring>
+
+/**
+ * An interned string, used as the key of the variant maps. Every distinct
+ * string is stored only once in a global table and the atoms are pointers to
+ * the stored strings, so the thousands of maps in a reply share their keys and
+ * two atoms are equal if and only if the pointers are equal.
+ *
+ * The atoms are ordered by their strings, the maps keyed by atoms keep their
+ * alphabetical order. The interned strings are never released.
+ */
+class S9sAtom
+{
+    public:
+        S9sAtom();
+        S9sAtom(const char *name);
+        S9sAtom(const std::string &name);
+        S9sAtom(const char *name, size_t length);
+
+        inline const S9sString &toString() const;
+        inline operator const S9sString &() const;
+        inline const char *c_str() const;
+        inline size_t length() const;
+        inline bool empty() const;
+
+        inline bool operator==(const S9sAtom &rhs) const;
+        inline bool operator!=(const S9sAtom &rhs) const;
+        inline bool operator<(const S9sAtom &rhs) const;
+
+        inline bool operator==(const char *rhs) const;
+        inline bool operator!=(const char *rhs) const;
+        inline bool operator==(const std::string &rhs) const;
+        inline bool operator!=(const std::string &rhs) const;
+
+        static size_t nAtoms();
+
+    private:
+        static const S9sString *intern(const char *name, size_t length);
+
+    private:
+        const S9sString   *m_name;
+};
+
+inline const S9sString &
+S9sAtom::toString() const
+{
+    return *m_name;
+}
+
+inline
+S9sAtom::operator const S9sString &() const
+{
+    return *m_name;
+}
+
+inline const char *
+S9sAtom::c_str() const
+{
+    return m_name->c_str();
+}
+
+inline size_t
+S9sAtom::length() const
+{
+    return m_name->length();
+}
+
+inline bool
+S9sAtom::empty() const
+{
+    return m_name->empty();
+}
+
+inline bool
+S9sAtom::operator==(
+        const S9sAtom &rhs) const
+{
+    return m_name == rhs.m_name;
+}
+
+inline bool
+S9sAtom::operator!=(
+        const S9sAtom &rhs) const
+{
+    return m_name != rhs.m_name;
+}
+
+/**
+ * The atoms are ordered by their strings, the equal atoms are recognized by
+ * comparing the pointers.
+ */
+inline bool
+S9sAtom::operator<(
+        const S9sAtom &rhs) const
+{
+    return m_name != rhs.m_name && *m_name < *rhs.m_name;
+}
+
+inline bool
+S9sAtom::operator==(
+        const char *rhs) const
+{
+    return strcmp(m_name->c_str(), rhs) == 0;
+}
+
+inline bool
+S9sAtom::operator!=(
+        const char *rhs) const
+{
+    return strcmp(m_name->c_str(), rhs) != 0;
+}
+
+inline bool
+S9sAtom::operator==(
+        const std::string &rhs) const
+{
+    return *m_name == rhs;
+}
+
+inline bool
+S9sAtom::operator!=(
+        const std::string &rhs) const
+{
+    return *m_name != rhs;
+}
@@ -611,295 +611,184 @@ S9sBackup::toString(
         const int        fileIndex,
         const bool       syntaxHighlight,
         const S9sString &formatString) const
+{
+    return toString(
+            backupIndex, fileIndex, syntaxHighlight,
+            compileFormat(formatString));
+}
+
+/**
+ * \param formatString The format string with markup.
+ * \returns The format string compiled for the toString() method, the
+ *   program can be used to print any number of backups.
+ */
+S9sFormatProgram
+S9sBackup::compileFormat(
+        const S9sString &formatString)
+{
+    return S9sFormatProgram(formatString, 'c');
+}
+
+/**
+ * \param syntaxHighlight Controls if the string will have colors or not.
+ * \param program The compiled format string.
+ * \returns The string representation according to the format string.
+ *
+ * Converts the backup to a string executing the compiled format string, the
+ * format string is not parsed again for every backup.
+ */
+S9sString
+S9sBackup::toString(
+        const int               backupIndex,
+        const int               fileIndex,
+        const bool              syntaxHighlight,
+        const S9sFormatProgram &program) const
 {
     S9sString    retval;
-    S9sString    tmp;
-    char         c;
-    S9sString    partFormat;
-    bool         percent        = false;
-    bool         escaped        = false;
-    bool         modifierConfig = false;
-
-    S9S_WARNING("syntaxHighlight : %s", syntaxHighlight ? "true" : "false");
-    for (uint n = 0; n < formatString.size(); ++n)
+
+    for (uint n = 0; n < program.size(); ++n)
     {
-        c = formatString[n];
-       
-        if (c == '%' && !percent)
-        {
-            percent    = true;
-            partFormat = "%";
-            continue;
-        } else if (percent && c == 'c')
-        {
-            modifierConfig = true;
-            continue;
-        } else if (c == '\\' && !escaped)
+        const S9sFormatOp &op = program.at(n);
+
+        if (op.isLiteral())
         {
-            escaped = true;
+            retval += op.literal();
             continue;
         }
 
-        // FIXME: just to avoid unused veriable message.
-        if (modifierConfig)
-            modifierConfig = modifierConfig;
-
-        if (escaped)
-        {
-            switch (c)
-            {
-                case '\"':
-                    retval += '\"';
-                    break;
-
-                case '\\':
-                    retval += '\\';
-                    break;
-       
-                case 'a':
-                    retval += '\a';
-                    break;
-
-                case 'b':
-                    retval += '\b';
-                    break;
-
-                case 'e':
-                    retval += '\027';
-                    break;
-
-                case 'n':
-                    retval += '\n';
-                    break;
-
-                case 'r':
-                    retval += '\r';
-                    break;
-
-                case 't':
-                    retval += '\t';
-                    break;
-            }
-        } else if (percent)
+        switch (op.directive())
         {
-            switch (c)
-            {
-                case 'B':
-                    // The time when the backup creation was started.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(beginAsString()));
-                    retval += tmp;
-                    break;
-
-                case 'C':
-                    // The file creation date and time.
-                    partFormat += 's';
-
-                    tmp.sprintf(
-                            STR(partFormat), 
-                            STR(fileCreatedString(backupIndex, fileIndex)));
-
-                    retval += tmp;
-                    break;
-               
-                case 'd':
-                    // The list of databases.
-                    partFormat += 's';
-                    tmp.sprintf(
-                            STR(partFormat), 
-                            STR(databaseNamesAsString(backupIndex)));
-
-                    retval += tmp;
-                    break;
-                    
-                case 'D':
-                    // The description.
-                    partFormat += 's';
-
-                    if (modifierConfig)
-                        tmp.sprintf(STR(partFormat), STR(configDescription()));
-                    else
-                        tmp.sprintf(STR(partFormat), STR(description()));
-
-                    retval += tmp;
-                    break;
-                
-                case 'e':
-                    // The encryption status.
-                    partFormat += 's';
-
-                    tmp.sprintf(STR(partFormat), 
-                            encrypted() ? "ENCRYPTED" : "UNENCRYPTED");
-                    
-                    retval += tmp;
-                    break;
-
-                case 'E':
-                    // The time when the backup creation was finished.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(endAsString()));
-                    retval += tmp;
-                    break;
-                
-                case 'F':
-                    // The file name.
-                    partFormat += 's';
-
-                    if (syntaxHighlight)
-                    {
-                        retval += S9sRpcReply::fileColorBegin(
-                                fileName(backupIndex, fileIndex));
-                    }
-
-                    tmp.sprintf(
-                            STR(partFormat), 
-                            STR(fileName(backupIndex, fileIndex)));
-                    
-                    retval += tmp;
-
-                    if (syntaxHighlight)
-                        retval += S9sRpcReply::fileColorEnd();
-                    
-                    break;
-
-                case 'H':
-                    // The backup host.
-                    partFormat += 's';
-
-                    if (modifierConfig)
-                        tmp.sprintf(STR(partFormat), STR(configBackupHost()));
-                    else
-                        tmp.sprintf(STR(partFormat), STR(backupHost()));
-
-                    retval += tmp;
-                    break;
-                
-                case 'I':
-                    // The numerical ID of the backup.
-                    partFormat += 'd';
-                    tmp.sprintf(STR(partFormat), id());
-                    retval += tmp;
-                    break;
+            case 'B':
+                // The time when the backup creation was started.
+                op.appendString(retval, beginAsString());
+                break;
+
+            case 'C':
+                // The file creation date and time.
+                op.appendString(
+                        retval, fileCreatedString(backupIndex, fileIndex));
+                break;
+           
+            case 'd':
+                // The list of databases.
+                op.appendString(
+                        retval, databaseNamesAsString(backupIndex));
+                break;
                 
-                case 'i':
-                    // The cluster ID of the backup.
-                    partFormat += 'd';
-                    tmp.sprintf(STR(partFormat), clusterId());
-                    retval += tmp;
-                    break;
-               
-                case 'J':
-                    // The ID of the job.
-                    partFormat += 'd';
-                    tmp.sprintf(STR(partFormat), jobId());
-                    retval += tmp;
-                    break;
-
-                case 'M':
-                    // The backup method.
-                    partFormat += 's';
-
-                    if (modifierConfig)
-                        tmp.sprintf(STR(partFormat), STR(configMethod()));
-                    else
-                        tmp.sprintf(STR(partFormat), STR(method()));
-
-                    retval += tmp;
-                    break;
-                
-                case 'O':
-                    // The owner.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(configOwner()));
-                    retval += tmp;
-                    break;
-
-                case 'P':
-                    // The file name.
-                    partFormat += 's';
-
-                    if (syntaxHighlight)
-                    {
-                        retval += S9sRpcReply::fileColorBegin(
-                                fileName(backupIndex, fileIndex));
-                    }
-
-                    tmp.sprintf(
-                            STR(partFormat), 
-                            STR(filePath(backupIndex, fileIndex)));
-                    
-                    retval += tmp;
-
-                    if (syntaxHighlight)
-                        retval += S9sRpcReply::fileColorEnd();
-                    
-                    break;
-                
-                case 'R':
-                    // The root directory of the backup.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(rootDir()));
-                    retval += tmp;
-                    break;
-                
-                case 'S':
-                    // The storage host. 
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(storageHost()));
-                    retval += tmp;
-                    break;
-                
-                case 's':
-                    // The storage host. 
-                    partFormat += "llu";
-                    tmp.sprintf(
-                            STR(partFormat), 
-                            fileSize(backupIndex, fileIndex).toULongLong());
-                    retval += tmp;
-                    break;
+            case 'D':
+                // The description.
+                if (op.isModified())
+                    op.appendString(retval, configDescription());
+                else
+                    op.appendString(retval, description());
+
+                break;
+            
+            case 'e':
+                // The encryption status.
+                op.appendString(
+                        retval, encrypted() ? "ENCRYPTED" : "UNENCRYPTED");
+                break;
+
+            case 'E':
+                // The time when the backup creation was finished.
+                op.appendString(retval, endAsString());
+                break;
             
-                case 't':
-                    // The storage host. 
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(title()));
-                    retval += tmp;
-                    break;
+            case 'F':
+                // The file name.
+                if (syntaxHighlight)
+                {
+                    retval += S9sRpcReply::fileColorBegin(
+                            fileName(backupIndex, fileIndex));
+                }
+
+                op.appendString(retval, fileName(backupIndex, fileIndex));
+
+                if (syntaxHighlight)
+                    retval += S9sRpcReply::fileColorEnd();
                 
-                case 'v':
-                    // The verification status.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(verificationStatus()));
-                    retval += tmp;
-                    break;
+                break;
+
+            case 'H':
+                // The backup host.
+                if (op.isModified())
+                    op.appendString(retval, configBackupHost());
+                else
+                    op.appendString(retval, backupHost());
+
+                break;
+            
+            case 'I':
+                // The numerical ID of the backup.
+                op.appendInt(retval, id());
+                break;
+            
+            case 'i':
+                // The cluster ID of the backup.
+                op.appendInt(retval, clusterId());
+                break;
+           
+            case 'J':
+                // The ID of the job.
+                op.appendInt(retval, jobId());
+                break;
+
+            case 'M':
+                // The backup method.
+                if (op.isModified())
+                    op.appendString(retval, configMethod());
+                else
+                    op.appendString(retval, method());
+
+                break;
+            
+            case 'O':
+                // The owner.
+                op.appendString(retval, configOwner());
+                break;
+
+            case 'P':
+                // The file name.
+                if (syntaxHighlight)
+                {
+                    retval += S9sRpcReply::fileColorBegin(
+                            fileName(backupIndex, fileIndex));
+                }
+
+                op.appendString(retval, filePath(backupIndex, fileIndex));
+
+                if (syntaxHighlight)
+                    retval += S9sRpcReply::fileColorEnd();
                 
-                case '%':
-                    retval += '%';
-                    break;
-
-                case '0':
-                case '1':
-                case '2':
-                case '3':
-                case '4':
-                case '5':
-                case '6':
-                case '7':
-                case '8':
-                case '9':
-                case '-':
-                case '+':
-                case '.':
-                case '\'':
-                    partFormat += c;
-                    continue;
-            }
-        } else {
-            retval += c;
+                break;
+            
+            case 'R':
+                // The root directory of the backup.
+                op.appendString(retval, rootDir());
+                break;
+            
+            case 'S':
+                // The storage host. 
+                op.appendString(retval, storageHost());
+                break;
+            
+            case 's':
+                // The storage host. 
+                op.appendULongLong(
+                        retval, fileSize(backupIndex, fileIndex).toULongLong());
+                break;
+        
+            case 't':
+                // The storage host. 
+                op.appendString(retval, title());
+                break;
+            
+            case 'v':
+                // The verification status.
+                op.appendString(retval, verificationStatus());
+                break;
         }
-
-        percent        = false;
-        escaped        = false;
-        modifierConfig = false;
     }
 
     return retval;
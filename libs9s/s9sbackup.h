@@ -20,6 +20,7 @@
 #pragma once
 
 #include "S9sVariantMap"
+#include "S9sFormatProgram"
 
 /**
  * A class that represents a backup. 
@@ -121,6 +122,14 @@ class S9sBackup
                 const bool       syntaxHighlight,
                 const S9sString &formatString) const;
 
+        S9sString toString(
+                const int               backupIndex,
+                const int               fileIndex,
+                const bool              syntaxHighlight,
+                const S9sFormatProgram &program) const;
+
+        static S9sFormatProgram compileFormat(const S9sString &formatString);
+
     private:
         S9sVariant configValue(const S9sString &key) const;
         S9sVariant config() const;
@@ -22,6 +22,7 @@
 #include "S9sStringList"
 #include "S9sRpcReply"
 #include "S9sOptions"
+#include "S9sOutput"
 #include "S9sUser"
 #include "S9sNode"
 #include "S9sAccount"
@@ -57,8 +58,34 @@ S9sBusinessLogic::execute()
     int          clusterId  = options->clusterId();
     bool         useTls     = options->useTls();
     S9sRpcClient client(controller, port, path, useTls);
+    S9sVariantList failoverControllers = options->failoverControllers();
     bool         success;
 
+    client.setKeepAlive(options->useKeepAlive());
+    client.setCompression(options->useCompression());
+    client.setTimeouts(options->rpcConnectTimeout(), options->rpcTimeout());
+    client.setTlsSessionFile(options->tlsSessionFile());
+    client.setSessionFile(options->sessionFile(), options->sessionLifetime());
+
+    /*
+     * With more than one controller we use the one that answers first.
+     */
+    for (uint idx = 0u; idx < failoverControllers.size(); ++idx)
+    {
+        S9sVariantMap other = failoverControllers[idx].toVariantMap();
+        S9sString     protocol = other["controller_protocol"].toString();
+
+        client.addController(
+                other["controller"].toString(),
+                other.contains("controller_port") ? 
+                    other["controller_port"].toInt() : port,
+                other["controller_path"].toString(),
+                protocol.empty() ? useTls : protocol == "https");
+    }
+
+    if (!failoverControllers.empty() && !client.probeControllers())
+        PRINT_VERBOSE("%s", STR(client.errorString()));
+
     /*
      * Authenticating... maybe.
      */
@@ -342,7 +369,7 @@ S9sBusinessLogic::execute()
                 reply.printObjectTree();
             } else {
                 if (options->isJsonRequested())
-                    printf("%s\n", STR(reply.toString()));
+                    reply.printJson();
                 else
                     PRINT_ERROR("%s", STR(client.errorString()));
             }
@@ -906,12 +933,12 @@ again:
         {
             // well, nothing now
             if (options->isJsonRequested())
-                printf("%s\n", STR(reply.toString()));
+                reply.printJson();
             else
                 reply.printPing();
         } else {
             if (options->isJsonRequested())
-                printf("%s\n", STR(reply.toString()));
+                reply.printJson();
             else
                 PRINT_ERROR("%s", STR(reply.errorString()));
 
@@ -919,7 +946,7 @@ again:
         }
     } else {
         if (options->isJsonRequested())
-            printf("%s\n", STR(reply.toString()));
+            reply.printJson();
         else
             PRINT_ERROR("%s", STR(client.errorString()));
             
@@ -928,6 +955,7 @@ again:
 
     if (continuous)
     {
+        S9sOutput::flush();
         usleep(500000);
         goto again;
     }
@@ -953,7 +981,7 @@ S9sBusinessLogic::executeScriptTree(
         reply.printScriptTree();
     } else {
         if (options->isJsonRequested())
-            printf("%s\n", STR(reply.toString()));
+            reply.printJson();
         else
             PRINT_ERROR("%s", STR(client.errorString()));
     }
@@ -979,7 +1007,7 @@ S9sBusinessLogic::executeClusterList(
         reply.printClusterList();
     } else {
         if (options->isJsonRequested())
-            printf("%s\n", STR(reply.toString()));
+            reply.printJson();
         else
             PRINT_ERROR("%s", STR(client.errorString()));
     }
@@ -1016,7 +1044,7 @@ S9sBusinessLogic::executeNodeGraph(
             reply.printGraph();
         } else {
             if (options->isJsonRequested())
-                printf("%s\n", STR(reply.toString()));
+                reply.printJson();
             else
                 PRINT_ERROR("%s", STR(reply.errorString()));
         }
@@ -1049,7 +1077,7 @@ S9sBusinessLogic::executeNodeList(
             reply.printNodeList();
         } else {
             if (options->isJsonRequested())
-                printf("%s\n", STR(reply.toString()));
+                reply.printJson();
             else
                 PRINT_ERROR("%s", STR(reply.errorString()));
         }
@@ -1082,7 +1110,7 @@ S9sBusinessLogic::executeConfigList(
             reply.printConfigList();
         } else {
             if (options->isJsonRequested())
-                printf("%s\n", STR(reply.toString()));
+                reply.printJson();
             else
                 PRINT_ERROR("%s", STR(reply.errorString()));
         }
@@ -1148,7 +1176,7 @@ S9sBusinessLogic::executePullConfig(
     if (!success)
     {
         if (options->isJsonRequested())
-            printf("%s\n", STR(reply.toString()));
+            reply.printJson();
         else
             PRINT_ERROR("%s", STR(reply.errorString()));
 
@@ -1174,12 +1202,15 @@ S9sBusinessLogic::executeMaintenanceList(
         if (success)
         {
             if (options->isJsonRequested())
-                printf("\n%s\n", STR(reply.toString()));
-            else
+            {
+                printf("\n");
+                reply.printJson();
+            } else {
                 reply.printMaintenanceList();
+            }
         } else {
             if (options->isJsonRequested())
-                printf("%s\n", STR(reply.toString()));
+                reply.printJson();
             else
                 PRINT_ERROR("%s", STR(reply.errorString()));
         }
@@ -1204,12 +1235,15 @@ S9sBusinessLogic::executeMetaTypeList(
         if (success)
         {
             if (options->isJsonRequested())
-                printf("\n%s\n", STR(reply.toString()));
-            else
+            {
+                printf("\n");
+                reply.printJson();
+            } else {
                 reply.printMetaTypeList();
+            }
         } else {
             if (options->isJsonRequested())
-                printf("%s\n", STR(reply.toString()));
+                reply.printJson();
             else
                 PRINT_ERROR("%s", STR(reply.errorString()));
         }
@@ -1235,12 +1269,15 @@ S9sBusinessLogic::executeMetaTypePropertyList(
         if (success)
         {
             if (options->isJsonRequested())
-                printf("\n%s\n", STR(reply.toString()));
-            else
+            {
+                printf("\n");
+                reply.printJson();
+            } else {
                 reply.printMetaTypePropertyList();
+            }
         } else {
             if (options->isJsonRequested())
-                printf("%s\n", STR(reply.toString()));
+                reply.printJson();
             else
                 PRINT_ERROR("%s", STR(reply.errorString()));
         }
@@ -1584,7 +1621,7 @@ S9sBusinessLogic::executeJobList(
             reply.printJobList();
         } else {
             if (options->isJsonRequested())
-                printf("%s\n", STR(reply.toString()));
+                reply.printJson();
             else
                 PRINT_ERROR("%s", STR(reply.errorString()));
         }
@@ -1611,7 +1648,7 @@ S9sBusinessLogic::executeLogList(
             reply.printLogList();
         } else {
             if (options->isJsonRequested())
-                printf("%s\n", STR(reply.toString()));
+                reply.printJson();
             else
                 PRINT_ERROR("%s", STR(reply.errorString()));
         }
@@ -1646,7 +1683,7 @@ S9sBusinessLogic::executeJobLog(
             reply.printJobLog();
         } else {
             if (options->isJsonRequested())
-                printf("%s\n", STR(reply.toString()));
+                reply.printJson();
             else
                 PRINT_ERROR("%s", STR(reply.errorString()));
         }
@@ -1672,7 +1709,7 @@ S9sBusinessLogic::maybeJobRegistered(
         reply = client.reply();
 
         if (options->isJsonRequested())
-            printf("%s\n", STR(reply.toString()));
+            reply.printJson();
         else
             PRINT_ERROR("%s", STR(client.errorString()));
     }    
@@ -1711,7 +1748,7 @@ S9sBusinessLogic::jobRegistered(
         }
     } else {
         if (options->isJsonRequested())
-            printf("%s\n", STR(reply.toString()));
+            reply.printJson();
         else
             PRINT_ERROR("%s", STR(reply.errorString()));
     }
@@ -1786,7 +1823,7 @@ S9sBusinessLogic::waitForJobWithProgress(
         if (options->isJsonRequested())
         {
             reply     = client.reply();
-            printf("%s\n", STR(reply.toString()));
+            reply.printJson();
         
             fflush(stdout); 
             finished = reply.progressLine(progressLine, syntaxHighlight);
@@ -2323,6 +2360,7 @@ S9sBusinessLogic::executeCreateUserThroughPipe(
         } else {
             if (!options->isBatchRequested())
             {
+                S9sOutput::flush();
                 fprintf(stderr, 
                         "Grant user '%s' succeeded.\n", 
                         STR(userName));
@@ -2447,14 +2485,14 @@ S9sBusinessLogic::executeMaintenanceCreate(
     {
         if (options->isJsonRequested())
         {
-            printf("%s\n", STR(reply.toString()));
+            reply.printJson();
         } else if (!options->isBatchRequested()) 
         {
             printf("%s\n", STR(reply.uuid()));
         }
     } else {
         if (options->isJsonRequested())
-            printf("%s\n", STR(reply.toString()));
+            reply.printJson();
         else
             PRINT_ERROR("%s", STR(client.errorString()));
     }
@@ -277,12 +277,9 @@ S9sCluster::controllerDomainName() const
 int
 S9sCluster::alarmsCritical() const
 {
-    S9sVariantMap statMap;
+    static const S9sVariantPath path("alarm_statistics/critical");
 
-    if (m_properties.contains("alarm_statistics"))
-        statMap = m_properties.at("alarm_statistics").toVariantMap();
-
-    return statMap["critical"].toInt();
+    return m_properties.valueByPath(path).toInt();
 }
 
 /**
@@ -291,12 +288,9 @@ S9sCluster::alarmsCritical() const
 int
 S9sCluster::alarmsWarning() const
 {
-    S9sVariantMap statMap;
-
-    if (m_properties.contains("alarm_statistics"))
-        statMap = m_properties.at("alarm_statistics").toVariantMap();
+    static const S9sVariantPath path("alarm_statistics/warning");
 
-    return statMap["warning"].toInt();
+    return m_properties.valueByPath(path).toInt();
 }
 
 /**
@@ -305,9 +299,9 @@ S9sCluster::alarmsWarning() const
 int
 S9sCluster::jobsAborted() const
 {
-    S9sVariantMap stateMap = S9sCluster::jobStatistics() ;
+    static const S9sVariantPath path("job_statistics/by_state/ABORTED");
 
-    return stateMap["ABORTED"].toInt();
+    return m_properties.valueByPath(path).toInt();
 }
 
 /**
@@ -316,9 +310,9 @@ S9sCluster::jobsAborted() const
 int
 S9sCluster::jobsDefined() const
 {
-    S9sVariantMap stateMap = S9sCluster::jobStatistics() ;
+    static const S9sVariantPath path("job_statistics/by_state/DEFINED");
 
-    return stateMap["DEFINED"].toInt();
+    return m_properties.valueByPath(path).toInt();
 }
 
 /**
@@ -327,9 +321,9 @@ S9sCluster::jobsDefined() const
 int
 S9sCluster::jobsDequeued() const
 {
-    S9sVariantMap stateMap = S9sCluster::jobStatistics() ;
+    static const S9sVariantPath path("job_statistics/by_state/DEQUEUED");
 
-    return stateMap["DEQUEUED"].toInt();
+    return m_properties.valueByPath(path).toInt();
 }
 
 /**
@@ -338,9 +332,9 @@ S9sCluster::jobsDequeued() const
 int
 S9sCluster::jobsFailed() const
 {
-    S9sVariantMap stateMap = S9sCluster::jobStatistics() ;
+    static const S9sVariantPath path("job_statistics/by_state/FAILED");
 
-    return stateMap["FAILED"].toInt();
+    return m_properties.valueByPath(path).toInt();
 }
 
 /**
@@ -349,9 +343,9 @@ S9sCluster::jobsFailed() const
 int
 S9sCluster::jobsFinished() const
 {
-    S9sVariantMap stateMap = S9sCluster::jobStatistics() ;
+    static const S9sVariantPath path("job_statistics/by_state/FINISHED");
 
-    return stateMap["FINISHED"].toInt();
+    return m_properties.valueByPath(path).toInt();
 }
 
 /**
@@ -360,26 +354,12 @@ S9sCluster::jobsFinished() const
 int
 S9sCluster::jobsRunning() const
 {
-    S9sVariantMap stateMap = S9sCluster::jobStatistics() ;
+    static const S9sVariantPath path("job_statistics/by_state/RUNNING");
 
-    return stateMap["RUNNING"].toInt();
+    return m_properties.valueByPath(path).toInt();
 }
 
 
-/**
- * Private function to get the job statistics map.
- */
-S9sVariantMap 
-S9sCluster::jobStatistics() const
-{
-    S9sVariantMap jobsMap;
-
-    if (m_properties.contains("job_statistics"))
-        jobsMap = m_properties.at("job_statistics").toVariantMap();
-
-    return jobsMap["by_state"].toVariantMap();
-}
-
 /**
  * \returns The total memory size of the hosts in the cluster.
  */
@@ -928,357 +908,233 @@ S9sCluster::toString(
         const bool       syntaxHighlight,
         const S9sString &formatString) const
 {
-    S9sFormatter formatter;    
+    return toString(syntaxHighlight, compileFormat(formatString));
+}
+
+/**
+ * \param formatString The format string with markup.
+ * \returns The format string compiled for the toString() method, the
+ *   program can be used to print any number of clusters.
+ */
+S9sFormatProgram
+S9sCluster::compileFormat(
+        const S9sString &formatString)
+{
+    return S9sFormatProgram(formatString, 'f', false);
+}
+
+/**
+ * \param syntaxHighlight Controls if the string will have colors or not.
+ * \param program The compiled format string.
+ * \returns The string representation according to the format string.
+ *
+ * Converts the cluster to a string executing the compiled format string, the
+ * format string is not parsed again for every cluster.
+ */
+S9sString
+S9sCluster::toString(
+        const bool              syntaxHighlight,
+        const S9sFormatProgram &program) const
+{
+    S9sFormatter formatter;
     S9sString    retval;
-    S9sString    tmp;
-    char         c;
-    S9sString    partFormat;
-    bool         percent      = false;
-    bool         escaped      = false;
-    bool         modifierFree = false;
-
-    for (uint n = 0; n < formatString.size(); ++n)
+
+    for (uint n = 0; n < program.size(); ++n)
     {
-        c = formatString[n];
-        
-        if (c == '%' && !percent)
-        {
-            percent    = true;
-            partFormat = "%";
-            continue;
-        } else if (percent && c == 'f')
-        {
-            modifierFree = true;
-            continue;
-        } else if (c == '\\' && !escaped)
+        const S9sFormatOp &op = program.at(n);
+
+        if (op.isLiteral())
         {
-            escaped = true;
+            retval += op.literal();
             continue;
         }
 
-        if (escaped)
+        switch (op.directive())
         {
-            switch (c)
-            {
-                case '\"':
-                    retval += '\"';
-                    break;
-
-                case '\\':
-                    retval += '\\';
-                    break;
-       
-                case 'a':
-                    retval += '\a';
-                    break;
-
-                case 'b':
-                    retval += '\b';
-                    break;
-
-                case 'e':
-                    retval += '\027';
-                    break;
-
-                case 'n':
-                    retval += '\n';
-                    break;
-
-                case 'r':
-                    retval += '\r';
-                    break;
-
-                case 't':
-                    retval += '\t';
-                    break;
-            }
-        } else if (percent)
-        {
-            switch (c)
-            {
-                case 'a':
-                    // The number of active alarms on the cluster.
-                    partFormat += 'd';
-                    tmp.sprintf(STR(partFormat), 
-                            alarmsCritical() + alarmsWarning());
-
-                    retval += tmp;
-                    break;
-
-                case 'C':
-                    // The configuration file for the cluster.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(configFile()));
-                    
-                    if (syntaxHighlight)
-                        retval += S9sRpcReply::fileColorBegin(configFile());
-                    
-                    retval += tmp;
-
-                    if (syntaxHighlight)
-                        retval += S9sRpcReply::fileColorEnd();
-                    break;
+            case 'a':
+                // The number of active alarms on the cluster.
+                op.appendInt(retval, alarmsCritical() + alarmsWarning());
+                break;
+
+            case 'C':
+                // The configuration file for the cluster.
+                if (syntaxHighlight)
+                    retval += S9sRpcReply::fileColorBegin(configFile());
                 
-                case 'c':
-                    // The total number of CPU cores in the cluster.
-                    partFormat += 'd';
-                    tmp.sprintf(STR(partFormat), nCpuCores().toInt());
-                    retval += tmp;
-                    break;
-
+                op.appendString(retval, configFile());
+
+                if (syntaxHighlight)
+                    retval += S9sRpcReply::fileColorEnd();
+                break;
+            
+            case 'c':
+                // The total number of CPU cores in the cluster.
+                op.appendInt(retval, nCpuCores().toInt());
+                break;
+
+            
+            case 'D':
+                // The controller domain name for the cluster.
+                op.appendString(retval, controllerDomainName());
+
+                break;
+
+            case 'G':
+                // The name of the group owner.
+                if (syntaxHighlight)
+                {
+                    retval += S9sRpcReply::groupColorBegin(
+                            groupOwnerName());
+                }
+
+                op.appendString(retval, groupOwnerName());
+
+                if (syntaxHighlight)
+                    retval += S9sRpcReply::groupColorEnd();
+
+                break;
+
+            case 'H':
+                // The controller host name for the cluster.
+                op.appendString(retval, controllerName());
+
+                break;
+            
+            case 'h':
+                // The number of the hosts in the cluster.
+                op.appendInt(retval, nHosts());
+                break;
+
+            case 'I':
+                // The ID of the cluster.
+                op.appendInt(retval, clusterId());
+                break;
+            
+            case 'i':
+                // The total number of monitored disk devices.
+                op.appendInt(retval, nDevices().toInt());
+                break;
+             
+            case 'k':
+                // The total disk size found in the cluster.
+                if (op.isModified())
+                {
+                    op.appendDouble(retval, freeDiskBytes().toTBytes());
+                } else {
+                    op.appendDouble(retval, totalDiskBytes().toTBytes());
+                }
+
+                break;
+
+            case 'L':
+                // The log file for the cluster.
+                if (syntaxHighlight)
+                    retval += S9sRpcReply::fileColorBegin(logFile());
                 
-                case 'D':
-                    // The controller domain name for the cluster.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(controllerDomainName()));
-                    
-                    retval += tmp;
-
-                    break;
-
-                case 'G':
-                    // The name of the group owner.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(groupOwnerName()));
-
-                    if (syntaxHighlight)
-                    {
-                        retval += S9sRpcReply::groupColorBegin(
-                                groupOwnerName());
-                    }
-
-                    retval += tmp;
-
-                    if (syntaxHighlight)
-                        retval += S9sRpcReply::groupColorEnd();
-
-                    break;
-
-                case 'H':
-                    // The controller host name for the cluster.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(controllerName()));
-                    
-                    retval += tmp;
-
-                    break;
-                
-                case 'h':
-                    // The number of the hosts in the cluster.
-                    partFormat += 'd';
-                    tmp.sprintf(STR(partFormat), nHosts());
-
-                    retval += tmp;
-                    break;
-
-                case 'I':
-                    // The ID of the cluster.
-                    partFormat += 'd';
-                    tmp.sprintf(STR(partFormat), clusterId());
-
-                    retval += tmp;
-                    break;
-                
-                case 'i':
-                    // The total number of monitored disk devices.
-                    partFormat += 'd';
-                    tmp.sprintf(STR(partFormat), nDevices().toInt());
-
-                    retval += tmp;
-                    break;
-                 
-                case 'k':
-                    // The total disk size found in the cluster.
-                    partFormat += 'f';
-
-                    if (modifierFree)
-                    {
-                        tmp.sprintf(
-                                STR(partFormat), 
-                                freeDiskBytes().toTBytes());
-                    } else {
-                        tmp.sprintf(
-                                STR(partFormat), 
-                                totalDiskBytes().toTBytes());
-                    }
-
-                    retval += tmp;
-                    break;
-
-                case 'L':
-                    // The log file for the cluster.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(logFile()));
-                    
-                    if (syntaxHighlight)
-                        retval += S9sRpcReply::fileColorBegin(logFile());
-                    
-                    retval += tmp;
-
-                    if (syntaxHighlight)
-                        retval += S9sRpcReply::fileColorEnd();
-
-                    break;
-
-                case 'M':
-                    // The ID of the cluster.
-                    partFormat += 's';
-                    
-                    tmp.sprintf(STR(partFormat), STR(statusText()));
-
-                    retval += tmp;
-                    break;
-                
-                case 'm':
-                    // The total memory size found in the cluster.
-                    partFormat += 'f';
-                    if (modifierFree)
-                        tmp.sprintf(STR(partFormat), memFree().toGBytes());
-                    else
-                        tmp.sprintf(STR(partFormat), memTotal().toGBytes());
-
-                    retval += tmp;
-                    break;
-
-                case 'N':
-                    // The name of the cluster.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(name()));
-
-                    if (syntaxHighlight)
-                        retval += XTERM_COLOR_BLUE;
-
-                    retval += tmp;
-
-                    if (syntaxHighlight)
-                        retval += TERM_NORMAL;
-
-                    break;
-                
-                case 'n':
-                    // The total number of monitored network interfaces.
-                    partFormat += 'd';
-                    tmp.sprintf(STR(partFormat), nNics().toInt());
-
-                    retval += tmp;
-                    break;
-                
-                case 'O':
-                    // The name of the owner.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(ownerName()));
-
-                    if (syntaxHighlight)
-                        retval += S9sRpcReply::userColorBegin();
-
-                    retval += tmp;
-
-                    if (syntaxHighlight)
-                        retval += S9sRpcReply::userColorEnd();
-
-                    break;
-
-                case 'P':
-                    // The CDT path 
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(cdtPath()));
-
-                    retval += formatter.folderColorBegin();
-                    retval += tmp;
-                    retval += formatter.folderColorEnd();
-
-                    break;
-
-                case 'S':
-                    // The state of the cluster.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(state()));
-
-                    if (syntaxHighlight)
-                        retval += S9sRpcReply::clusterStateColorBegin(state());
-
-                    retval += tmp;
-
-                    if (syntaxHighlight)
-                        retval += S9sRpcReply::clusterStateColorEnd();
-
-                    break;
-                
-                case 'T':
-                    // The type of the cluster.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(clusterType()));
-                    retval += tmp;
-                    break;
-
-                case 't':
-                    // The total network traffic found in the cluster.
-                    partFormat += 'f';
-                    tmp.sprintf(STR(partFormat), 
-                            netBytesPerSecond().toMBytes());
-
-                    retval += tmp;
-                    break;
-
-                case 'V':
-                    // The vendor and version of the node.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(vendorAndVersion()));
-                    retval += tmp;
-                    break;
-               
-                case 'U':
-                    // The number of CPUs.
-                    partFormat += 'd';
-                    tmp.sprintf(STR(partFormat), nCpus().toInt());
-                    retval += tmp;
-                    break;
-
-                case 'u':
-                    // The CPU usage percent. 
-                    partFormat += 'f';
-                    tmp.sprintf(STR(partFormat), cpuUsagePercent().toDouble());
-                    retval += tmp;
-                    break;
-                
-                case 'w':
-                    // The total swap space size found in the cluster.
-                    partFormat += 'f';
-                    if (modifierFree)
-                        tmp.sprintf(STR(partFormat), swapFree().toGBytes());
-                    else
-                        tmp.sprintf(STR(partFormat), swapTotal().toGBytes());
-
-                    retval += tmp;
-                    break;
-                
-                case '%':
-                    retval += '%';
-                    break;
-
-                case '0':
-                case '1':
-                case '2':
-                case '3':
-                case '4':
-                case '5':
-                case '6':
-                case '7':
-                case '8':
-                case '9':
-                case '-':
-                case '+':
-                case '.':
-                    partFormat += c;
-                    continue;
-            }
-        } else {
-            retval += c;
+                op.appendString(retval, logFile());
+
+                if (syntaxHighlight)
+                    retval += S9sRpcReply::fileColorEnd();
+
+                break;
+
+            case 'M':
+                // The ID of the cluster.
+                op.appendString(retval, statusText());
+                break;
+            
+            case 'm':
+                // The total memory size found in the cluster.
+                if (op.isModified())
+                    op.appendDouble(retval, memFree().toGBytes());
+                else
+                    op.appendDouble(retval, memTotal().toGBytes());
+
+                break;
+
+            case 'N':
+                // The name of the cluster.
+                if (syntaxHighlight)
+                    retval += XTERM_COLOR_BLUE;
+
+                op.appendString(retval, name());
+
+                if (syntaxHighlight)
+                    retval += TERM_NORMAL;
+
+                break;
+            
+            case 'n':
+                // The total number of monitored network interfaces.
+                op.appendInt(retval, nNics().toInt());
+                break;
+            
+            case 'O':
+                // The name of the owner.
+                if (syntaxHighlight)
+                    retval += S9sRpcReply::userColorBegin();
+
+                op.appendString(retval, ownerName());
+
+                if (syntaxHighlight)
+                    retval += S9sRpcReply::userColorEnd();
+
+                break;
+
+            case 'P':
+                // The CDT path 
+                retval += formatter.folderColorBegin();
+                op.appendString(retval, cdtPath());
+                retval += formatter.folderColorEnd();
+
+                break;
+
+            case 'S':
+                // The state of the cluster.
+                if (syntaxHighlight)
+                    retval += S9sRpcReply::clusterStateColorBegin(state());
+
+                op.appendString(retval, state());
+
+                if (syntaxHighlight)
+                    retval += S9sRpcReply::clusterStateColorEnd();
+
+                break;
+            
+            case 'T':
+                // The type of the cluster.
+                op.appendString(retval, clusterType());
+                break;
+
+            case 't':
+                // The total network traffic found in the cluster.
+                op.appendDouble(retval, netBytesPerSecond().toMBytes());
+                break;
+
+            case 'V':
+                // The vendor and version of the node.
+                op.appendString(retval, vendorAndVersion());
+                break;
+           
+            case 'U':
+                // The number of CPUs.
+                op.appendInt(retval, nCpus().toInt());
+                break;
+
+            case 'u':
+                // The CPU usage percent. 
+                op.appendDouble(retval, cpuUsagePercent().toDouble());
+                break;
+            
+            case 'w':
+                // The total swap space size found in the cluster.
+                if (op.isModified())
+                    op.appendDouble(retval, swapFree().toGBytes());
+                else
+                    op.appendDouble(retval, swapTotal().toGBytes());
+
+                break;
         }
-
-        percent      = false;
-        escaped      = false;
-        modifierFree = false;
     }
 
     return retval;
@@ -21,6 +21,7 @@
 
 #include <S9sVariantMap>
 #include <S9sObject>
+#include <S9sFormatProgram>
 
 #define S9S_INVALID_CLUSTER_ID -1
 #define S9S_CLUSTER_ID_IS_VALID(_id) (_id > 0)
@@ -123,7 +124,12 @@ class S9sCluster : public S9sObject
                 const bool       syntaxHighlight,
                 const S9sString &formatString) const;
 
+        S9sString toString(
+                const bool              syntaxHighlight,
+                const S9sFormatProgram &program) const;
+
+        static S9sFormatProgram compileFormat(const S9sString &formatString);
+
     private:
-        S9sVariantMap jobStatistics() const;
         S9sVariant sheetInfo(const S9sString &key) const;
 };
@@ -198,277 +198,182 @@ S9sContainer::toString(
         const bool       syntaxHighlight,
         const S9sString &formatString) const
 {
-    S9sString      retval;
-    S9sString      tmp, value;
-    char           c;
-    S9sString      partFormat;
-    bool           percent      = false;
-    bool           escaped      = false;
-    S9sOptions    *options = S9sOptions::instance();
-    //bool         modifierFree = false;
-
-    for (uint n = 0; n < formatString.size(); ++n)
+    return toString(syntaxHighlight, compileFormat(formatString));
+}
+
+/**
+ * \param formatString The format string with markup.
+ * \returns The format string compiled for the toString() method, the
+ *   program can be used to print any number of containers.
+ */
+S9sFormatProgram
+S9sContainer::compileFormat(
+        const S9sString &formatString)
+{
+    return S9sFormatProgram(formatString, 'f');
+}
+
+/**
+ * \param syntaxHighlight Controls if the string will have colors or not.
+ * \param program The compiled format string.
+ * \returns The string representation according to the format string.
+ *
+ * Converts the container to a string executing the compiled format string, the
+ * format string is not parsed again for every container.
+ */
+S9sString
+S9sContainer::toString(
+        const bool              syntaxHighlight,
+        const S9sFormatProgram &program) const
+{
+    S9sOptions  *options = S9sOptions::instance();
+    S9sString    retval;
+    S9sString    value;
+
+    for (uint n = 0; n < program.size(); ++n)
     {
-        c = formatString[n];
-       
-        if (c == '%' && !percent)
-        {
-            percent    = true;
-            partFormat = "%";
-            continue;
-        } else if (percent && c == 'f')
-        {
-            //modifierFree = true;
-            continue;
-        } else if (c == '\\' && !escaped)
+        const S9sFormatOp &op = program.at(n);
+
+        if (op.isLiteral())
         {
-            escaped = true;
+            retval += op.literal();
             continue;
         }
 
-        if (escaped)
+        switch (op.directive())
         {
-            switch (c)
-            {
-                case '\"':
-                    retval += '\"';
-                    break;
-
-                case '\\':
-                    retval += '\\';
-                    break;
-       
-                case 'a':
-                    retval += '\a';
-                    break;
-
-                case 'b':
-                    retval += '\b';
-                    break;
-
-                case 'e':
-                    retval += '\027';
-                    break;
-
-                case 'n':
-                    retval += '\n';
-                    break;
-
-                case 'r':
-                    retval += '\r';
-                    break;
-
-                case 't':
-                    retval += '\t';
-                    break;
-            }
-        } else if (percent)
-        {
-            switch (c)
-            {
-                case 'A':
-                    // The ip address of the node.
-                    partFormat += 's';
-                    value = ipAddress(options->addressType(), "-");
-
-                    tmp.sprintf(STR(partFormat), STR(value));
-
-                    retval += S9sRpcReply::ipColorBegin(value);
-                    retval += tmp;
-                    retval += S9sRpcReply::ipColorEnd();
-                    break;
-                
-                case 'a':
-                    // The private ip address of the node.
-                    partFormat += 's';
-                    value = ipAddress(S9s::PrivateIpv4Address, "-");
+            case 'A':
+                // The ip address of the node.
+                value = ipAddress(options->addressType(), "-");
 
-                    tmp.sprintf(STR(partFormat), STR(value));
+                retval += S9sRpcReply::ipColorBegin(value);
+                op.appendString(retval, value);
+                retval += S9sRpcReply::ipColorEnd();
+                break;
+            
+            case 'a':
+                // The private ip address of the node.
+                value = ipAddress(S9s::PrivateIpv4Address, "-");
+
+                retval += S9sRpcReply::ipColorBegin(value);
+                op.appendString(retval, value);
+                retval += S9sRpcReply::ipColorEnd();
+                break;
 
-                    retval += S9sRpcReply::ipColorBegin(value);
-                    retval += tmp;
-                    retval += S9sRpcReply::ipColorEnd();
-                    break;
+            case 'C':
+                // The configuration file. 
+                if (syntaxHighlight)
+                    retval += S9sRpcReply::fileColorBegin(configFile());
 
-                case 'C':
-                    // The configuration file. 
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(configFile()));
+                op.appendString(retval, configFile());
 
-                    if (syntaxHighlight)
-                        retval += S9sRpcReply::fileColorBegin(configFile());
+                if (syntaxHighlight)
+                    retval += S9sRpcReply::fileColorEnd();
 
-                    retval += tmp;
+                break;
+            
+            case 'c':
+                // 
+                op.appendString(retval, provider());
+                break;
 
-                    if (syntaxHighlight)
-                        retval += S9sRpcReply::fileColorEnd();
+            case 'F':
+                // The first firewall.
+                op.appendString(retval, firewall());
+                break;
 
-                    break;
-                
-                case 'c':
-                    // 
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(provider()));
-                    retval += tmp;
-                    break;
-
-                case 'F':
-                    // The first firewall.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(firewall()));
-                    retval += tmp;
-                    break;
-
-                case 'I':
-                    // The ID of the node.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(id("-")));
-                    retval += tmp;
-                    break;
-                
-                case 'i':
-                    // 
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(image("-")));
-                    retval += tmp;
-                    break;
-
-                case 'N':
-                    // The name of the container.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(alias()));
-
-                    retval += S9sRpcReply::containerColorBegin(stateAsChar());
-                    retval += tmp;
-                    retval += S9sRpcReply::containerColorEnd();
-                    
-                    break;
-
-                case 'O':
-                    // The name of the owner.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(ownerName()));
-
-                    if (syntaxHighlight)
-                        retval += S9sRpcReply::userColorBegin();
-
-                    retval += tmp;
-
-                    if (syntaxHighlight)
-                        retval += S9sRpcReply::userColorEnd();
-
-                    break;
-                
-                case 'P':
-                    // The name of the parent server.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(parentServerName()));
-                    retval += tmp;
-                    break;
-                
-                case 'R':
-                    // 
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(region("-")));
-                    retval += tmp;
-                    break;
-                
-                case 'r':
-                    // 
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(subnetCidr("-")));
-                    retval += tmp;
-                    break;
-
-                case 'S':
-                    // The state of the container.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(state()));
-
-                    if (syntaxHighlight)
-                    {
-                        retval += 
-                            S9sRpcReply::clusterStateColorBegin(state());
-                    }
-
-                    retval += tmp;
-
-                    if (syntaxHighlight)
-                        retval += S9sRpcReply::clusterStateColorEnd();
-
-                    break;
-                    
-                case 'T':
-                    // The type of the container.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(type()));
-                    retval += tmp;
-                    break;
+            case 'I':
+                // The ID of the node.
+                op.appendString(retval, id("-"));
+                break;
+            
+            case 'i':
+                // 
+                op.appendString(retval, image("-"));
+                break;
+
+            case 'N':
+                // The name of the container.
+                retval += S9sRpcReply::containerColorBegin(stateAsChar());
+                op.appendString(retval, alias());
+                retval += S9sRpcReply::containerColorEnd();
                 
-                case 't':
-                    // 
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(templateName("-")));
-                    retval += tmp;
-                    break;
+                break;
+
+            case 'O':
+                // The name of the owner.
+                if (syntaxHighlight)
+                    retval += S9sRpcReply::userColorBegin();
+
+                op.appendString(retval, ownerName());
+
+                if (syntaxHighlight)
+                    retval += S9sRpcReply::userColorEnd();
+
+                break;
+            
+            case 'P':
+                // The name of the parent server.
+                op.appendString(retval, parentServerName());
+                break;
+            
+            case 'R':
+                // 
+                op.appendString(retval, region("-"));
+                break;
+            
+            case 'r':
+                // 
+                op.appendString(retval, subnetCidr("-"));
+                break;
+
+            case 'S':
+                // The state of the container.
+                if (syntaxHighlight)
+                {
+                    retval += 
+                        S9sRpcReply::clusterStateColorBegin(state());
+                }
+
+                op.appendString(retval, state());
+
+                if (syntaxHighlight)
+                    retval += S9sRpcReply::clusterStateColorEnd();
+
+                break;
                 
-                case 'U':
-                    // The type of the container.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(subnetId()));
-                    retval += tmp;
-                    break;
+            case 'T':
+                // The type of the container.
+                op.appendString(retval, type());
+                break;
+            
+            case 't':
+                // 
+                op.appendString(retval, templateName("-"));
+                break;
+            
+            case 'U':
+                // The type of the container.
+                op.appendString(retval, subnetId());
+                break;
+            
+            case 'V':
+                // The type of the container.
+                op.appendString(retval, subnetVpcId());
+                break;
+
+            case 'z':
+                // The class name.
+                if (syntaxHighlight)
+                    retval += XTERM_COLOR_GREEN;
+
+                op.appendString(retval, className());
+
+                if (syntaxHighlight)
+                    retval += TERM_NORMAL;
                 
-                case 'V':
-                    // The type of the container.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(subnetVpcId()));
-                    retval += tmp;
-                    break;
-
-                case 'z':
-                    // The class name.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(className()));
-                    
-                    if (syntaxHighlight)
-                        retval += XTERM_COLOR_GREEN;
-
-                    retval += tmp;
-
-                    if (syntaxHighlight)
-                        retval += TERM_NORMAL;
-                    
-                    break;
-
-                case '%':
-                    retval += '%';
-                    break;
-
-                case '0':
-                case '1':
-                case '2':
-                case '3':
-                case '4':
-                case '5':
-                case '6':
-                case '7':
-                case '8':
-                case '9':
-                case '-':
-                case '+':
-                case '.':
-                case '\'':
-                    partFormat += c;
-                    continue;
-            }
-        } else {
-            retval += c;
+                break;
         }
-
-        percent      = false;
-        escaped      = false;
-        //modifierFree = false;
     }
 
     return retval;
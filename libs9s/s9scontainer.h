@@ -23,6 +23,7 @@
 #include "S9sVariantMap"
 #include "S9sUrl"
 #include "S9sCluster"
+#include "S9sFormatProgram"
 
 /**
  * A class that represents a node/host/server. 
@@ -54,6 +55,13 @@ class S9sContainer : public S9sObject
                     const bool       syntaxHighlight,
                     const S9sString &formatString) const;
 
+        S9sString 
+            toString(
+                    const bool              syntaxHighlight,
+                    const S9sFormatProgram &program) const;
+
+        static S9sFormatProgram compileFormat(const S9sString &formatString);
+
         S9sString hostname() const;
 
         S9sString ipAddress(
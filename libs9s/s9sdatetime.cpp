@@ -432,7 +432,8 @@ S9sString
 S9sDateTime::toString(
         S9sDateTime::DateTimeFormat format) const
 {
-    struct tm *lt = ::localtime(&m_timeSpec.tv_sec);
+    struct tm  localTime;
+    struct tm *lt = ::localtime_r(&m_timeSpec.tv_sec, &localTime);
     S9sString retval;
 
     switch (format)
@@ -545,7 +546,8 @@ S9sDateTime::toString(
                 // 
                 // Here we change to GTMT and format that.
                 // 
-                struct tm *lt = ::gmtime(&m_timeSpec.tv_sec);
+                struct tm  gmtTime;
+                struct tm *lt = ::gmtime_r(&m_timeSpec.tv_sec, &gmtTime);
                     
                 strftime(buffer, size, "%Y-%m-%dT%H:%M:%S", lt);
                 millisecs.sprintf(".%03d", m_timeSpec.tv_nsec / 1000000);
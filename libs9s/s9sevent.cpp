@@ -407,24 +407,20 @@ S9sEvent::eventJobToOneLiner() const
 S9sString
 S9sEvent::eventLogToOneLiner() const
 {
-    S9sVariantMap logEntryMap = 
-        m_properties.valueByPath("event_specifics/log_entry").toVariantMap();
+    static const S9sVariantPath path("event_specifics/log_entry");
+    static const S9sVariantPath messagePath("log_specifics/message_text");
+    const S9sVariantMap &logEntryMap = 
+        m_properties.valueByPath(path).toVariantMap();
 
-    logEntryMap = m_properties.valueByPath("event_specifics/log_entry").toVariantMap();
     #if 0
     return m_properties.toString();
     #else
     S9sString retval;
-    S9sVariantMap specifics;
+    const S9sVariant &message = logEntryMap.valueByPath(messagePath);
 
-    if (logEntryMap.contains("log_specifics"))
-        specifics = logEntryMap.at("log_specifics").toVariantMap();
-
-    if (specifics.contains("message_text"))
+    if (!message.isInvalid())
     {
-        S9sString message = specifics.at("message_text").toString();
-
-        retval.sprintf("%s", STR(message));
+        retval.sprintf("%s", STR(message.toString()));
     } else {
         S9sVariant variant = logEntryMap;
 
@@ -744,15 +740,18 @@ S9sEvent::cmonDiskInfoToOneLiner(
 S9sString
 S9sEvent::senderFile() const
 {
-    return getString("event_origins/sender_file");
+    static const S9sVariantPath path("event_origins/sender_file");
+
+    return getString(path);
 }
 
 int
 S9sEvent::senderLine() const
 {
-    return m_properties.valueByPath("event_origins/sender_line").toInt();
-}
+    static const S9sVariantPath path("event_origins/sender_line");
 
+    return getInt(path);
+}
 
 S9sString 
 S9sEvent::getString(
@@ -761,6 +760,13 @@ S9sEvent::getString(
     return m_properties.valueByPath(path).toString();
 }
 
+S9sString 
+S9sEvent::getString(
+        const S9sVariantPath &path) const
+{
+    return m_properties.valueByPath(path).toString();
+}
+
 int
 S9sEvent::getInt(
         const S9sString &path) const
@@ -768,21 +774,33 @@ S9sEvent::getInt(
     return m_properties.valueByPath(path).toInt();
 }
 
+int
+S9sEvent::getInt(
+        const S9sVariantPath &path) const
+{
+    return m_properties.valueByPath(path).toInt();
+}
+
 int
 S9sEvent::clusterId() const
 {
-    return getInt("event_specifics/cluster_id");
+    static const S9sVariantPath path("event_specifics/cluster_id");
+
+    return getInt(path);
 }
 
 bool
 S9sEvent::hasHost() const
 {
-    S9sString className;
-    if (!m_properties.valueByPath("/event_specifics/host").isVariantMap())
+    static const S9sVariantPath path("event_specifics/host");
+    static const S9sVariantPath classNamePath("class_name");
+    const S9sVariant &host = m_properties.valueByPath(path);
+    S9sString         className;
+
+    if (!host.isVariantMap())
         return false;
 
-    className = m_properties.valueByPath("/event_specifics/host/class_name").
-        toString();
+    className = host.toVariantMap().valueByPath(classNamePath).toString();
 
     // We handle these using a different class.
     if (className == "CmonLxcServer")
@@ -798,8 +816,8 @@ S9sEvent::hasHost() const
 S9sNode
 S9sEvent::host() const
 {
-    S9sNode host =
-        m_properties.valueByPath("/event_specifics/host").toVariantMap();
+    static const S9sVariantPath path("event_specifics/host");
+    S9sNode host = m_properties.valueByPath(path).toVariantMap();
 
     return host;
 }
@@ -807,12 +825,15 @@ S9sEvent::host() const
 bool
 S9sEvent::hasServer() const
 {
-    S9sString className;
-    if (!m_properties.valueByPath("/event_specifics/host").isVariantMap())
+    static const S9sVariantPath path("event_specifics/host");
+    static const S9sVariantPath classNamePath("class_name");
+    const S9sVariant &host = m_properties.valueByPath(path);
+    S9sString         className;
+
+    if (!host.isVariantMap())
         return false;
 
-    className = m_properties.valueByPath("/event_specifics/host/class_name").
-        toString();
+    className = host.toVariantMap().valueByPath(classNamePath).toString();
 
     // We handle these using a different class.
     if (className == "CmonLxcServer")
@@ -828,8 +849,8 @@ S9sEvent::hasServer() const
 S9sServer
 S9sEvent::server() const
 {
-    S9sServer server =
-        m_properties.valueByPath("/event_specifics/host").toVariantMap();
+    static const S9sVariantPath path("event_specifics/host");
+    S9sServer server = m_properties.valueByPath(path).toVariantMap();
 
     return server;
 }
@@ -837,14 +858,16 @@ S9sEvent::server() const
 bool
 S9sEvent::hasCluster() const
 {
-    return m_properties.valueByPath("/event_specifics/cluster").isVariantMap();
+    static const S9sVariantPath path("event_specifics/cluster");
+
+    return m_properties.valueByPath(path).isVariantMap();
 }
 
 S9sCluster
 S9sEvent::cluster() const
 {
-    S9sCluster cluster =
-        m_properties.valueByPath("/event_specifics/cluster").toVariantMap();
+    static const S9sVariantPath path("event_specifics/cluster");
+    S9sCluster cluster = m_properties.valueByPath(path).toVariantMap();
 
     return cluster;
 }
@@ -852,14 +875,16 @@ S9sEvent::cluster() const
 bool
 S9sEvent::hasJob() const
 {
-    return m_properties.valueByPath("/event_specifics/job").isVariantMap();
+    static const S9sVariantPath path("event_specifics/job");
+
+    return m_properties.valueByPath(path).isVariantMap();
 }
 
 S9sJob
 S9sEvent::job() const
 {
-    S9sJob job =
-        m_properties.valueByPath("/event_specifics/job").toVariantMap();
+    static const S9sVariantPath path("event_specifics/job");
+    S9sJob job = m_properties.valueByPath(path).toVariantMap();
 
     return job;
 }
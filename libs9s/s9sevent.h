@@ -146,7 +146,9 @@ class S9sEvent : public S9sObject
                 bool          useSyntaxHighlight) const;
         
         S9sString getString(const S9sString &path) const;
+        S9sString getString(const S9sVariantPath &path) const;
         int getInt(const S9sString &path) const;
+        int getInt(const S9sVariantPath &path) const;
 
     private:
         S9sFormatter m_formatter;
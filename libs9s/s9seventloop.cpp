@@ -0,0 +1,307 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2018  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "s9seventloop.h"
+
+#include "S9sVector"
+
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+
+#ifdef __linux__
+#  include <sys/epoll.h>
+#endif
+
+//#define DEBUG
+//#define WARNING
+#include "s9sdebug.h"
+
+#define MAX_EVENTS 64
+
+#ifdef __linux__
+static uint32_t
+toEpollEvents(
+        int events)
+{
+    uint32_t retval = 0u;
+
+    if (events & POLLIN)
+        retval |= EPOLLIN;
+
+    if (events & POLLOUT)
+        retval |= EPOLLOUT;
+
+    return retval;
+}
+
+static int
+fromEpollEvents(
+        uint32_t events)
+{
+    int retval = 0;
+
+    if (events & EPOLLIN)
+        retval |= POLLIN;
+
+    if (events & EPOLLOUT)
+        retval |= POLLOUT;
+
+    if (events & EPOLLERR)
+        retval |= POLLERR;
+
+    if (events & EPOLLHUP)
+        retval |= POLLHUP;
+
+    return retval;
+}
+#endif
+
+S9sEventLoop::S9sEventLoop() :
+    m_epollFd(-1),
+    m_nextSerial(0u)
+{
+    #ifdef __linux__
+    m_epollFd = epoll_create(MAX_EVENTS);
+    if (m_epollFd < 0)
+        S9S_WARNING("epoll_create(): %m");
+    #endif
+}
+
+S9sEventLoop::~S9sEventLoop()
+{
+    if (m_epollFd >= 0)
+        ::close(m_epollFd);
+}
+
+/**
+ * \param fd The file descriptor to watch.
+ * \param events The poll() events to wait for (POLLIN and/or POLLOUT).
+ * \param callback The function to call when the file descriptor is ready.
+ * \param userData The pointer passed to the callback.
+ * \returns true if the file descriptor is now watched.
+ */
+bool
+S9sEventLoop::watch(
+        int               fd, 
+        int               events,
+        S9sEventCallback  callback,
+        void             *userData)
+{
+    Watcher watcher;
+
+    if (fd < 0 || m_watchers.contains(fd))
+        return false;
+
+    #ifdef __linux__
+    if (m_epollFd >= 0)
+    {
+        struct epoll_event event;
+
+        event.events  = toEpollEvents(events);
+        event.data.fd = fd;
+
+        if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event) != 0)
+        {
+            S9S_WARNING("epoll_ctl(): %m");
+            return false;
+        }
+    }
+    #endif
+
+    watcher.events   = events;
+    watcher.callback = callback;
+    watcher.userData = userData;
+    watcher.serial   = ++m_nextSerial;
+
+    m_watchers[fd] = watcher;
+    return true;
+}
+
+/**
+ * Changes the events a watched file descriptor is waiting for.
+ */
+bool
+S9sEventLoop::modify(
+        int fd, 
+        int events)
+{
+    if (!m_watchers.contains(fd))
+        return false;
+
+    if (m_watchers[fd].events == events)
+        return true;
+
+    #ifdef __linux__
+    if (m_epollFd >= 0)
+    {
+        struct epoll_event event;
+
+        event.events  = toEpollEvents(events);
+        event.data.fd = fd;
+
+        if (epoll_ctl(m_epollFd, EPOLL_CTL_MOD, fd, &event) != 0)
+        {
+            S9S_WARNING("epoll_ctl(): %m");
+            return false;
+        }
+    }
+    #endif
+
+    m_watchers[fd].events = events;
+    return true;
+}
+
+/**
+ * Stops watching the file descriptor. This should be called before the file
+ * descriptor is closed.
+ */
+void
+S9sEventLoop::unwatch(
+        int fd)
+{
+    if (!m_watchers.contains(fd))
+        return;
+
+    #ifdef __linux__
+    if (m_epollFd >= 0)
+    {
+        struct epoll_event event;
+
+        event.events  = 0u;
+        event.data.fd = fd;
+        epoll_ctl(m_epollFd, EPOLL_CTL_DEL, fd, &event);
+    }
+    #endif
+
+    m_watchers.erase(fd);
+}
+
+/**
+ * \returns true if there is no file descriptor to watch.
+ */
+bool
+S9sEventLoop::isEmpty() const
+{
+    return m_watchers.empty();
+}
+
+/**
+ * \param timeoutMs How long to wait for the events in milliseconds.
+ * \returns The number of the callbacks called, 0 on timeout and -1 on
+ *   error.
+ *
+ * Waits until at least one of the watched file descriptors is ready and calls
+ * the callbacks of the ready file descriptors. The callbacks may watch,
+ * modify or unwatch file descriptors.
+ */
+int
+S9sEventLoop::runOnce(
+        int timeoutMs)
+{
+    S9sVector<int>  readyFds;
+    S9sVector<int>  readyEvents;
+    S9sVector<uint> readySerials;
+    int             nReady;
+
+    if (m_watchers.empty())
+        return 0;
+
+    #ifdef __linux__
+    if (m_epollFd >= 0)
+    {
+        struct epoll_event events[MAX_EVENTS];
+
+        do {
+            nReady = epoll_wait(m_epollFd, events, MAX_EVENTS, timeoutMs);
+        } while (nReady < 0 && errno == EINTR);
+
+        for (int idx = 0; idx < nReady; ++idx)
+        {
+            int fd = events[idx].data.fd;
+
+            if (!m_watchers.contains(fd))
+                continue;
+
+            readyFds     << fd;
+            readyEvents  << fromEpollEvents(events[idx].events);
+            readySerials << m_watchers[fd].serial;
+        }
+    } else
+    #endif
+    {
+        S9sVector<struct pollfd>       pollFds;
+        S9sMap<int, Watcher>::iterator it;
+
+        for (it = m_watchers.begin(); it != m_watchers.end(); ++it)
+        {
+            struct pollfd pollFd;
+
+            pollFd.fd      = it->first;
+            pollFd.events  = it->second.events;
+            pollFd.revents = 0;
+
+            pollFds << pollFd;
+        }
+
+        do {
+            nReady = ::poll(&pollFds[0], pollFds.size(), timeoutMs);
+        } while (nReady < 0 && errno == EINTR);
+
+        for (uint idx = 0u; nReady > 0 && idx < pollFds.size(); ++idx)
+        {
+            if (pollFds[idx].revents == 0)
+                continue;
+
+            readyFds     << pollFds[idx].fd;
+            readyEvents  << pollFds[idx].revents;
+            readySerials << m_watchers[pollFds[idx].fd].serial;
+        }
+    }
+
+    if (nReady < 0)
+    {
+        S9S_WARNING("Waiting for events: %m");
+        return -1;
+    }
+
+    /*
+     * Calling the callbacks. A callback might unwatch other file descriptors,
+     * so we check every one of them before calling. If a callback closed a
+     * file descriptor and watched a new one that got the same number the
+     * serial tells them apart, the events belong to the closed one.
+     */
+    nReady = 0;
+    for (uint idx = 0u; idx < readyFds.size(); ++idx)
+    {
+        Watcher watcher;
+
+        if (!m_watchers.contains(readyFds[idx]) ||
+                m_watchers[readyFds[idx]].serial != readySerials[idx])
+        {
+            continue;
+        }
+
+        watcher = m_watchers[readyFds[idx]];
+        watcher.callback(readyFds[idx], readyEvents[idx], watcher.userData);
+        ++nReady;
+    }
+
+    return nReady;
+}
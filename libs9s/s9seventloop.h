@@ -0,0 +1,65 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2018  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "S9sMap"
+
+/**
+ * The callback the event loop calls when a watched file descriptor is ready.
+ * The events are the poll() events (POLLIN, POLLOUT, POLLERR, POLLHUP).
+ */
+typedef void (*S9sEventCallback)(int fd, int events, void *userData);
+
+/**
+ * A simple event loop that watches any number of non-blocking file
+ * descriptors and calls a callback when they are ready for reading or
+ * writing. Uses epoll on Linux and poll() everywhere else.
+ */
+class S9sEventLoop
+{
+    public:
+        S9sEventLoop();
+        virtual ~S9sEventLoop();
+
+        bool watch(
+                int               fd, 
+                int               events,
+                S9sEventCallback  callback,
+                void             *userData);
+
+        bool modify(int fd, int events);
+        void unwatch(int fd);
+
+        bool isEmpty() const;
+        int runOnce(int timeoutMs);
+
+    private:
+        struct Watcher
+        {
+            int               events;
+            S9sEventCallback  callback;
+            void             *userData;
+            uint              serial;
+        };
+
+        S9sMap<int, Watcher>  m_watchers;
+        int                   m_epollFd;
+        uint                  m_nextSerial;
+};
@@ -0,0 +1,377 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2018  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+
+#include "S9sVector"
+
+/**
+ * The maps with at most this many elements are searched by comparing the keys
+ * for equality one by one, which is faster for the small maps than the binary
+ * search, especially if the keys can be compared cheaply for equality.
+ */
+#define S9S_FLATMAP_LINEAR_SEARCH 16
+
+/**
+ * An ordered map that stores its elements in one sorted vector. It has the
+ * interface of the std::map, but the elements are next to each other in the
+ * memory, so the lookups and the iteration are fast for the maps with a few
+ * dozen elements (like the objects of the controller replies).
+ *
+ * Unlike with the std::map the insertion and the removal of an element moves
+ * the elements after it, so the iterators and the references to the elements
+ * are invalidated when the map is changed.
+ */
+template <
+    typename Key, 
+    typename T, 
+    typename Allocator = std::allocator<std::pair<Key, T> > >
+class S9sFlatMap
+{
+    public:
+        typedef Key                                     key_type;
+        typedef T                                       mapped_type;
+        typedef std::pair<Key, T>                       value_type;
+        typedef Allocator                               allocator_type;
+        typedef std::vector<value_type, Allocator>      container_type;
+        typedef typename container_type::size_type      size_type;
+        typedef typename container_type::iterator       iterator;
+        typedef typename container_type::const_iterator const_iterator;
+
+        S9sFlatMap() {};
+        explicit S9sFlatMap(const Allocator &allocator) :
+            m_elements(allocator) {};
+
+        iterator begin() { return m_elements.begin(); };
+        iterator end() { return m_elements.end(); };
+        const_iterator begin() const { return m_elements.begin(); };
+        const_iterator end() const { return m_elements.end(); };
+
+        size_type size() const { return m_elements.size(); };
+        bool empty() const { return m_elements.empty(); };
+        void clear() { m_elements.clear(); };
+        void reserve(size_type n) { m_elements.reserve(n); };
+        allocator_type get_allocator() const 
+            { return m_elements.get_allocator(); };
+
+        void swap(S9sFlatMap<Key, T, Allocator> &other);
+
+        iterator lower_bound(const Key &key);
+        const_iterator lower_bound(const Key &key) const;
+        iterator find(const Key &key);
+        const_iterator find(const Key &key) const;
+        size_type count(const Key &key) const;
+        bool contains(const Key &key) const;
+
+        T &at(const Key &key);
+        const T &at(const Key &key) const;
+        T &operator[](const Key &key);
+
+        std::pair<iterator, bool> insert(const value_type &value);
+        iterator insert(iterator hint, const value_type &value);
+        iterator insert(iterator hint, value_type &&value);
+
+        iterator erase(iterator position);
+        size_type erase(const Key &key);
+
+        S9sVector<Key> keys() const;
+
+        bool operator==(const S9sFlatMap<Key, T, Allocator> &rhs) const;
+        bool operator!=(const S9sFlatMap<Key, T, Allocator> &rhs) const;
+
+    private:
+        struct LessThanKey
+        {
+            bool operator()(const value_type &element, const Key &key) const
+                { return element.first < key; };
+        };
+
+    private:
+        container_type  m_elements;
+};
+
+template <typename Key, typename T, typename Allocator>
+inline void
+S9sFlatMap<Key, T, Allocator>::swap(
+        S9sFlatMap<Key, T, Allocator> &other)
+{
+    m_elements.swap(other.m_elements);
+}
+
+/**
+ * \returns The first element that is not less than the key.
+ */
+template <typename Key, typename T, typename Allocator>
+inline typename S9sFlatMap<Key, T, Allocator>::iterator
+S9sFlatMap<Key, T, Allocator>::lower_bound(
+        const Key &key)
+{
+    return std::lower_bound(
+            m_elements.begin(), m_elements.end(), key, LessThanKey());
+}
+
+template <typename Key, typename T, typename Allocator>
+inline typename S9sFlatMap<Key, T, Allocator>::const_iterator
+S9sFlatMap<Key, T, Allocator>::lower_bound(
+        const Key &key) const
+{
+    return std::lower_bound(
+            m_elements.begin(), m_elements.end(), key, LessThanKey());
+}
+
+template <typename Key, typename T, typename Allocator>
+inline typename S9sFlatMap<Key, T, Allocator>::iterator
+S9sFlatMap<Key, T, Allocator>::find(
+        const Key &key)
+{
+    iterator it;
+
+    if (m_elements.size() <= S9S_FLATMAP_LINEAR_SEARCH)
+    {
+        for (it = m_elements.begin(); it != m_elements.end(); ++it)
+        {
+            if (it->first == key)
+                break;
+        }
+
+        return it;
+    }
+
+    it = lower_bound(key);
+
+    if (it != m_elements.end() && !(key < it->first))
+        return it;
+
+    return m_elements.end();
+}
+
+template <typename Key, typename T, typename Allocator>
+inline typename S9sFlatMap<Key, T, Allocator>::const_iterator
+S9sFlatMap<Key, T, Allocator>::find(
+        const Key &key) const
+{
+    const_iterator it;
+
+    if (m_elements.size() <= S9S_FLATMAP_LINEAR_SEARCH)
+    {
+        for (it = m_elements.begin(); it != m_elements.end(); ++it)
+        {
+            if (it->first == key)
+                break;
+        }
+
+        return it;
+    }
+
+    it = lower_bound(key);
+
+    if (it != m_elements.end() && !(key < it->first))
+        return it;
+
+    return m_elements.end();
+}
+
+template <typename Key, typename T, typename Allocator>
+inline typename S9sFlatMap<Key, T, Allocator>::size_type
+S9sFlatMap<Key, T, Allocator>::count(
+        const Key &key) const
+{
+    return find(key) != m_elements.end() ? 1 : 0;
+}
+
+/**
+ * \returns true if the map contains an element with the given key.
+ */
+template <typename Key, typename T, typename Allocator>
+inline bool
+S9sFlatMap<Key, T, Allocator>::contains(
+        const Key &key) const
+{
+    return find(key) != m_elements.end();
+}
+
+/**
+ * \returns The value with the given key, throws std::out_of_range if there is
+ *   no such element.
+ */
+template <typename Key, typename T, typename Allocator>
+T &
+S9sFlatMap<Key, T, Allocator>::at(
+        const Key &key)
+{
+    iterator it = find(key);
+
+    if (it == m_elements.end())
+        throw std::out_of_range("S9sFlatMap::at");
+
+    return it->second;
+}
+
+template <typename Key, typename T, typename Allocator>
+const T &
+S9sFlatMap<Key, T, Allocator>::at(
+        const Key &key) const
+{
+    const_iterator it = find(key);
+
+    if (it == m_elements.end())
+        throw std::out_of_range("S9sFlatMap::at");
+
+    return it->second;
+}
+
+/**
+ * \returns The value with the given key, a default constructed value is
+ *   inserted if there is no such element.
+ */
+template <typename Key, typename T, typename Allocator>
+T &
+S9sFlatMap<Key, T, Allocator>::operator[](
+        const Key &key)
+{
+    iterator it = lower_bound(key);
+
+    if (it == m_elements.end() || key < it->first)
+        it = m_elements.insert(it, value_type(key, T()));
+
+    return it->second;
+}
+
+/**
+ * Inserts the element if the map has no element with the same key.
+ */
+template <typename Key, typename T, typename Allocator>
+std::pair<typename S9sFlatMap<Key, T, Allocator>::iterator, bool>
+S9sFlatMap<Key, T, Allocator>::insert(
+        const value_type &value)
+{
+    iterator it = lower_bound(value.first);
+
+    if (it != m_elements.end() && !(value.first < it->first))
+        return std::pair<iterator, bool>(it, false);
+
+    it = m_elements.insert(it, value);
+    return std::pair<iterator, bool>(it, true);
+}
+
+/**
+ * Inserts the element at the position of the hint if it is the right place,
+ * otherwise it is inserted where it belongs. The map is not changed if it has
+ * an element with the same key.
+ */
+template <typename Key, typename T, typename Allocator>
+typename S9sFlatMap<Key, T, Allocator>::iterator
+S9sFlatMap<Key, T, Allocator>::insert(
+        iterator          hint,
+        const value_type &value)
+{
+    return insert(hint, value_type(value));
+}
+
+template <typename Key, typename T, typename Allocator>
+typename S9sFlatMap<Key, T, Allocator>::iterator
+S9sFlatMap<Key, T, Allocator>::insert(
+        iterator     hint,
+        value_type &&value)
+{
+    bool afterPrevious = 
+        hint == m_elements.begin() || (hint - 1)->first < value.first;
+    bool beforeNext = 
+        hint == m_elements.end() || value.first < hint->first;
+
+    if (!afterPrevious || !beforeNext)
+    {
+        hint = lower_bound(value.first);
+        if (hint != m_elements.end() && !(value.first < hint->first))
+            return hint;
+    }
+
+    return m_elements.insert(hint, std::move(value));
+}
+
+template <typename Key, typename T, typename Allocator>
+inline typename S9sFlatMap<Key, T, Allocator>::iterator
+S9sFlatMap<Key, T, Allocator>::erase(
+        iterator position)
+{
+    return m_elements.erase(position);
+}
+
+template <typename Key, typename T, typename Allocator>
+typename S9sFlatMap<Key, T, Allocator>::size_type
+S9sFlatMap<Key, T, Allocator>::erase(
+        const Key &key)
+{
+    iterator it = find(key);
+
+    if (it == m_elements.end())
+        return 0;
+
+    m_elements.erase(it);
+    return 1;
+}
+
+/**
+ * \returns A list that holds all the keys from the map in order.
+ */
+template <typename Key, typename T, typename Allocator>
+S9sVector<Key>
+S9sFlatMap<Key, T, Allocator>::keys() const
+{
+    S9sVector<Key> retval;
+
+    retval.reserve(m_elements.size());
+    for (const_iterator it = m_elements.begin(); it != m_elements.end(); ++it)
+        retval.push_back(it->first);
+
+    return retval;
+}
+
+template <typename Key, typename T, typename Allocator>
+bool
+S9sFlatMap<Key, T, Allocator>::operator==(
+        const S9sFlatMap<Key, T, Allocator> &rhs) const
+{
+    if (m_elements.size() != rhs.m_elements.size())
+        return false;
+
+    for (size_type idx = 0; idx < m_elements.size(); ++idx)
+    {
+        if (!(m_elements[idx].first == rhs.m_elements[idx].first) ||
+                !(m_elements[idx].second == rhs.m_elements[idx].second))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template <typename Key, typename T, typename Allocator>
+inline bool
+S9sFlatMap<Key, T, Allocator>::operator!=(
+        const S9sFlatMap<Key, T, Allocator> &rhs) const
+{
+    return !operator==(rhs);
+}
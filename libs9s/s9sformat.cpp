@@ -21,6 +21,7 @@
 
 #include <stdio.h>
 #include "S9sOptions"
+#include "S9sOutput"
 
 //#define DEBUG
 //#define WARNING
@@ -155,17 +156,12 @@ void
 S9sFormat::printf(
         const int value) const
 {
-    S9sString formatString;
+    S9sString text;
 
-    if (m_width > 0)
-        formatString.sprintf("%%%dd", m_width);
-    else
-        formatString.sprintf("%%d", m_width);
+    text.sprintf(m_withFieldSeparator ? "%*d " : "%*d",
+            m_width > 0 ? m_width : 0, value);
 
-    if (m_withFieldSeparator)
-        formatString += " ";
-
-    ::printf(STR(formatString), value);
+    S9sOutput::write(text);
 }
 
 /**
@@ -175,73 +171,72 @@ void
 S9sFormat::printf(
         const ulonglong value) const
 {
-    S9sString formatString;
+    S9sString text;
 
-    if (m_width > 0)
-        formatString.sprintf("%%%dllu", m_width);
-    else
-        formatString.sprintf("%%llu", m_width);
-
-    if (m_withFieldSeparator)
-        formatString += " ";
+    text.sprintf(m_withFieldSeparator ? "%*llu " : "%*llu",
+            m_width > 0 ? m_width : 0, value);
 
-    ::printf(STR(formatString), value);
+    S9sOutput::write(text);
 }
 
 /**
  * Prints the value to the standard output, then prints the field separator.
+ * The color sequences, the padding, the value and the separator are collected
+ * and written into the output together.
  */
 void
 S9sFormat::printf(
         const S9sString &value,
         bool             color) const
 {
-    S9sString formatString;
-    S9sString myValue = value;
+    S9sString text;
+    int       padding = 0;
+
+    text.reserve(value.length() + (m_width > 0 ? m_width : 0) + 32);
+
+    if (color && m_colorStart != NULL)
+        text += m_colorStart;
+
+    if (m_width > (int) value.length())
+        padding = m_width - value.length();
 
-    if (m_width > 0)
+    switch (m_alignment)
     {
-        switch (m_alignment)
-        {
-            case AlignRight:
-                formatString.sprintf("%%%ds", m_width);
-                break;
-            
-            case AlignLeft:
-                formatString.sprintf("%%-%ds", m_width);
-                break;
-            
-            case AlignCenter:
-                {
-                    S9sString alignString;
-
-                    if (m_width > (int) value.terminalLength())
-                    {
-                        alignString = 
-                            S9sString(" ") * 
-                            ((m_width - value.terminalLength()) / 2);
-                    }
-               
-                    myValue = alignString + myValue;
-
-                    formatString.sprintf("%%-%ds", m_width);
-                }
-                break;
-        }
-    } else {
-        formatString = "%s";
+        case AlignRight:
+            text.append(padding, ' ');
+            text += value;
+            break;
+
+        case AlignLeft:
+            text += value;
+            text.append(padding, ' ');
+            break;
+
+        case AlignCenter:
+            {
+                int prefix = 0;
+
+                if (m_width > (int) value.terminalLength())
+                    prefix = (m_width - value.terminalLength()) / 2;
+
+                padding = m_width - prefix - (int) value.length();
+                if (padding < 0)
+                    padding = 0;
+
+                text.append(prefix, ' ');
+                text += value;
+                text.append(padding, ' ');
+            }
+            break;
     }
 
     if (m_withFieldSeparator)
-        formatString += " ";
-
-    if (color && m_colorStart != NULL)
-        ::printf("%s", m_colorStart);
-
-    ::printf(STR(formatString), STR(myValue));
+        text += " ";
 
     if (color && m_colorEnd != NULL)
-        ::printf("%s", m_colorEnd);
+        text += m_colorEnd;
+
+    S9sOutput::write(text);
 }
 
 /**
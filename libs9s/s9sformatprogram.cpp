@@ -0,0 +1,329 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2018  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "s9sformatprogram.h"
+
+#include <cstdio>
+#include <cstring>
+
+//#define DEBUG
+//#define WARNING
+#include "s9sdebug.h"
+
+S9sFormatOp::S9sFormatOp() :
+    m_directive('\0'),
+    m_modified(false),
+    m_simple(false),
+    m_leftAlign(false),
+    m_width(0),
+    m_precision(-1)
+{
+}
+
+/**
+ * Appends a string value formatted as "%s" with the flags of the directive
+ * would format it.
+ */
+void
+S9sFormatOp::appendString(
+        S9sString       &output,
+        const S9sString &value) const
+{
+    appendString(output, STR(value));
+}
+
+void
+S9sFormatOp::appendString(
+        S9sString  &output,
+        const char *value) const
+{
+    size_t length;
+    int    padding;
+
+    if (!m_simple)
+    {
+        appendFormatted(output, "s", value);
+        return;
+    }
+
+    // The width and the precision are counted in bytes just like printf()
+    // counts them.
+    if (m_precision >= 0)
+        length = strnlen(value, m_precision);
+    else
+        length = strlen(value);
+
+    padding = m_width - (int) length;
+
+    if (padding > 0 && !m_leftAlign)
+        output.append(padding, ' ');
+
+    output.append(value, length);
+
+    if (padding > 0 && m_leftAlign)
+        output.append(padding, ' ');
+}
+
+void
+S9sFormatOp::appendInt(
+        S9sString &output,
+        const int  value) const
+{
+    appendFormatted(output, "d", value);
+}
+
+void
+S9sFormatOp::appendULongLong(
+        S9sString       &output,
+        const ulonglong  value) const
+{
+    appendFormatted(output, "llu", value);
+}
+
+void
+S9sFormatOp::appendDouble(
+        S9sString    &output,
+        const double  value) const
+{
+    appendFormatted(output, "f", value);
+}
+
+/**
+ * Private method that formats the value with snprintf() using the flags of the
+ * directive and the given conversion. The values that do not fit the stack
+ * buffer are formatted by S9sString::sprintf(), so the result is the same as
+ * the result of the printf() the format string used to be passed to.
+ */
+void
+S9sFormatOp::appendFormatted(
+        S9sString  &output,
+        const char *conversion,
+        ...) const
+{
+    char     format[64];
+    char     buffer[256];
+    size_t   flagsLength = m_text.length();
+    size_t   conversionLength = strlen(conversion);
+    int      nPrinted = -1;
+    va_list  arguments;
+
+    if (flagsLength + conversionLength < sizeof(format))
+    {
+        memcpy(format, m_text.c_str(), flagsLength);
+        memcpy(format + flagsLength, conversion, conversionLength + 1);
+
+        va_start(arguments, conversion);
+        nPrinted = vsnprintf(buffer, sizeof(buffer), format, arguments);
+        va_end(arguments);
+    }
+
+    if (nPrinted >= 0 && nPrinted < (int) sizeof(buffer))
+    {
+        output.append(buffer, nPrinted);
+    } else {
+        S9sString longFormat = m_text + conversion;
+        S9sString tmp;
+
+        va_start(arguments, conversion);
+        tmp.vsprintf(STR(longFormat), arguments);
+        va_end(arguments);
+
+        output += tmp;
+    }
+}
+
+/**
+ * Private method that parses the flags of the directive. The directives that
+ * have only a '-' flag, a width and a precision are simple, the strings are
+ * formatted for them without calling snprintf().
+ */
+void
+S9sFormatOp::compile()
+{
+    const char *flags = STR(m_text);
+    int         index = 1;
+
+    m_simple    = false;
+    m_leftAlign = false;
+    m_width     = 0;
+    m_precision = -1;
+
+    if (flags[index] == '-')
+    {
+        m_leftAlign = true;
+        ++index;
+    }
+
+    if (flags[index] == '0')
+        return;
+
+    while (flags[index] >= '0' && flags[index] <= '9')
+    {
+        if (m_width > 9999)
+            return;
+
+        m_width = m_width * 10 + flags[index] - '0';
+        ++index;
+    }
+
+    if (flags[index] == '.')
+    {
+        ++index;
+        m_precision = 0;
+
+        while (flags[index] >= '0' && flags[index] <= '9')
+        {
+            if (m_precision > 9999)
+                return;
+
+            m_precision = m_precision * 10 + flags[index] - '0';
+            ++index;
+        }
+    }
+
+    m_simple = flags[index] == '\0';
+}
+
+S9sFormatProgram::S9sFormatProgram()
+{
+}
+
+/**
+ * \param formatString The format string to compile.
+ * \param modifier The character that modifies the directive it precedes or
+ *   '\0' if the directives have no modifier.
+ * \param apostropheFlag If the '\'' (thousands' grouping) is accepted as a
+ *   flag.
+ */
+S9sFormatProgram::S9sFormatProgram(
+        const S9sString &formatString,
+        const char       modifier,
+        const bool       apostropheFlag)
+{
+    S9sString  flags;
+    char       c;
+    bool       percent  = false;
+    bool       escaped  = false;
+    bool       modified = false;
+
+    for (uint n = 0; n < formatString.size(); ++n)
+    {
+        c = formatString[n];
+        
+        if (c == '%' && !percent)
+        {
+            percent = true;
+            flags   = "%";
+            continue;
+        } else if (percent && modifier != '\0' && c == modifier)
+        {
+            modified = true;
+            continue;
+        } else if (c == '\\' && !escaped)
+        {
+            escaped = true;
+            continue;
+        }
+
+        if (escaped)
+        {
+            switch (c)
+            {
+                case '\"':
+                case '\\':
+                    addLiteral(c);
+                    break;
+
+                case 'a':
+                    addLiteral('\a');
+                    break;
+
+                case 'b':
+                    addLiteral('\b');
+                    break;
+
+                case 'e':
+                    addLiteral('\027');
+                    break;
+
+                case 'n':
+                    addLiteral('\n');
+                    break;
+
+                case 'r':
+                    addLiteral('\r');
+                    break;
+
+                case 't':
+                    addLiteral('\t');
+                    break;
+            }
+        } else if (percent)
+        {
+            if (c == '%')
+            {
+                addLiteral('%');
+            } else if ((c >= '0' && c <= '9') || c == '-' || c == '+' ||
+                    c == '.' || (c == '\'' && apostropheFlag))
+            {
+                flags += c;
+                continue;
+            } else if (c != '\0')
+            {
+                addDirective(c, flags, modified);
+            }
+        } else {
+            addLiteral(c);
+        }
+
+        percent  = false;
+        escaped  = false;
+        modified = false;
+    }
+}
+
+/**
+ * Private method to add a literal character, the consecutive characters are
+ * stored in one operation.
+ */
+void
+S9sFormatProgram::addLiteral(
+        const char c)
+{
+    if (m_ops.empty() || !m_ops.back().isLiteral())
+        m_ops.push_back(S9sFormatOp());
+
+    m_ops.back().m_text += c;
+}
+
+void
+S9sFormatProgram::addDirective(
+        const char       directive,
+        const S9sString &flags,
+        const bool       modified)
+{
+    S9sFormatOp op;
+
+    op.m_text      = flags;
+    op.m_directive = directive;
+    op.m_modified  = modified;
+    op.compile();
+
+    m_ops.push_back(op);
+}
@@ -0,0 +1,100 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2018  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "S9sString"
+#include "S9sVector"
+
+/**
+ * One operation of a compiled format string: either a literal text or a
+ * directive with the printf() style flags, field width and precision that
+ * preceded the directive character.
+ */
+class S9sFormatOp
+{
+    public:
+        S9sFormatOp();
+
+        bool isLiteral() const { return m_directive == '\0'; };
+        const S9sString &literal() const { return m_text; };
+        char directive() const { return m_directive; };
+        bool isModified() const { return m_modified; };
+
+        void appendString(S9sString &output, const S9sString &value) const;
+        void appendString(S9sString &output, const char *value) const;
+        void appendInt(S9sString &output, const int value) const;
+        void appendULongLong(S9sString &output, const ulonglong value) const;
+        void appendDouble(S9sString &output, const double value) const;
+
+    private:
+        void appendFormatted(
+                S9sString  &output,
+                const char *conversion,
+                ...) const;
+
+        void compile();
+
+    private:
+        S9sString  m_text;
+        char       m_directive;
+        bool       m_modified;
+        bool       m_simple;
+        bool       m_leftAlign;
+        int        m_width;
+        int        m_precision;
+
+        friend class S9sFormatProgram;
+};
+
+/**
+ * A format string of the --node-format, --log-format and similar options
+ * compiled into a list of operations, so that the format string is parsed
+ * only once and not for every printed object.
+ *
+ * The compiler follows the syntax the toString() methods always accepted: a
+ * directive is a '%' followed by flags ("0-9", '-', '+', '.' and optionally
+ * '\'') and a directive character, backslash escapes are resolved into the
+ * literal text. The objects that have a modifier character (e.g. "%fm" for
+ * the free memory) pass it to the constructor.
+ */
+class S9sFormatProgram
+{
+    public:
+        S9sFormatProgram();
+
+        S9sFormatProgram(
+                const S9sString &formatString,
+                const char       modifier       = '\0',
+                const bool       apostropheFlag = true);
+
+        uint size() const { return m_ops.size(); };
+        const S9sFormatOp &at(const uint index) const { return m_ops[index]; };
+
+    private:
+        void addLiteral(const char c);
+
+        void addDirective(
+                const char       directive,
+                const S9sString &flags,
+                const bool       modified);
+
+    private:
+        S9sVector<S9sFormatOp> m_ops;
+};
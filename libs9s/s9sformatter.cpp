@@ -4,6 +4,7 @@
 #include "s9sformatter.h"
 
 #include "S9sOptions"
+#include "S9sOutput"
 #include "S9sFormat"
 #include "S9sObject"
 #include "S9sUser"
@@ -495,9 +496,9 @@ S9sFormatter::printObjectStat(
     //
     printf("%s    Name:%s ", greyBegin, greyEnd);
     // FIXME: the color should depend on the class
-    printf("%s", objectColorBegin(object));
+    S9sOutput::write(objectColorBegin(object));
     printf("%-32s ", STR(object.name()));
-    printf("%s", objectColorEnd());
+    S9sOutput::write(objectColorEnd());
     
     printf("\n");
    
@@ -505,9 +506,9 @@ S9sFormatter::printObjectStat(
     // "CDT path: /ft_ndb_6776"
     //
     printf("%sCDT path:%s ", greyBegin, greyEnd);
-    printf("%s", folderColorBegin());
+    S9sOutput::write(folderColorBegin());
     printf("%-32s ", STR(object.cdtPath()));
-    printf("%s", folderColorEnd());
+    S9sOutput::write(folderColorEnd());
     printf("\n");
     
     //
@@ -669,7 +670,7 @@ S9sFormatter::printNodeStat(
     ::printf("%s      IP:%s ", greyBegin, greyEnd);
     ::printf("%s", ipColorBegin(node.ipAddress()));
     ::printf("%-27s ", STR(node.ipAddress()));
-    ::printf("%s", ipColorEnd());
+    S9sOutput::write(ipColorEnd());
     //printf("\n");
     
     printf("          %sPort:%s ", greyBegin, greyEnd);
@@ -713,7 +714,7 @@ S9sFormatter::printNodeStat(
     ::printf("%s  Status:%s ", greyBegin, greyEnd);
     ::printf("%s", hostStateColorBegin(node.hostStatus()));
     ::printf("%-35s", STR(node.hostStatus()));
-    ::printf("%s", hostStateColorEnd());
+    S9sOutput::write(hostStateColorEnd());
     
     printf("   %sRole:%s ", greyBegin, greyEnd);
     printf("%s", STR(node.role()));
@@ -1196,9 +1197,9 @@ S9sFormatter::printContainerStat(
     // "  Server: core1                                State: RUNNING"
     //
     printf("%s  Server:%s ", greyBegin, greyEnd);
-    printf("%s", serverColorBegin());
+    S9sOutput::write(serverColorBegin());
     printf("%-33s ", STR(container.parentServerName()));
-    printf("%s", serverColorEnd());
+    S9sOutput::write(serverColorEnd());
     
     printf("%s   State:%s ", greyBegin, greyEnd);
     printf("%s%s%s ", 
@@ -1370,13 +1371,13 @@ S9sFormatter::printBackendServersSubList(
 
         printf("\n");
         
-        printf("%s", headerColorBegin());
+        S9sOutput::write(headerColorBegin());
         printf("%s", STR(indent));
         hostNameFormat.printf("NAME", false);
         portFormat.printf("PORT", false);
         statusFormat.printf("STATUS", false);
         commentFormat.printf("COMMENT", false);
-        printf("%s", headerColorEnd());
+        S9sOutput::write(headerColorEnd());
         printf("\n");
 
         for (uint idx = 0u; idx < node.numberOfBackendServers(); ++idx)
@@ -1447,7 +1448,7 @@ S9sFormatter::printContainersCompact(
     ipFormat.widen("IP ADDRESS");
     aliasFormat.widen("NAME");
 
-    printf("%s", headerColorBegin());
+    S9sOutput::write(headerColorBegin());
     printf("%s", STR(indent));
     printf("S ");
     providerFormat.printf("CLOUD", false);
@@ -1455,7 +1456,7 @@ S9sFormatter::printContainersCompact(
     groupFormat.printf("GROUP", false);
     ipFormat.printf("IP ADDRESS", false);
     aliasFormat.printf("NAME", false);
-    printf("%s", headerColorEnd());
+    S9sOutput::write(headerColorEnd());
     printf("\n");
 
 
@@ -1478,7 +1479,7 @@ S9sFormatter::printContainersCompact(
 
         ::printf("%s", containerColorBegin(container.stateAsChar()));
         aliasFormat.printf(alias);
-        ::printf("%s", containerColorEnd());
+        S9sOutput::write(containerColorEnd());
 
         printf("\n");
     }
@@ -1557,7 +1558,7 @@ S9sFormatter::printHostTable(
 
     hostNameFormat.widen("HOSTNAME");
 
-    printf("%s", headerColorBegin());
+    S9sOutput::write(headerColorBegin());
     printf("%s", STR(indent));
 
     hostNameFormat.printf("HOSTNAME");
@@ -1582,7 +1583,7 @@ S9sFormatter::printHostTable(
     labelFormat.setCenterJustify();
     labelFormat.printf("NICs"); 
 
-    printf("%s", headerColorEnd());
+    S9sOutput::write(headerColorEnd());
     printf("\n");
 
         
@@ -0,0 +1,178 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2018  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "s9sinflater.h"
+
+#include <cstring>
+
+//#define DEBUG
+//#define WARNING
+#include "s9sdebug.h"
+
+/**
+ * \param data The compressed data, it is not copied, it has to be valid while
+ *   the object is used.
+ * \param length The length of the compressed data.
+ * \param maxSize The maximum size of the decompressed data, decompressing
+ *   more is an error.
+ */
+S9sInflater::S9sInflater(
+        const char *data, 
+        size_t      length,
+        size_t      maxSize) :
+    m_data(data),
+    m_length(length),
+    m_maxSize(maxSize),
+    m_initialized(false),
+    m_raw(false),
+    m_finished(false)
+{
+    init(false);
+}
+
+S9sInflater::~S9sInflater()
+{
+    if (m_initialized)
+        inflateEnd(&m_stream);
+}
+
+/**
+ * \param raw If the data is a raw deflate stream without the zlib header.
+ *
+ * Initializes the decompression from the beginning of the data. When not
+ * raw the gzip and the zlib headers are both detected automatically.
+ */
+bool
+S9sInflater::init(
+        bool raw)
+{
+    int retval;
+
+    if (m_initialized)
+        inflateEnd(&m_stream);
+
+    memset(&m_stream, 0, sizeof(m_stream));
+    m_stream.next_in  = (Bytef *) m_data;
+    m_stream.avail_in = m_length;
+
+    retval        = inflateInit2(&m_stream, raw ? -MAX_WBITS : MAX_WBITS + 32);
+    m_initialized = retval == Z_OK;
+    m_raw         = raw;
+
+    if (!m_initialized)
+        m_errorString.sprintf("Error initializing decompression (%d).", retval);
+
+    return m_initialized;
+}
+
+/**
+ * \param buffer The buffer where the decompressed data is placed.
+ * \param maxSize The size of the buffer.
+ * \returns The number of bytes placed in the buffer, 0 at the end of the data
+ *   or on error.
+ */
+int
+S9sInflater::read(
+        char *buffer, 
+        int   maxSize)
+{
+    if (!m_initialized || m_finished || maxSize <= 0)
+        return 0;
+
+    m_stream.next_out  = (Bytef *) buffer;
+    m_stream.avail_out = maxSize;
+
+    while (m_stream.avail_out == (uInt) maxSize)
+    {
+        int retval = inflate(&m_stream, Z_NO_FLUSH);
+
+        if (retval == Z_STREAM_END)
+        {
+            m_finished = true;
+            break;
+        } else if (retval == Z_DATA_ERROR && !m_raw && m_stream.total_out == 0)
+        {
+            // Some servers send "deflate" without the zlib header.
+            S9S_DEBUG("Trying raw deflate.");
+            if (!init(true))
+                return 0;
+
+            m_stream.next_out  = (Bytef *) buffer;
+            m_stream.avail_out = maxSize;
+            continue;
+        } else if (retval == Z_BUF_ERROR && m_stream.avail_in == 0)
+        {
+            m_errorString = "The compressed data is truncated.";
+            m_finished    = true;
+            return 0;
+        } else if (retval != Z_OK)
+        {
+            m_errorString.sprintf(
+                    "Error decompressing data: %s.", 
+                    m_stream.msg ? m_stream.msg : "unknown error");
+
+            m_finished = true;
+            return 0;
+        }
+    }
+
+    if (m_stream.total_out > m_maxSize)
+    {
+        m_errorString.sprintf(
+                "The decompressed data is larger than %zu bytes.", m_maxSize);
+
+        m_finished = true;
+        return 0;
+    }
+
+    return maxSize - m_stream.avail_out;
+}
+
+/**
+ * \returns true if the data could not be decompressed.
+ */
+bool
+S9sInflater::hasError() const
+{
+    return !m_errorString.empty();
+}
+
+/**
+ * \returns The human readable description of the error.
+ */
+S9sString
+S9sInflater::errorString() const
+{
+    return m_errorString;
+}
+
+/**
+ * A reader function that can be passed to the parsers (see S9sParseReader) to
+ * parse the data while it is decompressed.
+ */
+int
+S9sInflater::reader(
+        char *buffer, 
+        int   maxSize, 
+        void *userData)
+{
+    S9sInflater *inflater = (S9sInflater *) userData;
+
+    return inflater->read(buffer, maxSize);
+}
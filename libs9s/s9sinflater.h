@@ -0,0 +1,66 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2018  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "S9sString"
+
+#include <zlib.h>
+
+/**
+ * The default limit of the decompressed data, a small compressed input could
+ * otherwise expand into gigabytes.
+ */
+#define S9S_INFLATER_MAX_SIZE ((size_t) 1024 * 1024 * 1024)
+
+/**
+ * A class to decompress gzip or deflate compressed data (e.g. an HTTP reply
+ * with a "Content-Encoding: gzip" header) in chunks, so that the consumer
+ * can process the data while it is decompressed, without decompressing the
+ * whole data into the memory first.
+ */
+class S9sInflater
+{
+    public:
+        S9sInflater(
+                const char *data, 
+                size_t      length,
+                size_t      maxSize = S9S_INFLATER_MAX_SIZE);
+
+        virtual ~S9sInflater();
+
+        int read(char *buffer, int maxSize);
+        bool hasError() const;
+        S9sString errorString() const;
+
+        static int reader(char *buffer, int maxSize, void *userData);
+
+    private:
+        bool init(bool raw);
+
+    private:
+        const char   *m_data;
+        size_t        m_length;
+        size_t        m_maxSize;
+        z_stream      m_stream;
+        bool          m_initialized;
+        bool          m_raw;
+        bool          m_finished;
+        S9sString     m_errorString;
+};
@@ -0,0 +1,407 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2018  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "s9sjsondocument.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#include "S9sVariantMap"
+#include "S9sVariantList"
+#include "S9sJsonParser"
+
+//#define DEBUG
+//#define WARNING
+#include "s9sdebug.h"
+
+/**
+ * The maximum nesting level of the maps and lists, the same the parser
+ * accepts.
+ */
+#define JSON_MAX_DEPTH      1000
+
+/**
+ * The characters the index is built from, everything else is skipped.
+ */
+#define JSON_STRUCTURAL     "{}[]\"'/"
+
+/**
+ * \param arena The arena where the values of the document are allocated or
+ *   NULL to allocate them on the heap. The document holds a reference to it.
+ */
+S9sJsonDocument::S9sJsonDocument(
+        S9sArena *arena) :
+    m_buffer(NULL),
+    m_text(""),
+    m_length(0),
+    m_arena(arena),
+    m_referenceCounter(1)
+{
+    if (m_arena != NULL)
+        m_arena->ref();
+}
+
+S9sJsonDocument::~S9sJsonDocument()
+{
+    free(m_buffer);
+
+    if (m_arena != NULL)
+        m_arena->unRef();
+}
+
+void
+S9sJsonDocument::ref()
+{
+    __sync_add_and_fetch(&m_referenceCounter, 1);
+}
+
+/**
+ * Releases a reference, the document is destroyed when the last one is gone.
+ */
+void
+S9sJsonDocument::unRef()
+{
+    if (__sync_sub_and_fetch(&m_referenceCounter, 1) == 0)
+        delete this;
+}
+
+void
+S9sJsonDocument::lock()
+{
+    m_mutex.lock();
+}
+
+void
+S9sJsonDocument::unlock()
+{
+    m_mutex.unlock();
+}
+
+/**
+ * \param text The JSON string, it is copied into the document.
+ * \param length The length of the JSON string in bytes.
+ * \returns true if the structure of the string is valid.
+ */
+bool
+S9sJsonDocument::setText(
+        const char *text,
+        size_t      length)
+{
+    char *buffer = (char *) malloc(length + 1);
+
+    if (buffer == NULL)
+        return setError("Failed to allocate memory for the JSON string.");
+
+    memcpy(buffer, text, length);
+    if (!adoptText(buffer, 0, length))
+    {
+        free(buffer);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * \param buffer The buffer the JSON string is in, allocated by malloc(). It
+ *   must have room for a null byte after the string.
+ * \param offset The offset of the JSON string in the buffer.
+ * \param length The length of the JSON string in bytes.
+ * \returns true if the structure of the string is valid.
+ *
+ * The document takes the ownership of the buffer if the structure is valid,
+ * otherwise the buffer is left to the caller. This is how the network buffer
+ * the reply was received in becomes the text of the document without copying.
+ */
+bool
+S9sJsonDocument::adoptText(
+        char   *buffer,
+        size_t  offset,
+        size_t  length)
+{
+    free(m_buffer);
+
+    buffer[offset + length] = '\0';
+    m_buffer = buffer;
+    m_text   = buffer + offset;
+    m_length = length;
+
+    if (!buildIndex())
+    {
+        m_buffer = NULL;
+        m_text   = "";
+        m_length = 0;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * \returns The buffer the document was holding, the caller has to free() it.
+ *
+ * Gives up the ownership of the text, the document must not be loaded after
+ * this.
+ */
+char *
+S9sJsonDocument::releaseText()
+{
+    char *retval = m_buffer;
+
+    m_buffer = NULL;
+    m_text   = "";
+    m_length = 0;
+    m_elements.clear();
+
+    return retval;
+}
+
+/**
+ * \returns The JSON string of the document.
+ */
+const char *
+S9sJsonDocument::text() const
+{
+    return m_text;
+}
+
+/**
+ * \returns The length of the JSON string in bytes.
+ */
+size_t
+S9sJsonDocument::length() const
+{
+    return m_length;
+}
+
+/**
+ * \returns The number of maps and lists in the document.
+ */
+size_t
+S9sJsonDocument::nElements() const
+{
+    return m_elements.size();
+}
+
+/**
+ * \returns The description of the last error: the structure of the string was
+ *   invalid or a value could not be loaded.
+ */
+S9sString
+S9sJsonDocument::errorString() const
+{
+    return m_errorString;
+}
+
+/**
+ * Loads the map with the given index, called by the map when it is first
+ * accessed. The maps and the lists in the map are not loaded, they are loaded
+ * when they are accessed.
+ *
+ * The whole text is checked when the index is built, so the map can be
+ * loaded. If it still can not be parsed it is loaded empty.
+ */
+void
+S9sJsonDocument::load(
+        unsigned int   index,
+        S9sVariantMap &value)
+{
+    S9sJsonParser parser(m_text, m_length);
+
+    parser.setArena(m_arena);
+    if (!parser.load(this, index, value))
+    {
+        m_errorString = parser.errorString();
+        S9S_WARNING("%s", STR(m_errorString));
+        value.clear();
+    }
+}
+
+/**
+ * Loads the list with the given index, the same way the maps are loaded.
+ */
+void
+S9sJsonDocument::load(
+        unsigned int    index,
+        S9sVariantList &value)
+{
+    S9sJsonParser parser(m_text, m_length);
+
+    parser.setArena(m_arena);
+    if (!parser.load(this, index, value))
+    {
+        m_errorString = parser.errorString();
+        S9S_WARNING("%s", STR(m_errorString));
+        value.clear();
+    }
+}
+
+/**
+ * Private method to build the index of the maps and the lists in one pass over
+ * the text. The strings and the comments are skipped, so only the brackets
+ * that are part of the structure are found, and the brackets are checked to
+ * be balanced. Then the syntax of the whole text is checked without creating
+ * the values, the errors are found here and not when the values are loaded.
+ */
+bool
+S9sJsonDocument::buildIndex()
+{
+    const char            *begin = m_text;
+    const char            *end   = begin + m_length;
+    const char            *position = begin;
+    const char            *found;
+    std::vector<uint32_t>  open;
+    Element                element;
+    char                   c;
+
+    m_elements.clear();
+    m_errorString.clear();
+
+    if (m_length >= UINT32_MAX)
+        return setError("The JSON string is too long.");
+
+    while (position < end)
+    {
+        // The string is null terminated, the null bytes in it are skipped.
+        position += strcspn(position, JSON_STRUCTURAL);
+        if (position >= end)
+            break;
+
+        c = *position;
+        switch (c)
+        {
+            case '\0':
+                ++position;
+                break;
+
+            case '{':
+            case '[':
+                if (open.size() >= JSON_MAX_DEPTH)
+                {
+                    return setError("The JSON string is nested too deep.");
+                }
+
+                element.begin = position - begin;
+                element.end   = 0;
+                element.next  = 0;
+                open.push_back(m_elements.size());
+                m_elements.push_back(element);
+                ++position;
+                break;
+
+            case '}':
+            case ']':
+                if (open.empty() || 
+                        begin[m_elements[open.back()].begin] != 
+                        (c == '}' ? '{' : '['))
+                {
+                    m_errorString.sprintf(
+                            "Unexpected character '%c' at offset %lu.",
+                            c, (unsigned long) (position - begin));
+
+                    m_elements.clear();
+                    return false;
+                }
+
+                ++position;
+                m_elements[open.back()].end  = position - begin;
+                m_elements[open.back()].next = m_elements.size();
+                open.pop_back();
+                break;
+
+            case '"':
+            case '\'':
+                // The quote is escaped by an odd number of backslashes.
+                found = position;
+                for (;;)
+                {
+                    const char *backslash;
+
+                    found = (const char *) 
+                        memchr(found + 1, c, end - found - 1);
+
+                    if (found == NULL)
+                        return setError("The string is not terminated.");
+
+                    for (backslash = found; 
+                            backslash - 1 > position && backslash[-1] == '\\';
+                            --backslash)
+                        ;
+
+                    if ((found - backslash) % 2 == 0)
+                        break;
+                }
+
+                position = found + 1;
+                break;
+
+            case '/':
+                if (position + 1 < end && position[1] == '/')
+                {
+                    found = (const char *) 
+                        memchr(position, '\n', end - position);
+
+                    position = found != NULL ? found + 1 : end;
+                } else if (position + 1 < end && position[1] == '*')
+                {
+                    // A comment that is not closed is accepted.
+                    found = (const char *) 
+                        memmem(position + 2, end - position - 2, "*/", 2);
+
+                    position = found != NULL ? found + 2 : end;
+                } else {
+                    ++position;
+                }
+
+                break;
+        }
+    }
+
+    if (!open.empty())
+        return setError("Unexpected end of the JSON string.");
+
+    // The syntax is checked too, the values are loaded later without errors.
+    {
+        S9sJsonParser parser(m_text, m_length);
+
+        if (!parser.validate())
+        {
+            m_errorString = parser.errorString();
+            m_elements.clear();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Private method to set the error string of an invalid structure, always
+ * returns false.
+ */
+bool
+S9sJsonDocument::setError(
+        const char *message)
+{
+    m_errorString = message;
+    m_elements.clear();
+    S9S_DEBUG("%s", message);
+
+    return false;
+}
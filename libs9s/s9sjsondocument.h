@@ -0,0 +1,106 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2018  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+
+#include "S9sString"
+#include "S9sMutex"
+#include "S9sArena"
+#include "s9ssharedvalue.h"
+
+/**
+ * The text of a lazily parsed JSON document together with its structural
+ * index (the tape): the position of every map and list in the text. The parser
+ * creates the maps and the lists of the document empty and they are parsed
+ * from the text only when they are first accessed, so the parts of a large
+ * reply nobody reads are never built.
+ *
+ * The document is reference counted, it is kept alive by the values that are
+ * not loaded yet. The values are loaded while the document is locked, so they
+ * can be loaded from different threads, the values are allocated in the arena
+ * of the document.
+ */
+class S9sJsonDocument : public S9sValueLoader
+{
+    public:
+        /**
+         * One map or list of the document in the order they start in the
+         * text.
+         */
+        struct Element
+        {
+            /** The offset of the opening bracket. */
+            uint32_t begin;
+            /** The offset after the closing bracket. */
+            uint32_t end;
+            /** The index of the first element after this one and its children. */
+            uint32_t next;
+        };
+
+        S9sJsonDocument(S9sArena *arena);
+
+        bool setText(const char *text, size_t length);
+        bool adoptText(char *buffer, size_t offset, size_t length);
+        char *releaseText();
+
+        const char *text() const;
+        size_t length() const;
+        const Element &element(unsigned int index) const;
+        size_t nElements() const;
+        S9sString errorString() const;
+
+        virtual void ref();
+        virtual void unRef();
+        virtual void lock();
+        virtual void unlock();
+
+        virtual void load(unsigned int index, S9sVariantMap &value);
+        virtual void load(unsigned int index, S9sVariantList &value);
+
+    private:
+        virtual ~S9sJsonDocument();
+        S9sJsonDocument(const S9sJsonDocument &orig);
+        S9sJsonDocument &operator=(const S9sJsonDocument &rhs);
+
+        bool buildIndex();
+        bool setError(const char *message);
+
+    private:
+        char                 *m_buffer;
+        const char           *m_text;
+        size_t                m_length;
+        std::vector<Element>  m_elements;
+        S9sArena             *m_arena;
+        S9sMutex              m_mutex;
+        S9sString             m_errorString;
+        volatile int          m_referenceCounter;
+};
+
+/**
+ * \returns The element with the given index.
+ */
+inline const S9sJsonDocument::Element &
+S9sJsonDocument::element(
+        unsigned int index) const
+{
+    return m_elements[index];
+}
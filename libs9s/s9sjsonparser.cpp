@@ -0,0 +1,1409 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2018  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "s9sjsonparser.h"
+#include "s9sjsondocument.h"
+
+#include <cmath>
+#include <climits>
+#include <clocale>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+#include <strings.h>
+
+//#define DEBUG
+//#define WARNING
+#include "s9sdebug.h"
+
+/**
+ * The size of the buffer where the data produced by the reader function is
+ * parsed.
+ */
+#define JSON_BUFFER_SIZE    (64 * 1024)
+
+/**
+ * The maximum nesting level of the maps and lists, so that an invalid input can
+ * not exhaust the stack.
+ */
+#define JSON_MAX_DEPTH      1000
+
+/**
+ * The maximum length of a number in characters.
+ */
+#define JSON_MAX_NUMBER     128
+
+/**
+ * \param input The JSON string, it is not copied, it has to be valid while the
+ *   parser is used. It does not need to be null terminated.
+ * \param length The length of the JSON string in bytes.
+ */
+S9sJsonParser::S9sJsonParser(
+        const char *input,
+        size_t      length) :
+    m_reader(NULL),
+    m_readerData(NULL),
+    m_buffer(NULL),
+    m_begin(input),
+    m_position(input),
+    m_end(input + length),
+    m_offset(0),
+    m_depth(0),
+    m_arena(NULL),
+    m_lazy(false),
+    m_document(NULL),
+    m_element(0),
+    m_adopted(NULL)
+{
+}
+
+/**
+ * \param reader The function the parser calls to read the JSON string in
+ *   chunks.
+ * \param userData The pointer passed to the reader function.
+ */
+S9sJsonParser::S9sJsonParser(
+        S9sParseReader  reader,
+        void           *userData) :
+    m_reader(reader),
+    m_readerData(userData),
+    m_buffer(new char[JSON_BUFFER_SIZE]),
+    m_begin(m_buffer),
+    m_position(m_buffer),
+    m_end(m_buffer),
+    m_offset(0),
+    m_depth(0),
+    m_arena(NULL),
+    m_lazy(false),
+    m_document(NULL),
+    m_element(0),
+    m_adopted(NULL)
+{
+}
+
+S9sJsonParser::~S9sJsonParser()
+{
+    delete[] m_buffer;
+}
+
+/**
+ * \param values The map where the parsed values are placed.
+ * \returns true if and only if the string was successfully parsed.
+ *
+ * Parses the JSON string that must be one object (a map). If the string can
+ * not be parsed the map is not changed and the reason is available through
+ * errorString().
+ */
+bool
+S9sJsonParser::parse(
+        S9sVariantMap &values)
+{
+    if (m_lazy)
+        return parseDocument(values);
+
+    return parseRoot(values);
+}
+
+/**
+ * \param document The document that holds the map.
+ * \param index The index of the map in the document.
+ * \param value The map where the parsed values are placed, the maps and lists
+ *   in it are loaded lazily from the same document.
+ * \returns true if the map was successfully parsed.
+ *
+ * This is how the document loads its maps, the parser must be created for the
+ * text of the document.
+ */
+bool
+S9sJsonParser::load(
+        S9sJsonDocument *document,
+        unsigned int     index,
+        S9sVariantMap   &value)
+{
+    m_errorString.clear();
+    m_depth      = 0;
+    m_document   = document;
+    m_element    = index + 1;
+    m_position   = m_begin + document->element(index).begin;
+
+    return parseMap(value);
+}
+
+/**
+ * \param document The document that holds the list.
+ * \param index The index of the list in the document.
+ * \param value The list where the parsed values are placed.
+ * \returns true if the list was successfully parsed.
+ */
+bool
+S9sJsonParser::load(
+        S9sJsonDocument *document,
+        unsigned int     index,
+        S9sVariantList  &value)
+{
+    m_errorString.clear();
+    m_depth      = 0;
+    m_document   = document;
+    m_element    = index + 1;
+    m_position   = m_begin + document->element(index).begin;
+
+    return parseList(value);
+}
+
+/**
+ * Private method to parse the string lazily: the string is indexed in a new
+ * document, then only the top level map is parsed. The parsed values keep the
+ * document alive until they are loaded.
+ *
+ * The document takes the buffer given to adoptBuffer() or copies the string.
+ * A string that is read in chunks is parsed at once, the lazy values would
+ * need the whole string to be kept.
+ */
+bool
+S9sJsonParser::parseDocument(
+        S9sVariantMap &values)
+{
+    S9sJsonDocument *document;
+    bool             success;
+
+    if (m_reader != NULL)
+        return parseRoot(values);
+
+    document = new S9sJsonDocument(m_arena);
+    if (m_adopted != NULL)
+    {
+        success = document->adoptText(
+                m_adopted, m_begin - m_adopted, m_end - m_begin);
+    } else {
+        success = document->setText(m_begin, m_end - m_begin);
+    }
+
+    if (!success)
+    {
+        m_errorString = document->errorString();
+        document->unRef();
+        return false;
+    }
+
+    m_begin      = document->text();
+    m_position   = m_begin;
+    m_end        = m_begin + document->length();
+    m_offset     = 0;
+    m_document   = document;
+    m_element    = 1;
+
+    success      = parseRoot(values);
+    m_document   = NULL;
+
+    // The buffer is given back if the string could not be parsed.
+    if (!success && m_adopted != NULL)
+        document->releaseText();
+    else
+        m_adopted = NULL;
+
+    document->unRef();
+
+    return success;
+}
+
+/**
+ * Private method to parse the top level map of the JSON string.
+ */
+bool
+S9sJsonParser::parseRoot(
+        S9sVariantMap &values)
+{
+    S9sVariantMap result(m_arena);
+
+    m_errorString.clear();
+    m_depth = 0;
+
+    if (!skipSpace() || *m_position != '{')
+        return unexpected();
+
+    if (!parseMap(result))
+        return false;
+
+    // Nothing but whitespace and comments after the object.
+    if (skipSpace() || !m_errorString.empty())
+        return unexpected();
+
+    values.clear();
+    values.swap(result);
+
+    return true;
+}
+
+/**
+ * \returns true if the JSON string is one valid map.
+ *
+ * Checks the syntax of the whole string the same way it is parsed, but
+ * without creating the values. The document checks the string with this
+ * before it is parsed lazily, so the values that are loaded later can not
+ * fail.
+ */
+bool
+S9sJsonParser::validate()
+{
+    m_errorString.clear();
+    m_depth = 0;
+
+    if (!skipSpace() || *m_position != '{')
+        return unexpected();
+
+    if (!skipMap())
+        return false;
+
+    // Nothing but whitespace and comments after the object.
+    if (skipSpace() || !m_errorString.empty())
+        return unexpected();
+
+    return true;
+}
+
+/**
+ * \param arena The arena where the parsed values are allocated or NULL to
+ *   allocate them on the heap.
+ *
+ * The arena is referenced by the parsed values, it can be released by the
+ * caller after the parsing.
+ */
+void
+S9sJsonParser::setArena(
+        S9sArena *arena)
+{
+    m_arena = arena;
+}
+
+/**
+ * \param buffer The buffer allocated by malloc() the input of the parser is
+ *   in, with room for a null byte after the input.
+ *
+ * In lazy mode the document takes the ownership of the buffer if the parsing
+ * succeeds, so the input does not have to be copied. The buffer is left to the
+ * caller if the parsing fails.
+ */
+void
+S9sJsonParser::adoptBuffer(
+        char *buffer)
+{
+    m_adopted = buffer;
+}
+
+/**
+ * \param lazy true to parse the maps and the lists in the top level map only
+ *   when they are accessed.
+ */
+void
+S9sJsonParser::setLazy(
+        bool lazy)
+{
+    m_lazy = lazy;
+}
+
+/**
+ * \returns The human readable description of the error when the parsing
+ *   failed.
+ */
+S9sString
+S9sJsonParser::errorString() const
+{
+    return m_errorString;
+}
+
+/**
+ * Private method to read the next chunk of the string when the parser is
+ * using a reader function. Should only be called when all the data in the
+ * buffer is processed.
+ *
+ * \returns false at the end of the data.
+ */
+bool
+S9sJsonParser::fill()
+{
+    int nBytes;
+
+    if (m_reader == NULL)
+        return false;
+
+    m_offset  += m_end - m_begin;
+    nBytes     = m_reader(m_buffer, JSON_BUFFER_SIZE, m_readerData);
+    m_begin    = m_buffer;
+    m_position = m_buffer;
+    m_end      = m_buffer + (nBytes > 0 ? nBytes : 0);
+
+    return nBytes > 0;
+}
+
+/**
+ * \param c The next character is placed here, it is not consumed.
+ * \returns false at the end of the data.
+ */
+inline bool
+S9sJsonParser::peek(
+        char &c)
+{
+    if (m_position == m_end && !fill())
+        return false;
+
+    c = *m_position;
+    return true;
+}
+
+/**
+ * Skips the whitespace and the comments.
+ *
+ * \returns true if there is a character to process, false at the end of the
+ *   data or if an invalid comment was found.
+ */
+bool
+S9sJsonParser::skipSpace()
+{
+    for (;;)
+    {
+        while (m_position < m_end)
+        {
+            switch (*m_position)
+            {
+                case ' ':
+                    // The indentation is skipped eight spaces at a time.
+                    ++m_position;
+                    while (m_end - m_position >= 8 &&
+                            memcmp(m_position, "        ", 8) == 0)
+                    {
+                        m_position += 8;
+                    }
+                    break;
+
+                case '\n':
+                case '\t':
+                case '\r':
+                    ++m_position;
+                    break;
+
+                case '/':
+                    if (!skipComment())
+                        return false;
+
+                    break;
+
+                default:
+                    return true;
+            }
+        }
+
+        if (!fill())
+            return false;
+    }
+}
+
+/**
+ * Skips a C or a C++ style comment. A C style comment that is not closed
+ * before the end of the data is accepted.
+ */
+bool
+S9sJsonParser::skipComment()
+{
+    char c;
+
+    ++m_position;
+    if (!peek(c))
+        return setError("Unexpected '/' at the end of the JSON string.");
+
+    if (c == '/')
+    {
+        for (;;)
+        {
+            const char *newLine = (const char *)
+                memchr(m_position, '\n', m_end - m_position);
+
+            if (newLine != NULL)
+            {
+                m_position = newLine + 1;
+                return true;
+            }
+
+            m_position = m_end;
+            if (!fill())
+                return true;
+        }
+    } else if (c == '*')
+    {
+        ++m_position;
+
+        for (;;)
+        {
+            const char *star = (const char *)
+                memchr(m_position, '*', m_end - m_position);
+
+            if (star == NULL)
+            {
+                m_position = m_end;
+                if (!fill())
+                    return true;
+
+                continue;
+            }
+
+            m_position = star + 1;
+            if (!peek(c))
+                return true;
+
+            if (c == '/')
+            {
+                ++m_position;
+                return true;
+            }
+        }
+    }
+
+    // The '/' may be in the previous chunk, it can not be pointed to.
+    m_errorString.sprintf(
+            "Unexpected character '/' at offset %lu.",
+            (unsigned long) offset() - 1);
+
+    return false;
+}
+
+/**
+ * Parses a map starting with the '{' at the current position.
+ */
+bool
+S9sJsonParser::parseMap(
+        S9sVariantMap &map)
+{
+    S9sString               key;
+    S9sAtom                 atom;
+    S9sVariantMap::iterator it;
+
+    if (++m_depth > JSON_MAX_DEPTH)
+        return setError("The JSON string is nested too deep.");
+
+    ++m_position;
+    if (!skipSpace())
+        return unexpected();
+
+    if (*m_position == '}')
+    {
+        ++m_position;
+        --m_depth;
+        return true;
+    }
+
+    for (;;)
+    {
+        if (!parseKey(key))
+            return false;
+
+        if (!skipSpace() || *m_position != ':')
+            return unexpected();
+
+        ++m_position;
+        if (!skipSpace())
+            return unexpected();
+
+        /*
+         * The value is parsed directly into the map. The keys are interned,
+         * the maps of the reply share them.
+         */
+        atom = S9sAtom(key);
+        it   = map.lower_bound(atom);
+        if (it == map.end() || atom < it->first)
+            it = map.insert(it, S9sVariantMap::value_type(atom, S9sVariant()));
+
+        if (!parseValue(it->second))
+            return false;
+
+        if (!skipSpace())
+            return unexpected();
+
+        if (*m_position == ',')
+        {
+            ++m_position;
+            if (!skipSpace())
+                return unexpected();
+        } else if (*m_position == '}')
+        {
+            ++m_position;
+            break;
+        } else {
+            return unexpected();
+        }
+    }
+
+    --m_depth;
+    return true;
+}
+
+/**
+ * Parses a list starting with the '[' at the current position.
+ */
+bool
+S9sJsonParser::parseList(
+        S9sVariantList &list)
+{
+    if (++m_depth > JSON_MAX_DEPTH)
+        return setError("The JSON string is nested too deep.");
+
+    ++m_position;
+    if (!skipSpace())
+        return unexpected();
+
+    if (*m_position == ']')
+    {
+        ++m_position;
+        --m_depth;
+        return true;
+    }
+
+    for (;;)
+    {
+        list.push_back(S9sVariant());
+        if (!parseValue(list.back()))
+            return false;
+
+        if (!skipSpace())
+            return unexpected();
+
+        if (*m_position == ',')
+        {
+            ++m_position;
+            if (!skipSpace())
+                return unexpected();
+        } else if (*m_position == ']')
+        {
+            ++m_position;
+            break;
+        } else {
+            return unexpected();
+        }
+    }
+
+    --m_depth;
+    return true;
+}
+
+/**
+ * Parses the value at the current position into the given variant, which is
+ * the element of the map or the list that holds the value.
+ */
+bool
+S9sJsonParser::parseValue(
+        S9sVariant &value)
+{
+    char         c = *m_position;
+    unsigned int index;
+
+    value.clear();
+
+    switch (c)
+    {
+        case '{':
+            value.m_type = Map;
+            value.m_union.mapValue = 
+                S9sSharedValue<S9sVariantMap>::create(m_arena);
+
+            if (m_document == NULL)
+                return parseMap(value.m_union.mapValue->m_value);
+
+            if (!startElement(index))
+                return false;
+
+            value.m_union.mapValue->setLoader(m_document, index);
+            return true;
+
+        case '[':
+            value.m_type = List;
+            value.m_union.listValue = 
+                S9sSharedValue<S9sVariantList>::create(m_arena);
+
+            if (m_document == NULL)
+                return parseList(value.m_union.listValue->m_value);
+
+            if (!startElement(index))
+                return false;
+
+            value.m_union.listValue->setLoader(m_document, index);
+            return true;
+
+        case '"':
+        case '\'':
+            m_string.clear();
+            if (!parseString(m_string))
+                return false;
+
+            setString(value);
+            return true;
+    }
+
+    if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.')
+        return parseNumber(value);
+
+    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_')
+    {
+        m_string.clear();
+        if (!parseWord(m_string))
+            return false;
+
+        if (!keywordValue(m_string, value))
+            setString(value);
+
+        return true;
+    }
+
+    return unexpected();
+}
+
+/**
+ * Private method to check the map starting with the '{' at the current
+ * position, the same way parseMap() parses it.
+ */
+bool
+S9sJsonParser::skipMap()
+{
+    if (++m_depth > JSON_MAX_DEPTH)
+        return setError("The JSON string is nested too deep.");
+
+    ++m_position;
+    if (!skipSpace())
+        return unexpected();
+
+    if (*m_position == '}')
+    {
+        ++m_position;
+        --m_depth;
+        return true;
+    }
+
+    for (;;)
+    {
+        if (!parseKey(m_string))
+            return false;
+
+        if (!skipSpace() || *m_position != ':')
+            return unexpected();
+
+        ++m_position;
+        if (!skipSpace())
+            return unexpected();
+
+        if (!skipValue())
+            return false;
+
+        if (!skipSpace())
+            return unexpected();
+
+        if (*m_position == ',')
+        {
+            ++m_position;
+            if (!skipSpace())
+                return unexpected();
+        } else if (*m_position == '}')
+        {
+            ++m_position;
+            break;
+        } else {
+            return unexpected();
+        }
+    }
+
+    --m_depth;
+    return true;
+}
+
+/**
+ * Private method to check the list starting with the '[' at the current
+ * position.
+ */
+bool
+S9sJsonParser::skipList()
+{
+    if (++m_depth > JSON_MAX_DEPTH)
+        return setError("The JSON string is nested too deep.");
+
+    ++m_position;
+    if (!skipSpace())
+        return unexpected();
+
+    if (*m_position == ']')
+    {
+        ++m_position;
+        --m_depth;
+        return true;
+    }
+
+    for (;;)
+    {
+        if (!skipValue())
+            return false;
+
+        if (!skipSpace())
+            return unexpected();
+
+        if (*m_position == ',')
+        {
+            ++m_position;
+            if (!skipSpace())
+                return unexpected();
+        } else if (*m_position == ']')
+        {
+            ++m_position;
+            break;
+        } else {
+            return unexpected();
+        }
+    }
+
+    --m_depth;
+    return true;
+}
+
+/**
+ * Private method to check the value at the current position. The strings are
+ * parsed into the buffer of the parser, the numbers into a variant on the
+ * stack, so nothing is allocated for them.
+ */
+bool
+S9sJsonParser::skipValue()
+{
+    char       c = *m_position;
+    S9sVariant number;
+
+    switch (c)
+    {
+        case '{':
+            return skipMap();
+
+        case '[':
+            return skipList();
+
+        case '"':
+        case '\'':
+            m_string.clear();
+            return parseString(m_string);
+    }
+
+    if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.')
+        return parseNumber(number);
+
+    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_')
+    {
+        m_string.clear();
+        return parseWord(m_string);
+    }
+
+    return unexpected();
+}
+
+/**
+ * Private method to skip the map or the list at the current position in lazy
+ * mode, it is parsed later by the document.
+ *
+ * \param index The index of the map or the list in the document is placed
+ *   here.
+ */
+bool
+S9sJsonParser::startElement(
+        unsigned int &index)
+{
+    if (m_element >= m_document->nElements() ||
+            m_document->element(m_element).begin != offset())
+    {
+        return setError("The index of the JSON document is invalid.");
+    }
+
+    index      = m_element;
+    m_position = m_begin + m_document->element(index).end;
+    m_element  = m_document->element(index).next;
+
+    return true;
+}
+
+/**
+ * Private method to set the string that was just parsed as the value. The
+ * characters are copied, so the parser keeps the buffer for the next string.
+ */
+void
+S9sJsonParser::setString(
+        S9sVariant &value)
+{
+    value.m_type = String;
+
+    if (m_string.length() <= S9S_SHORT_STRING_SIZE)
+    {
+        value.setString(m_string.data(), m_string.length());
+    } else {
+        value.setSharedString(
+                S9sSharedValue<S9sString>::create(m_arena, m_string));
+    }
+}
+
+/**
+ * Parses a key of a map, a quoted string or a bare word.
+ */
+bool
+S9sJsonParser::parseKey(
+        S9sString &key)
+{
+    char       c = *m_position;
+    S9sVariant keyword;
+
+    key.clear();
+
+    if (c == '"' || c == '\'')
+        return parseString(key);
+
+    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_')
+    {
+        if (!parseWord(key))
+            return false;
+
+        if (keywordValue(key, keyword))
+        {
+            m_errorString.sprintf(
+                    "The keyword '%s' can not be a key at offset %lu.",
+                    STR(key), (unsigned long) offset());
+
+            return false;
+        }
+
+        return true;
+    }
+
+    return unexpected();
+}
+
+/**
+ * Parses a string quoted by '"' or '\'' starting at the current position. The
+ * characters between the escape sequences are found by scanning multiple
+ * bytes at once and they are appended to the string in one step.
+ */
+bool
+S9sJsonParser::parseString(
+        S9sString &value)
+{
+    const char  quote = *m_position;
+    const char *found;
+
+    ++m_position;
+
+    for (;;)
+    {
+        found = findQuoteOrEscape(m_position, m_end, quote);
+        value.append(m_position, found - m_position);
+        m_position = found;
+
+        if (found == m_end)
+        {
+            if (!fill())
+                return setError("The string is not terminated.");
+
+            continue;
+        }
+
+        ++m_position;
+        if (*found == quote)
+            return true;
+
+        if (!parseEscape(value))
+            return false;
+    }
+}
+
+/**
+ * Parses the escape sequence after a backslash. The unknown escape sequences
+ * are replaced by a space as they always were.
+ */
+bool
+S9sJsonParser::parseEscape(
+        S9sString &value)
+{
+    unsigned int code;
+    unsigned int low;
+    char         c;
+
+    if (!peek(c))
+        return setError("The string is not terminated.");
+
+    ++m_position;
+    switch (c)
+    {
+        case '"':
+        case '\'':
+        case '\\':
+        case '/':
+            value += c;
+            break;
+
+        case 'n':
+            value += '\n';
+            break;
+
+        case 'r':
+            value += '\r';
+            break;
+
+        case 't':
+            value += '\t';
+            break;
+
+        case 'b':
+            value += '\b';
+            break;
+
+        case 'f':
+            value += '\f';
+            break;
+
+        case 'u':
+            if (!parseHexDigits(code))
+                return false;
+
+            if (code >= 0xdc00 && code <= 0xdfff)
+            {
+                code = 0xfffd;
+            } else if (code >= 0xd800 && code <= 0xdbff)
+            {
+                // The high surrogate must be followed by the low surrogate.
+                if (!peek(c) || c != '\\')
+                {
+                    appendUtf8(value, 0xfffd);
+                    break;
+                }
+
+                ++m_position;
+                if (!peek(c) || c != 'u')
+                {
+                    appendUtf8(value, 0xfffd);
+                    return parseEscape(value);
+                }
+
+                ++m_position;
+                if (!parseHexDigits(low))
+                    return false;
+
+                if (low >= 0xdc00 && low <= 0xdfff)
+                {
+                    code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+                } else {
+                    appendUtf8(value, 0xfffd);
+                    code = low >= 0xd800 && low <= 0xdbff ? 0xfffd : low;
+                }
+            }
+
+            appendUtf8(value, code);
+            break;
+
+        default:
+            value += ' ';
+    }
+
+    return true;
+}
+
+/**
+ * Parses the four hexadecimal digits of a \\u escape sequence.
+ */
+bool
+S9sJsonParser::parseHexDigits(
+        unsigned int &code)
+{
+    char c;
+
+    code = 0;
+    for (int n = 0; n < 4; ++n)
+    {
+        if (!peek(c))
+            return setError("The string is not terminated.");
+
+        if (c >= '0' && c <= '9')
+            code = code * 16 + (c - '0');
+        else if (c >= 'a' && c <= 'f')
+            code = code * 16 + (c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F')
+            code = code * 16 + (c - 'A' + 10);
+        else
+            return setError("Invalid \\u escape sequence.");
+
+        ++m_position;
+    }
+
+    return true;
+}
+
+/**
+ * Parses a bare word (letters and underscores) starting at the current
+ * position.
+ */
+bool
+S9sJsonParser::parseWord(
+        S9sString &word)
+{
+    const char *start;
+    char        c;
+
+    for (;;)
+    {
+        start = m_position;
+        while (m_position < m_end)
+        {
+            c = *m_position;
+            if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_')
+                ++m_position;
+            else
+                break;
+        }
+
+        word.append(start, m_position - start);
+        if (m_position < m_end || !fill())
+            break;
+    }
+
+    return true;
+}
+
+/**
+ * Parses a number or a signed NaN or Infinity. The integers are stored as int
+ * when they fit, as ulonglong when they are positive and fit, all the other
+ * numbers are stored as double.
+ */
+bool
+S9sJsonParser::parseNumber(
+        S9sVariant &value)
+{
+    char      token[JSON_MAX_NUMBER];
+    int       length = 0;
+    int       start;
+    bool      isDouble = false;
+    char      c = *m_position;
+
+    if (c == '-' || c == '+')
+    {
+        token[length++] = c;
+        ++m_position;
+
+        if (!peek(c))
+            return unexpected();
+
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_')
+        {
+            S9sString  word;
+            S9sVariant keyword;
+
+            parseWord(word);
+            if (!keywordValue(word, keyword) || !keyword.isDouble())
+            {
+                m_errorString.sprintf(
+                        "Invalid number '%c%s' at offset %lu.",
+                        token[0], STR(word), (unsigned long) offset());
+
+                return false;
+            }
+
+            if (token[0] == '-')
+                value = -keyword.toDouble();
+            else
+                value = keyword;
+
+            return true;
+        }
+    }
+
+    start = length;
+    if (!parseDigits(token, length))
+        return false;
+
+    if (peek(c) && c == '.')
+    {
+        token[length++] = c;
+        ++m_position;
+
+        start = length;
+        if (!parseDigits(token, length))
+            return false;
+
+        isDouble = true;
+    }
+
+    if (length == start)
+        return unexpected();
+
+    if (peek(c) && (c == 'e' || c == 'E'))
+    {
+        token[length++] = c;
+        ++m_position;
+
+        if (peek(c) && (c == '-' || c == '+'))
+        {
+            token[length++] = c;
+            ++m_position;
+        }
+
+        start = length;
+        if (!parseDigits(token, length))
+            return false;
+
+        if (length == start)
+            return unexpected();
+
+        isDouble = true;
+    }
+
+    token[length] = '\0';
+
+    if (!isDouble)
+    {
+        const char *digit    = token;
+        bool        negative = *digit == '-';
+        bool        overflow = false;
+        ulonglong   number   = 0ull;
+
+        if (*digit == '-' || *digit == '+')
+            ++digit;
+
+        for (; *digit != '\0'; ++digit)
+        {
+            int d = *digit - '0';
+
+            if (number > (ULLONG_MAX - d) / 10)
+            {
+                overflow = true;
+                break;
+            }
+
+            number = number * 10 + d;
+        }
+
+        if (!negative)
+        {
+            if (overflow)
+                value = ULLONG_MAX;
+            else if (number > INT_MAX)
+                value = number;
+            else
+                value = (int) number;
+
+            return true;
+        } else if (!overflow && number <= (ulonglong) INT_MAX + 1)
+        {
+            value = (int) -(longlong) number;
+            return true;
+        }
+    }
+
+    // The decimal separator of the strtod() depends on the locale.
+    if (*localeconv()->decimal_point != '.')
+    {
+        char *dot = strchr(token, '.');
+
+        if (dot != NULL)
+            *dot = *localeconv()->decimal_point;
+    }
+
+    value = strtod(token, NULL);
+    return true;
+}
+
+/**
+ * Appends the decimal digits at the current position to the token.
+ */
+bool
+S9sJsonParser::parseDigits(
+        char  *token,
+        int   &length)
+{
+    char c;
+
+    while (peek(c) && c >= '0' && c <= '9')
+    {
+        // Leaving room for the '.', the exponent sign and the terminating 0.
+        if (length >= JSON_MAX_NUMBER - 3)
+            return setError("The number is too long.");
+
+        token[length++] = c;
+        ++m_position;
+    }
+
+    return true;
+}
+
+/**
+ * Sets the error string for the character at the current position or for the
+ * end of the data. Keeps the error string if it was already set. Always
+ * returns false.
+ */
+bool
+S9sJsonParser::unexpected()
+{
+    if (!m_errorString.empty())
+        return false;
+
+    if (m_position >= m_end)
+    {
+        m_errorString = "Unexpected end of the JSON string.";
+    } else {
+        m_errorString.sprintf(
+                "Unexpected character '%c' at offset %lu.",
+                *m_position, (unsigned long) offset());
+    }
+
+    return false;
+}
+
+/**
+ * Sets the error string, always returns false.
+ */
+bool
+S9sJsonParser::setError(
+        const char *message)
+{
+    m_errorString = message;
+    S9S_DEBUG("%s", message);
+
+    return false;
+}
+
+/**
+ * \returns The offset of the current position from the beginning of the JSON
+ *   string.
+ */
+size_t
+S9sJsonParser::offset() const
+{
+    return m_offset + (m_position - m_begin);
+}
+
+/**
+ * \returns The first quote or backslash between the position and the end or
+ *   the end if there is none.
+ *
+ * Checks eight bytes in one step: a byte that is equal to the searched
+ * character becomes zero after the XOR, and the zero bytes are found by the
+ * borrow the subtraction produces.
+ */
+const char *
+S9sJsonParser::findQuoteOrEscape(
+        const char *position,
+        const char *end,
+        const char  quote)
+{
+    const uint64_t ones      = 0x0101010101010101ull;
+    const uint64_t highBits  = 0x8080808080808080ull;
+    const uint64_t quotes    = ones * (unsigned char) quote;
+    const uint64_t escapes   = ones * (unsigned char) '\\';
+    uint64_t       word;
+    uint64_t       x, y;
+
+    while (end - position >= 8)
+    {
+        memcpy(&word, position, sizeof(word));
+
+        x = word ^ quotes;
+        y = word ^ escapes;
+        if ((((x - ones) & ~x) | ((y - ones) & ~y)) & highBits)
+            break;
+
+        position += 8;
+    }
+
+    while (position < end && *position != quote && *position != '\\')
+        ++position;
+
+    return position;
+}
+
+/**
+ * \param word The bare word.
+ * \param value The value of the keyword is placed here.
+ * \returns true if the word is a keyword: true, false, NaN or Infinity.
+ */
+bool
+S9sJsonParser::keywordValue(
+        const S9sString &word,
+        S9sVariant      &value)
+{
+    switch (word.length())
+    {
+        case 3:
+            if (strcasecmp(STR(word), "nan") == 0)
+            {
+                value = NAN;
+                return true;
+            } else if (strcasecmp(STR(word), "inf") == 0)
+            {
+                value = INFINITY;
+                return true;
+            }
+            break;
+
+        case 4:
+            if (word == "true")
+            {
+                value = true;
+                return true;
+            }
+            break;
+
+        case 5:
+            if (word == "false")
+            {
+                value = false;
+                return true;
+            }
+            break;
+
+        case 8:
+            if (strcasecmp(STR(word), "infinity") == 0)
+            {
+                value = INFINITY;
+                return true;
+            }
+            break;
+    }
+
+    return false;
+}
+
+/**
+ * Appends the character with the given unicode code point in UTF-8 encoding.
+ */
+void
+S9sJsonParser::appendUtf8(
+        S9sString    &value,
+        unsigned int  code)
+{
+    if (code < 0x80)
+    {
+        value += (char) code;
+    } else if (code < 0x800)
+    {
+        value += (char) (0xc0 | (code >> 6));
+        value += (char) (0x80 | (code & 0x3f));
+    } else if (code < 0x10000)
+    {
+        value += (char) (0xe0 | (code >> 12));
+        value += (char) (0x80 | ((code >> 6) & 0x3f));
+        value += (char) (0x80 | (code & 0x3f));
+    } else {
+        value += (char) (0xf0 | (code >> 18));
+        value += (char) (0x80 | ((code >> 12) & 0x3f));
+        value += (char) (0x80 | ((code >> 6) & 0x3f));
+        value += (char) (0x80 | (code & 0x3f));
+    }
+}
@@ -0,0 +1,124 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2018  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "S9sVariantMap"
+#include "S9sVariantList"
+#include "S9sParseContextState"
+
+class S9sJsonDocument;
+
+/**
+ * A recursive descent parser for the JSON strings the controller sends. The
+ * values are created where they are stored (in the map or in the list that
+ * holds them), so the parsed values are never copied.
+ *
+ * Besides the standard JSON the parser accepts the syntax the controller and
+ * the configuration files use: C and C++ style comments, single quoted
+ * strings, bare words as strings, NaN and Infinity.
+ *
+ * In lazy mode the parser builds the structural index of the string first
+ * (see S9sJsonDocument) and parses only the top level map, the maps and the
+ * lists in it are parsed when they are first accessed.
+ */
+class S9sJsonParser
+{
+    public:
+        S9sJsonParser(
+                const char *input,
+                size_t      length);
+
+        S9sJsonParser(
+                S9sParseReader  reader,
+                void           *userData);
+
+        virtual ~S9sJsonParser();
+
+        void setArena(S9sArena *arena);
+        void setLazy(bool lazy);
+        void adoptBuffer(char *buffer);
+        bool parse(S9sVariantMap &values);
+        bool validate();
+
+        bool load(
+                S9sJsonDocument *document,
+                unsigned int     index,
+                S9sVariantMap   &value);
+
+        bool load(
+                S9sJsonDocument *document,
+                unsigned int     index,
+                S9sVariantList  &value);
+
+        S9sString errorString() const;
+
+    private:
+        bool parseDocument(S9sVariantMap &values);
+        bool parseRoot(S9sVariantMap &values);
+        bool startElement(unsigned int &index);
+        bool fill();
+        bool peek(char &c);
+        bool skipSpace();
+        bool skipComment();
+
+        bool parseMap(S9sVariantMap &map);
+        bool parseList(S9sVariantList &list);
+        bool parseValue(S9sVariant &value);
+        bool skipMap();
+        bool skipList();
+        bool skipValue();
+        bool parseKey(S9sString &key);
+        bool parseString(S9sString &value);
+        bool parseEscape(S9sString &value);
+        bool parseHexDigits(unsigned int &code);
+        bool parseWord(S9sString &word);
+        bool parseNumber(S9sVariant &value);
+        void setString(S9sVariant &value);
+        bool parseDigits(char *token, int &length);
+
+        bool unexpected();
+        bool setError(const char *message);
+        size_t offset() const;
+
+        static const char *findQuoteOrEscape(
+                const char *position,
+                const char *end,
+                const char  quote);
+
+        static bool keywordValue(const S9sString &word, S9sVariant &value);
+        static void appendUtf8(S9sString &value, unsigned int code);
+
+    private:
+        S9sParseReader   m_reader;
+        void            *m_readerData;
+        char            *m_buffer;
+        const char      *m_begin;
+        const char      *m_position;
+        const char      *m_end;
+        size_t           m_offset;
+        int              m_depth;
+        S9sString        m_string;
+        S9sArena        *m_arena;
+        bool             m_lazy;
+        S9sJsonDocument *m_document;
+        unsigned int     m_element;
+        char            *m_adopted;
+        S9sString        m_errorString;
+};
@@ -0,0 +1,448 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2018  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "s9sjsonwriter.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "S9sVariant"
+#include "S9sVariantMap"
+#include "S9sVariantList"
+
+//#define DEBUG
+//#define WARNING
+#include "s9sdebug.h"
+
+/**
+ * \param output The file where the text is written.
+ * \param compact true to write the text without whitespace.
+ */
+S9sJsonWriter::S9sJsonWriter(
+        FILE *output,
+        bool  compact) :
+    m_file(output),
+    m_string(NULL),
+    m_compact(compact),
+    m_length(0)
+{
+}
+
+/**
+ * \param output The string where the text is appended.
+ * \param compact true to write the text without whitespace.
+ */
+S9sJsonWriter::S9sJsonWriter(
+        S9sString &output,
+        bool       compact) :
+    m_file(NULL),
+    m_string(&output),
+    m_compact(compact),
+    m_length(0)
+{
+}
+
+/**
+ * The text that is still in the buffer is written when the writer is
+ * destroyed.
+ */
+S9sJsonWriter::~S9sJsonWriter()
+{
+    flush();
+}
+
+/**
+ * Starts a map, as the top level value, the value of a key or the element of
+ * a list.
+ */
+void
+S9sJsonWriter::beginMap()
+{
+    Level level;
+
+    beginValue();
+
+    level.isMap     = true;
+    level.depth     = m_levels.empty() ? 0 : m_levels.back().depth + 1;
+    level.nElements = 0u;
+
+    if (m_compact)
+    {
+        append('{');
+    } else {
+        // The maps inside other values start on a new line.
+        if (!m_levels.empty())
+            append('\n');
+
+        indent(level.depth);
+        append("{\n", 2);
+    }
+
+    m_levels.push_back(level);
+}
+
+/**
+ * Closes the map started by beginMap().
+ */
+void
+S9sJsonWriter::endMap()
+{
+    Level level = m_levels.back();
+
+    m_levels.pop_back();
+
+    if (m_compact)
+    {
+        append('}');
+    } else {
+        if (level.nElements > 0u)
+            append('\n');
+
+        indent(level.depth);
+        append('}');
+    }
+}
+
+/**
+ * Starts a list. The elements of a list are written in one line, the maps in
+ * the list are written in new lines.
+ */
+void
+S9sJsonWriter::beginList()
+{
+    Level level;
+
+    beginValue();
+
+    level.isMap     = false;
+    level.depth     = m_levels.empty() ? 0 : m_levels.back().depth;
+    level.nElements = 0u;
+
+    if (m_compact)
+        append('[');
+    else
+        append("[ ", 2);
+
+    m_levels.push_back(level);
+}
+
+/**
+ * Closes the list started by beginList().
+ */
+void
+S9sJsonWriter::endList()
+{
+    m_levels.pop_back();
+
+    if (m_compact)
+        append(']');
+    else
+        append(" ]", 2);
+}
+
+/**
+ * Writes the key of the next value of the map that is being written.
+ */
+void
+S9sJsonWriter::key(
+        const S9sString &key)
+{
+    Level &level = m_levels.back();
+
+    if (level.nElements > 0u)
+    {
+        if (m_compact)
+            append(',');
+        else
+            append(",\n", 2);
+    }
+
+    ++level.nElements;
+
+    if (!m_compact)
+        indent(level.depth + 1);
+
+    quoted(key.data(), key.length());
+
+    if (m_compact)
+        append(':');
+    else
+        append(": ", 2);
+}
+
+/**
+ * Writes a whole value, the maps and the lists with all their elements.
+ */
+void
+S9sJsonWriter::value(
+        const S9sVariant &value)
+{
+    char   number[64];
+    int    length;
+    double dValue;
+
+    switch (value.type())
+    {
+        case String:
+            // The string is written where it is stored, it is not copied.
+            beginValue();
+            if (value.isSharedString())
+            {
+                const S9sString &text = value.sharedString()->m_value;
+
+                quoted(text.data(), text.length());
+            } else {
+                quoted(value.m_union.stringValue.data, 
+                        value.m_union.stringValue.length);
+            }
+            return;
+
+        case Bool:
+            beginValue();
+            if (value.toBoolean())
+                append("true", 4);
+            else
+                append("false", 5);
+
+            return;
+
+        case Int:
+            beginValue();
+            length = snprintf(number, sizeof(number), "%d", value.toInt());
+            append(number, length);
+            return;
+
+        case Ulonglong:
+            beginValue();
+            length = snprintf(
+                    number, sizeof(number), "%llu", value.toULongLong());
+
+            append(number, length);
+            return;
+
+        case Double: 
+            beginValue();
+            dValue = value.toDouble();
+            if (std::isnan(dValue))
+            {
+                append("NaN", 3);
+            } else if (std::isinf(dValue))
+            {
+                append("Infinity", 8);
+            } else {
+                length = snprintf(number, sizeof(number), "%g", dValue);
+                append(number, length);
+            }
+            return;
+
+        case Map:
+        case Node:
+        case Account:
+            this->value(value.toVariantMap());
+            return;
+
+        case List:
+            this->value(value.toVariantList());
+            return;
+        
+        default:
+            // Let's use 'null' for invalid/null data (http://www.json.org/)
+            beginValue();
+            append("null", 4);
+            return;
+    }
+}
+
+/**
+ * Writes a whole map.
+ */
+void
+S9sJsonWriter::value(
+        const S9sVariantMap &value)
+{
+    beginMap();
+
+    for (S9sVariantMap::const_iterator it = value.begin(); 
+            it != value.end(); ++it)
+    {
+        key(it->first);
+        this->value(it->second);
+    }
+
+    endMap();
+}
+
+/**
+ * Writes a whole list.
+ */
+void
+S9sJsonWriter::value(
+        const S9sVariantList &value)
+{
+    beginList();
+
+    for (uint idx = 0u; idx < value.size(); ++idx)
+        this->value(value[idx]);
+
+    endList();
+}
+
+/**
+ * Writes a text as it is, e.g. the new line between the documents.
+ */
+void
+S9sJsonWriter::write(
+        const char *text)
+{
+    append(text, strlen(text));
+}
+
+/**
+ * Writes the text in the buffer to the file or appends it to the string.
+ *
+ * \returns false if the text could not be written.
+ */
+bool
+S9sJsonWriter::flush()
+{
+    bool retval = true;
+
+    if (m_length == 0)
+        return true;
+
+    if (m_file != NULL)
+        retval = fwrite(m_buffer, 1, m_length, m_file) == m_length;
+    else
+        m_string->append(m_buffer, m_length);
+
+    m_length = 0;
+    return retval;
+}
+
+/**
+ * Private method called before every value, writes the separator between the
+ * elements of a list.
+ */
+void
+S9sJsonWriter::beginValue()
+{
+    if (m_levels.empty() || m_levels.back().isMap)
+        return;
+
+    if (m_levels.back().nElements++ > 0u)
+    {
+        if (m_compact)
+            append(',');
+        else
+            append(", ", 2);
+    }
+}
+
+/**
+ * Private method to write the indentation of the given depth.
+ */
+void
+S9sJsonWriter::indent(
+        int depth)
+{
+    static const char spaces[] = 
+        "                                                                ";
+
+    for (int n = depth * 4; n > 0; n -= sizeof(spaces) - 1)
+        append(spaces, n < (int) sizeof(spaces) - 1 ? n : sizeof(spaces) - 1);
+}
+
+/**
+ * Private method to write a string quoted, the characters that need no
+ * escaping are written in runs.
+ */
+void
+S9sJsonWriter::quoted(
+        const char *data,
+        size_t      length)
+{
+    size_t start = 0;
+
+    append('"');
+
+    for (size_t idx = 0; idx < length; ++idx)
+    {
+        const char *escaped;
+
+        switch (data[idx])
+        {
+            case '"':
+                escaped = "\\\"";
+                break;
+
+            case '\\':
+                escaped = "\\\\";
+                break;
+
+            case '\n':
+                escaped = "\\n";
+                break;
+
+            case '\r':
+                escaped = "\\r";
+                break;
+
+            case '\t':
+                escaped = "\\t";
+                break;
+
+            default:
+                continue;
+        }
+
+        append(data + start, idx - start);
+        append(escaped, 2);
+        start = idx + 1;
+    }
+
+    append(data + start, length - start);
+    append('"');
+}
+
+/**
+ * Private method to add text to the buffer, the text that does not fit is
+ * written in more steps.
+ */
+void
+S9sJsonWriter::append(
+        const char *text,
+        size_t      length)
+{
+    size_t chunk;
+
+    while (length > 0)
+    {
+        if (m_length == sizeof(m_buffer))
+            flush();
+
+        chunk = sizeof(m_buffer) - m_length;
+        if (chunk > length)
+            chunk = length;
+
+        memcpy(m_buffer + m_length, text, chunk);
+        m_length += chunk;
+        text     += chunk;
+        length   -= chunk;
+    }
+}
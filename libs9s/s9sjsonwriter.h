@@ -0,0 +1,115 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2018  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstdio>
+
+#include "S9sString"
+#include "S9sVector"
+
+class S9sVariant;
+class S9sVariantMap;
+class S9sVariantList;
+
+/**
+ * The size of the buffer the writer collects the text in before writing it.
+ */
+#define S9S_JSON_WRITER_BUFFER_SIZE (16 * 1024)
+
+/**
+ * Writes JSON text while walking the values, the text is written to a file in
+ * chunks of a fixed size buffer (or appended to a string), so the whole
+ * document is never built in the memory. The indented format is the one
+ * S9sVariantMap::toString() always produced, the compact format has no
+ * whitespace at all.
+ *
+ * Whole values can be written by value(), the documents that are produced
+ * piece by piece are written by the begin/end methods:
+ *
+ *   S9sJsonWriter writer(stdout);
+ *
+ *   writer.beginMap();
+ *   writer.key("total");
+ *   writer.value(nJobs);
+ *   writer.key("jobs");
+ *   writer.beginList();
+ *   ...
+ *   writer.endList();
+ *   writer.endMap();
+ */
+class S9sJsonWriter
+{
+    public:
+        S9sJsonWriter(FILE *output, bool compact = false);
+        S9sJsonWriter(S9sString &output, bool compact = false);
+        virtual ~S9sJsonWriter();
+
+        void beginMap();
+        void endMap();
+        void beginList();
+        void endList();
+        void key(const S9sString &key);
+        void value(const S9sVariant &value);
+        void value(const S9sVariantMap &value);
+        void value(const S9sVariantList &value);
+        void write(const char *text);
+        bool flush();
+
+    private:
+        S9sJsonWriter(const S9sJsonWriter &orig);
+        S9sJsonWriter &operator=(const S9sJsonWriter &rhs);
+
+        void beginValue();
+        void indent(int depth);
+        void quoted(const char *text, size_t length);
+        inline void append(char c);
+        void append(const char *text, size_t length);
+
+    private:
+        /**
+         * A map or a list that is being written.
+         */
+        struct Level
+        {
+            bool         isMap;
+            int          depth;
+            unsigned int nElements;
+        };
+
+        FILE              *m_file;
+        S9sString         *m_string;
+        bool               m_compact;
+        S9sVector<Level>   m_levels;
+        char               m_buffer[S9S_JSON_WRITER_BUFFER_SIZE];
+        size_t             m_length;
+};
+
+/**
+ * Private method to append one character to the buffer.
+ */
+inline void
+S9sJsonWriter::append(
+        char c)
+{
+    if (m_length == sizeof(m_buffer))
+        flush();
+
+    m_buffer[m_length++] = c;
+}
@@ -11,15 +11,23 @@
 #include "S9sString"
 #include "S9sVector"
 
-template <typename Key, typename T>
-class S9sMap : public std::map<Key, T>
+template <
+    typename Key, 
+    typename T, 
+    typename Allocator = std::allocator<std::pair<const Key, T> > >
+class S9sMap : public std::map<Key, T, std::less<Key>, Allocator>
 {
     public:
+        S9sMap() {};
+        explicit S9sMap(const Allocator &allocator) :
+            std::map<Key, T, std::less<Key>, Allocator>(
+                    std::less<Key>(), allocator) {};
+
         bool contains(const Key &key) const;
         S9sVector<Key> keys() const;
 #if 0
-        static S9sMap<Key, T> fromVector(const std::vector<Key> &theVector);
-        static S9sMap<Key, T> fromVector(const CmonStringList &theVector);
+        static S9sMap<Key, T, Allocator> fromVector(const std::vector<Key> &theVector);
+        static S9sMap<Key, T, Allocator> fromVector(const CmonStringList &theVector);
 #endif
 };
 
@@ -44,8 +52,8 @@ class S9sMap : public std::map<Key, T>
  </code>
 
  */
-template <typename Key, typename T>
-inline bool S9sMap<Key, T>::contains(
+template <typename Key, typename T, typename Allocator>
+inline bool S9sMap<Key, T, Allocator>::contains(
         const Key &key) const
 {
     return this->find(key) != this->end();
@@ -55,12 +63,12 @@ inline bool S9sMap<Key, T>::contains(
 /**
  * \returns a list that holds all the keys from the map
  */
-template <typename Key, typename T>
-S9sVector<Key> S9sMap<Key, T>::keys() const
+template <typename Key, typename T, typename Allocator>
+S9sVector<Key> S9sMap<Key, T, Allocator>::keys() const
 {
     S9sVector<Key> retval;
 
-    for (typename std::map<Key, T>::const_iterator it = this->begin(); it != this->end(); ++it) 
+    for (typename std::map<Key, T, std::less<Key>, Allocator>::const_iterator it = this->begin(); it != this->end(); ++it) 
     {
         retval.push_back(it->first);
     }
@@ -79,11 +87,11 @@ S9sMap<std::string, bool> theMap;
 theMap = S9sMap<std::string, bool>::fromVector(theList);
  </code>
  */
-template <typename Key, typename T>
-S9sMap<Key, T> S9sMap<Key, T>::fromVector(
+template <typename Key, typename T, typename Allocator>
+S9sMap<Key, T, Allocator> S9sMap<Key, T, Allocator>::fromVector(
         const std::vector<Key> &theVector)
 {
-    S9sMap<Key, T> retval;
+    S9sMap<Key, T, Allocator> retval;
 
     for (uint idx = 0; idx < theVector.size(); ++idx)
         retval[theVector[idx]] = T();
@@ -93,11 +101,11 @@ S9sMap<Key, T> S9sMap<Key, T>::fromVector(
 #endif
 
 #if 0
-template <typename Key, typename T>
-S9sMap<Key, T> S9sMap<Key, T>::fromVector(
+template <typename Key, typename T, typename Allocator>
+S9sMap<Key, T, Allocator> S9sMap<Key, T, Allocator>::fromVector(
         const S9sStringList &theVector)
 {
-    S9sMap<Key, T> retval;
+    S9sMap<Key, T, Allocator> retval;
 
     for (uint idx = 0; idx < theVector.size(); ++idx)
         retval[theVector[idx]] = T();
@@ -295,227 +295,144 @@ S9sString
 S9sMessage::toString(
         const bool       syntaxHighlight,
         const S9sString &formatString) const
+{
+    return toString(syntaxHighlight, compileFormat(formatString));
+}
+
+/**
+ * \param formatString The format string with markup.
+ * \returns The format string compiled for the toString() method, the
+ *   program can be used to print any number of messages.
+ */
+S9sFormatProgram
+S9sMessage::compileFormat(
+        const S9sString &formatString)
+{
+    return S9sFormatProgram(formatString, '\0', false);
+}
+
+/**
+ * \param syntaxHighlight Controls if the string will have colors or not.
+ * \param program The compiled format string.
+ * \returns The string representation according to the format string.
+ *
+ * Converts the message to a string executing the compiled format string, the
+ * format string is not parsed again for every message.
+ */
+S9sString
+S9sMessage::toString(
+        const bool              syntaxHighlight,
+        const S9sFormatProgram &program) const
 {
     S9sOptions  *options = S9sOptions::instance();
     S9sString    retval;
-    S9sString    tmp;
-    char         c;
-    S9sString    partFormat;
-    bool         percent = false;
-    bool         escaped = false;
-    
-    for (uint n = 0; n < formatString.size(); ++n)
+
+    for (uint n = 0; n < program.size(); ++n)
     {
-        c = formatString[n];
-        
-        if (c == '%' && !percent)
-        {
-            percent    = true;
-            partFormat = "%";
-            continue;
-        } else if (c == '\\' && !escaped)
+        const S9sFormatOp &op = program.at(n);
+
+        if (op.isLiteral())
         {
-            escaped = true;
+            retval += op.literal();
             continue;
         }
 
-        if (escaped)
+        switch (op.directive())
         {
-            switch (c)
-            {
-                case '\"':
-                    retval += '\"';
-                    break;
-
-                case '\\':
-                    retval += '\\';
-                    break;
-       
-                case 'a':
-                    retval += '\a';
-                    break;
-
-                case 'b':
-                    retval += '\b';
-                    break;
-
-                case 'e':
-                    retval += '\027';
-                    break;
-
-                case 'n':
-                    retval += '\n';
-                    break;
-
-                case 'r':
-                    retval += '\r';
-                    break;
-
-                case 't':
-                    retval += '\t';
-                    break;
-            }
-        } else if (percent)
-        {
-            switch (c)
-            {
-                case 'L':
-                    // The line number.
-                    partFormat += 'd';
-                    tmp.sprintf(STR(partFormat), lineNumber());
-                    retval += tmp;
-                    break;
-                
-                case 'I':
-                    // The message ID.
-                    partFormat += 'd';
-                    tmp.sprintf(STR(partFormat), messageId());
-                    retval += tmp;
-                    break;
-                
-                case 'J':
-                    // The job ID.
-                    partFormat += 'd';
-                    tmp.sprintf(STR(partFormat), jobId());
-                    retval += tmp;
-                    break;
-
-                case 'M':
-                    // The message in color.
-                    partFormat += 's';
-                    
-                    if (syntaxHighlight)
+            case 'L':
+                // The line number.
+                op.appendInt(retval, lineNumber());
+                break;
+            
+            case 'I':
+                // The message ID.
+                op.appendInt(retval, messageId());
+                break;
+            
+            case 'J':
+                // The job ID.
+                op.appendInt(retval, jobId());
+                break;
+
+            case 'M':
+                // The message in color.
+                if (syntaxHighlight)
+                {
+                    op.appendString(
+                            retval, S9sString::html2ansi(message()));
+                } else {
+                    op.appendString(
+                            retval, S9sString::html2text(message()));
+                }
+
+                break;
+
+            case 'C':
+                // The 'created' date&time.
+                op.appendString(
+                        retval, options->formatDateTime(created()));
+                break;
+            
+            case 'T':
+                // The 'created' time.
+                op.appendString(
+                        retval,
+                        created().toString(S9sDateTime::LongTimeFormat));
+                break;
+
+            case 'S':
+                // The severity or status.
+                // FIXME: This is hackish.
+                if (syntaxHighlight)
+                {
+                    if (severity() == "MESSAGE" || 
+                            severity() == "DEBUG")
                     {
-                        tmp.sprintf(
-                                STR(partFormat), 
-                                STR(S9sString::html2ansi(message())));
-                    } else {
-                        tmp.sprintf(
-                                STR(partFormat), 
-                                STR(S9sString::html2text(message())));
-                    }
-
-                    retval += tmp;
-                    break;
-
-                case 'C':
-                    // The 'created' date&time.
-                    partFormat += 's';
-                    tmp.sprintf(
-                            STR(partFormat), 
-                            STR(options->formatDateTime(created())));
-                    retval += tmp;
-                    break;
-                
-                case 'T':
-                    // The 'created' time.
-                    partFormat += 's';
-                    tmp.sprintf(
-                            STR(partFormat), 
-                            STR(created().toString(
-                                    S9sDateTime::LongTimeFormat)));
-                    retval += tmp;
-                    break;
-
-                case 'S':
-                    // The severity or status.
-                    partFormat += 's';
-                    tmp.sprintf(
-                            STR(partFormat), 
-                            STR(severity()));
-
-                    // FIXME: This is hackish.
-                    if (syntaxHighlight)
+                        retval += XTERM_COLOR_GREEN;
+                    } else if (severity() == "WARNING")
+                        retval += XTERM_COLOR_YELLOW;
+                    else if (severity() == "FAILURE" ||
+                             severity() == "ERROR"   ||
+                             severity() == "CRITICAL")
                     {
-                        if (severity() == "MESSAGE" || 
-                                severity() == "DEBUG")
-                        {
-                            retval += XTERM_COLOR_GREEN;
-                        } else if (severity() == "WARNING")
-                            retval += XTERM_COLOR_YELLOW;
-                        else if (severity() == "FAILURE" ||
-                                 severity() == "ERROR"   ||
-                                 severity() == "CRITICAL")
-                        {
-                            retval += XTERM_COLOR_RED;
-                        }
+                        retval += XTERM_COLOR_RED;
                     }
+                }
 
-                    retval += tmp;
+                op.appendString(retval, severity());
 
-                    retval += TERM_NORMAL;
-                    break;
-
-                case 'F':
-                    // The file name in color.
-                    partFormat += 's';
-                    tmp.sprintf(
-                            STR(partFormat), 
-                            STR(fileName()));
-                        
-                    retval += XTERM_COLOR_BLUE;
-                    retval += tmp;
+                retval += TERM_NORMAL;
+                break;
 
-                    retval += TERM_NORMAL;
-                    break;
+            case 'F':
+                // The file name in color.
+                retval += XTERM_COLOR_BLUE;
+                op.appendString(retval, fileName());
 
-                case 'B':
-                    // The base name in color.
-                    partFormat += 's';
-                    tmp.sprintf(
-                            STR(partFormat), 
-                            STR(fileName().baseName()));
-                        
-                    if (syntaxHighlight)
-                        retval += XTERM_COLOR_BLUE;
+                retval += TERM_NORMAL;
+                break;
 
-                    retval += tmp;
+            case 'B':
+                // The base name in color.
+                if (syntaxHighlight)
+                    retval += XTERM_COLOR_BLUE;
 
-                    if (syntaxHighlight)
-                        retval += TERM_NORMAL;
-                    break;
+                op.appendString(retval, fileName().baseName());
 
-#ifdef LOG_FUNCNAMES_TO_JOBLOG
-                case 'P':
-                    // The function (procedure) name in color.
-                    partFormat += 's';
-                    tmp.sprintf(
-                            STR(partFormat), 
-                            STR(functionName()));
+                if (syntaxHighlight)
+                    retval += TERM_NORMAL;
+                break;
 
-                    retval += XTERM_COLOR_BLUE;
-                    retval += tmp;
+#ifdef LOG_FUNCNAMES_TO_JOBLOG
+            case 'P':
+                // The function (procedure) name in color.
+                retval += XTERM_COLOR_BLUE;
+                op.appendString(retval, functionName());
 
-                    retval += TERM_NORMAL;
-                    break;
+                retval += TERM_NORMAL;
+                break;
 #endif
-
-                case '%':
-                    retval += '%';
-                    break;
-
-                case '0':
-                case '1':
-                case '2':
-                case '3':
-                case '4':
-                case '5':
-                case '6':
-                case '7':
-                case '8':
-                case '9':
-                case '-':
-                case '+':
-                case '.':
-                    partFormat += c;
-                    continue;
-            }
-        } else {
-            retval += c;
         }
-
-        percent = false;
-        escaped    = false;
     }
 
     return retval;
@@ -21,6 +21,7 @@
 
 #include <S9sVariantMap>
 #include <S9sDateTime>
+#include <S9sFormatProgram>
 
 class S9sMessage
 {
@@ -60,6 +61,12 @@ class S9sMessage
                 const bool       syntaxHighlight,
                 const S9sString &formatString) const;
 
+        S9sString toString(
+                const bool              syntaxHighlight,
+                const S9sFormatProgram &program) const;
+
+        static S9sFormatProgram compileFormat(const S9sString &formatString);
+
         S9sString termColorString() const;
 
     private:
@@ -20,6 +20,7 @@
 #include "s9smonitor.h"
 
 #include "S9sOptions"
+#include "S9sOutput"
 #include "S9sCluster"
 #include "S9sContainer"
 #include "S9sRpcReply"
@@ -482,17 +483,17 @@ S9sMonitor::printContainers()
                 templateFormat.printf(container.templateName("-", true));
                 stateFormat.printf(STR(container.state()));
 
-                ::printf("%s", ipColorBegin(ipAddress));
+                S9sOutput::write(ipColorBegin(ipAddress));
                 ipFormat.printf(STR(ipAddress));
-                ::printf("%s", ipColorEnd(ipAddress));
+                S9sOutput::write(ipColorEnd(ipAddress));
 
-                ::printf("%s", serverColorBegin());
+                S9sOutput::write(serverColorBegin());
                 serverFormat.printf(container.parentServerName());
-                ::printf("%s", serverColorEnd());
+                S9sOutput::write(serverColorEnd());
 
-                ::printf("%s", containerColorBegin(stateAsChar));
+                S9sOutput::write(containerColorBegin(stateAsChar));
                 aliasFormat.printf(container.alias());
-                ::printf("%s", containerColorEnd());
+                S9sOutput::write(containerColorEnd());
             } else {
                 // The line is selected, we use a highlight color.
                 ::printf("%s", XTERM_COLOR_SELECTION);
@@ -770,13 +771,13 @@ S9sMonitor::printClusters()
         
             printf("%s", clusterStateColorBegin(cluster.state()));
             stateFormat.printf(cluster.state());
-            printf("%s", clusterStateColorEnd());
+            S9sOutput::write(clusterStateColorEnd());
 
             typeFormat.printf(cluster.clusterType());
     
-            printf("%s", clusterColorBegin());
+            S9sOutput::write(clusterColorBegin());
             nameFormat.printf(cluster.name());
-            printf("%s", clusterColorEnd());
+            S9sOutput::write(clusterColorEnd());
         
             messageFormat.printf(cluster.statusText());
         }
@@ -1020,9 +1021,9 @@ S9sMonitor::printNodes()
             versionFormat.printf(node.version());
             clusterIdFormat.printf(node.clusterId());
 
-            printf("%s", clusterColorBegin());
+            S9sOutput::write(clusterColorBegin());
             clusterNameFormat.printf(clusterName);
-            printf("%s", clusterColorEnd());
+            S9sOutput::write(clusterColorEnd());
 
             hostNameFormat.printf(node.hostName());
             portFormat.printf(node.port());
@@ -1297,6 +1298,18 @@ S9sMonitor::processEventList(
     S9sOptions       *options = S9sOptions::instance();
     S9sString         output;
 
+    if (options->isNdJsonRequested())
+    {
+        // One compact object per line, flushed so the consumer at the other
+        // end of the pipe gets every event as soon as it arrives.
+        output  = event.toVariantMap().toCompactString();
+        output += '\n';
+
+        S9sOutput::write(output);
+        S9sOutput::flush();
+        return;
+    }
+
     if (options->isJsonRequested())
     {
         output = event.toVariantMap().toString();
@@ -1306,7 +1319,10 @@ S9sMonitor::processEventList(
 
     output.replace("\n", "\n\r");
     if (!output.empty())
+    {
         ::printf("\n\r%s", STR(output));
+        S9sOutput::flush();
+    }
 }
 
 /**
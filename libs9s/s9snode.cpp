@@ -162,474 +162,321 @@ S9sString
 S9sNode::toString(
         const bool       syntaxHighlight,
         const S9sString &formatString) const
+{
+    return toString(syntaxHighlight, compileFormat(formatString));
+}
+
+/**
+ * \param formatString The format string with markup.
+ * \returns The format string compiled for the toString() method, the
+ *   program can be used to print any number of nodes.
+ */
+S9sFormatProgram
+S9sNode::compileFormat(
+        const S9sString &formatString)
+{
+    return S9sFormatProgram(formatString, 'f');
+}
+
+/**
+ * \param syntaxHighlight Controls if the string will have colors or not.
+ * \param program The compiled format string.
+ * \returns The string representation according to the format string.
+ *
+ * Converts the node to a string executing the compiled format string, the
+ * format string is not parsed again for every node.
+ */
+S9sString
+S9sNode::toString(
+        const bool              syntaxHighlight,
+        const S9sFormatProgram &program) const
 {
     S9sFormatter formatter;
     S9sString    retval;
-    S9sString    tmp;
-    char         c;
-    S9sString    partFormat;
-    bool         percent      = false;
-    bool         escaped      = false;
-    bool         modifierFree = false;
-
-    for (uint n = 0; n < formatString.size(); ++n)
+
+    for (uint n = 0; n < program.size(); ++n)
     {
-        c = formatString[n];
-       
-        if (c == '%' && !percent)
-        {
-            percent    = true;
-            partFormat = "%";
-            continue;
-        } else if (percent && c == 'f')
-        {
-            modifierFree = true;
-            continue;
-        } else if (c == '\\' && !escaped)
+        const S9sFormatOp &op = program.at(n);
+
+        if (op.isLiteral())
         {
-            escaped = true;
+            retval += op.literal();
             continue;
         }
 
-        if (escaped)
+        switch (op.directive())
         {
-            switch (c)
-            {
-                case '\"':
-                    retval += '\"';
-                    break;
-
-                case '\\':
-                    retval += '\\';
-                    break;
-       
-                case 'a':
-                    retval += '\a';
-                    break;
-
-                case 'b':
-                    retval += '\b';
-                    break;
-
-                case 'e':
-                    retval += '\027';
-                    break;
-
-                case 'n':
-                    retval += '\n';
-                    break;
-
-                case 'r':
-                    retval += '\r';
-                    break;
-
-                case 't':
-                    retval += '\t';
-                    break;
-            }
-        } else if (percent)
-        {
-            switch (c)
-            {
-                case 'A':
-                    // The ip address of the node.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(ipAddress()));
-                    retval += tmp;
-                    break;
-                
-                case 'a':
-                    // Maintenance flag.
-                    partFormat += 's';
-                    
-                    tmp.sprintf(STR(partFormat), 
-                            isMaintenanceActive() ? "M" : "-");
-
-                    retval += tmp;
-                    break;
+            case 'A':
+                // The ip address of the node.
+                op.appendString(retval, ipAddress());
+                break;
+            
+            case 'a':
+                // Maintenance flag.
+                op.appendString(retval, isMaintenanceActive() ? "M" : "-");
+                break;
  
-                case 'C':
-                    // The configuration file. 
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(configFile()));
-
-                    if (syntaxHighlight)
-                        retval += S9sRpcReply::fileColorBegin(configFile());
-
-                    retval += tmp;
-
-                    if (syntaxHighlight)
-                        retval += S9sRpcReply::fileColorEnd();
-
-                    break;
-
-                case 'c':
-                    // The total number of CPU cores in the cluster.
-                    partFormat += 'd';
-                    tmp.sprintf(STR(partFormat), nCpuCores().toInt());
-                    retval += tmp;
-                    break;
-
-                case 'D':
-                    // The data directory.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(dataDir()));
-
-                    if (syntaxHighlight)
-                        retval += XTERM_COLOR_BLUE;
-
-                    retval += tmp;
-
-                    if (syntaxHighlight)
-                        retval += TERM_NORMAL;
-
-                    break;
-                
-                case 'd':
-                    // The PID file.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(pidFile()));
-
-                    if (syntaxHighlight)
-                        retval += S9sRpcReply::fileColorBegin(pidFile());
-
-                    retval += tmp;
-
-                    if (syntaxHighlight)
-                        retval += S9sRpcReply::fileColorEnd();
-
-                    break;
-                
-                case 'E':
-                    // The replication state.
-                    partFormat += "s";
-                    tmp.sprintf(STR(partFormat), STR(replicationState()));
-                    retval += tmp;
-                    break; 
+            case 'C':
+                // The configuration file. 
+                if (syntaxHighlight)
+                    retval += S9sRpcReply::fileColorBegin(configFile());
 
-                case 'G':
-                    // The name of the group owner.
-                    partFormat += 's';
-                    tmp.sprintf(
-                            STR(partFormat),
-                            STR(groupOwnerName()));
+                op.appendString(retval, configFile());
 
-                    if (syntaxHighlight)
-                        retval += S9sRpcReply::groupColorBegin();
+                if (syntaxHighlight)
+                    retval += S9sRpcReply::fileColorEnd();
 
-                    retval += tmp;
+                break;
 
-                    if (syntaxHighlight)
-                        retval += S9sRpcReply::groupColorEnd();
+            case 'c':
+                // The total number of CPU cores in the cluster.
+                op.appendInt(retval, nCpuCores().toInt());
+                break;
 
-                    break;
+            case 'D':
+                // The data directory.
+                if (syntaxHighlight)
+                    retval += XTERM_COLOR_BLUE;
+
+                op.appendString(retval, dataDir());
+
+                if (syntaxHighlight)
+                    retval += TERM_NORMAL;
 
-                case 'g':
-                    // The log file. 
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(logFile()));
+                break;
+            
+            case 'd':
+                // The PID file.
+                if (syntaxHighlight)
+                    retval += S9sRpcReply::fileColorBegin(pidFile());
+
+                op.appendString(retval, pidFile());
+
+                if (syntaxHighlight)
+                    retval += S9sRpcReply::fileColorEnd();
 
-                    if (syntaxHighlight)
-                        retval += S9sRpcReply::fileColorBegin(logFile());
+                break;
+            
+            case 'E':
+                // The replication state.
+                op.appendString(retval, replicationState());
+                break; 
 
-                    retval += tmp;
-
-                    if (syntaxHighlight)
-                        retval += S9sRpcReply::fileColorEnd();
-
-                    break;
-                
-                case 'h':
-                    // The CDT path 
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(cdtPath()));
-
-                    retval += formatter.folderColorBegin();
-                    retval += tmp;
-                    retval += formatter.folderColorEnd();
-
-                    break;
-
-                case 'I':
-                    // The ID of the node.
-                    partFormat += 'd';
-                    tmp.sprintf(STR(partFormat), id());
-
-                    retval += tmp;
-                    break;
-
-                case 'i':
-                    // The total number of monitored disk devices.
-                    partFormat += 'd';
-                    tmp.sprintf(STR(partFormat), nDevices().toInt());
-
-                    retval += tmp;
-                    break;
-
-                case 'k':
-                    // The total disk size found in the node.
-                    partFormat += 'f';
-
-                    if (modifierFree)
-                    {
-                        tmp.sprintf(
-                                STR(partFormat), 
-                                freeDiskBytes().toTBytes());
-                    } else {
-                        tmp.sprintf(
-                                STR(partFormat), 
-                                totalDiskBytes().toTBytes());
-                    }
-
-                    retval += tmp;
-                    break;
-
-                case 'N':
-                    // The name of the node.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(name()));
-
-                    if (syntaxHighlight)
-                        retval += XTERM_COLOR_BLUE;
-
-                    retval += tmp;
-
-                    if (syntaxHighlight)
-                        retval += TERM_NORMAL;
-
-                    break;
-                
-                case 'M':
-                    // The message describing the node's status. 
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(message()));
-                    retval += tmp;
-                    break;
-
-                case 'm':
-                    // The total memory size found on the host.
-                    partFormat += 'f';
-                    if (modifierFree)
-                        tmp.sprintf(STR(partFormat), memFree().toGBytes());
-                    else
-                        tmp.sprintf(STR(partFormat), memTotal().toGBytes());
-
-                    retval += tmp;
-                    break;
-
-                case 'n':
-                    // The total number of monitored network interfaces.
-                    partFormat += 'd';
-                    tmp.sprintf(STR(partFormat), nNics().toInt());
-
-                    retval += tmp;
-                    break;
-
-                case 'O':
-                    // The name of the owner.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(ownerName()));
-
-                    if (syntaxHighlight)
-                        retval += S9sRpcReply::userColorBegin();
-
-                    retval += tmp;
-
-                    if (syntaxHighlight)
-                        retval += S9sRpcReply::userColorEnd();
-
-                    break;
-
-                case 'o':
-                    // The OS version string.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(osVersionString()));
-                    retval += tmp;
-                    break;
-                
-                case 'L':
-                    // The replay location.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(replayLocation()));
-                    retval += tmp;
-                    break;
-                
-                case 'l':
-                    // The received location.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(receivedLocation()));
-                    retval += tmp;
-                    break;
-
-                case 'P':
-                    // The Port.
-                    partFormat += "d";
-                    tmp.sprintf(STR(partFormat), port());
-                    retval += tmp;
-                    break;
-                
-                case 'p':
-                    // The PID.
-                    partFormat += "d";
-                    tmp.sprintf(STR(partFormat), pid());
-                    retval += tmp;
-                    break;
-                
-                case 'R':
-                    // The role.
-                    partFormat += "s";
-                    tmp.sprintf(STR(partFormat), STR(role()));
-                    retval += tmp;
-                    break;
-                
-                case 'r':
-                    // A string 'read-only' or 'read-write'.
-                    partFormat += "s";
-                    tmp.sprintf(STR(partFormat), 
-                            readOnly() ? "read-only" : "read-write");
-                    retval += tmp;
-                    break;
-
-                case 'S':
-                    // The state of the node.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(hostStatus()));
-
-                    if (syntaxHighlight)
-                    {
-                        retval += 
-                            S9sRpcReply::hostStateColorBegin(hostStatus());
-                    }
-
-                    retval += tmp;
-
-                    if (syntaxHighlight)
-                        retval += S9sRpcReply::hostStateColorEnd();
-
-                    break;
-                
-                case 's':
-                    // The list of slaves in one string.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(slavesAsString()));
-                    retval += tmp;
-                
-                    break;
-
-                case 'T':
-                    // The type of the node.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(nodeType()));
-                    retval += tmp;
-                    break;
-
-                case 't':
-                    // The network traffic found in the cluster.
-                    partFormat += 'f';
-                    tmp.sprintf(STR(partFormat), 
-                            netBytesPerSecond().toMBytes());
-
-                    retval += tmp;
-                    break;
+            case 'G':
+                // The name of the group owner.
+                if (syntaxHighlight)
+                    retval += S9sRpcReply::groupColorBegin();
+
+                op.appendString(retval, groupOwnerName());
+
+                if (syntaxHighlight)
+                    retval += S9sRpcReply::groupColorEnd();
+
+                break;
+
+            case 'g':
+                // The log file. 
+                if (syntaxHighlight)
+                    retval += S9sRpcReply::fileColorBegin(logFile());
+
+                op.appendString(retval, logFile());
+
+                if (syntaxHighlight)
+                    retval += S9sRpcReply::fileColorEnd();
+
+                break;
+            
+            case 'h':
+                // The CDT path 
+                retval += formatter.folderColorBegin();
+                op.appendString(retval, cdtPath());
+                retval += formatter.folderColorEnd();
+
+                break;
+
+            case 'I':
+                // The ID of the node.
+                op.appendInt(retval, id());
+                break;
+
+            case 'i':
+                // The total number of monitored disk devices.
+                op.appendInt(retval, nDevices().toInt());
+                break;
+
+            case 'k':
+                // The total disk size found in the node.
+                if (op.isModified())
+                {
+                    op.appendDouble(retval, freeDiskBytes().toTBytes());
+                } else {
+                    op.appendDouble(retval, totalDiskBytes().toTBytes());
+                }
+
+                break;
+
+            case 'N':
+                // The name of the node.
+                if (syntaxHighlight)
+                    retval += XTERM_COLOR_BLUE;
+
+                op.appendString(retval, name());
+
+                if (syntaxHighlight)
+                    retval += TERM_NORMAL;
+
+                break;
+            
+            case 'M':
+                // The message describing the node's status. 
+                op.appendString(retval, message());
+                break;
+
+            case 'm':
+                // The total memory size found on the host.
+                if (op.isModified())
+                    op.appendDouble(retval, memFree().toGBytes());
+                else
+                    op.appendDouble(retval, memTotal().toGBytes());
+
+                break;
+
+            case 'n':
+                // The total number of monitored network interfaces.
+                op.appendInt(retval, nNics().toInt());
+                break;
+
+            case 'O':
+                // The name of the owner.
+                if (syntaxHighlight)
+                    retval += S9sRpcReply::userColorBegin();
+
+                op.appendString(retval, ownerName());
+
+                if (syntaxHighlight)
+                    retval += S9sRpcReply::userColorEnd();
+
+                break;
+
+            case 'o':
+                // The OS version string.
+                op.appendString(retval, osVersionString());
+                break;
+            
+            case 'L':
+                // The replay location.
+                op.appendString(retval, replayLocation());
+                break;
+            
+            case 'l':
+                // The received location.
+                op.appendString(retval, receivedLocation());
+                break;
+
+            case 'P':
+                // The Port.
+                op.appendInt(retval, port());
+                break;
+            
+            case 'p':
+                // The PID.
+                op.appendInt(retval, pid());
+                break;
+            
+            case 'R':
+                // The role.
+                op.appendString(retval, role());
+                break;
+            
+            case 'r':
+                // A string 'read-only' or 'read-write'.
+                op.appendString(
+                        retval, readOnly() ? "read-only" : "read-write");
+                break;
+
+            case 'S':
+                // The state of the node.
+                if (syntaxHighlight)
+                {
+                    retval += 
+                        S9sRpcReply::hostStateColorBegin(hostStatus());
+                }
+
+                op.appendString(retval, hostStatus());
+
+                if (syntaxHighlight)
+                    retval += S9sRpcReply::hostStateColorEnd();
+
+                break;
+            
+            case 's':
+                // The list of slaves in one string.
+                op.appendString(retval, slavesAsString());
+            
+                break;
+
+            case 'T':
+                // The type of the node.
+                op.appendString(retval, nodeType());
+                break;
+
+            case 't':
+                // The network traffic found in the cluster.
+                op.appendDouble(retval, netBytesPerSecond().toMBytes());
+                break;
 
 #if 0
-                case 'U':
-                    // The uptime.
-                    partFormat += "s";
-                    tmp.sprintf(STR(partFormat), 
-                            STR(S9sString::uptime(uptime())));
-                    retval += tmp;
-                    break;
+            case 'U':
+                // The uptime.
+                op.appendString(retval, S9sString::uptime(uptime()));
+                break;
 #endif
-                case 'V':
-                    // The version.
-                    partFormat += "s";
-                    tmp.sprintf(STR(partFormat), STR(version()));
-                    retval += tmp;
-                    break;
-                
-                case 'v':
-                    // The container/vm ID.
-                    partFormat += "s";
-                    tmp.sprintf(STR(partFormat), STR(containerId("-")));
-                    retval += tmp;
-                    break;
-
-                case 'U':
-                    // The number of CPUs.
-                    partFormat += 'd';
-                    tmp.sprintf(STR(partFormat), nCpus().toInt());
-                    retval += tmp;
-                    break;
-
-                case 'u':
-                    // The cpu usage percent. 
-                    partFormat += 'f';
-                    tmp.sprintf(STR(partFormat), cpuUsagePercent().toDouble());
-                    retval += tmp;
-                    break;
-
-                case 'w':
-                    // The total swap space found in the host.
-                    partFormat += 'f';
-                    if (modifierFree)
-                        tmp.sprintf(STR(partFormat), swapTotal().toGBytes());
-                    else
-                        tmp.sprintf(STR(partFormat), swapFree().toGBytes());
-
-                    retval += tmp;
-                    break;
-
-                case 'Z':
-                    // The CPU model.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(cpuModel()));
-                    retval += tmp;
-                    break;
+            case 'V':
+                // The version.
+                op.appendString(retval, version());
+                break;
+            
+            case 'v':
+                // The container/vm ID.
+                op.appendString(retval, containerId("-"));
+                break;
+
+            case 'U':
+                // The number of CPUs.
+                op.appendInt(retval, nCpus().toInt());
+                break;
+
+            case 'u':
+                // The cpu usage percent. 
+                op.appendDouble(retval, cpuUsagePercent().toDouble());
+                break;
+
+            case 'w':
+                // The total swap space found in the host.
+                if (op.isModified())
+                    op.appendDouble(retval, swapTotal().toGBytes());
+                else
+                    op.appendDouble(retval, swapFree().toGBytes());
+
+                break;
+
+            case 'Z':
+                // The CPU model.
+                op.appendString(retval, cpuModel());
+                break;
+            
+            case 'z':
+                // The class name.
+                if (syntaxHighlight)
+                    retval += XTERM_COLOR_GREEN;
+
+                op.appendString(retval, className());
+
+                if (syntaxHighlight)
+                    retval += TERM_NORMAL;
                 
-                case 'z':
-                    // The class name.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(className()));
-                    
-                    if (syntaxHighlight)
-                        retval += XTERM_COLOR_GREEN;
-
-                    retval += tmp;
-
-                    if (syntaxHighlight)
-                        retval += TERM_NORMAL;
-                    
-                    break;
-
-                case '%':
-                    retval += '%';
-                    break;
-
-                case '0':
-                case '1':
-                case '2':
-                case '3':
-                case '4':
-                case '5':
-                case '6':
-                case '7':
-                case '8':
-                case '9':
-                case '-':
-                case '+':
-                case '.':
-                case '\'':
-                    partFormat += c;
-                    continue;
-            }
-        } else {
-            retval += c;
+                break;
         }
-
-        percent      = false;
-        escaped      = false;
-        modifierFree = false;
     }
 
     return retval;
@@ -1120,38 +967,24 @@ S9sNode::uptime() const
 S9sString
 S9sNode::replicationState() const
 {
+    static const S9sVariantPath galeraPath("galera/localstatusstr");
+    static const S9sVariantPath masterPath(
+            "replication_master/semisync_status");
+    static const S9sVariantPath slavePath(
+            "replication_slave/semisync_status");
     S9sString retval;
 
     if (m_properties.contains("replication_state"))
         retval = m_properties.at("replication_state").toString();
 
     if (m_properties.contains("galera"))
-    {
-        S9sVariantMap map;
-        
-        map = m_properties.at("galera").toVariantMap();
-        retval = map["localstatusstr"].toString().toLower();
-    }
-
-    if (retval.empty() && m_properties.contains("replication_master"))
-    {
-        S9sVariantMap map;
-        
-        map = m_properties.at("replication_master").toVariantMap();
+        retval = m_properties.valueByPath(galeraPath).toString().toLower();
 
-        if (map["semisync_status"] == "ON")
-            retval = "semisync";
-    } 
+    if (retval.empty() && m_properties.valueByPath(masterPath) == "ON")
+        retval = "semisync";
     
-    if (retval.empty() && m_properties.contains("replication_slave"))
-    {
-        S9sVariantMap map;
-        
-        map = m_properties.at("replication_slave").toVariantMap();
-
-        if (map["semisync_status"] == "ON")
-            retval = "semisync";
-    } 
+    if (retval.empty() && m_properties.valueByPath(slavePath) == "ON")
+        retval = "semisync";
 
     if (retval.empty() && m_properties.contains("connected_slaves"))
     {
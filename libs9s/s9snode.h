@@ -23,6 +23,7 @@
 #include "S9sVariantMap"
 #include "S9sUrl"
 #include "S9sCluster"
+#include "S9sFormatProgram"
 
 class S9sSshCredentials;
 
@@ -55,6 +56,13 @@ class S9sNode : public S9sObject
                 const bool       syntaxHighlight,
                 const S9sString &formatString) const;
 
+        S9sString 
+            toString(
+                const bool              syntaxHighlight,
+                const S9sFormatProgram &program) const;
+
+        static S9sFormatProgram compileFormat(const S9sString &formatString);
+
         virtual int id() const;
         int clusterId() const;
         virtual S9sString name() const;
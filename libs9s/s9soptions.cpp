@@ -23,6 +23,7 @@
 #include "S9sNode"
 #include "S9sAccount"
 #include "S9sFile"
+#include "S9sOutput"
 #include "S9sRegExp"
 #include "S9sDir"
 #include "s9srsakey.h"
@@ -54,6 +55,7 @@ enum S9sOptionType
 {
     OptionRpcTls     = 1000,
     OptionPrintJson,
+    OptionPrintNdJson,
     OptionColor,
     OptionConfigFile,
     OptionTop,
@@ -560,37 +562,35 @@ S9sOptions::loadConfigFiles()
  * \param url the Cmon Controller host or host:port or protocol://host:port.
  *
  * Sets the controller host name. If the passed string has the format
- * HOSTNAME:PORT sets the controller port too.
+ * HOSTNAME:PORT sets the controller port too. The url can be a comma separated
+ * list of controllers, the first is the one that is used by default, the
+ * others are used when it is not available (see failoverControllers()).
  */
 void
 S9sOptions::setController(
         const S9sString &url)
 {
-    S9sString myUrl = url;
-    S9sRegExp regexp;
+    S9sVariantList urls = url.split(",");
+    S9sVariantList failoverControllers;
+    S9sVariantMap  controller;
 
-    S9S_DEBUG("              myUrl  : '%s'", STR(myUrl));
-    regexp = "([a-zA-Z]+):\\/\\/(.+)";
-    if (regexp == myUrl)
-    {
-        /*
-        S9S_DEBUG("    MATCH1 '%s', '%s'", 
-                STR(regexp[1]), 
-                STR(regexp[2]));
-                */
+    for (uint idx = 1u; idx < urls.size(); ++idx)
+        failoverControllers << parseControllerUrl(urls[idx].toString());
 
-        m_options["controller_protocol"] = regexp[1];
-        myUrl = regexp[2];
+    m_options["failover_controllers"] = failoverControllers;
+
+    controller = parseControllerUrl(urls.empty() ? url : urls[0].toString());
+    if (controller.contains("controller_protocol"))
+    {
+        m_options["controller_protocol"] = 
+            controller["controller_protocol"];
     }
  
-    regexp = "(.+):([0-9]+)(\\/.*)?";
-    if (regexp == myUrl)
+    m_options["controller"] = controller["controller"];
+    if (controller.contains("controller_port"))
     {
-        m_options["controller"]      = regexp[1];
-        m_options["controller_port"] = regexp[2].toInt();
-        m_options["controller_path"] = regexp[3];
-    } else {
-        m_options["controller"] = myUrl;
+        m_options["controller_port"] = controller["controller_port"];
+        m_options["controller_path"] = controller["controller_path"];
     }
     
     S9S_DEBUG("  controller_protocol : '%s'", 
@@ -606,6 +606,106 @@ S9sOptions::setController(
             STR(m_options["controller_path"].toString()));
 }
 
+/**
+ * \param url The URL of one controller, protocol://host:port/path.
+ * \returns The parts of the URL, the same keys setController() sets in the
+ *   options.
+ *
+ * The IPv6 addresses should be in brackets (e.g. "https://[::1]:9501"), the
+ * port and the path are optional.
+ */
+S9sVariantMap
+S9sOptions::parseControllerUrl(
+        const S9sString &url) const
+{
+    S9sVariantMap retval;
+    S9sString     myUrl = url.trim();
+    S9sString     hostName;
+    S9sString     rest;
+    S9sString     port;
+    S9sString     path;
+    size_t        position;
+    S9sRegExp     regexp;
+
+    S9S_DEBUG("              myUrl  : '%s'", STR(myUrl));
+    regexp = "([a-zA-Z]+):\\/\\/(.+)";
+    if (regexp == myUrl)
+    {
+        retval["controller_protocol"] = regexp[1];
+        myUrl = regexp[2];
+    }
+
+    /*
+     * The host name, a bracketed IPv6 address ends at the closing bracket,
+     * the others at the colon before the port or at the path.
+     */
+    if (myUrl.startsWith("[") && myUrl.find(']') != std::string::npos)
+    {
+        position = myUrl.find(']');
+        hostName = myUrl.substr(1, position - 1);
+        rest     = myUrl.substr(position + 1);
+    } else {
+        position = myUrl.find('/');
+        hostName = myUrl.substr(0, position);
+        
+        if (position != std::string::npos)
+            rest = myUrl.substr(position);
+
+        position = hostName.rfind(':');
+        if (position != std::string::npos)
+        {
+            rest     = hostName.substr(position) + rest;
+            hostName = hostName.substr(0, position);
+        }
+    }
+
+    // The optional port and the optional path.
+    position = rest.find('/');
+    if (position != std::string::npos)
+    {
+        path = rest.substr(position);
+        rest = rest.substr(0, position);
+    }
+
+    if (rest.startsWith(":"))
+        port = rest.substr(1);
+
+    if ((!rest.empty() && port.empty()) ||
+            port.find_first_not_of("0123456789") != std::string::npos)
+    {
+        // Not a valid URL, we use it as it is.
+        hostName = myUrl;
+        port.clear();
+        path.clear();
+    }
+
+    if (!port.empty())
+        retval["controller_port"] = port.toInt();
+
+    if (!port.empty() || !path.empty())
+        retval["controller_path"] = path;
+
+    retval["controller"] = hostName;
+
+    return retval;
+}
+
+/**
+ * \returns The controllers that are used when the controller is not available,
+ *   the ones after the first in the comma separated list of the controller
+ *   URLs. The list items are maps as parseControllerUrl() returns them.
+ */
+S9sVariantList
+S9sOptions::failoverControllers()
+{
+    checkController();
+
+    if (m_options.contains("failover_controllers"))
+        return m_options.at("failover_controllers").toVariantList();
+
+    return S9sVariantList();
+}
+
 void
 S9sOptions::checkController()
 {
@@ -3699,6 +3799,16 @@ S9sOptions::isJsonRequested() const
     return getBool("print_json");
 }
 
+/**
+ * \returns true if the --print-ndjson command line option was provided when
+ *   the program was started.
+ */
+bool
+S9sOptions::isNdJsonRequested() const
+{
+    return getBool("print_ndjson");
+}
+
 /**
  * \returns true if the --top command line option was provided when starting the
  *   program.
@@ -4018,6 +4128,151 @@ S9sOptions::useTls()
 
     return retval.toBoolean();
 }
+
+/**
+ * \returns true if the client should ask the controller to compress the
+ *   replies (gzip or deflate).
+ */
+bool
+S9sOptions::useCompression()
+{
+    S9sString retval;
+
+    if (m_options.contains("rpc_compression"))
+    {
+        retval = m_options.at("rpc_compression").toString();
+    } else {
+        retval = m_userConfig.variableValue("rpc_compression");
+
+        if (retval.empty())
+            retval = m_systemConfig.variableValue("rpc_compression");
+    }
+
+    return retval.toBoolean();
+}
+
+/**
+ * \returns How long (in ms) connecting to the controller may take, the
+ *   rpc_connect_timeout configuration value (in seconds), 0 if not set.
+ */
+int
+S9sOptions::rpcConnectTimeout()
+{
+    S9sString value;
+
+    value = m_userConfig.variableValue("rpc_connect_timeout");
+    if (value.empty())
+        value = m_systemConfig.variableValue("rpc_connect_timeout");
+
+    return (int) (value.toDouble() * 1000.0);
+}
+
+/**
+ * \returns How long (in ms) the client waits for the controller to send
+ *   something, the rpc_timeout configuration value (in seconds), 0 if not set.
+ */
+int
+S9sOptions::rpcTimeout()
+{
+    S9sString value;
+
+    value = m_userConfig.variableValue("rpc_timeout");
+    if (value.empty())
+        value = m_systemConfig.variableValue("rpc_timeout");
+
+    return (int) (value.toDouble() * 1000.0);
+}
+
+/**
+ * \returns true if the client should keep the connection to the controller
+ *   open between the RPC requests (HTTP/1.1 keep-alive).
+ */
+bool
+S9sOptions::useKeepAlive()
+{
+    S9sString retval;
+
+    if (m_options.contains("rpc_keep_alive"))
+    {
+        retval = m_options.at("rpc_keep_alive").toString();
+    } else {
+        retval = m_userConfig.variableValue("rpc_keep_alive");
+
+        if (retval.empty())
+            retval = m_systemConfig.variableValue("rpc_keep_alive");
+    }
+
+    return retval.toBoolean();
+}
+
+/**
+ * \returns The file where the TLS session is saved so that the next s9s
+ *   process can resume it or the empty string if the rpc_tls_session_cache is
+ *   not set.
+ */
+S9sString
+S9sOptions::tlsSessionFile()
+{
+    S9sString value;
+    S9sString retval;
+
+    value = m_userConfig.variableValue("rpc_tls_session_cache");
+    if (value.empty())
+        value = m_systemConfig.variableValue("rpc_tls_session_cache");
+
+    if (!value.toBoolean())
+        return retval;
+
+    retval.sprintf("~/.s9s/%s_%d.tls_session", 
+            STR(controllerHostName()), controllerPort());
+
+    return retval;
+}
+
+/**
+ * \returns The file where the authenticated session is saved for the next s9s
+ *   processes or the empty string if the rpc_session_cache is not set.
+ */
+S9sString
+S9sOptions::sessionFile()
+{
+    S9sString value;
+    S9sString retval;
+
+    value = m_userConfig.variableValue("rpc_session_cache");
+    if (value.empty())
+        value = m_systemConfig.variableValue("rpc_session_cache");
+
+    if (!value.toBoolean() || userName().empty())
+        return retval;
+
+    retval.sprintf("~/.s9s/%s@%s_%d.session", 
+            STR(userName()), STR(controllerHostName()), controllerPort());
+
+    return retval;
+}
+
+/**
+ * \returns How long (in seconds) the saved session is used before
+ *   authenticating again, the rpc_session_cache_lifetime configuration value.
+ */
+int
+S9sOptions::sessionLifetime()
+{
+    int retval;
+
+    retval = m_userConfig.variableValue("rpc_session_cache_lifetime").toInt();
+    if (retval <= 0)
+    {
+        retval = m_systemConfig.variableValue(
+                "rpc_session_cache_lifetime").toInt();
+    }
+
+    if (retval <= 0)
+        retval = 1800;
+
+    return retval;
+}
 /**
  * \returns a human readable error description stored inside the object.
  */
@@ -4065,6 +4320,8 @@ S9sOptions::printError(
     theString.vsprintf(formatString, arguments);
     va_end(arguments);
 
+    // The standard output is buffered, what was printed before comes first.
+    S9sOutput::flush();
     fprintf(stderr, "%s\n", STR(theString));
     fflush(stderr);
 }
@@ -4459,6 +4716,7 @@ S9sOptions::printHelpGeneric()
 "  --no-header                Do not print headers.\n"
 "  --only-ascii               Do not use UTF8 characters.\n"
 "  --print-json               Print the sent/received JSon messages.\n"
+"  --print-ndjson             Print the listed objects one per line.\n"
 "\n"
 "Job related options:\n"
 "  --log                      Wait and monitor job messages.\n"
@@ -5009,6 +5267,7 @@ S9sOptions::readOptionsNode(
         { "rpc-tls",          no_argument,       0, OptionRpcTls          },
         { "long",             no_argument,       0, 'l'                   },
         { "print-json",       no_argument,       0, OptionPrintJson       },
+        { "print-ndjson",     no_argument,       0, OptionPrintNdJson     },
         { "color",            optional_argument, 0, OptionColor           },
         { "config-file",      required_argument, 0,  4                    },
         { "no-header",        no_argument,       0, OptionNoHeader        },
@@ -5247,6 +5506,11 @@ S9sOptions::readOptionsNode(
                 m_options["print_json"] = true;
                 break;
 
+            case OptionPrintNdJson:
+                // --print-ndjson
+                m_options["print_ndjson"] = true;
+                break;
+
             case OptionRpcTls:
                 // --rpc-tls
                 m_options["rpc_tls"] = true;
@@ -5370,6 +5634,7 @@ S9sOptions::readOptionsBackup(
         { "long",             no_argument,       0, 'l'                   },
         { "password",         required_argument, 0, 'p'                   }, 
         { "print-json",       no_argument,       0, OptionPrintJson       },
+        { "print-ndjson",     no_argument,       0, OptionPrintNdJson     },
         { "private-key-file", required_argument, 0, OptionPrivateKeyFile  }, 
         { "rpc-tls",          no_argument,       0, OptionRpcTls          },
         { "time-style",       required_argument, 0, OptionTimeStyle       },
@@ -5626,6 +5891,11 @@ S9sOptions::readOptionsBackup(
                 m_options["print_json"] = true;
                 break;
 
+            case OptionPrintNdJson:
+                // --print-ndjson
+                m_options["print_ndjson"] = true;
+                break;
+
             case OptionRpcTls:
                 // --rpc-tls
                 m_options["rpc_tls"] = true;
@@ -5975,6 +6245,7 @@ S9sOptions::readOptionsLog(
         { "rpc-tls",          no_argument,       0, OptionRpcTls          },
         { "long",             no_argument,       0, 'l'                   },
         { "print-json",       no_argument,       0, OptionPrintJson       },
+        { "print-ndjson",     no_argument,       0, OptionPrintNdJson     },
         { "color",            optional_argument, 0, OptionColor           },
         { "config-file",      required_argument, 0,  4                    },
         { "no-header",        no_argument,       0, OptionNoHeader        },
@@ -6105,6 +6376,11 @@ S9sOptions::readOptionsLog(
                 m_options["print_json"] = true;
                 break;
 
+            case OptionPrintNdJson:
+                // --print-ndjson
+                m_options["print_ndjson"] = true;
+                break;
+
             case OptionRpcTls:
                 // --rpc-tls
                 m_options["rpc_tls"] = true;
@@ -6196,6 +6472,7 @@ S9sOptions::readOptionsEvent(
         { "rpc-tls",          no_argument,       0, OptionRpcTls          },
         { "long",             no_argument,       0, 'l'                   },
         { "print-json",       no_argument,       0, OptionPrintJson       },
+        { "print-ndjson",     no_argument,       0, OptionPrintNdJson     },
         { "color",            optional_argument, 0, OptionColor           },
         { "config-file",      required_argument, 0,  4                    },
         { "no-header",        no_argument,       0, OptionNoHeader        },
@@ -6366,6 +6643,11 @@ S9sOptions::readOptionsEvent(
                 m_options["print_json"] = true;
                 break;
 
+            case OptionPrintNdJson:
+                // --print-ndjson
+                m_options["print_ndjson"] = true;
+                break;
+
             case OptionRpcTls:
                 // --rpc-tls
                 m_options["rpc_tls"] = true;
@@ -6572,6 +6854,7 @@ S9sOptions::readOptionsAlarm(
         { "rpc-tls",          no_argument,       0, OptionRpcTls          },
         { "long",             no_argument,       0, 'l'                   },
         { "print-json",       no_argument,       0, OptionPrintJson       },
+        { "print-ndjson",     no_argument,       0, OptionPrintNdJson     },
         { "color",            optional_argument, 0, OptionColor           },
         { "config-file",      required_argument, 0,  4                    },
         { "no-header",        no_argument,       0, OptionNoHeader        },
@@ -6696,6 +6979,11 @@ S9sOptions::readOptionsAlarm(
                 m_options["print_json"] = true;
                 break;
 
+            case OptionPrintNdJson:
+                // --print-ndjson
+                m_options["print_ndjson"] = true;
+                break;
+
             case OptionRpcTls:
                 // --rpc-tls
                 m_options["rpc_tls"] = true;
@@ -9254,6 +9542,7 @@ S9sOptions::readOptionsContainer(
         { "rpc-tls",          no_argument,       0,  OptionRpcTls         },
         { "long",             no_argument,       0, 'l'                   },
         { "print-json",       no_argument,       0, OptionPrintJson       },
+        { "print-ndjson",     no_argument,       0, OptionPrintNdJson     },
         { "color",            optional_argument, 0, OptionColor           },
         { "human-readable",   no_argument,       0, 'h'                   },
         { "config-file",      required_argument, 0, OptionConfigFile      },
@@ -9384,6 +9673,11 @@ S9sOptions::readOptionsContainer(
                 // --print-json
                 m_options["print_json"] = true;
                 break;
+
+            case OptionPrintNdJson:
+                // --print-ndjson
+                m_options["print_ndjson"] = true;
+                break;
             
             case OptionWait:
                 // --wait
@@ -9608,6 +9902,7 @@ S9sOptions::readOptionsJob(
         { "rpc-tls",          no_argument,       0,  6                    },
         { "long",             no_argument,       0, 'l'                   },
         { "print-json",       no_argument,       0,  OptionPrintJson      },
+        { "print-ndjson",     no_argument,       0,  OptionPrintNdJson    },
         { "config-file",      required_argument, 0,  OptionConfigFile     },
         { "color",            optional_argument, 0,  OptionColor          },
         { "date-format",      required_argument, 0,  OptionDateFormat     },
@@ -9761,6 +10056,11 @@ S9sOptions::readOptionsJob(
                 // --print-json
                 m_options["print_json"] = true;
                 break;
+
+            case OptionPrintNdJson:
+                // --print-ndjson
+                m_options["print_ndjson"] = true;
+                break;
             
             case OptionBatch:
                 // --batch
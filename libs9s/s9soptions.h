@@ -92,6 +92,7 @@ class S9sOptions
         int controllerPort();
         S9sString controllerProtocol();
         S9sString controllerPath();
+        S9sVariantList failoverControllers();
 
         S9sString controllerUrl();
 
@@ -305,6 +306,13 @@ class S9sOptions
         bool backupDatadir() const;
 
         bool useTls();
+        bool useKeepAlive();
+        bool useCompression();
+        int rpcConnectTimeout();
+        int rpcTimeout();
+        S9sString tlsSessionFile();
+        S9sString sessionFile();
+        int sessionLifetime();
 
         bool isNodeOperation() const;
         bool isLogOperation() const;
@@ -427,6 +435,7 @@ class S9sOptions
 
         bool isLongRequested() const;
         bool isJsonRequested() const;
+        bool isNdJsonRequested() const;
         bool isTopRequested() const;
         bool isWaitRequested() const;
         bool isBatchRequested() const;
@@ -480,6 +489,7 @@ class S9sOptions
 
     private:
         void checkController();
+        S9sVariantMap parseControllerUrl(const S9sString &url) const;
         void printHelpGeneric();
         void printHelpCluster();
         void printHelpContainer();
@@ -574,4 +584,5 @@ class S9sOptions
 
     friend class UtS9sOptions;
     friend class UtS9sRpcClient;
+    friend class UtS9sTable;
 };
@@ -0,0 +1,42 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2018  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "s9soutput.h"
+
+char S9sOutput::sm_buffer[S9S_OUTPUT_BUFFER_SIZE];
+
+/**
+ * Sets up the buffer of the standard output. This has to be called before
+ * anything is printed.
+ */
+void
+S9sOutput::init()
+{
+    setvbuf(stdout, sm_buffer, _IOFBF, sizeof(sm_buffer));
+}
+
+/**
+ * Writes the buffered output, called before the program waits so that the
+ * user sees everything that was printed.
+ */
+void
+S9sOutput::flush()
+{
+    fflush(stdout);
+}
@@ -0,0 +1,81 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2018  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstdio>
+#include <cstring>
+
+#include "S9sString"
+
+#define S9S_OUTPUT_BUFFER_SIZE (256 * 1024)
+
+/**
+ * The sink the list printers, the formats and the screens write into. The
+ * output goes into a large buffer that is written with one write() when it is
+ * full or when the output is flushed: at the end of a screen, before the
+ * program waits for the controller or for the user and when the program exits.
+ *
+ * The buffer is the buffer of the standard output, so the parts of the program
+ * that still use printf() write into the same buffer and the order of the
+ * output is kept.
+ */
+class S9sOutput
+{
+    public:
+        static void init();
+
+        static void write(const char *string);
+        static void write(const char *data, size_t length);
+        static void write(const S9sString &string);
+        static void flush();
+
+    private:
+        static char sm_buffer[S9S_OUTPUT_BUFFER_SIZE];
+};
+
+/**
+ * \param string The null terminated string to write, NULL writes nothing.
+ */
+inline void
+S9sOutput::write(
+        const char *string)
+{
+    if (string != NULL)
+        write(string, strlen(string));
+}
+
+/**
+ * \param data The bytes to write.
+ * \param length The number of bytes.
+ */
+inline void
+S9sOutput::write(
+        const char *data,
+        size_t      length)
+{
+    fwrite(data, 1, length, stdout);
+}
+
+inline void
+S9sOutput::write(
+        const S9sString &string)
+{
+    write(string.c_str(), string.length());
+}
@@ -20,6 +20,45 @@ S9sParseContext::S9sParseContext(
     m_currentToken = 0;
 }
 
+/**
+ * \param input The string to parse, it is not copied, it has to be valid
+ *   while the parser is running.
+ * \param length The number of bytes to parse.
+ *
+ * A constructor to parse a string that is already in the memory (e.g. in the
+ * buffer of the network reply) without copying it.
+ */
+S9sParseContext::S9sParseContext(
+        const char *input,
+        size_t      length) :
+    m_flex_scanner(0)
+{
+    m_states.push(S9sParseContextState());
+    m_states.top().m_inputData   = input;
+    m_states.top().m_inputLength = length;
+
+    m_currentToken = 0;
+}
+
+/**
+ * \param reader The function that is called to read the input.
+ * \param userData The pointer passed to the reader function.
+ *
+ * A constructor to parse an input that is produced while it is parsed, e.g.
+ * decompressed chunk by chunk.
+ */
+S9sParseContext::S9sParseContext(
+        S9sParseReader  reader,
+        void           *userData) :
+    m_flex_scanner(0)
+{
+    m_states.push(S9sParseContextState());
+    m_states.top().m_reader     = reader;
+    m_states.top().m_readerData = userData;
+
+    m_currentToken = 0;
+}
+
 S9sParseContext::S9sParseContext(
         const S9sParseContext &orig) :
     m_flex_scanner(0)
@@ -44,6 +83,10 @@ S9sParseContext::setInput(
         m_states.push(S9sParseContextState());
 
     m_states.top().m_inputString  = input;
+    m_states.top().m_inputData    = 0;
+    m_states.top().m_inputLength  = 0;
+    m_states.top().m_reader       = 0;
+    m_states.top().m_readerData   = 0;
     m_states.top().m_parserCursor = 0;
 }
 
@@ -54,10 +97,13 @@ S9sParseContext::setInput(
 S9sString 
 S9sParseContext::input() const
 {
-    if (m_states.empty())
-        return m_lastState.m_inputString;
+    const S9sParseContextState &state = 
+        m_states.empty() ? m_lastState : m_states.top();
 
-    return m_states.top().m_inputString;
+    if (state.m_inputData != 0)
+        return S9sString(std::string(state.m_inputData, state.m_inputLength));
+
+    return state.m_inputString;
 }
 
 /**
@@ -255,9 +301,21 @@ S9sParseContext::yyinput(
         return 0;
     }
 
+    if (m_states.top().m_reader != 0)
+    {
+        return m_states.top().m_reader(
+                buffer, maxsize, m_states.top().m_readerData);
+    }
+
     const char *data = STR(m_states.top().m_inputString);
     int         dataLength = m_states.top().m_inputString.length();
 
+    if (m_states.top().m_inputData != 0)
+    {
+        data       = m_states.top().m_inputData;
+        dataLength = m_states.top().m_inputLength;
+    }
+
     int numBytes = maxsize;
     if (numBytes > dataLength - m_states.top().m_parserCursor)
         numBytes = dataLength - m_states.top().m_parserCursor;
@@ -13,6 +13,8 @@ class S9sParseContext
 {
     public:
         S9sParseContext(const char *input);
+        S9sParseContext(const char *input, size_t length);
+        S9sParseContext(S9sParseReader reader, void *userData);
         S9sParseContext(const S9sParseContext &orig);
         virtual ~S9sParseContext();
 
@@ -5,6 +5,13 @@
 
 #include "S9sString"
 
+/**
+ * A function that the parser calls to read the next chunk of the input when
+ * the input is not in the memory (e.g. it is decompressed while parsing). It
+ * returns the number of bytes placed into the buffer, 0 at the end.
+ */
+typedef int (*S9sParseReader)(char *buffer, int maxSize, void *userData);
+
 /**
  * A state that is used by the CmonParseContext to represent one input
  * file/string. These are used in a stack when the parser supports include
@@ -16,6 +23,10 @@ class S9sParseContextState
         S9sParseContextState();
 
         S9sString    m_inputString;
+        const char  *m_inputData;
+        size_t       m_inputLength;
+        S9sParseReader m_reader;
+        void        *m_readerData;
         int          m_parserCursor;
         int          m_currentLineNumber;
         S9sString    m_fileName;
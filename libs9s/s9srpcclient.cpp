@@ -29,15 +29,19 @@
 #include "S9sFile"
 #include "S9sSshCredentials"
 #include "S9sContainer"
+#include "S9sEventLoop"
+#include "S9sInflater"
+#include "S9sArena"
 
 #include <cstring>
 #include <cstdio>
+#include <utility>
+#include <poll.h>
 
 //#define DEBUG
 //#define WARNING
 #include "s9sdebug.h"
 
-#define READ_SIZE 10240
 //#define SEND_NODES
 
 /**
@@ -118,6 +122,261 @@ S9sRpcClient::operator= (
 	return *this;
 }
 
+/**
+ * \param keepAlive true if the connection to the controller should be kept
+ *   open and reused by the subsequent requests.
+ *
+ * When keep-alive is enabled the requests are sent using HTTP/1.1 and the
+ * connection is closed only if the controller requests so. If the controller
+ * closes the idle connection the client reconnects transparently.
+ */
+void
+S9sRpcClient::setKeepAlive(
+        const bool keepAlive)
+{
+    m_priv->m_keepAlive = keepAlive;
+}
+
+/**
+ * \param compression true if the controller may send the replies compressed.
+ *
+ * With compression enabled the requests are sent with an "Accept-Encoding:
+ * gzip, deflate" header and the compressed replies are decompressed while the
+ * JSON string is parsed. The streamed replies are never compressed.
+ */
+void
+S9sRpcClient::setCompression(
+        const bool compression)
+{
+    m_priv->m_compression = compression;
+}
+
+/**
+ * \param connectTimeout How long (in ms) the connection to the controller may
+ *   take, the TLS handshake included.
+ * \param readTimeout How long (in ms) the client waits for the controller to
+ *   send something.
+ *
+ * The zero or negative values leave the defaults in place. A short connect
+ * timeout makes the failover to the next controller quick.
+ */
+void
+S9sRpcClient::setTimeouts(
+        const int connectTimeout,
+        const int readTimeout)
+{
+    if (connectTimeout > 0)
+        m_priv->m_connectTimeout = connectTimeout;
+
+    if (readTimeout > 0)
+        m_priv->m_readTimeout = readTimeout;
+}
+
+/**
+ * \param hostName The host name of the controller.
+ * \param port The port of the controller.
+ * \param path The path part of the URL.
+ * \param useTls If TLS is used to connect the controller.
+ *
+ * Adds a controller the requests can be sent to. The controller passed to the
+ * constructor is the first one, the others are used when it is not available
+ * (see failOver()) or when an other controller is faster (see
+ * probeControllers()).
+ */
+void
+S9sRpcClient::addController(
+        const S9sString &hostName,
+        const int        port,
+        const S9sString &path,
+        const bool       useTls)
+{
+    S9sRpcClientPrivate::Endpoint endpoint = 
+        { hostName, port, path, useTls, -1, false };
+
+    if (m_priv->m_endpoints.empty())
+    {
+        S9sRpcClientPrivate::Endpoint first = 
+        { 
+            m_priv->m_hostName, m_priv->m_port, m_priv->m_path,
+            m_priv->m_useTls, -1, false 
+        };
+
+        m_priv->m_endpoints << first;
+        m_priv->m_endpointIndex = 0u;
+    }
+
+    m_priv->m_endpoints << endpoint;
+}
+
+/**
+ * \returns false if none of the controllers answered.
+ *
+ * Sends a ping to all the controllers added by addController() concurrently
+ * and switches to the controller that answers first. The controllers that can
+ * not be connected are marked as failed, they are not used for failover.
+ * Probing stops when the first controller answers, so a controller that is
+ * down does not slow down the client.
+ */
+bool
+S9sRpcClient::probeControllers()
+{
+    S9sVector<S9sRpcClient *> probes;
+    S9sVariantMap             request;
+    S9sString                 payload;
+    S9sDateTime               now = S9sDateTime::currentDateTime();
+    int                       best;
+
+    if (m_priv->m_endpoints.size() < 2u)
+        return true;
+
+    request["operation"]       = "ping";
+    request["request_created"] = now.toString(S9sDateTime::TzDateTimeFormat);
+    payload = request.toCompactString();
+
+    for (uint idx = 0u; idx < m_priv->m_endpoints.size(); ++idx)
+    {
+        const S9sRpcClientPrivate::Endpoint &endpoint = 
+            m_priv->m_endpoints[idx];
+        S9sRpcClient *probe;
+
+        probe = new S9sRpcClient(
+                endpoint.hostName, endpoint.port, endpoint.path, 
+                endpoint.useTls);
+
+        probe->setTimeouts(
+                m_priv->m_connectTimeout, m_priv->m_connectTimeout);
+
+        probe->m_priv->startRequest(
+                probe->httpHeader(
+                    endpoint.path + "/v2/clusters/", payload.length(), false),
+                payload);
+
+        probes << probe;
+    }
+
+    runRequests(probes, true);
+
+    for (uint idx = 0u; idx < probes.size(); ++idx)
+    {
+        S9sRpcClientPrivate::Endpoint &endpoint = m_priv->m_endpoints[idx];
+        S9sRpcClientPrivate           *priv     = probes[idx]->m_priv;
+
+        if (priv->m_requestState == S9sRpcClientPrivate::Finished)
+        {
+            PRINT_VERBOSE("Controller %s:%d answered in %d ms.",
+                    STR(endpoint.hostName), endpoint.port, priv->m_latency);
+
+            endpoint.latency = priv->m_latency;
+            endpoint.failed  = false;
+        } else if (priv->m_requestState == S9sRpcClientPrivate::Failed)
+        {
+            PRINT_VERBOSE("Controller %s:%d failed: %s",
+                    STR(endpoint.hostName), endpoint.port, 
+                    STR(priv->m_errorString));
+
+            endpoint.latency = -1;
+            endpoint.failed  = true;
+        }
+
+        delete probes[idx];
+    }
+
+    best = m_priv->bestEndpoint();
+    if (best < 0)
+    {
+        m_priv->m_errorString = "None of the controllers are available.";
+        return false;
+    }
+
+    m_priv->useEndpoint(best);
+    PRINT_VERBOSE("Using controller %s:%d.", 
+            STR(m_priv->m_hostName), m_priv->m_port);
+
+    return true;
+}
+
+/**
+ * \returns true if the client switched to an other controller.
+ *
+ * Called when the controller in use can not be connected: marks it as failed
+ * and switches to the fastest controller that did not fail. The session
+ * cookies are not valid on the other controller, the client authenticates
+ * again when the controller asks for it.
+ */
+bool
+S9sRpcClient::failOver()
+{
+    int best;
+
+    if (m_priv->m_endpoints.size() < 2u)
+        return false;
+
+    m_priv->m_endpoints[m_priv->m_endpointIndex].failed = true;
+
+    best = m_priv->bestEndpoint();
+    if (best < 0)
+        return false;
+
+    PRINT_VERBOSE("%s", STR(m_priv->m_errorString));
+    m_priv->useEndpoint(best);
+    PRINT_VERBOSE("Failing over to controller %s:%d.", 
+            STR(m_priv->m_hostName), m_priv->m_port);
+
+    if (!m_priv->m_cookies.empty())
+    {
+        m_priv->m_cookies.clear();
+        m_priv->m_failedOver = true;
+    }
+
+    return true;
+}
+
+/**
+ * \param fileName The file where the TLS session of the controller is saved
+ *   and loaded from.
+ *
+ * The TLS sessions are always resumed when the client reconnects to the same
+ * controller. With the session file set the session is also saved, so the
+ * next process connecting the controller can resume it with an abbreviated
+ * handshake. The sessions of the other controllers (see addController()) are
+ * saved in the same directory, one file for every controller.
+ */
+void
+S9sRpcClient::setTlsSessionFile(
+        const S9sString &fileName)
+{
+    if (fileName.empty())
+    {
+        m_priv->m_tlsSessionFile.clear();
+        m_priv->m_tlsSessionKey.clear();
+    } else {
+        m_priv->m_tlsSessionFile = S9sFile(fileName).path();
+        m_priv->m_tlsSessionKey  = m_priv->controllerKey();
+    }
+}
+
+/**
+ * \param fileName The file where the authenticated session is saved.
+ * \param lifetime How long the saved session is used in seconds.
+ *
+ * With the session file set the session of the authenticated user is saved
+ * and the next process uses it instead of authenticating again. If the
+ * controller does not accept the saved session the client authenticates and
+ * sends the request again.
+ */
+void
+S9sRpcClient::setSessionFile(
+        const S9sString &fileName,
+        const int        lifetime)
+{
+    if (fileName.empty())
+        m_priv->m_sessionFile.clear();
+    else
+        m_priv->m_sessionFile = S9sFile(fileName).path();
+
+    m_priv->m_sessionLifetime = lifetime;
+}
+
 bool
 S9sRpcClient::hasPrivateKey() const
 {
@@ -191,12 +450,22 @@ S9sRpcClient::maybeAuthenticate()
     // We can authenticate, the user intended to.
     if (canDoAuthentication)
     {
-        bool success = authenticate();
+        bool success;
+
+        if (m_priv->loadSession())
+        {
+            PRINT_VERBOSE("Using the saved session.");
+            m_priv->m_authenticated = true;
+            success = true;
+        } else {
+            success = authenticate();
+        }
+
         if (!success)
         {
             if (options->isJsonRequested())
             {
-                printf("%s\n", STR(reply().toString()));
+                reply().printJson();
             } else {
                 if (m_priv->m_errorString.empty())
                     m_priv->m_errorString = reply().errorString();
@@ -313,6 +582,354 @@ S9sRpcClient::setExitStatus()
     }
 }
 
+/**
+ * Starts collecting the requests into a batch. Until executeBatch() is called
+ * the request methods (e.g. getCpuStats(), getRunningProcesses()) are not
+ * sending the requests, they only record them and return true. Only the
+ * methods that send one single request and do not process the reply can be
+ * batched.
+ */
+void
+S9sRpcClient::beginBatch()
+{
+    m_priv->m_batchMode = true;
+    m_priv->m_batchUris.clear();
+    m_priv->m_batchRequests.clear();
+    m_priv->resetAbortPipe();
+}
+
+/**
+ * \param replies The replies received, in the order the requests were
+ *   recorded.
+ * \returns true if all the requests were sent and all the replies received
+ *   (even if some of the replies are error messages).
+ *
+ * Sends the requests collected since beginBatch() concurrently, every request
+ * on its own non-blocking connection driven by one event loop, so the batch
+ * takes as long as the slowest request instead of the sum of all of them. The
+ * connections are kept for the next batch if keep-alive is enabled.
+ *
+ * If abortBatch() is called while the requests are running the requests are
+ * dropped and this method returns false without replies.
+ */
+bool
+S9sRpcClient::executeBatch(
+        S9sVector<S9sRpcReply> &replies)
+{
+    S9sOptions   *options = S9sOptions::instance();    
+    S9sVector<S9sRpcClient *> clients;
+    S9sDateTime   replyReceived;
+    bool          authRequired = false;
+    bool          connectFailed = false;
+    bool          success = true;
+
+    m_priv->m_batchMode = false;
+    replies.clear();
+
+    while (m_priv->m_batchClients.size() < m_priv->m_batchUris.size())
+    {
+        S9sRpcClient *client = new S9sRpcClient(
+                m_priv->m_hostName, m_priv->m_port, m_priv->m_path,
+                m_priv->m_useTls);
+
+        client->setKeepAlive(m_priv->m_keepAlive);
+        client->setCompression(m_priv->m_compression);
+        client->setTimeouts(m_priv->m_connectTimeout, m_priv->m_readTimeout);
+        m_priv->m_batchClients << client;
+    }
+
+    PRINT_VERBOSE("Sending %u requests in a batch.", 
+            (uint) m_priv->m_batchUris.size());
+
+    /*
+     * Starting all the requests, then driving them concurrently.
+     */
+    for (uint idx = 0u; idx < m_priv->m_batchUris.size(); ++idx)
+    {
+        S9sRpcClient        *client = m_priv->m_batchClients[idx];
+        S9sRpcClientPrivate *priv   = client->m_priv;
+        S9sString            uri    = m_priv->m_path + m_priv->m_batchUris[idx];
+        S9sString            header;
+        S9sString            payload;
+
+        priv->m_cookies = m_priv->m_cookies;
+        priv->m_reply.clear();
+
+        payload = m_priv->m_batchRequests[idx].toCompactString();
+        header  = client->httpHeader(uri, payload.length(), priv->m_keepAlive);
+        priv->startRequest(header, std::move(payload));
+
+        clients << client;
+    }
+
+    if (!runRequests(clients, false, m_priv->m_abortPipe[0]))
+    {
+        PRINT_VERBOSE("The batch was aborted.");
+        m_priv->m_errorString = "The batch was aborted.";
+        return false;
+    }
+
+    /*
+     * If the controller could not be connected none of the requests were
+     * sent, we can send them all to an other controller.
+     */
+    for (uint idx = 0u; idx < clients.size(); ++idx)
+    {
+        S9sRpcClientPrivate *priv = clients[idx]->m_priv;
+
+        if (priv->m_requestState == S9sRpcClientPrivate::Failed &&
+                !priv->m_established)
+        {
+            m_priv->m_errorString = priv->m_errorString;
+            connectFailed = true;
+        }
+    }
+
+    if (connectFailed && failOver())
+        return executeBatch(replies);
+
+    /*
+     * Processing the replies.
+     */
+    replyReceived = S9sDateTime::currentDateTime();
+
+    for (uint idx = 0u; idx < m_priv->m_batchUris.size(); ++idx)
+    {
+        S9sRpcClient        *client = m_priv->m_batchClients[idx];
+        S9sRpcClientPrivate *priv   = client->m_priv;
+        bool                 clientSuccess;
+
+        if (priv->m_requestState == S9sRpcClientPrivate::ConnectionClosed &&
+                priv->m_reusedConnection)
+        {
+            // The controller closed the idle connection, sending this one
+            // again on a new connection.
+            PRINT_VERBOSE("Connection closed by controller, reconnecting.");
+            priv->close();
+
+            clientSuccess = client->doExecuteRequest(
+                    m_priv->m_batchUris[idx], m_priv->m_batchRequests[idx]);
+        } else if (priv->m_requestState == S9sRpcClientPrivate::Failed)
+        {
+            options->setExitStatus(S9sOptions::ConnectionError);
+            client->setError(priv->m_errorString);
+            clientSuccess = false;
+        } else {
+            clientSuccess = client->processReply(
+                    replyReceived, priv->m_keepAlive);
+        }
+
+        if (!clientSuccess && success)
+        {
+            m_priv->m_errorString = client->errorString();
+            success = false;
+        }
+
+        if (client->reply().isAuthRequired())
+            authRequired = true;
+
+        replies << client->reply();
+    }
+
+    /*
+     * If the controller does not accept the session we loaded from the file
+     * (or the session of the controller we failed over from) we authenticate
+     * and send the batch again.
+     */
+    if (success && authRequired && 
+            (m_priv->m_sessionFromFile || m_priv->m_failedOver))
+    {
+        PRINT_VERBOSE("The session is not valid, authenticating.");
+
+        if (m_priv->m_sessionFromFile)
+            m_priv->removeSession();
+
+        m_priv->m_cookies.clear();
+        m_priv->m_failedOver = false;
+
+        if (!authenticate())
+            return true;
+
+        for (uint idx = 0u; idx < m_priv->m_batchRequests.size(); ++idx)
+            m_priv->m_batchRequests[idx]["request_id"] = ++m_priv->m_requestId;
+
+        return executeBatch(replies);
+    }
+
+    return success;
+}
+
+/**
+ * Aborts the batch executeBatch() is running, or the next one if it is called
+ * between beginBatch() and executeBatch(). This is the only method of the
+ * client that may be called from an other thread, e.g. from the thread that
+ * reads the keys of a screen UI while the main thread waits for the replies.
+ */
+void
+S9sRpcClient::abortBatch()
+{
+    m_priv->writeAbortPipe();
+}
+
+/**
+ * \param clients The clients with the requests started by startRequest().
+ * \param untilFirst Return as soon as one of the requests is finished.
+ * \param abortFd A file descriptor that becomes readable when the requests
+ *   should be aborted or -1.
+ * \returns false if the requests were aborted, true otherwise.
+ *
+ * Drives the started requests of the clients concurrently with one event
+ * loop until all of them are in a final state. Every request has its own
+ * deadline (see S9sRpcClientPrivate::m_deadline), the requests that miss it
+ * are failed or, while connecting, try the next address of the controller.
+ */
+bool
+S9sRpcClient::runRequests(
+        S9sVector<S9sRpcClient *> &clients,
+        const bool                 untilFirst,
+        const int                  abortFd)
+{
+    S9sEventLoop  eventLoop;
+    long long     now;
+    bool          aborted = false;
+
+    for (uint idx = 0u; idx < clients.size(); ++idx)
+    {
+        S9sRpcClientPrivate *priv = clients[idx]->m_priv;
+        int                  events;
+
+        events = priv->advance();
+        if (events != 0)
+        {
+            priv->m_eventLoop = &eventLoop;
+            eventLoop.watch(
+                    priv->m_socketFd, events, 
+                    S9sRpcClientPrivate::eventCallback, priv);
+        } else {
+            priv->m_latency = 
+                S9sRpcClientPrivate::monotonicMs() - priv->m_requestStarted;
+        }
+    }
+
+    if (abortFd >= 0)
+    {
+        eventLoop.watch(
+                abortFd, POLLIN,
+                S9sRpcClientPrivate::abortCallback, &aborted);
+    }
+
+    while (!aborted)
+    {
+        long long deadline = -1ll;
+        bool      finished = false;
+        int       nRunning = 0;
+
+        for (uint idx = 0u; idx < clients.size(); ++idx)
+        {
+            S9sRpcClientPrivate *priv = clients[idx]->m_priv;
+
+            if (priv->m_eventLoop == 0)
+            {
+                if (priv->m_requestState == S9sRpcClientPrivate::Finished)
+                    finished = true;
+
+                continue;
+            }
+
+            if (deadline < 0ll || priv->m_deadline < deadline)
+                deadline = priv->m_deadline;
+
+            ++nRunning;
+        }
+
+        if (nRunning == 0 || (untilFirst && finished))
+            break;
+
+        now = S9sRpcClientPrivate::monotonicMs();
+        eventLoop.runOnce(deadline > now ? deadline - now : 0);
+
+        // The requests that missed their deadline.
+        now = S9sRpcClientPrivate::monotonicMs();
+        for (uint idx = 0u; idx < clients.size(); ++idx)
+        {
+            S9sRpcClientPrivate *priv = clients[idx]->m_priv;
+            int                  events = 0;
+
+            if (priv->m_eventLoop == 0 || priv->m_deadline > now)
+                continue;
+
+            eventLoop.unwatch(priv->m_socketFd);
+            priv->m_eventLoop = 0;
+
+            if (priv->m_requestState == S9sRpcClientPrivate::Connecting ||
+                    priv->m_requestState == S9sRpcClientPrivate::Handshaking)
+            {
+                priv->m_errorString.sprintf(
+                        "Timeout connecting to controller (%s:%d TLS: %s).",
+                        STR(priv->m_hostName), priv->m_port, 
+                        priv->m_useTls ? "yes" : "no");
+
+                if (priv->m_requestState == S9sRpcClientPrivate::Connecting &&
+                        priv->retryConnect())
+                {
+                    events = priv->advance();
+                }
+            } else {
+                priv->m_errorString.sprintf(
+                        "Timeout communicating with controller "
+                        "(%s:%d TLS: %s).",
+                        STR(priv->m_hostName), priv->m_port, 
+                        priv->m_useTls ? "yes" : "no");
+            }
+
+            if (events != 0)
+            {
+                priv->m_eventLoop = &eventLoop;
+                eventLoop.watch(
+                        priv->m_socketFd, events, 
+                        S9sRpcClientPrivate::eventCallback, priv);
+
+                continue;
+            }
+
+            if (priv->m_requestState != S9sRpcClientPrivate::Finished)
+            {
+                priv->close();
+                priv->m_requestState = S9sRpcClientPrivate::Failed;
+            }
+
+            priv->m_latency = now - priv->m_requestStarted;
+        }
+    }
+
+    if (abortFd >= 0)
+        eventLoop.unwatch(abortFd);
+
+    /*
+     * Leaving the requests that are still running (if untilFirst) or
+     * dropping them (if aborted).
+     */
+    for (uint idx = 0u; idx < clients.size(); ++idx)
+    {
+        S9sRpcClientPrivate *priv = clients[idx]->m_priv;
+
+        if (priv->m_eventLoop == 0)
+            continue;
+
+        eventLoop.unwatch(priv->m_socketFd);
+        priv->m_eventLoop = 0;
+
+        if (aborted)
+        {
+            priv->close();
+            priv->m_requestState = S9sRpcClientPrivate::Failed;
+            priv->m_errorString  = "The request was aborted.";
+        }
+    }
+
+    return !aborted;
+}
+
 /**
  * \returns the human readable error string stored in the object.
  */
@@ -341,7 +958,7 @@ S9sRpcClient::printMessages(
     } else {
         if (options->isJsonRequested())
         {
-            printf("%s\n", STR(rpcReply.toString()));
+            rpcReply.printJson();
         } else {
             rpcReply.printMessages(errorString());
             //PRINT_ERROR("%s", STR(errorString()));
@@ -368,7 +985,7 @@ S9sRpcClient::printServerRegistered(
         #endif
     } else {
         if (options->isJsonRequested())
-            printf("%s\n", STR(rpcReply.toString()));
+            rpcReply.printJson();
         else
             PRINT_ERROR("%s", STR(errorString()));
     }
@@ -384,13 +1001,19 @@ bool
 S9sRpcClient::authenticate()
 {
     S9sOptions    *options = S9sOptions::instance();
+    bool           success;
 
     if (options->hasPassword())
-        return authenticateWithPassword();
+        success = authenticateWithPassword();
     else if (!options->password().empty())
-        return authenticateWithPassword();
+        success = authenticateWithPassword();
+    else
+        success = authenticateWithKey();
 
-    return authenticateWithKey();
+    if (success)
+        m_priv->saveSession();
+
+    return success;
 }
 
 bool 
@@ -6991,7 +7614,47 @@ S9sRpcClient::executeRequest(
     request["request_created"] = timeString;
     request["request_id"]      = ++m_priv->m_requestId;
 
-    return doExecuteRequest(uri, request);
+    if (m_priv->m_batchMode)
+    {
+        m_priv->m_batchUris     << uri;
+        m_priv->m_batchRequests << request;
+        return true;
+    }
+
+    if (!doExecuteRequest(uri, request))
+        return false;
+
+    /*
+     * If the controller does not accept the session we loaded from the file
+     * (or we failed over to a controller that does not know our session) we
+     * authenticate and send the request again.
+     */
+    if (m_priv->m_failedOver && reply().isAuthRequired())
+    {
+        PRINT_VERBOSE("Authenticating on controller %s:%d.",
+                STR(m_priv->m_hostName), m_priv->m_port);
+
+        m_priv->m_failedOver = false;
+        if (!authenticate())
+            return true;
+
+        request["request_id"] = ++m_priv->m_requestId;
+        return doExecuteRequest(uri, request);
+    } else if (m_priv->m_sessionFromFile && reply().isAuthRequired())
+    {
+        PRINT_VERBOSE("The saved session is not valid, authenticating.");
+
+        m_priv->removeSession();
+        m_priv->m_cookies.clear();
+
+        if (!authenticate())
+            return true;
+
+        request["request_id"] = ++m_priv->m_requestId;
+        return doExecuteRequest(uri, request);
+    }
+
+    return true;
 }
 
 /**
@@ -7008,17 +7671,15 @@ S9sRpcClient::doExecuteRequest(
         const S9sString     &uri,
         S9sVariantMap &request)
 {
-    S9sString    payload = request.toString();
+    S9sString    payload = request.toCompactString();
     S9sOptions  *options = S9sOptions::instance();    
     S9sDateTime  replyReceived;
-    S9sString    header;
     S9sString    myUri = uri;
     ssize_t      readLength;
     ssize_t      writtenLength;
-    S9sString    dataToSend; 
-    size_t       dataSize;
-    size_t       payloadSize = 0;
+    S9sString    header; 
     bool         isJSonStream = false;
+    bool         keepAlive;
 
     PRINT_VERBOSE("Preparing to send rquest.");
 
@@ -7027,11 +7688,19 @@ S9sRpcClient::doExecuteRequest(
 
     PRINT_VERBOSE("URI is '%s'", STR(myUri));
 
-    m_priv->m_jsonReply.clear();
     m_priv->m_reply.clear();
 
-    if (!m_priv->connect())
+    /*
+     * JSon streams are read until the controller closes the connection, so
+     * they are never sent on a connection we want to keep.
+     */
+    keepAlive = m_priv->m_keepAlive && m_priv->m_callbackFunction == 0;
+
+    if (!keepAlive && !m_priv->connect())
     {
+        if (failOver())
+            return doExecuteRequest(uri, request);
+
         PRINT_VERBOSE("Connection failed: %s", STR(m_priv->m_errorString));
         options->setExitStatus(S9sOptions::ConnectionError);
 
@@ -7045,40 +7714,60 @@ S9sRpcClient::doExecuteRequest(
     if (options->isJsonRequested() && options->isVerbose())
     {
         printf("Preparing to send request on %s: \n%s\n", 
-                STR(myUri), STR(payload));
+                STR(myUri), STR(request.toString()));
     }
 
-    if (!payload.empty())
-        payloadSize = strlen(STR(payload));
+    header = httpHeader(myUri, payload.length(), keepAlive);
+    
+    PRINT_VERBOSE("Sending: \n%s%s\n", STR(header), STR(payload));
 
-    header.sprintf(
-        "POST %s HTTP/1.0\r\n"
-        "Host: %s:%d\r\n"
-        "User-Agent: s9s-tools/1.0\r\n"
-        "Connection: close\r\n"
-        "Accept: application/json\r\n"
-        "Transfer-Encoding: identity\r\n"
-        "%s"
-        "Content-Type: application/json\r\n"
-        "Content-Length: %zd\r\n"
-        "\r\n",
-        STR(myUri),
-        STR(m_priv->m_hostName),
-        m_priv->m_port,
-        STR(m_priv->cookieHeaders()),
-        payloadSize);
+    if (keepAlive)
+    {
+        S9sRpcClientPrivate::RequestState state;
 
-    dataToSend = header + payload;
-    dataSize   = strlen(STR(dataToSend));
-    
-    PRINT_VERBOSE("Sending: \n%s\n", STR(dataToSend));
-    writtenLength = m_priv->write(STR(dataToSend), dataSize);
+        /*
+         * Connecting (or reusing the connection), sending the request and
+         * receiving the reply without blocking on the socket.
+         */
+        m_priv->startRequest(header, std::move(payload));
+        state = m_priv->runRequest();
+        replyReceived = S9sDateTime::currentDateTime();
 
+        if (state == S9sRpcClientPrivate::ConnectionClosed && 
+                m_priv->m_reusedConnection)
+        {
+            // The controller closed the idle connection just as we sent the
+            // request.
+            PRINT_VERBOSE("Connection closed by controller, reconnecting.");
+            m_priv->close();
+
+            return doExecuteRequest(uri, request);
+        } else if (state == S9sRpcClientPrivate::Failed && 
+                !m_priv->m_established && failOver())
+        {
+            // The request was not sent, sending it to an other controller.
+            return doExecuteRequest(uri, request);
+        } else if (state == S9sRpcClientPrivate::Failed)
+        {
+            PRINT_VERBOSE("Request failed: %s", STR(m_priv->m_errorString));
+            options->setExitStatus(S9sOptions::ConnectionError);
+            setError(m_priv->m_errorString);
+            return false;
+        }
+        
+        if (options->isJsonRequested() && options->isVerbose())
+        {
+            printf("Sent request.\n");
+        }
 
-    S9S_DEBUG("%s: Size: %zd, written: %zd", 
-            STR(timeStampString()), dataSize, writtenLength);
+        return processReply(replyReceived, keepAlive);
+    }
 
-    //S9S_WARNING("dataToSend: \n%s\n", STR(dataToSend));
+    writtenLength = m_priv->write(header, payload);
+
+    S9S_DEBUG("%s: Size: %zd, written: %zd", 
+            STR(timeStampString()), header.length() + payload.length(), 
+            writtenLength);
 
     if (writtenLength < 0)
     {
@@ -7103,11 +7792,25 @@ S9sRpcClient::doExecuteRequest(
      * Reading the reply from the server.
      */
     replyReceived = S9sDateTime::currentDateTime();
-    m_priv->clearBuffer();
     
+    m_priv->clearBuffer();
+
     for (;;)
     {
-        m_priv->ensureHasBuffer(m_priv->m_dataSize + READ_SIZE);
+        const char *record;
+        size_t      recordLength;
+
+        if (isJSonStream)
+            m_priv->compactBuffer();
+
+        if (!m_priv->ensureHasBuffer(m_priv->m_dataSize + READ_SIZE))
+        {
+            m_priv->close();
+
+            options->setExitStatus(S9sOptions::ConnectionError);
+            setError(m_priv->m_errorString);
+            return false;
+        }
 
         readLength = m_priv->read(
                 m_priv->m_buffer + m_priv->m_dataSize, READ_SIZE - 1);
@@ -7116,8 +7819,15 @@ S9sRpcClient::doExecuteRequest(
         {
             m_priv->m_dataSize += readLength;
 
+            /*
+             * JSon stream records always starts by <RS> (\036) and ending by
+             * \n
+             */
+            if (m_priv->m_buffer[0] == '\036')
+                isJSonStream = true;
+
             // read may got interrupted due to too small buffer
-            if (readLength >= READ_SIZE - 1)
+            if (readLength >= READ_SIZE - 1 && !isJSonStream)
             {
                 S9S_WARNING("%u >= %d", readLength, READ_SIZE - 1);
                 S9S_WARNING("continue");
@@ -7126,7 +7836,8 @@ S9sRpcClient::doExecuteRequest(
         } else if (readLength < 0)
         {
             m_priv->m_errorString.sprintf(
-                    "Error while reading from controller (%s:%d TLS: %s): %m",
+                    "Error while reading from controller "
+                    "(%s:%d TLS: %s): %m",
                     STR(m_priv->m_hostName), m_priv->m_port,
                     m_priv->m_useTls ? "yes" : "no");
 
@@ -7136,28 +7847,23 @@ S9sRpcClient::doExecuteRequest(
         }
 
         /*
-         * JSon stream records always starts by <RS> (\036) and ending by \n
+         * If this is a JSon stream we process the JSon messages until we
+         * done with all of them in the buffer. The buffer might have zero
+         * or more complete JSon messages, they are parsed where they are in
+         * the buffer.
          */
-        if (m_priv->m_buffer[0] == '\036')
-            isJSonStream = true;
-
-        m_priv->m_jsonReply.clear();
-
-        /*
-         * If this is a JSon stream we process the JSon messages until we done
-         * with all of them in the buffer. The buffer might have zero or more 
-         * complete JSon messages.
-         */
-        while (isJSonStream && m_priv->hasCompleteJSon())
+        while (isJSonStream && 
+                m_priv->nextRecord(record, recordLength, readLength == 0))
         {
             S9sVariantMap jsonRecord;
+            bool          parsed = jsonRecord.parse(record, recordLength);
 
-            m_priv->m_jsonReply = m_priv->getCompleteJSon();
-            //S9S_WARNING("json: %s", STR(m_priv->m_jsonReply));
-            S9S_WARNING("1 Parsing json");
-
-            m_priv->skipRecord();
-            if (!jsonRecord.parse(STR(m_priv->m_jsonReply)))
+            if (!parsed && readLength == 0)
+            {
+                // The connection was closed in the middle of a record.
+                PRINT_VERBOSE("Incomplete record at the end of the stream.");
+                return true;
+            } else if (!parsed)
             {
                 PRINT_ERROR("Failed to parse JSon string.");
                 return false;
@@ -7165,7 +7871,7 @@ S9sRpcClient::doExecuteRequest(
             {
                 m_priv->m_errorString.sprintf(
                         "Got JSon stream when expecting JSon object:\n%s.",
-                        STR(m_priv->m_jsonReply));
+                        STR(S9sString(std::string(record, recordLength))));
                 PRINT_ERROR("%s", STR(m_priv->m_errorString));
 
                 options->setExitStatus(S9sOptions::ConnectionError);
@@ -7176,8 +7882,6 @@ S9sRpcClient::doExecuteRequest(
 
             (*m_priv->m_callbackFunction)(
                         jsonRecord, m_priv->m_callbackUserData);
-
-            m_priv->m_jsonReply = "";
         }
 
         if (isJSonStream)
@@ -7190,23 +7894,95 @@ S9sRpcClient::doExecuteRequest(
             // We continue reading the connection.
             continue;
         }
-            
-        // If this is not a JSon stream and we could not read data we break the
-        // read-loop, the next lines will handle this.
+        
+        // If this is not a JSon stream and we could not read data we
+        // break the read-loop, the next lines will handle this.
         if (readLength == 0)
             break;
     } // for(;;)
 
+    return processReply(replyReceived, keepAlive);
+}
+
+/**
+ * \param uri The URI the request is sent to (with the path).
+ * \param payloadSize The length of the JSON request string.
+ * \param keepAlive If the connection should be kept for the next request.
+ * \returns The HTTP header of the request, the payload is sent right after
+ *   it (see S9sRpcClientPrivate::startRequest()).
+ */
+S9sString
+S9sRpcClient::httpHeader(
+        const S9sString &uri,
+        const size_t     payloadSize,
+        const bool       keepAlive) const
+{
+    S9sString    header;
+
+    header.sprintf(
+        "POST %s %s\r\n"
+        "Host: %s:%d\r\n"
+        "User-Agent: s9s-tools/1.0\r\n"
+        "Connection: %s\r\n"
+        "Accept: application/json\r\n"
+        "%s"
+        "Transfer-Encoding: identity\r\n"
+        "%s"
+        "Content-Type: application/json\r\n"
+        "Content-Length: %zd\r\n"
+        "\r\n",
+        STR(uri),
+        keepAlive ? "HTTP/1.1" : "HTTP/1.0",
+        STR(m_priv->m_hostName),
+        m_priv->m_port,
+        keepAlive ? "keep-alive" : "close",
+        m_priv->m_compression && m_priv->m_callbackFunction == 0 ?
+            "Accept-Encoding: gzip, deflate\r\n" : "",
+        STR(m_priv->cookieHeaders()),
+        payloadSize);
+
+    return header;
+}
+
+/**
+ * \param replyReceived The time the reply was received.
+ * \param keepAlive If the connection should be kept for the next request.
+ * \returns true if the reply was received and parsed.
+ *
+ * Processes the reply that is in the buffer: parses the cookies and the JSON
+ * reply and closes the connection unless it can be used for the next request.
+ */
+bool
+S9sRpcClient::processReply(
+        const S9sDateTime &replyReceived,
+        const bool         keepAlive)
+{
+    S9sOptions  *options = S9sOptions::instance();    
+    const char  *body = "";
+    size_t       bodyLength = 0;
+    bool         compressed = false;
+    bool         success;
+    S9sArena    *arena;
+
     // Closing the buffer with a null terminating byte.
-    m_priv->ensureHasBuffer(m_priv->m_dataSize + 1);
+    if (!m_priv->ensureHasBuffer(m_priv->m_dataSize + 1))
+    {
+        m_priv->close();
+
+        options->setExitStatus(S9sOptions::ConnectionError);
+        setError(m_priv->m_errorString);
+        return false;
+    }
+
     m_priv->m_buffer[m_priv->m_dataSize] = '\0';
     m_priv->m_dataSize += 1;
 
     // This is producing a lot of lines.
     //S9S_DEBUG("reply: '%s'", m_priv->m_buffer); 
 
-    // Closing the socket.
-    m_priv->close();
+    // Closing the socket unless we can send the next request on it.
+    if (!keepAlive || !m_priv->m_serverKeepsAlive)
+        m_priv->close();
    
     S9S_DEBUG("%s: total received: %zd bytes", 
             STR(timeStampString()), m_priv->m_dataSize);
@@ -7218,11 +7994,23 @@ S9sRpcClient::doExecuteRequest(
         char *tmp = strstr(m_priv->m_buffer, "\r\n\r\n");
         if (tmp)
         {
-            m_priv->m_jsonReply = (tmp + 4);
+            // The JSON reply is parsed where it is, in the buffer.
+            body       = tmp + 4;
+            bodyLength = m_priv->m_buffer + m_priv->m_dataSize - 1 - body;
+            compressed = 
+                m_priv->m_contentEncoding == "gzip" ||
+                m_priv->m_contentEncoding == "x-gzip" ||
+                m_priv->m_contentEncoding == "deflate";
 
             if (options->isJsonRequested() && options->isVerbose())
             {
-                printf("Reply: \n%s\n", STR(m_priv->m_jsonReply));
+                if (compressed)
+                {
+                    printf("Reply: %zd bytes %s compressed\n", 
+                            bodyLength, STR(m_priv->m_contentEncoding));
+                } else {
+                    printf("Reply: \n%s\n", body);
+                }
             }
         }
     } else {
@@ -7237,9 +8025,50 @@ S9sRpcClient::doExecuteRequest(
         return false;
     }
 
-    if (!m_priv->m_reply.parse(STR(m_priv->m_jsonReply)))
+    /*
+     * The reply is allocated in an arena, so the whole document is released at
+     * once when it is replaced by the next reply. The reply is parsed lazily
+     * where it was received, the buffer is kept by the reply, the printers read
+     * only a few fields of the objects in the reply, the rest of them are never
+     * built.
+     */
+    arena = new S9sArena;
+
+    if (compressed)
+    {
+        /*
+         * The reply is decompressed while it is parsed, the decompressed
+         * string is never in the memory as a whole, so it is parsed at once.
+         */
+        S9sInflater inflater(body, bodyLength, RPC_MAX_REPLY_SIZE);
+
+        success = m_priv->m_reply.parse(
+                S9sInflater::reader, &inflater, arena);
+
+        arena->unRef();
+
+        if (inflater.hasError())
+        {
+            m_priv->m_errorString = inflater.errorString();
+            options->setExitStatus(S9sOptions::ConnectionError);
+            setError(m_priv->m_errorString);
+
+            return false;
+        }
+    } else {
+        success = m_priv->m_reply.parseLazy(
+                m_priv->m_buffer, body - m_priv->m_buffer, bodyLength, arena);
+
+        arena->unRef();
+
+        if (success)
+            m_priv->detachBuffer();
+    }
+
+    if (!success)
     {
-        PRINT_VERBOSE("Error in reply: \n%s\n", STR(m_priv->m_jsonReply));
+        if (!compressed)
+            PRINT_VERBOSE("Error in reply: \n%s\n", body);
 
         m_priv->m_errorString.sprintf("Error parsing JSON reply.");
         options->setExitStatus(S9sOptions::ConnectionError);
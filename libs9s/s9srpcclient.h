@@ -21,8 +21,10 @@
 
 #include "S9sString"
 #include "S9sRpcReply"
+#include "S9sVector"
 
 class S9sRpcClientPrivate;
+class S9sDateTime;
 class S9sUser;
 
 typedef void (*S9sJSonHandler)(const S9sVariantMap &jsonMessage, void *userData);
@@ -44,6 +46,23 @@ class S9sRpcClient
 
         S9sRpcClient &operator=(const S9sRpcClient &rhs);
 
+        void setKeepAlive(const bool keepAlive);
+        void setCompression(const bool compression);
+        void setTimeouts(const int connectTimeout, const int readTimeout);
+
+        void addController(
+                const S9sString &hostName,
+                const int        port,
+                const S9sString &path,
+                const bool       useTls);
+
+        bool probeControllers();
+        void setTlsSessionFile(const S9sString &fileName);
+        
+        void setSessionFile(
+                const S9sString &fileName,
+                const int        lifetime);
+
         bool hasPrivateKey() const;
         bool canAuthenticate(S9sString &reason) const;
         bool needToAuthenticate() const;
@@ -56,6 +75,10 @@ class S9sRpcClient
         const S9sRpcReply &reply() const;
         void setExitStatus();
 
+        void beginBatch();
+        bool executeBatch(S9sVector<S9sRpcReply> &replies);
+        void abortBatch();
+
         S9sString errorString() const;
         void printMessages(
                 const S9sString &defaultMessage,
@@ -342,6 +365,22 @@ class S9sRpcClient
                 const S9sString &errorString,
                 const S9sString &errorCode = "ConnectError");
     private:
+        S9sString httpHeader(
+                const S9sString &uri,
+                const size_t     payloadSize,
+                const bool       keepAlive) const;
+
+        bool processReply(
+                const S9sDateTime &replyReceived,
+                const bool         keepAlive);
+
+        bool failOver();
+
+        static bool runRequests(
+                S9sVector<S9sRpcClient *> &clients,
+                const bool                 untilFirst = false,
+                const int                  abortFd = -1);
+        
         
         // Low level methods that create/register new clusters.
         bool createMySqlSingleCluster(
@@ -4,41 +4,103 @@
 #include "s9srpcclient_p.h"
  
 #include <string.h>
+#include <strings.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <arpa/inet.h>
 #include <netdb.h>
 #include <unistd.h>
+#include <poll.h>
 #include <cerrno>
+#include <cctype>
 
-#include "S9sRegExp"
 #include "S9sOptions"
+#include "S9sFile"
+#include "S9sMutexLocker"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <ctime>
+#include <openssl/pem.h>
 
 //#define DEBUG
 //#define WARNING
 #include "s9sdebug.h"
 
+SSL_CTX                          *S9sRpcClientPrivate::sm_sslContext = 0;
+S9sMap<S9sString, SSL_SESSION *>  S9sRpcClientPrivate::sm_tlsSessions;
+S9sMap<S9sString, S9sString>      S9sRpcClientPrivate::sm_tlsSessionPems;
+S9sMutex                          S9sRpcClientPrivate::sm_tlsMutex;
+int                               S9sRpcClientPrivate::sm_tlsHandshakes = 0;
+int                               S9sRpcClientPrivate::sm_tlsResumed = 0;
+S9sMap<S9sString, struct addrinfo *> S9sRpcClientPrivate::sm_addresses;
+S9sMap<struct addrinfo *, int>     S9sRpcClientPrivate::sm_addressRefs;
+S9sMutex                          S9sRpcClientPrivate::sm_resolverMutex;
+
 S9sRpcClientPrivate::S9sRpcClientPrivate() :
     m_referenceCounter(1),
     m_requestId(0ull),
     m_socketFd(-1),
     m_port(0),
     m_useTls(false),
+    m_keepAlive(false),
+    m_compression(false),
     m_buffer(0),
     m_bufferSize(0),
     m_dataSize(0),
-    m_sslContext(0),
+    m_readOffset(0),
+    m_scanOffset(0),
     m_ssl(0),
+    m_tlsSessionSaved(false),
     m_callbackFunction(0),
     m_callbackUserData(0),
-    m_authenticated(false)
+    m_authenticated(false),
+    m_headerLength(0),
+    m_contentLength(-1),
+    m_chunked(false),
+    m_serverKeepsAlive(false),
+    m_chunkCursor(0),
+    m_bodyLength(0),
+    m_sessionLifetime(0),
+    m_sessionFromFile(false),
+    m_requestState(Idle),
+    m_outSent(0),
+    m_reusedConnection(false),
+    m_eventLoop(0),
+    m_connectionSerial(0u),
+    m_connectTimeout(RPC_CONNECT_TIMEOUT_MS),
+    m_readTimeout(RPC_TIMEOUT_MS),
+    m_deadline(0ll),
+    m_established(false),
+    m_requestStarted(0ll),
+    m_latency(-1),
+    m_addresses(0),
+    m_nextAddress(0),
+    m_endpointIndex(0u),
+    m_failedOver(false),
+    m_batchMode(false)
 {
+    m_abortPipe[0] = -1;
+    m_abortPipe[1] = -1;
 }
 
 S9sRpcClientPrivate::~S9sRpcClientPrivate()
 {
+    for (uint idx = 0u; idx < m_batchClients.size(); ++idx)
+        delete m_batchClients[idx];
+
+    m_batchClients.clear();
+
+    if (m_abortPipe[0] >= 0)
+    {
+        ::close(m_abortPipe[0]);
+        ::close(m_abortPipe[1]);
+    }
+
     close();
     clearBuffer();
+    releaseAddresses();
 }
 
 void 
@@ -53,23 +115,73 @@ S9sRpcClientPrivate::unRef()
 	return --m_referenceCounter;
 }
 
-void 
+/**
+ * \param size The number of bytes the buffer should have at least.
+ * \returns false if the memory could not be allocated.
+ *
+ * Makes sure the buffer has at least the given size. If the allocation fails
+ * the buffer is left as it was and the error string is set.
+ */
+bool
 S9sRpcClientPrivate::ensureHasBuffer(
         size_t   size)
 {
+    char *newBuffer;
+
     if (size <= m_bufferSize)
-        return;
+        return true;
+
+    // Growing geometrically, a large reply needs only a few reallocations.
+    if (m_buffer != NULL && size < 2 * m_bufferSize)
+        size = 2 * m_bufferSize;
 
     if (m_buffer == NULL)
+        newBuffer = (char *) malloc(size);
+    else
+        newBuffer = (char *) realloc(m_buffer, size);
+
+    if (newBuffer == NULL)
     {
-        m_buffer     = (char *)malloc(size);
-        m_bufferSize = size;
+        m_errorString.sprintf(
+                "Failed to allocate %zu bytes for the reply from controller "
+                "(%s:%d TLS: %s).",
+                size, STR(m_hostName), m_port, m_useTls ? "yes" : "no");
 
-        return;
+        return false;
     }
 
-    m_buffer     = (char *) realloc(m_buffer, size);
+    m_buffer     = newBuffer;
     m_bufferSize = size;
+
+    return true;
+}
+
+/**
+ * Drops the records that are already processed from the beginning of the
+ * buffer, so the next read goes after the partial record that remained. The
+ * data is moved only when the free space at the end of the buffer is getting
+ * low, and then only the unprocessed part is moved.
+ */
+void
+S9sRpcClientPrivate::compactBuffer()
+{
+    size_t remaining;
+
+    if (m_readOffset == 0 || m_bufferSize - m_dataSize >= READ_SIZE)
+        return;
+
+    remaining = m_dataSize - m_readOffset;
+    if (remaining > 0)
+        memmove(m_buffer, m_buffer + m_readOffset, remaining);
+
+    // The separators skipped by nextRecord() might be past the scan offset.
+    if (m_scanOffset > m_readOffset)
+        m_scanOffset -= m_readOffset;
+    else
+        m_scanOffset = 0;
+
+    m_dataSize    = remaining;
+    m_readOffset  = 0;
 }
 
 void
@@ -81,248 +193,1694 @@ S9sRpcClientPrivate::clearBuffer()
     m_buffer     = 0;
     m_bufferSize = 0;
     m_dataSize   = 0;
+    m_readOffset = 0;
+    m_scanOffset = 0;
+}
+
+/**
+ * Forgets the buffer without releasing it, called when the parsed reply took
+ * the ownership of it. The next reply is received in a new buffer.
+ */
+void
+S9sRpcClientPrivate::detachBuffer()
+{
+    m_buffer     = 0;
+    m_bufferSize = 0;
+    m_dataSize   = 0;
+    m_readOffset = 0;
+    m_scanOffset = 0;
 }
 
 /**
  * \returns whether it connected successfully
+ *
+ * Connects to the controller and finishes the TLS handshake if TLS is
+ * enabled. The socket is non-blocking, this method waits until the connection
+ * is established.
  */
 bool
 S9sRpcClientPrivate::connect()
 {
-    struct hostent *hp;
-    struct timeval timeout;
-    struct sockaddr_in server;
+    m_outData.clear();
+    m_outPayload.clear();
+    m_outSent = 0;
+
+    if (!startConnect())
+        return false;
+
+    return runRequest() == Connected;
+}
 
+/**
+ * \returns false if the connection could not be initiated.
+ *
+ * Resolves the controller host name and initiates the connection to the first
+ * address. The connection is then established by advance(), the other
+ * addresses are tried if connecting to the first one fails.
+ */
+bool
+S9sRpcClientPrivate::startConnect()
+{
     /*
      * disconnect first if there is a previous connection
      */
     if (m_socketFd > 0)
         close();
 
+    m_requestState = Failed;
+    m_established  = false;
+
     if (m_hostName.empty())
     {
         m_errorString = "Controller host name is not set.";
         return false;
     }
 
-    if (m_port <= 0)
-    {
-        m_errorString = "Controller port is not set.";
-        return false;
-    }
+    if (m_port <= 0)
+    {
+        m_errorString = "Controller port is not set.";
+        return false;
+    }
+
+    releaseAddresses();
+
+    m_nextAddress = resolve();
+    if (m_nextAddress == NULL)
+        return false;
+
+    return connectNext();
+}
+
+/**
+ * \returns false if none of the remaining addresses could be connected.
+ *
+ * Creates a non-blocking socket and initiates the connection to the next
+ * address of the controller.
+ */
+bool
+S9sRpcClientPrivate::connectNext()
+{
+    while (m_nextAddress != NULL)
+    {
+        struct addrinfo *address = m_nextAddress;
+        char             host[NI_MAXHOST];
+        int              flags;
+
+        m_nextAddress = address->ai_next;
+
+        if (getnameinfo(address->ai_addr, address->ai_addrlen, 
+                    host, sizeof(host), NULL, 0, NI_NUMERICHOST) != 0)
+        {
+            strcpy(host, "?");
+        }
+
+        PRINT_VERBOSE("Connecting to %s:%d (%s)...", 
+                STR(m_hostName), m_port, host);
+
+        m_socketFd = socket(address->ai_family, SOCK_STREAM, 0);
+        if (m_socketFd == -1)
+        {
+            m_errorString.sprintf("Error creating socket: %m");
+            continue;
+        }
+
+        ++m_connectionSerial;
+
+        /*
+         * The socket is non-blocking, the timeouts are handled when waiting
+         * for the socket, see waitForSocket().
+         */
+        flags = fcntl(m_socketFd, F_GETFL, 0);
+        if (flags == -1 || 
+                fcntl(m_socketFd, F_SETFL, flags | O_NONBLOCK) == -1)
+        {
+            m_errorString.sprintf("Error setting socket non-blocking: %m");
+            close();
+            continue;
+        }
+
+        if (::connect(m_socketFd, address->ai_addr, address->ai_addrlen) == -1
+                && errno != EINPROGRESS)
+        {
+            m_errorString.sprintf(
+                    "Connect to %s:%d failed: %m.", 
+                    STR(m_hostName), m_port);
+      
+            close();
+            continue;
+        }
+
+        m_deadline     = monotonicMs() + m_connectTimeout;
+        m_requestState = Connecting;
+        return true;
+    }
+
+    forgetAddresses();
+    m_requestState = Failed;
+    return false;
+}
+
+/**
+ * \returns true if connecting to the next address is initiated.
+ *
+ * Called when connecting to the controller failed or timed out, closes the
+ * socket and tries the next address of the controller if there is one.
+ */
+bool
+S9sRpcClientPrivate::retryConnect()
+{
+    close();
+
+    if (m_nextAddress == NULL)
+    {
+        forgetAddresses();
+        m_requestState = Failed;
+        return false;
+    }
+
+    PRINT_VERBOSE("%s", STR(m_errorString));
+    return connectNext();
+}
+
+/**
+ * \returns The addresses of the controller or NULL if the host name could
+ *   not be resolved.
+ *
+ * Resolves the host name of the controller with getaddrinfo() (IPv4 and IPv6
+ * both). The result is cached, so the host name is resolved only once even
+ * if the client reconnects many times, until all the addresses fail (see
+ * forgetAddresses()).
+ */
+struct addrinfo *
+S9sRpcClientPrivate::resolve()
+{
+    S9sMutexLocker   locker(sm_resolverMutex);
+    S9sString        key;
+    S9sString        service;
+    struct addrinfo  hints;
+    struct addrinfo *result = NULL;
+    int              retval;
+
+    key.sprintf("%s:%d", STR(m_hostName), m_port);
+    if (sm_addresses.contains(key))
+    {
+        m_addresses = sm_addresses[key];
+        ++sm_addressRefs[m_addresses];
+        return m_addresses;
+    }
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    service.sprintf("%d", m_port);
+
+    retval = getaddrinfo(STR(m_hostName), STR(service), &hints, &result);
+    if (retval != 0)
+    {
+        m_errorString.sprintf(
+                "Host '%s' not found: %s.", 
+                STR(m_hostName), gai_strerror(retval));
+
+        return NULL;
+    }
+
+    sm_addresses[key]      = result;
+    sm_addressRefs[result] = 2;
+    m_addresses            = result;
+
+    return result;
+}
+
+/**
+ * Releases the reference to the addresses the client connected with, the
+ * list is freed if it is no longer in the cache and no other client uses it.
+ */
+void
+S9sRpcClientPrivate::releaseAddresses()
+{
+    S9sMutexLocker locker(sm_resolverMutex);
+
+    if (m_addresses == NULL)
+        return;
+
+    if (--sm_addressRefs[m_addresses] == 0)
+    {
+        sm_addressRefs.erase(m_addresses);
+        freeaddrinfo(m_addresses);
+    }
+
+    m_addresses   = NULL;
+    m_nextAddress = NULL;
+}
+
+/**
+ * Called when none of the addresses of the controller could be connected,
+ * removes them from the cache so the host name is resolved again the next
+ * time (the DNS may have changed). The clients using the list can still
+ * use it.
+ */
+void
+S9sRpcClientPrivate::forgetAddresses()
+{
+    S9sMutexLocker locker(sm_resolverMutex);
+    S9sString      key;
+
+    if (m_addresses == NULL)
+        return;
+
+    key.sprintf("%s:%d", STR(m_hostName), m_port);
+    if (!sm_addresses.contains(key) || sm_addresses[key] != m_addresses)
+        return;
+
+    sm_addresses.erase(key);
+    --sm_addressRefs[m_addresses];
+}
+
+/**
+ * \param index The index of the controller in m_endpoints.
+ *
+ * Switches to the given controller, the requests are sent to this controller
+ * from now on.
+ */
+void
+S9sRpcClientPrivate::useEndpoint(
+        uint index)
+{
+    const Endpoint &endpoint = m_endpoints[index];
+
+    if (index == m_endpointIndex && endpoint.hostName == m_hostName &&
+            endpoint.port == m_port)
+    {
+        return;
+    }
+
+    close();
+
+    for (uint idx = 0u; idx < m_batchClients.size(); ++idx)
+        delete m_batchClients[idx];
+
+    m_batchClients.clear();
+
+    m_endpointIndex = index;
+    m_hostName      = endpoint.hostName;
+    m_port          = endpoint.port;
+    m_path          = endpoint.path;
+    m_useTls        = endpoint.useTls;
+}
+
+/**
+ * \returns The index of the controller that did not fail and answered the
+ *   fastest when probed, -1 if all the controllers failed.
+ *
+ * The controllers that were not probed are considered slower than the ones
+ * that were, they are taken in the order they were added.
+ */
+int
+S9sRpcClientPrivate::bestEndpoint() const
+{
+    int retval = -1;
+
+    for (uint idx = 0u; idx < m_endpoints.size(); ++idx)
+    {
+        const Endpoint &endpoint = m_endpoints[idx];
+
+        if (endpoint.failed)
+            continue;
+
+        if (retval < 0)
+        {
+            retval = idx;
+            continue;
+        }
+
+        if (endpoint.latency < 0)
+            continue;
+
+        if (m_endpoints[retval].latency < 0 || 
+                endpoint.latency < m_endpoints[retval].latency)
+        {
+            retval = idx;
+        }
+    }
+
+    return retval;
+}
+
+/**
+ * \returns The monotonic time in milliseconds, used for the deadlines.
+ */
+long long
+S9sRpcClientPrivate::monotonicMs()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000ll + now.tv_nsec / 1000000ll;
+}
+
+/**
+ * \returns false if the TLS handshake could not be initiated.
+ *
+ * Creates the SSL object for the connection, the handshake itself is done by
+ * advance().
+ */
+bool
+S9sRpcClientPrivate::startTls()
+{
+    SSL_CTX     *context = sslContext();
+
+    PRINT_VERBOSE ("Initiate TLS...");
+
+    if (!context)
+    {
+        m_errorString = "Couldn't create SSL context.";
+        return false;
+    }
+
+    m_ssl = SSL_new(context);
+
+    if (!m_ssl)
+    {
+        m_errorString = "Couldn't create SSL.";
+        return false;
+    }
+
+    SSL_set_app_data(m_ssl, this);
+    SSL_set_fd(m_ssl, m_socketFd);
+    SSL_set_connect_state(m_ssl);
+    SSL_set_tlsext_host_name(m_ssl, STR(m_hostName));
+
+    m_tlsSessionSaved = false;
+    resumeTlsSession();
+
+    return true;
+}
+
+/**
+ * \param header The HTTP header of the request.
+ * \param payload The body of the request, the callers move it here.
+ *
+ * Prepares sending the request. If the connection is open the request is sent
+ * on it, otherwise a new connection is initiated. The request is then sent and
+ * the reply is received by advance() (or runRequest()).
+ *
+ * The header and the payload are sent together by one system call without
+ * copying the payload, see writeNonBlocking(). With TLS they are in one buffer
+ * so that they are sent in one record.
+ */
+void
+S9sRpcClientPrivate::startRequest(
+        const S9sString &header,
+        S9sString        payload)
+{
+    m_outData          = header;
+    m_outPayload.clear();
+    m_outSent          = 0;
+
+    if (m_useTls)
+        m_outData += payload;
+    else
+        m_outPayload.swap(payload);
+
+    m_reusedConnection = isConnected();
+    m_requestStarted   = monotonicMs();
+
+    if (m_reusedConnection)
+    {
+        PRINT_VERBOSE("Reusing connection to %s:%d.", 
+                STR(m_hostName), m_port);
+
+        m_deadline     = m_requestStarted + m_readTimeout;
+        m_requestState = Connected;
+    } else if (!startConnect())
+    {
+        m_requestState = Failed;
+    }
+}
+
+/**
+ * \returns The poll() events the request is waiting for or 0 if the request
+ *   is in a final state (Connected without data to send, Finished,
+ *   ConnectionClosed or Failed).
+ *
+ * Moves the request forward as far as possible without blocking: finishes the
+ * connection, the TLS handshake, sends the request and receives the reply.
+ */
+int
+S9sRpcClientPrivate::advance()
+{
+    for (;;)
+    {
+        switch (m_requestState)
+        {
+            case Connecting:
+            {
+                struct pollfd pollFd;
+                int           error = 0;
+                socklen_t     length = sizeof(error);
+
+                pollFd.fd      = m_socketFd;
+                pollFd.events  = POLLOUT;
+                pollFd.revents = 0;
+
+                if (::poll(&pollFd, 1, 0) == 0)
+                    return POLLOUT;
+
+                getsockopt(m_socketFd, SOL_SOCKET, SO_ERROR, &error, &length);
+                if (error != 0)
+                {
+                    m_errorString.sprintf(
+                            "Connect to %s:%d failed: %s.", 
+                            STR(m_hostName), m_port, strerror(error));
+
+                    if (retryConnect())
+                        break;
+
+                    return 0;
+                }
+
+                PRINT_VERBOSE("Connected.");
+                
+                if (!m_useTls)
+                {
+                    m_established  = true;
+                    m_deadline     = monotonicMs() + m_readTimeout;
+                    m_requestState = Connected;
+                } else if (startTls())
+                {
+                    m_requestState = Handshaking;
+                } else {
+                    close();
+                    m_requestState = Failed;
+                    return 0;
+                }
+            }
+            break;
+
+            case Handshaking:
+            {
+                int retval = SSL_connect(m_ssl);
+                
+                if (retval <= 0)
+                {
+                    int events = sslWantEvents(retval);
+
+                    if (events != 0)
+                        return events;
+
+                    m_errorString = "SSL handshake failed.";
+                    close();
+                    m_requestState = Failed;
+                    return 0;
+                }
+
+                sm_tlsMutex.lock();
+                ++sm_tlsHandshakes;
+                if (SSL_session_reused(m_ssl))
+                    ++sm_tlsResumed;
+                sm_tlsMutex.unlock();
+
+                PRINT_VERBOSE(
+                        "TLS handshake finished (version: %s, cipher: %s, "
+                        "resumed: %s, %d/%d resumed).",
+                        SSL_get_version(m_ssl), SSL_get_cipher(m_ssl),
+                        SSL_session_reused(m_ssl) ? "yes" : "no",
+                        sm_tlsResumed, sm_tlsHandshakes);
+
+                m_established  = true;
+                m_deadline     = monotonicMs() + m_readTimeout;
+                m_requestState = Connected;
+            }
+            break;
+
+            case Connected:
+                if (m_outData.empty())
+                    return 0;
+
+                m_requestState = Sending;
+                break;
+
+            case Sending:
+            {
+                int     events = 0;
+                ssize_t retval;
+               
+                retval = writeNonBlocking(
+                        m_outData, m_outPayload, m_outSent, events);
+
+                if (retval < 0 && events != 0)
+                {
+                    return events;
+                } else if (retval < 0 && m_reusedConnection)
+                {
+                    // The controller closed the idle connection.
+                    close();
+                    m_requestState = ConnectionClosed;
+                    return 0;
+                } else if (retval < 0)
+                {
+                    m_errorString.sprintf("Error writing socket: %m");
+                    close();
+                    m_requestState = Failed;
+                    return 0;
+                }
+
+                m_outSent += retval;
+                if (m_outSent < m_outData.length() + m_outPayload.length())
+                    break;
+
+                m_outData.clear();
+                m_outPayload.clear();
+                m_outSent          = 0;
+                startReceiving();
+            }
+            break;
+
+            case Receiving:
+            {
+                int     events = 0;
+                ssize_t readLength;
+                
+                if (!ensureHasBuffer(m_dataSize + READ_SIZE))
+                {
+                    close();
+                    m_requestState = Failed;
+                    return 0;
+                }
+
+                readLength = readNonBlocking(
+                        m_buffer + m_dataSize, m_bufferSize - m_dataSize - 1,
+                        events);
+
+                if (readLength < 0 && events != 0)
+                    return events;
+
+                m_requestState = receivedData(readLength);
+                if (m_requestState != Receiving)
+                    return 0;
+            }
+            break;
+
+            case Idle:
+            case Finished:
+            case ConnectionClosed:
+            case Failed:
+                return 0;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Resets the buffer and the framing of the reply, so the next data received
+ * is processed as the beginning of a new reply.
+ */
+void
+S9sRpcClientPrivate::startReceiving()
+{
+    m_dataSize         = 0;
+    m_readOffset       = 0;
+    m_scanOffset       = 0;
+    m_headerLength     = 0;
+    m_contentLength    = -1;
+    m_chunked          = false;
+    m_serverKeepsAlive = false;
+    m_chunkCursor      = 0;
+    m_bodyLength       = 0;
+    m_requestState     = Receiving;
+}
+
+/**
+ * \param data The data to process as if it was read from the controller.
+ * \param length The length of the data, 0 means the controller closed the
+ *   connection.
+ * \returns The state of the request, see receivedData(ssize_t).
+ *
+ * Copies the data to the end of the buffer and processes it the same way as
+ * the data read from the socket.
+ */
+S9sRpcClientPrivate::RequestState
+S9sRpcClientPrivate::receivedData(
+        const char *data,
+        size_t      length)
+{
+    if (!ensureHasBuffer(m_dataSize + length + 1))
+        return Failed;
+
+    memcpy(m_buffer + m_dataSize, data, length);
+
+    return receivedData((ssize_t) length);
+}
+
+/**
+ * \param readLength The return value of the read, the data is already in the
+ *   buffer after m_dataSize.
+ * \returns Receiving if the reply is not complete yet, Finished if a complete
+ *   reply was read, ConnectionClosed if the controller closed the connection
+ *   before sending anything and Failed on error.
+ *
+ * Processes the data read from the controller. The end of the reply is found
+ * by the Content-Length header or the chunked transfer encoding, so the
+ * connection can be used for the next request. A reply without any framing is
+ * read until the controller closes the connection.
+ *
+ * When the reply is complete the buffer holds the headers followed by the
+ * body (the chunks are decoded in place) and m_dataSize covers both.
+ */
+S9sRpcClientPrivate::RequestState
+S9sRpcClientPrivate::receivedData(
+        ssize_t readLength)
+{
+    if (readLength < 0 && m_dataSize == 0 && errno == ECONNRESET)
+    {
+        // Closed by the controller before it got our request.
+        return ConnectionClosed;
+    } else if (readLength < 0)
+    {
+        m_errorString.sprintf(
+                "Error while reading from controller (%s:%d TLS: %s): %m",
+                STR(m_hostName), m_port, m_useTls ? "yes" : "no");
+
+        return Failed;
+    } else if (readLength == 0)
+    {
+        if (m_dataSize == 0)
+            return ConnectionClosed;
+
+        if (m_headerLength > 0 && m_contentLength < 0 && !m_chunked)
+        {
+            m_bodyLength = m_dataSize - m_headerLength;
+            return Finished;
+        }
+
+        m_errorString.sprintf(
+                "Connection closed by controller (%s:%d TLS: %s) "
+                "while reading the reply.",
+                STR(m_hostName), m_port, m_useTls ? "yes" : "no");
+
+        return Failed;
+    }
+
+    m_dataSize += readLength;
+
+    if (m_headerLength == 0)
+    {
+        char *headerEnd;
+
+        headerEnd = (char *) memmem(m_buffer, m_dataSize, "\r\n\r\n", 4);
+        if (headerEnd == NULL && m_dataSize > RPC_MAX_HEADER_SIZE)
+        {
+            m_errorString.sprintf(
+                    "Too long HTTP header from controller (%s:%d TLS: %s).",
+                    STR(m_hostName), m_port, m_useTls ? "yes" : "no");
+
+            return Failed;
+        } else if (headerEnd == NULL)
+        {
+            return Receiving;
+        }
+
+        m_headerLength = headerEnd - m_buffer + 4;
+        m_chunkCursor  = m_headerLength;
+
+        if (!parseReplyHeaders(m_headerLength))
+            return Failed;
+
+        // We know the size, we can allocate the buffer in one step.
+        if (m_contentLength > 0 && 
+                !ensureHasBuffer(m_headerLength + m_contentLength + 1))
+        {
+            return Failed;
+        }
+    }
+
+    if (m_chunked)
+    {
+        RequestState state = decodeChunks();
+
+        if (state == Finished)
+            m_dataSize = m_headerLength + m_bodyLength;
+
+        return state;
+    } else if (m_contentLength >= 0)
+    {
+        if (m_dataSize >= m_headerLength + m_contentLength)
+        {
+            m_bodyLength = m_contentLength;
+            m_dataSize   = m_headerLength + m_bodyLength;
+            return Finished;
+        }
+    } else if (m_dataSize - m_headerLength > RPC_MAX_REPLY_SIZE)
+    {
+        m_errorString.sprintf(
+                "Too large reply from controller (%s:%d TLS: %s).",
+                STR(m_hostName), m_port, m_useTls ? "yes" : "no");
+
+        return Failed;
+    }
+
+    return Receiving;
+}
+
+/**
+ * \returns The state the request ended up in.
+ *
+ * Advances the request started by startRequest() (or startConnect()) waiting
+ * for the socket whenever it is needed until the request reaches a final
+ * state.
+ */
+S9sRpcClientPrivate::RequestState
+S9sRpcClientPrivate::runRequest()
+{
+    int events;
+
+    while ((events = advance()) != 0)
+    {
+        if (waitForSocket(events))
+            continue;
+
+        if (m_requestState == Connecting || m_requestState == Handshaking)
+        {
+            m_errorString.sprintf(
+                    "Timeout connecting to controller (%s:%d TLS: %s).",
+                    STR(m_hostName), m_port, m_useTls ? "yes" : "no");
+
+            if (m_requestState == Connecting && retryConnect())
+                continue;
+        } else {
+            m_errorString.sprintf(
+                    "Timeout communicating with controller "
+                    "(%s:%d TLS: %s).",
+                    STR(m_hostName), m_port, m_useTls ? "yes" : "no");
+        }
+
+        close();
+        m_requestState = Failed;
+        break;
+    }
+
+    m_latency = monotonicMs() - m_requestStarted;
+    return m_requestState;
+}
+
+/**
+ * The event loop calls this when the socket of a request is ready. Advances
+ * the request and updates the events it waits for, stops watching the socket
+ * when the request is in a final state.
+ *
+ * When advance() connects to the next address of the controller the old socket
+ * is closed (and so removed from the epoll set) and the new one usually gets
+ * the same file descriptor, so the connections are told apart by
+ * m_connectionSerial and the new socket is always watched again.
+ */
+void
+S9sRpcClientPrivate::eventCallback(
+        int   fd,
+        int   events,
+        void *userData)
+{
+    S9sRpcClientPrivate *priv = (S9sRpcClientPrivate *) userData;
+    S9sEventLoop        *eventLoop = priv->m_eventLoop;
+    uint                 connection = priv->m_connectionSerial;
+    int                  waitFor;
+
+    waitFor = priv->advance();
+
+    if (priv->m_requestState != Connecting && 
+            priv->m_requestState != Handshaking)
+    {
+        // Something received or sent, the controller is alive.
+        priv->m_deadline = monotonicMs() + priv->m_readTimeout;
+    }
+
+    if (waitFor == 0)
+    {
+        eventLoop->unwatch(fd);
+        priv->m_eventLoop = 0;
+        priv->m_latency   = monotonicMs() - priv->m_requestStarted;
+    } else if (priv->m_connectionSerial != connection)
+    {
+        // Connecting to the next address of the controller.
+        eventLoop->unwatch(fd);
+        eventLoop->watch(priv->m_socketFd, waitFor, eventCallback, priv);
+    } else {
+        eventLoop->modify(fd, waitFor);
+    }
+}
+
+/**
+ * Creates the abort pipe if it does not exist yet, reads what an earlier
+ * abortBatch() left in it if it does. Both ends are non-blocking.
+ */
+void
+S9sRpcClientPrivate::resetAbortPipe()
+{
+    char buffer[16];
+
+    if (m_abortPipe[0] >= 0)
+    {
+        while (::read(m_abortPipe[0], buffer, sizeof(buffer)) > 0)
+            ;
+
+        return;
+    }
+
+    if (::pipe(m_abortPipe) != 0)
+    {
+        S9S_WARNING("pipe(): %m");
+        m_abortPipe[0] = -1;
+        m_abortPipe[1] = -1;
+        return;
+    }
+
+    for (int idx = 0; idx < 2; ++idx)
+    {
+        fcntl(m_abortPipe[idx], F_SETFL,
+                fcntl(m_abortPipe[idx], F_GETFL) | O_NONBLOCK);
+        fcntl(m_abortPipe[idx], F_SETFD, FD_CLOEXEC);
+    }
+}
+
+/**
+ * Wakes up the event loop that drives the batch. Only writes into the pipe, so
+ * it can be called from any thread.
+ */
+void
+S9sRpcClientPrivate::writeAbortPipe()
+{
+    if (m_abortPipe[1] < 0)
+        return;
+
+    if (::write(m_abortPipe[1], "a", 1) < 0 && errno != EAGAIN)
+        S9S_WARNING("write(): %m");
+}
+
+/**
+ * The event loop calls this when abortBatch() wrote into the abort pipe. Reads
+ * what was written and sets the flag the userData points to.
+ */
+void
+S9sRpcClientPrivate::abortCallback(
+        int   fd,
+        int   events,
+        void *userData)
+{
+    bool *aborted = (bool *) userData;
+    char  buffer[16];
+
+    while (::read(fd, buffer, sizeof(buffer)) > 0)
+        ;
+
+    *aborted = true;
+}
+
+/**
+ * \param events The poll() events to wait for.
+ * \returns true if the socket is ready, false on timeout or error.
+ */
+bool
+S9sRpcClientPrivate::waitForSocket(
+        int events)
+{
+    struct pollfd pollFd;
+    int           timeout = m_readTimeout;
+    int           retval;
+
+    // While connecting the deadline is for the whole connection.
+    if (m_requestState == Connecting || m_requestState == Handshaking)
+    {
+        timeout = m_deadline - monotonicMs();
+        if (timeout < 0)
+            timeout = 0;
+    }
+
+    pollFd.fd      = m_socketFd;
+    pollFd.events  = events;
+    pollFd.revents = 0;
+
+    do {
+        retval = ::poll(&pollFd, 1, timeout);
+    } while (retval < 0 && errno == EINTR);
+
+    if (retval == 0)
+        errno = ETIMEDOUT;
+
+    return retval > 0;
+}
+
+/**
+ * \param retval The return value of the SSL function.
+ * \returns The poll() events the SSL connection is waiting for, 0 if this
+ *   is an error.
+ */
+int
+S9sRpcClientPrivate::sslWantEvents(
+        int retval) const
+{
+    switch (SSL_get_error(m_ssl, retval))
+    {
+        case SSL_ERROR_WANT_READ:
+            return POLLIN;
+
+        case SSL_ERROR_WANT_WRITE:
+            return POLLOUT;
+    }
+
+    return 0;
+}
+
+void
+S9sRpcClientPrivate::close()
+{
+    if (m_socketFd < 0)
+        return;
+
+    if (m_ssl)
+    {
+        SSL_shutdown(m_ssl);
+        SSL_free(m_ssl);
+        m_ssl = 0;
+    }
+
+    ::shutdown(m_socketFd, SHUT_RDWR);
+    ::close(m_socketFd);
+    m_socketFd = -1;
+}
+
+/**
+ * \returns true if there is an open connection to the controller that can be
+ *   used to send the next request.
+ *
+ * An idle connection should have nothing to read, if the socket is readable
+ * the controller either closed the connection or sent something we can not
+ * handle, the connection can not be reused in either case.
+ */
+bool
+S9sRpcClientPrivate::isConnected() const
+{
+    struct pollfd pollFd;
+
+    if (m_socketFd < 0)
+        return false;
+
+    pollFd.fd      = m_socketFd;
+    pollFd.events  = POLLIN;
+    pollFd.revents = 0;
+
+    if (::poll(&pollFd, 1, 0) != 0)
+        return false;
+
+    return true;
+}
+
+/**
+ * \returns The TLS context shared by all the connections.
+ *
+ * The context is created on the first call and it is never released. The
+ * context is set up to notify us about the new sessions, so we can resume them
+ * when connecting to the same controller again.
+ */
+SSL_CTX *
+S9sRpcClientPrivate::sslContext()
+{
+    S9sMutexLocker locker(sm_tlsMutex);
+
+    if (sm_sslContext != NULL)
+        return sm_sslContext;
+
+    SSL_load_error_strings ();
+    SSL_library_init ();
+
+    #if (OPENSSL_VERSION_NUMBER >= 0x10100000L)
+    sm_sslContext = SSL_CTX_new(TLS_client_method());
+    #else
+    sm_sslContext = SSL_CTX_new(SSLv23_client_method());
+    #endif
+
+    if (!sm_sslContext)
+        return NULL;
+
+    SSL_CTX_set_verify(sm_sslContext, SSL_VERIFY_NONE, NULL);
+    SSL_CTX_set_options(sm_sslContext,
+            SSL_OP_ALL | SSL_OP_NO_SSLv2 | SSL_OP_NO_SSLv3);
+    SSL_CTX_set_mode(sm_sslContext, SSL_MODE_AUTO_RETRY);
+
+    /*
+     * A reply without framing ends when the controller closes the connection
+     * and it might not send a close_notify before that. OpenSSL 3 takes that
+     * for a fatal error and drops the session, so it could not be resumed.
+     */
+    #ifdef SSL_OP_IGNORE_UNEXPECTED_EOF
+    SSL_CTX_set_options(sm_sslContext, SSL_OP_IGNORE_UNEXPECTED_EOF);
+    #endif
+
+    SSL_CTX_set_session_cache_mode(sm_sslContext,
+            SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(sm_sslContext, newTlsSessionCallback);
+
+    return sm_sslContext;
+}
+
+/**
+ * OpenSSL calls this when the controller sends a new session (with TLS 1.3
+ * possibly after the handshake, while reading the reply). Returning 1 means
+ * we keep the reference to the session.
+ */
+int
+S9sRpcClientPrivate::newTlsSessionCallback(
+        SSL         *ssl,
+        SSL_SESSION *session)
+{
+    S9sRpcClientPrivate *priv = (S9sRpcClientPrivate *) SSL_get_app_data(ssl);
+
+    if (priv == NULL)
+        return 0;
+
+    priv->saveTlsSession(session);
+    return 1;
+}
+
+/**
+ * The key identifying the controller in the TLS session cache and in the saved
+ * authenticated sessions.
+ */
+S9sString
+S9sRpcClientPrivate::controllerKey() const
+{
+    S9sString retval;
+
+    retval.sprintf("%s:%d", STR(m_hostName), m_port);
+    return retval;
+}
+
+/**
+ * \returns The file where the TLS session of the controller in use is saved
+ *   or the empty string if the sessions are not saved.
+ *
+ * The session file is set for one controller, the sessions of the other
+ * controllers are in the same directory named after the controller the way
+ * S9sOptions::tlsSessionFile() names them, so a handshake never offers the
+ * session of an other controller.
+ */
+S9sString
+S9sRpcClientPrivate::tlsSessionFile() const
+{
+    S9sString fileName;
+
+    if (m_tlsSessionFile.empty() || controllerKey() == m_tlsSessionKey)
+        return m_tlsSessionFile;
+
+    fileName.sprintf("%s_%d.tls_session", STR(m_hostName), m_port);
+    return S9sFile::buildPath(S9sFile::dirname(m_tlsSessionFile), fileName);
+}
+
+/**
+ * \returns true if a session was found to resume.
+ *
+ * Sets the session we got the last time we connected to the same controller
+ * to be resumed by the handshake. If the session is not in the memory yet and
+ * the session file is set the session is loaded from the file.
+ *
+ * The session is set while the mutex is held, a new session arriving on an
+ * other connection might free the one in the cache right after.
+ */
+bool
+S9sRpcClientPrivate::resumeTlsSession()
+{
+    S9sMutexLocker  locker(sm_tlsMutex);
+    S9sString       key = controllerKey();
+    S9sString       fileName = tlsSessionFile();
+    SSL_SESSION    *session = NULL;
+    BIO            *bio;
+
+    if (sm_tlsSessions.contains(key))
+    {
+        SSL_set_session(m_ssl, sm_tlsSessions.at(key));
+        return true;
+    }
+
+    if (fileName.empty() || !S9sFile::fileExists(fileName))
+        return false;
+
+    bio = BIO_new_file(STR(fileName), "r");
+    if (bio == NULL)
+        return false;
+
+    session = PEM_read_bio_SSL_SESSION(bio, NULL, 0, NULL);
+    BIO_free_all(bio);
+
+    if (session == NULL)
+        return false;
+
+    sm_tlsSessions[key]    = session;
+    sm_tlsSessionPems[key] = sessionPem(session);
+    SSL_set_session(m_ssl, session);
+
+    return true;
+}
+
+/**
+ * Stores the session (we take over the reference) to resume it on the next
+ * connection and also saves it into the session file if it is set. The
+ * session file holds the keys of the session so it is readable only by the
+ * user.
+ *
+ * With TLS 1.3 the controller sends more than one ticket on every connection,
+ * the file is written only for the first one and only if it is different from
+ * what the file already holds. The file is replaced by a rename, so an other
+ * process never reads it half written.
+ */
+void
+S9sRpcClientPrivate::saveTlsSession(
+        SSL_SESSION *session)
+{
+    S9sMutexLocker  locker(sm_tlsMutex);
+    S9sString       key = controllerKey();
+    S9sString       fileName = tlsSessionFile();
+    S9sString       pem;
+    S9sString       tmpFile;
+    int             fileDescriptor;
+    ssize_t         written;
+
+    if (sm_tlsSessions.contains(key))
+        SSL_SESSION_free(sm_tlsSessions[key]);
+
+    sm_tlsSessions[key] = session;
+
+    if (fileName.empty() || m_tlsSessionSaved)
+        return;
+
+    pem = sessionPem(session);
+    if (pem.empty() || 
+            (sm_tlsSessionPems.contains(key) && sm_tlsSessionPems[key] == pem))
+    {
+        return;
+    }
+
+    m_tlsSessionSaved = true;
+    tmpFile.sprintf("%s.%d", STR(fileName), (int) getpid());
+
+    fileDescriptor = ::open(STR(tmpFile),
+            O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+
+    if (fileDescriptor < 0)
+    {
+        PRINT_VERBOSE("Error opening '%s' for writing: %m", STR(tmpFile));
+        return;
+    }
+
+    // The file might have been created earlier with different permissions.
+    ::fchmod(fileDescriptor, S_IRUSR | S_IWUSR);
+
+    written = ::write(fileDescriptor, STR(pem), pem.length());
+    ::close(fileDescriptor);
+
+    if (written != (ssize_t) pem.length() || 
+            ::rename(STR(tmpFile), STR(fileName)) != 0)
+    {
+        PRINT_VERBOSE("Error writing '%s': %m", STR(fileName));
+        ::unlink(STR(tmpFile));
+        return;
+    }
+
+    sm_tlsSessionPems[key] = pem;
+}
+
+/**
+ * \returns The session in PEM format, the way it is saved in the session
+ *   file, an empty string on error.
+ */
+S9sString
+S9sRpcClientPrivate::sessionPem(
+        SSL_SESSION *session)
+{
+    S9sString  retval;
+    BIO       *bio = BIO_new(BIO_s_mem());
+    char      *data;
+    long       length;
+
+    if (bio == NULL)
+        return retval;
 
-    PRINT_VERBOSE("Connecting to %s:%d...", STR(m_hostName), m_port);
-    m_socketFd = socket(AF_INET, SOCK_STREAM, 0);
-    if (m_socketFd == -1)
+    if (PEM_write_bio_SSL_SESSION(bio, session))
     {
-        m_errorString.sprintf("Error creating socket: %m");
-        return false;
+        length = BIO_get_mem_data(bio, &data);
+        if (length > 0)
+            retval = std::string(data, length);
     }
 
-    /*
-     * Setting up a read and write timeout values
-     * (otherwise it hangs on interrupted connection)
-     */
-    timeout.tv_sec  = 240;
-    timeout.tv_usec = 0;
-    setsockopt(
-            m_socketFd, SOL_SOCKET, SO_RCVTIMEO,
-            (char*) &timeout, sizeof(timeout));
+    BIO_free_all(bio);
+    return retval;
+}
 
-    setsockopt(
-            m_socketFd, SOL_SOCKET, SO_SNDTIMEO,
-            (char*) &timeout, sizeof(timeout));
+/**
+ * \param header The first part of the data to write.
+ * \param payload The second part of the data to write.
+ * \param offset How many bytes of the two parts are already written.
+ * \param events Set to the poll() events the socket needs to be waited for if
+ *   no data could be written now.
+ * \returns The number of bytes written, -1 on error or if the socket is not
+ *   ready (events is set then).
+ *
+ * Writes the rest of the two parts together with one sendmsg(), so the HTTP
+ * header and the payload are sent without being copied into one buffer.
+ */
+ssize_t
+S9sRpcClientPrivate::writeNonBlocking(
+        const S9sString &header,
+        const S9sString &payload,
+        size_t           offset,
+        int             &events)
+{
+    struct iovec  iov[2];
+    struct msghdr message;
+    int           iovcnt = 0;
+    ssize_t       retval = -1;
 
-    /*
-     * lookup
-     */
-    hp = gethostbyname(STR(m_hostName));
-    if (hp == NULL)
+    if (offset < header.length())
     {
-        m_errorString.sprintf("Host '%s' not found.", STR(m_hostName));
-        close();
-        return false;
+        iov[iovcnt].iov_base = (void *) (header.data() + offset);
+        iov[iovcnt].iov_len  = header.length() - offset;
+        ++iovcnt;
+        offset = 0;
+    } else {
+        offset -= header.length();
     }
 
-    /*
-     * Connecting to the server.
-     * (TODO: IPv6)
-     */
-    memcpy((char *) &server.sin_addr, (char *) hp->h_addr, hp->h_length);
-    server.sin_family = AF_INET;
-    server.sin_port = htons(m_port);
-
-    if (::connect(m_socketFd, (struct sockaddr *) &server, sizeof server) == -1)
+    if (offset < payload.length())
     {
-        m_errorString.sprintf(
-                "Connect to %s:%d failed: %m.", 
-                STR(m_hostName), m_port);
-      
-        close();
-        return false;
+        iov[iovcnt].iov_base = (void *) (payload.data() + offset);
+        iov[iovcnt].iov_len  = payload.length() - offset;
+        ++iovcnt;
     }
 
-    PRINT_VERBOSE("Connected.");
+    events = 0;
+    if (iovcnt == 0)
+        return 0;
 
-    if (m_useTls)
+    if (m_ssl)
     {
-        PRINT_VERBOSE ("Initiate TLS...");
-
-        static bool openSslInitialized;
-        if (!openSslInitialized)
+        retval = SSL_write(m_ssl, iov[0].iov_base, iov[0].iov_len);
+        if (retval <= 0)
         {
-            openSslInitialized = true;
-            SSL_load_error_strings ();
-            SSL_library_init ();
+            events = sslWantEvents(retval);
+            retval = -1;
         }
 
-        #if (OPENSSL_VERSION_NUMBER >= 0x10100000L)
-        m_sslContext = SSL_CTX_new(TLS_client_method());
+        return retval;
+    }
+
+    memset(&message, 0, sizeof(message));
+    message.msg_iov    = iov;
+    message.msg_iovlen = iovcnt;
+
+    do {
+        #ifdef MSG_NOSIGNAL
+        retval = ::sendmsg(m_socketFd, &message, MSG_NOSIGNAL);
         #else
-        m_sslContext = SSL_CTX_new(SSLv23_client_method());
+        retval = ::sendmsg(m_socketFd, &message, 0);
         #endif
+    } while (retval == -1 && errno == EINTR);
 
-        if (!m_sslContext)
-        {
-            m_errorString = "Couldn't create SSL context.";
-            close();
-            return false;
-        }
+    if (retval < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        events = POLLOUT;
 
-        SSL_CTX_set_verify(m_sslContext, SSL_VERIFY_NONE, NULL);
-        SSL_CTX_set_options(m_sslContext,
-                SSL_OP_ALL | SSL_OP_NO_SSLv2 | SSL_OP_NO_SSLv3);
-        SSL_CTX_set_mode(m_sslContext, SSL_MODE_AUTO_RETRY);
+    return retval;
+}
 
-        m_ssl = SSL_new(m_sslContext);
+/**
+ * \param events Set to the poll() events the socket needs to be waited for if
+ *   no data could be read now.
+ * \returns The number of bytes read, 0 if the connection is closed, -1 on
+ *   error or if there is nothing to read now (events is set then).
+ */
+ssize_t
+S9sRpcClientPrivate::readNonBlocking(
+        char   *buffer, 
+        size_t  bufSize,
+        int    &events)
+{
+    ssize_t retval = -1;
 
-        if (!m_ssl)
+    events = 0;
+    if (m_ssl)
+    {
+        retval = SSL_read(m_ssl, buffer, bufSize);
+        if (retval <= 0)
         {
-            m_errorString = "Couldn't create SSL.";
-            close();
-            return false;
-        }
-
-        SSL_set_fd(m_ssl, m_socketFd);
-        SSL_set_connect_state(m_ssl);
-        SSL_set_tlsext_host_name(m_ssl, STR(m_hostName));
+            if (SSL_get_error(m_ssl, retval) == SSL_ERROR_ZERO_RETURN)
+                return 0;
 
-        if (SSL_connect(m_ssl) <= 0 || SSL_do_handshake(m_ssl) <= 0)
-        {
-            m_errorString = "SSL handshake failed.";
-            close();
-            return false;
+            events = sslWantEvents(retval);
+            retval = events != 0 || retval < 0 ? -1 : 0;
         }
 
-        PRINT_VERBOSE("TLS handshake finished (version: %s, cipher: %s).",
-            SSL_get_version(m_ssl), SSL_get_cipher(m_ssl));
+        return retval;
     }
 
-    return true;
+    do {
+        retval = ::read(m_socketFd, buffer, bufSize);
+    } while (retval == -1 && errno == EINTR);
+
+    if (retval < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        events = POLLIN;
+
+    return retval;
 }
 
-void
-S9sRpcClientPrivate::close()
+/**
+ * write safely to a socket (waits until all the data is written), the header
+ * and the payload are written together, see writeNonBlocking().
+ */
+ssize_t
+S9sRpcClientPrivate::write(
+        const S9sString &header,
+        const S9sString &payload)
 {
-    if (m_socketFd < 0)
-        return;
+    size_t length  = header.length() + payload.length();
+    size_t written = 0;
 
-    if (m_ssl)
+    while (written < length)
     {
-        SSL_shutdown(m_ssl);
-        SSL_free(m_ssl);
-        m_ssl = 0;
-    }
+        int     events;
+        ssize_t retval;
+        
+        retval = writeNonBlocking(header, payload, written, events);
+        if (retval < 0 && events != 0)
+        {
+            if (!waitForSocket(events))
+                return -1;
 
-    if (m_sslContext)
-    {
-        SSL_CTX_free(m_sslContext);
-        m_sslContext = 0;
+            continue;
+        } else if (retval < 0)
+        {
+            return -1;
+        }
+
+        written += retval;
     }
 
-    ::shutdown(m_socketFd, SHUT_RDWR);
-    ::close(m_socketFd);
+    return written;
 }
 
 /**
- * write safely to a socket
+ * read safely from a socket (waits until some data is available)
  */
 ssize_t
-S9sRpcClientPrivate::write(
-        const char *data, 
-        size_t      length)
+S9sRpcClientPrivate::read(
+        char   *buffer, 
+        size_t  bufSize)
 {
-    ssize_t retval = -1;
+    for (;;)
+    {
+        int     events;
+        ssize_t retval;
+        
+        retval = readNonBlocking(buffer, bufSize, events);
+        if (retval < 0 && events != 0)
+        {
+            if (!waitForSocket(events))
+                return -1;
 
-    if (m_ssl)
-        return SSL_write(m_ssl, data, length);
+            continue;
+        }
 
-    do {
-        retval = ::write(m_socketFd, data, length);
-    } while (retval == -1 && errno == EINTR);
+        return retval;
+    }
 
-    return retval;
+    return -1;
 }
 
 /**
- * read safely from a socket
+ * \param headerLength The length of the status line and the headers including
+ *   the empty line closing them.
+ * \returns false if the reply is not a valid HTTP reply.
+ *
+ * Parses the headers that are needed to find the end of the reply and to
+ * decide if the connection can be used for the next request.
  */
-ssize_t
-S9sRpcClientPrivate::read(
-        char   *buffer, 
-        size_t  bufSize)
+bool
+S9sRpcClientPrivate::parseReplyHeaders(
+        size_t headerLength)
 {
-    ssize_t retval = -1;
-    int     loopCount = 0;
+    const char *cursor = m_buffer;
+    const char *end    = m_buffer + headerLength;
 
-    if (m_ssl)
+    if (headerLength < 12 || strncmp(m_buffer, "HTTP/1.", 7) != 0)
     {
-        S9S_WARNING("calling SSL_read");
-        return SSL_read(m_ssl, buffer, bufSize);
+        m_errorString.sprintf(
+                "Invalid HTTP reply from controller (%s:%d TLS: %s).",
+                STR(m_hostName), m_port, m_useTls ? "yes" : "no");
+
+        return false;
     }
 
-    do {
-        S9S_WARNING("calling read");
-        retval = ::read(m_socketFd, buffer, bufSize);
+    // HTTP/1.1 keeps the connection by default, HTTP/1.0 does not.
+    m_serverKeepsAlive = m_buffer[7] == '1';
+
+    while (cursor < end)
+    {
+        const char *lineEnd;
+        const char *colon;
 
-        loopCount += 1;
-        if (loopCount > 100)
+        lineEnd = (const char *) memchr(cursor, '\n', end - cursor);
+        if (lineEnd == NULL)
             break;
-    } while (retval == -1 && errno == EINTR);
 
-    return retval;
+        colon = (const char *) memchr(cursor, ':', lineEnd - cursor);
+        if (colon != NULL)
+        {
+            S9sString name  = std::string(cursor, colon - cursor);
+            S9sString value = std::string(colon + 1, lineEnd - colon - 1);
+
+            name  = name.toLower();
+            value = value.trim(" \t\r").toLower();
+
+            if (name == "content-length")
+            {
+                unsigned long long length;
+                char              *lengthEnd;
+
+                errno  = 0;
+                length = strtoull(STR(value), &lengthEnd, 10);
+
+                if (!isdigit((unsigned char) value[0]) || 
+                        *lengthEnd != '\0' || errno == ERANGE || 
+                        length > RPC_MAX_REPLY_SIZE)
+                {
+                    m_errorString.sprintf(
+                            "Invalid Content-Length '%s' in reply from "
+                            "controller (%s:%d TLS: %s).",
+                            STR(value), 
+                            STR(m_hostName), m_port, 
+                            m_useTls ? "yes" : "no");
+
+                    return false;
+                }
+
+                m_contentLength = (ssize_t) length;
+            } else if (name == "transfer-encoding")
+            {
+                m_chunked = value.contains("chunked");
+            } else if (name == "connection")
+            {
+                if (value.contains("close"))
+                    m_serverKeepsAlive = false;
+                else if (value.contains("keep-alive"))
+                    m_serverKeepsAlive = true;
+            }
+        }
+
+        cursor = lineEnd + 1;
+    }
+
+    // Without framing the reply ends when the connection is closed.
+    if (!m_chunked && m_contentLength < 0)
+        m_serverKeepsAlive = false;
+
+    return true;
+}
+
+/**
+ * \returns Finished if the last chunk of the reply is received, Receiving if
+ *   more data is needed and Failed if the chunked encoding is invalid.
+ *
+ * Decodes the chunked transfer encoding in place. The chunks that are already
+ * received are moved right after the headers, so when the last chunk arrives
+ * the body is in one piece. Can be called repeatedly as new data arrives, the
+ * chunks are processed only once.
+ */
+S9sRpcClientPrivate::RequestState
+S9sRpcClientPrivate::decodeChunks()
+{
+    for (;;)
+    {
+        char               *chunkStart = m_buffer + m_chunkCursor;
+        size_t              available  = m_dataSize - m_chunkCursor;
+        char               *lineEnd;
+        char               *sizeEnd;
+        char               *chunkData;
+        unsigned long long  chunkSize;
+
+        lineEnd = (char *) memmem(chunkStart, available, "\r\n", 2);
+        if (lineEnd == NULL && available > RPC_MAX_HEADER_SIZE)
+        {
+            m_errorString.sprintf(
+                    "Too long chunk size line in reply from controller "
+                    "(%s:%d TLS: %s).",
+                    STR(m_hostName), m_port, m_useTls ? "yes" : "no");
+
+            return Failed;
+        } else if (lineEnd == NULL)
+        {
+            return Receiving;
+        }
+
+        // The hexadecimal size might be followed by chunk extensions.
+        errno     = 0;
+        chunkSize = strtoull(chunkStart, &sizeEnd, 16);
+        if (!isxdigit((unsigned char) *chunkStart) || errno == ERANGE ||
+                (sizeEnd != lineEnd && strchr("; \t", *sizeEnd) == NULL))
+        {
+            m_errorString.sprintf(
+                    "Invalid chunk size in reply from controller "
+                    "(%s:%d TLS: %s).",
+                    STR(m_hostName), m_port, m_useTls ? "yes" : "no");
+
+            return Failed;
+        } else if (chunkSize > RPC_MAX_REPLY_SIZE - m_bodyLength)
+        {
+            m_errorString.sprintf(
+                    "Too large reply from controller (%s:%d TLS: %s).",
+                    STR(m_hostName), m_port, m_useTls ? "yes" : "no");
+
+            return Failed;
+        }
+
+        if (chunkSize == 0)
+        {
+            // The last chunk is followed by the optional trailers and an empty
+            // line.
+            available = m_dataSize - (lineEnd - m_buffer);
+            if (memmem(lineEnd, available, "\r\n\r\n", 4) != NULL)
+                return Finished;
+
+            if (available > RPC_MAX_HEADER_SIZE)
+            {
+                m_errorString.sprintf(
+                        "Too long trailer in reply from controller "
+                        "(%s:%d TLS: %s).",
+                        STR(m_hostName), m_port, m_useTls ? "yes" : "no");
+
+                return Failed;
+            }
+
+            return Receiving;
+        }
+
+        chunkData = lineEnd + 2;
+        available = m_dataSize - (chunkData - m_buffer);
+        if (available < chunkSize + 2)
+            return Receiving;
+
+        if (chunkData[chunkSize] != '\r' || chunkData[chunkSize + 1] != '\n')
+        {
+            m_errorString.sprintf(
+                    "Missing CRLF after chunk in reply from controller "
+                    "(%s:%d TLS: %s).",
+                    STR(m_hostName), m_port, m_useTls ? "yes" : "no");
+
+            return Failed;
+        }
+
+        memmove(m_buffer + m_headerLength + m_bodyLength, chunkData, chunkSize);
+        m_bodyLength  += chunkSize;
+        m_chunkCursor  = chunkData + chunkSize + 2 - m_buffer;
+    }
+
+    return Receiving;
 }
 
 /**
  * A bit higher level method, to parse out the cookies (HTTP session data) from
- * the read data (m_buffer)
+ * the read data (m_buffer). The headers are scanned in place, nothing is
+ * copied but the cookies and the server name.
  */
 void
 S9sRpcClientPrivate::parseHeaders()
 {
-    int lastIdx = 0;
+    const char *cursor = m_buffer;
+    const char *end;
+
+    m_contentEncoding.clear();
 
     if (!m_buffer || m_dataSize < 12)
         return;
 
-    S9sRegExp regexp("Set-Cookie: ([^=]*)=([^,;\r\n]*)");
-    regexp.setIgnoreCase(true);
+    end = (const char *) memmem(m_buffer, m_dataSize, "\r\n\r\n", 4);
+    if (end == NULL)
+        end = m_buffer + m_dataSize;
 
-    S9sString buffer;
+    while (cursor < end)
+    {
+        const char *lineEnd;
+        const char *value;
 
-    buffer.assign(m_buffer, m_dataSize);
+        lineEnd = (const char *) memchr(cursor, '\n', end - cursor);
+        if (lineEnd == NULL)
+            lineEnd = end;
 
-    while (lastIdx < (int) buffer.size() && regexp == buffer.substr(lastIdx))
-    {
-        m_cookies[regexp[1]] = regexp[2];
-        lastIdx += regexp.firstIndex()+1;
-    }
+        if (lineEnd - cursor > 11 && strncasecmp(cursor, "Set-Cookie:", 11) == 0)
+        {
+            const char *equal;
+            const char *valueEnd;
+
+            value = cursor + 11;
+            while (value < lineEnd && *value == ' ')
+                ++value;
+
+            equal = (const char *) memchr(value, '=', lineEnd - value);
+            if (equal != NULL)
+            {
+                valueEnd = equal + 1;
+                while (valueEnd < lineEnd && strchr(",;\r", *valueEnd) == NULL)
+                    ++valueEnd;
+
+                m_cookies[std::string(value, equal - value)] = 
+                    std::string(equal + 1, valueEnd - equal - 1);
+            }
+        } else if (lineEnd - cursor > 7 && strncasecmp(cursor, "Server:", 7) == 0)
+        {
+            const char *valueEnd = lineEnd;
+
+            value = cursor + 7;
+            while (value < lineEnd && *value == ' ')
+                ++value;
+
+            if (valueEnd > value && valueEnd[-1] == '\r')
+                --valueEnd;
+
+            m_serverHeader = std::string(value, valueEnd - value);
+        } else if (lineEnd - cursor > 17 && 
+                strncasecmp(cursor, "Content-Encoding:", 17) == 0)
+        {
+            const char *valueEnd = lineEnd;
+
+            value = cursor + 17;
+            while (value < lineEnd && *value == ' ')
+                ++value;
 
-    lastIdx = 0;
-    regexp  = S9sRegExp("Server: ([^\r\n]*)");
+            if (valueEnd > value && valueEnd[-1] == '\r')
+                --valueEnd;
 
-    if (regexp == buffer.substr(lastIdx))
-        m_serverHeader = regexp[1];
+            m_contentEncoding = 
+                S9sString(std::string(value, valueEnd - value)).toLower();
+        }
+
+        cursor = lineEnd + 1;
+    }
 }
 
 /**
@@ -352,6 +1910,119 @@ S9sRpcClientPrivate::cookieHeaders() const
     return cookieHeader;
 }
 
+/**
+ * \returns true if the saved session was found and loaded.
+ *
+ * Loads the session cookies saved by saveSession(). The session is ignored if
+ * it is expired, if it belongs to an other user or controller or if the file
+ * is accessible by other users.
+ */
+bool
+S9sRpcClientPrivate::loadSession()
+{
+    S9sOptions    *options = S9sOptions::instance();
+    S9sFile        file(m_sessionFile);
+    S9sString      content;
+    S9sVariantMap  session;
+    struct stat    fileStat;
+
+    if (m_sessionFile.empty() || !file.exists())
+        return false;
+
+    if (::stat(STR(m_sessionFile), &fileStat) != 0 ||
+            fileStat.st_uid != getuid() ||
+            (fileStat.st_mode & (S_IRWXG | S_IRWXO)) != 0)
+    {
+        PRINT_VERBOSE("Ignoring session file '%s': bad owner or permissions.",
+                STR(m_sessionFile));
+
+        return false;
+    }
+
+    if (!file.readTxtFile(content) || !session.parse(STR(content)))
+        return false;
+
+    if (session["controller"].toString() != controllerKey() ||
+            session["user_name"].toString() != options->userName() ||
+            session["expires"].toULongLong() <= (ulonglong) time(NULL))
+    {
+        return false;
+    }
+
+    m_cookies         = session["cookies"].toVariantMap();
+    m_serverHeader    = session["server"].toString();
+    m_sessionFromFile = !m_cookies.empty();
+
+    return m_sessionFromFile;
+}
+
+/**
+ * Saves the session cookies of the authenticated user so that the next s9s
+ * process can use the same session without authenticating again. The file
+ * holds the session ID so it is created readable only by the user. It is
+ * written under a temporary name and renamed, so a process starting at the
+ * same time never reads it half written.
+ */
+void
+S9sRpcClientPrivate::saveSession()
+{
+    S9sOptions    *options = S9sOptions::instance();
+    S9sVariantMap  session;
+    S9sString      content;
+    S9sString      tmpFile;
+    int            fileDescriptor;
+    ssize_t        written;
+
+    if (m_sessionFile.empty() || m_cookies.empty())
+        return;
+
+    session["controller"] = controllerKey();
+    session["user_name"]  = options->userName();
+    session["cookies"]    = m_cookies;
+    session["server"]     = m_serverHeader;
+    session["expires"]    = (ulonglong) time(NULL) + m_sessionLifetime;
+    content               = session.toString() + "\n";
+
+    tmpFile.sprintf("%s.%d", STR(m_sessionFile), (int) getpid());
+    fileDescriptor = ::open(STR(tmpFile),
+            O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+
+    if (fileDescriptor < 0)
+    {
+        PRINT_VERBOSE("Error opening '%s' for writing: %m", STR(tmpFile));
+        return;
+    }
+
+    // The file might have been created earlier with different permissions.
+    ::fchmod(fileDescriptor, S_IRUSR | S_IWUSR);
+
+    written = ::write(fileDescriptor, STR(content), content.size());
+    ::close(fileDescriptor);
+
+    if (written != (ssize_t) content.size() ||
+            ::rename(STR(tmpFile), STR(m_sessionFile)) != 0)
+    {
+        PRINT_VERBOSE("Error writing '%s': %m", STR(m_sessionFile));
+        ::unlink(STR(tmpFile));
+        return;
+    }
+
+    m_sessionFromFile = false;
+}
+
+/**
+ * Removes the saved session, called when the controller does not accept it
+ * any more.
+ */
+void
+S9sRpcClientPrivate::removeSession()
+{
+    m_sessionFromFile = false;
+
+    if (!m_sessionFile.empty())
+        ::unlink(STR(m_sessionFile));
+}
+
 /**
  * This simply returns the value of 'Server' header from the reply.
  */
@@ -372,7 +2043,8 @@ S9sRpcClientPrivate::setBuffer(
 {
     clearBuffer();   
 
-    ensureHasBuffer(content.size() + additionalSize + 1);
+    if (!ensureHasBuffer(content.size() + additionalSize + 1))
+        return;
 
     memcpy(m_buffer, STR(content), content.size());
     m_dataSize = content.size();
@@ -435,93 +2107,74 @@ S9sRpcClientPrivate::printBuffer(
 }
 
 /**
- * \returns True if there is at least one complete JSon string is in the 
- * buffer.
+ * \param record Set to point to the next record in the buffer.
+ * \param length Set to the length of the record.
+ * \param atEnd True if the controller closed the connection, then the data
+ *   after the last separator is also returned as a record.
+ * \returns True if a record was found.
  *
- * This method can be used when processing a JSon stream, otherwise it may
- * return false negatives. When streaming the end of the JSon string is marked
- * by either a '\036' character or an empty line.
+ * This method can be used only when JSon streaming is processed. When streaming
+ * the end of the JSon string is marked by either a '\036' character or an empty
+ * line. The record is not copied, it points into the buffer and it is valid
+ * until the buffer is read into again. The record is consumed by this call, the
+ * data that was searched without finding a separator is not searched again.
  */
 bool
-S9sRpcClientPrivate::hasCompleteJSon() const
+S9sRpcClientPrivate::nextRecord(
+        const char *&record,
+        size_t      &length,
+        bool         atEnd)
 {
+    const char *start;
+    const char *scan;
+    const char *end;
+    const char *separator;
+    const char *emptyLine;
+
     if (m_buffer == NULL)
         return false;
 
-    if (memmem(m_buffer, m_dataSize, "\n\n", 2) != NULL)
-        return true;
-
-    if (memchr(m_buffer, m_dataSize, '\036') != NULL)
-        return true;
-
-    return false;
-}
-
-/**
- * \returns One JSon string.
- *
- * This method can be used only when JSon streaming is processed. When streaming
- * the end of the JSon string is marked by either a '\036' character or an empty
- * line.
- */
-S9sString 
-S9sRpcClientPrivate::getCompleteJSon() const
-{
-    S9sString retval;
-    char      previousChar = '\0';
-
-    for (uint idx = 0; idx < m_dataSize; ++idx)
+    // Skipping the separators and the white space between the records.
+    while (m_readOffset < m_dataSize && strchr(
+                "\036\n\r\t ", m_buffer[m_readOffset]) != NULL)
     {
-        char c = m_buffer[idx];
-
-        if (idx == 0 && c == '\036')
-            continue;
-
-        if (c == '\036')
-            break;
-
-        if (c == '\n' && previousChar == '\n')
-            break;
-
-        retval += c;
-        previousChar = c;
+        ++m_readOffset;
     }
 
-    return retval;
-}
-
-/**
- * \returns True if the JSon string was removed from the buffer.
- *
- * This method can be used only when JSon streaming is processed. When streaming
- * the end of the JSon string is marked by either a '\036' character or an empty
- * line.
- */
-bool
-S9sRpcClientPrivate::skipRecord()
-{
-    char *nextRecord;
-    size_t remaining;
-    size_t recordSize;
-    
-    nextRecord = (char *) memmem(m_buffer, m_dataSize, "\n\n", 2);
-    if (nextRecord == NULL)
+    if (m_readOffset >= m_dataSize)
         return false;
 
-    nextRecord += 2;
-    if (*nextRecord == '\036')
-        ++nextRecord;
+    if (m_scanOffset < m_readOffset)
+        m_scanOffset = m_readOffset;
 
-    recordSize = nextRecord - m_buffer;
-    remaining  = m_dataSize - recordSize;
-    if (remaining == 0)
+    start     = m_buffer + m_readOffset;
+    scan      = m_buffer + m_scanOffset;
+    end       = m_buffer + m_dataSize;
+    separator = (const char *) memchr(scan, '\036', end - scan);
+    emptyLine = (const char *) memmem(
+            scan, (separator ? separator : end) - scan, "\n\n", 2);
+
+    if (emptyLine != NULL)
     {
-        m_dataSize = 0;
-        return true;
+        record       = start;
+        length       = emptyLine + 1 - start;
+        m_readOffset = emptyLine + 2 - m_buffer;
+    } else if (separator != NULL)
+    {
+        record       = start;
+        length       = separator - start;
+        m_readOffset = separator - m_buffer;
+    } else if (atEnd)
+    {
+        record       = start;
+        length       = end - start;
+        m_readOffset = m_dataSize;
+    } else {
+        // The last byte might be the first half of an empty line.
+        m_scanOffset = m_dataSize - 1;
+        return false;
     }
 
-    memmove(m_buffer, nextRecord, remaining);
-    m_dataSize = remaining;
+    m_scanOffset = m_readOffset;
     return true;
 }
-
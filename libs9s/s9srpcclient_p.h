@@ -5,15 +5,62 @@
 
 #include <cstdlib>
 #include <openssl/ssl.h>
+#include <netdb.h>
 
 #include "S9sString"
+#include "S9sMap"
+#include "S9sMutex"
+#include "S9sEventLoop"
+#include "S9sVector"
 #include "S9sRpcReply"
 #include "S9sVariantMap"
 #include "s9srpcclient.h"
 
+#define READ_SIZE 10240
+#define RPC_TIMEOUT_MS 240000
+#define RPC_CONNECT_TIMEOUT_MS 10000
+
+/*
+ * The limits of the replies: the status line with the headers (and also the
+ * chunk size lines and the trailers) and the body of the reply.
+ */
+#define RPC_MAX_HEADER_SIZE (64 * 1024)
+#define RPC_MAX_REPLY_SIZE ((size_t) 1024 * 1024 * 1024)
+
 class S9sRpcClientPrivate
 {
     public:
+        /**
+         * The states of a request driven by advance().
+         */
+        enum RequestState
+        {
+            Idle,
+            Connecting,
+            Handshaking,
+            Connected,
+            Sending,
+            Receiving,
+            Finished,
+            ConnectionClosed,
+            Failed
+        };
+
+        /**
+         * A controller the client can send the requests to, see
+         * S9sRpcClient::addController().
+         */
+        struct Endpoint
+        {
+            S9sString   hostName;
+            int         port;
+            S9sString   path;
+            bool        useTls;
+            /** How long the last probe took in ms, -1 if not known. */
+            int         latency;
+            bool        failed;
+        };
+
         S9sRpcClientPrivate();
         ~S9sRpcClientPrivate();
 
@@ -22,25 +69,80 @@ class S9sRpcClientPrivate
 
         void printBuffer(const S9sString &title);
 
-        bool hasCompleteJSon() const;
-        S9sString getCompleteJSon() const;
-        bool skipRecord();
+        bool nextRecord(
+                const char *&record, 
+                size_t      &length,
+                bool         atEnd = false);
 
     private:
         void clearBuffer();
-        void ensureHasBuffer(size_t size);
+        void detachBuffer();
+        bool ensureHasBuffer(size_t size);
+        void compactBuffer();
 
         bool connect();
+        bool startConnect();
+        bool connectNext();
+        bool retryConnect();
+        struct addrinfo *resolve();
+        void releaseAddresses();
+        void forgetAddresses();
+        void useEndpoint(uint index);
+        int bestEndpoint() const;
+        bool startTls();
         void close();
-        ssize_t write(const char *data, size_t length);
+        bool isConnected() const;
+
+        void startRequest(
+                const S9sString &header, 
+                S9sString        payload);
+        int advance();
+        RequestState runRequest();
+        void startReceiving();
+        RequestState receivedData(ssize_t readLength);
+        RequestState receivedData(const char *data, size_t length);
+        bool waitForSocket(int events);
+        int sslWantEvents(int retval) const;
+
+        ssize_t writeNonBlocking(
+                const S9sString &header, const S9sString &payload, 
+                size_t offset, int &events);
+        ssize_t readNonBlocking(
+                char *buffer, size_t bufSize, int &events);
+
+        ssize_t write(const S9sString &header, const S9sString &payload);
         ssize_t read(char *buffer, size_t bufSize);
 
         void setBuffer(S9sString &content, int additionalSize = 0);
 
+        bool parseReplyHeaders(size_t headerLength);
+        RequestState decodeChunks();
+
         void parseHeaders();
         S9sString cookieHeaders() const;
         S9sString serverVersionString() const;
 
+        S9sString controllerKey() const;
+
+        bool loadSession();
+        void saveSession();
+        void removeSession();
+
+        S9sString tlsSessionFile() const;
+        bool resumeTlsSession();
+        void saveTlsSession(SSL_SESSION *session);
+        static S9sString sessionPem(SSL_SESSION *session);
+
+        void resetAbortPipe();
+        void writeAbortPipe();
+
+        static void eventCallback(int fd, int events, void *userData);
+        static void abortCallback(int fd, int events, void *userData);
+        static long long monotonicMs();
+
+        static SSL_CTX *sslContext();
+        static int newTlsSessionCallback(SSL *ssl, SSL_SESSION *session);
+
     private:
         int             m_referenceCounter;
         ulonglong       m_requestId;
@@ -49,21 +151,126 @@ class S9sRpcClientPrivate
         int             m_port;
         S9sString       m_path;
         bool            m_useTls;
+        bool            m_keepAlive;
+        bool            m_compression;
         S9sString       m_errorString;
-        S9sString       m_jsonReply;
         S9sRpcReply     m_reply;
         char           *m_buffer;
         size_t          m_bufferSize;
         size_t          m_dataSize;
-        SSL_CTX        *m_sslContext;
+        size_t          m_readOffset;
+        size_t          m_scanOffset;
         SSL            *m_ssl;
+        S9sString       m_tlsSessionFile;
+        S9sString       m_tlsSessionKey;
+        bool            m_tlsSessionSaved;
         S9sVariantMap   m_cookies;
         S9sString       m_serverHeader;
+        S9sString       m_contentEncoding;
 
         S9sJSonHandler  m_callbackFunction;
         void           *m_callbackUserData;
         bool            m_authenticated;
+
+        /*
+         * The HTTP/1.1 framing of the reply we are currently reading, see
+         * receivedData().
+         */
+        size_t          m_headerLength;
+        ssize_t         m_contentLength;
+        bool            m_chunked;
+        bool            m_serverKeepsAlive;
+        size_t          m_chunkCursor;
+        size_t          m_bodyLength;
+
+        /*
+         * The file where the authenticated session is saved, see
+         * saveSession().
+         */
+        S9sString       m_sessionFile;
+        int             m_sessionLifetime;
+        bool            m_sessionFromFile;
+
+        /*
+         * The request being sent and received without blocking, see
+         * advance(). The m_connectionSerial is increased for every socket
+         * created, the event loop can tell a new connection from the old one
+         * even if the new socket has the same file descriptor.
+         */
+        RequestState    m_requestState;
+        S9sString       m_outData;
+        S9sString       m_outPayload;
+        size_t          m_outSent;
+        bool            m_reusedConnection;
+        S9sEventLoop   *m_eventLoop;
+        uint            m_connectionSerial;
+
+        /*
+         * The deadlines: the connection (with the TLS handshake) has to be
+         * established in m_connectTimeout ms, then the controller has to send
+         * something in every m_readTimeout ms. The m_deadline is the
+         * monotonic time the current wait expires. The m_established is set
+         * when the connection is established, so a failed request that was
+         * never sent can be sent to an other controller.
+         */
+        int              m_connectTimeout;
+        int              m_readTimeout;
+        long long        m_deadline;
+        bool             m_established;
+        long long        m_requestStarted;
+        int              m_latency;
+        struct addrinfo *m_addresses;
+        struct addrinfo *m_nextAddress;
+
+        /*
+         * The controllers the requests can be sent to, the one in use is
+         * m_endpointIndex (its data is also in m_hostName, m_port etc.).
+         */
+        S9sVector<Endpoint>       m_endpoints;
+        uint                      m_endpointIndex;
+        bool                      m_failedOver;
+
+        /*
+         * The requests collected between beginBatch() and executeBatch() and
+         * the clients that send them, each on its own connection.
+         */
+        bool                      m_batchMode;
+        S9sVector<S9sString>      m_batchUris;
+        S9sVector<S9sVariantMap>  m_batchRequests;
+        S9sVector<S9sRpcClient *> m_batchClients;
+
+        /*
+         * The pipe abortBatch() writes into, possibly from an other thread.
+         * The event loop that drives the batch watches the reading end.
+         */
+        int                       m_abortPipe[2];
+
+        /*
+         * The TLS context is shared by all the connections, the sessions are
+         * stored by the controller (host:port) to resume them when
+         * reconnecting. The PEM of the session last written to (or read
+         * from) the session file is kept to write the file only if the
+         * session changed.
+         */
+        static SSL_CTX                           *sm_sslContext;
+        static S9sMap<S9sString, SSL_SESSION *>   sm_tlsSessions;
+        static S9sMap<S9sString, S9sString>       sm_tlsSessionPems;
+        static S9sMutex                           sm_tlsMutex;
+        static int                                sm_tlsHandshakes;
+        static int                                sm_tlsResumed;
+
+        /*
+         * The addresses resolved by getaddrinfo() by host:port. The lists
+         * are reference counted: the cache holds one reference and every
+         * client holds one for the list it connects with (m_addresses). The
+         * list is removed from the cache when all of its addresses failed,
+         * so the host name is resolved again, and it is freed when the last
+         * client releases it.
+         */
+        static S9sMap<S9sString, struct addrinfo *> sm_addresses;
+        static S9sMap<struct addrinfo *, int>     sm_addressRefs;
+        static S9sMutex                           sm_resolverMutex;
         
         friend class S9sRpcClient;
+        friend class UtS9sRpcClient;
 };
-
@@ -22,6 +22,8 @@
 #include <stdio.h>
 
 #include "S9sOptions"
+#include "S9sOutput"
+#include "S9sTable"
 #include "S9sDateTime"
 #include "S9sFile"
 #include "S9sFormat"
@@ -42,6 +44,7 @@
 #include "S9sJob"
 #include "S9sContainer"
 #include "S9sStringList"
+#include "S9sJsonWriter"
 
 //#define DEBUG
 //#define WARNING
@@ -214,31 +217,20 @@ S9sRpcReply::jobs()
 int
 S9sRpcReply::jobId() const
 {
-    S9sVariantMap job;
-    int           retval = -1;
+    static const S9sVariantPath path("job/job_id");
 
     if (!contains("job"))
-        return retval;
+        return -1;
 
-    job = at("job").toVariantMap();
-    retval = job["job_id"].toInt();
-
-    return retval;
+    return valueByPath(path).toInt();
 }
 
 S9sString
 S9sRpcReply::jobTitle() const
 {
-    S9sVariantMap job;
-    S9sString     retval;
-
-    if (!contains("job"))
-        return retval;
+    static const S9sVariantPath path("job/title");
 
-    job = at("job").toVariantMap();
-    retval = job["title"].toString();
-
-    return retval;
+    return valueByPath(path).toString();
 }
 
 /**
@@ -247,16 +239,9 @@ S9sRpcReply::jobTitle() const
 bool
 S9sRpcReply::isJobFailed() const
 {
-    S9sVariantMap job;
-    bool          retval = false;
-
-    if (!contains("job"))
-        return retval;
+    static const S9sVariantPath path("job/status");
 
-    job = at("job").toVariantMap();
-    retval = job["status"].toString() == "FAILED";
-
-    return retval;
+    return valueByPath(path).toString() == "FAILED";
 }
 
 /**
@@ -317,7 +302,7 @@ S9sRpcReply::printCat()
 
     if (options->isJsonRequested())
     {
-        printf("%s\n", STR(toString()));
+        printJson();
     } else if (!isOk())
     {
         PRINT_ERROR("%s", STR(errorString()));
@@ -334,7 +319,7 @@ S9sRpcReply::printAcl()
 
     if (options->isJsonRequested())
     {
-        printf("%s\n", STR(toString()));
+        printJson();
     } else if (!isOk())
     {
         PRINT_ERROR("%s", STR(errorString()));
@@ -369,7 +354,7 @@ S9sRpcReply::printClusterList()
     S9sOptions *options = S9sOptions::instance();
 
     if (options->isJsonRequested())
-        printf("%s\n", STR(toString()));
+        printJson();
     else if (!isOk())
         PRINT_ERROR("%s", STR(errorString()));
     else if (options->isStatRequested())
@@ -545,7 +530,7 @@ S9sRpcReply::printMessages(
         
     if (options->isJsonRequested())
     {
-        printf("%s\n", STR(toString()));
+        printJson();
         return;
     }
 
@@ -599,7 +584,7 @@ S9sRpcReply::printCheckHostsReply()
    
     if (options->isJsonRequested())
     {
-        printf("%s\n", STR(toString()));
+        printJson();
         return;
     }
 
@@ -678,7 +663,7 @@ S9sRpcReply::printJobLog()
 
     if (options->isJsonRequested())
     {
-        printf("%s\n", STR(toString()));
+        printJson();
         return;
     } else if (options->isLongRequested())
     {
@@ -759,7 +744,8 @@ S9sRpcReply::printProcessList()
 
     if (options->isJsonRequested())
     {
-        printf("\n%s\n", STR(toString()));
+        printf("\n");
+        printJson();
         return;
     } else if (!isOk())
     {
@@ -886,7 +872,7 @@ S9sRpcReply::printProcessListLong(
         virtFormat.widen("VIRT");
         resFormat.widen("RES");
 
-        printf("%s", headerColorBegin());
+        S9sOutput::write(headerColorBegin());
 
         pidFormat.printf("PID");
         userFormat.printf("USER");
@@ -925,13 +911,13 @@ S9sRpcReply::printProcessListLong(
 
         pidFormat.printf(pid);
 
-        printf("%s", userColorBegin());        
+        S9sOutput::write(userColorBegin());        
         userFormat.printf(user);
-        printf("%s", userColorEnd());
+        S9sOutput::write(userColorEnd());
         
-        printf("%s", serverColorBegin());
+        S9sOutput::write(serverColorBegin());
         hostFormat.printf(hostName);
-        printf("%s", serverColorEnd()); 
+        S9sOutput::write(serverColorEnd()); 
 
         priorityFormat.printf(priority);
 
@@ -946,9 +932,9 @@ S9sRpcReply::printProcessListLong(
         printf("%6.2f ", cpuUsage);
         printf("%6.2f ", memUsage); 
         
-        ::printf("%s", executableColorBegin(executable));
+        S9sOutput::write(executableColorBegin(executable));
         ::printf("%s", STR(executable));
-        ::printf("%s", executableColorEnd()); 
+        S9sOutput::write(executableColorEnd()); 
 
         printf("\n");
 
@@ -1098,6 +1084,8 @@ S9sRpcReply::printJobLogBrief()
     if (options->hasLogFormat())
         formatString = options->logFormat();
 
+    S9sFormatProgram program = S9sMessage::compileFormat(formatString);
+
     for (uint idx = 0; idx < theList.size(); ++idx)
     {
         S9sVariantMap theMap  = theList[idx].toVariantMap();
@@ -1111,7 +1099,7 @@ S9sRpcReply::printJobLogBrief()
             printf("%s\n", STR(S9sString::html2ansi(message.message())));
         } else {
             printf("%s",
-                    STR(message.toString(syntaxHighlight, formatString)));
+                    STR(message.toString(syntaxHighlight, program)));
         }
     }
 }
@@ -1137,6 +1125,8 @@ S9sRpcReply::printJobLogLong()
      */
     if (!formatString.empty())
     {
+        S9sFormatProgram program = S9sMessage::compileFormat(formatString);
+
         for (uint idx = 0; idx < theList.size(); ++idx)
         {
             S9sVariantMap theMap  = theList[idx].toVariantMap();
@@ -1146,7 +1136,7 @@ S9sRpcReply::printJobLogLong()
                 printf("%s\n", STR(S9sString::html2ansi(message.message())));
             else {
                 printf("%s",
-                        STR(message.toString(syntaxHighlight, formatString)));
+                        STR(message.toString(syntaxHighlight, program)));
             }
         }
 
@@ -1238,7 +1228,9 @@ S9sRpcReply::printJobList()
     S9sOptions *options = S9sOptions::instance();
 
     if (options->isJsonRequested())
-        printf("%s\n", STR(toString()));
+        printJson();
+    else if (options->isNdJsonRequested())
+        printNdJson(jobs());
     else if (options->isLongRequested())
         printJobListLong();
     else
@@ -1252,10 +1244,16 @@ S9sRpcReply::printBackupList()
     
     if (options->isJsonRequested())
     {
-        printf("%s\n", STR(toString()));
+        printJson();
     } else if (!isOk())
     {
         PRINT_ERROR("%s", STR(errorString()));
+    } else if (options->isNdJsonRequested())
+    {
+        if (contains("data"))
+            printNdJson(operator[]("data").toVariantList());
+        else
+            printNdJson(operator[]("backup_records").toVariantList());
     } else if (options->hasBackupFormat())
     {
         printBackupListFormatString(options->isLongRequested());
@@ -1289,7 +1287,7 @@ S9sRpcReply::printKeys()
 
     if (options->isJsonRequested())
     {
-        printf("%s\n", STR(toString()));
+        printJson();
         return;
     } else if (!isOk())
     {
@@ -1322,7 +1320,7 @@ S9sRpcReply::printAccountList()
     
     if (options->isJsonRequested())
     {
-        printf("%s\n", STR(toString()));
+        printJson();
         return;
     }
 
@@ -1345,7 +1343,7 @@ S9sRpcReply::printDatabaseList()
     
     if (options->isJsonRequested())
     {
-        printf("%s\n", STR(toString()));
+        printJson();
         return;
     }
 
@@ -1418,103 +1416,38 @@ S9sRpcReply::printAccountListLong()
     S9sOptions     *options = S9sOptions::instance();
     S9sVariantList  accountList = operator[]("accounts").toVariantList();
     bool            syntaxHighlight = options->useSyntaxHighlight();
-    S9sFormat       accountNameFormat, hostNameFormat, passwordFormat;
-    S9sFormat       maxConnectionsFormat, connectionsFormat;
-    int             isTerminal    = options->isTerminal();
-    int             terminalWidth = options->terminalWidth();
-    int             columns;
+    S9sTable        table;
     const char     *colorBegin = "";
     const char     *colorEnd   = "";
     const char     *hostColorBegin = "";
     const char     *hostColorEnd   = "";
     
-    /*
-     *  Going through first and collecting some informations.
-     */
-    for (uint idx = 0; idx < accountList.size(); ++idx)
+    if (syntaxHighlight)
     {
-        S9sVariantMap  accountMap   = accountList[idx].toVariantMap();
-        S9sAccount     account      = accountMap;
-        S9sString      accountName  = account.userName();
-        S9sString      hostName     = account.hostAllow();
-        S9sString      password     = account.password();
-        int            maxConnections = account.maxConnections();
-        int            connections  = account.connections();
-        S9sString      fullName;
-
-        if (!options->isStringMatchExtraArguments(accountName))
-            continue;
-
-        if (hostName.empty())
-            hostName = "%";
-
-        fullName.sprintf("'%s'@'%s'", STR(accountName), STR(hostName));
-
-        if (password.empty())
-            password = "N";
-        else
-            password = "Y";
-
-        accountNameFormat.widen(fullName);
-        hostNameFormat.widen(hostName);
-        passwordFormat.widen(password);
-        maxConnectionsFormat.widen(maxConnections);
-        connectionsFormat.widen(connections);
+        colorBegin      = XTERM_COLOR_ORANGE;
+        colorEnd        = TERM_NORMAL;
+        hostColorBegin  = XTERM_COLOR_GREEN;
+        hostColorEnd    = TERM_NORMAL;
     }
-    
-    /*
-     * Printing the header.
-     */
-    if (!options->isNoHeaderRequested())
-    {
-        accountNameFormat.widen("NAME");
-        hostNameFormat.widen("HOST");
-        passwordFormat.widen("P");
-        connectionsFormat.widen("CONN");
-        maxConnectionsFormat.widen("MAXC");
 
-        printf("%s", headerColorBegin());
-        // Johan asked for ''@'' format, this is a temporary solution for that.
-        #if 0
-        accountNameFormat.printf("NAME");
-        hostNameFormat.printf("HOST");
-        #else
-        accountNameFormat.printf("NAME");
-        //hostNameFormat.printf("");
-        //printf(" ");
-        #endif
-        passwordFormat.printf("P");
-        connectionsFormat.printf("CONN");
-        maxConnectionsFormat.printf("MAXC");
-        printf("GRANTS");
-        printf("%s", headerColorEnd());
-
-        printf("\n");
-    }
+    // Johan asked for ''@'' format, the host is in the name column.
+    table.addColumn("NAME");
+    table.addColumn("P");
+    table.addColumn("CONN");
+    table.addColumn("MAXC");
+    table.addColumn("GRANTS");
+    table.setHeaderVisible(!options->isNoHeaderRequested());
+    table.setHeaderColor(headerColorBegin(), headerColorEnd());
 
-    columns  = terminalWidth;
-    columns -= accountNameFormat.realWidth();
-    //columns -= hostNameFormat.realWidth();
-    columns -= passwordFormat.realWidth();
-    columns -= connectionsFormat.realWidth();
-    columns -= maxConnectionsFormat.realWidth();
-    columns -= 1;
+    if (options->isTerminal())
+        table.setMaxWidth(options->terminalWidth() - 1);
 
-    /*
-     * Going through again and printing.
-     */
     for (uint idx = 0; idx < accountList.size(); ++idx)
     {
-        S9sVariantMap  accountMap   = accountList[idx].toVariantMap();
-        S9sAccount     account      = accountMap;
+        S9sAccount     account      = accountList[idx].toVariantMap();
         S9sString      accountName  = account.userName();
         S9sString      hostName     = account.hostAllow();
-        S9sString      grants       = account.grants();
-        S9sString      password     = account.password();
-        int            maxConnections = account.maxConnections();
-        int            connections  = account.connections();
-        int            thisWidth;
-        int            requiredWidth;
+        S9sString      fullName;
 
         if (!options->isStringMatchExtraArguments(accountName))
             continue;
@@ -1522,49 +1455,22 @@ S9sRpcReply::printAccountListLong()
         if (hostName.empty())
             hostName = "%";
 
-        if (syntaxHighlight)
-        {
-            colorBegin      = XTERM_COLOR_ORANGE;
-            colorEnd        = TERM_NORMAL;
-            hostColorBegin  = XTERM_COLOR_GREEN;
-            hostColorEnd    = TERM_NORMAL;
-        }
-        
-        if (password.empty())
-            password = "N";
-        else
-            password = "Y";
-       
-        // Johan asked for ''@'' format, this is a temporary solution for that.
-        printf("%s", colorBegin);
-        printf("'%s'", STR(accountName));
-        printf("%s", colorEnd);
-        printf("@");
-        printf("%s", hostColorBegin);
-        printf("'%s'", STR(hostName));
-        printf("%s", hostColorEnd);
-        
-        // The 5 is the length of ''@''
-        thisWidth = accountName.length() + hostName.length() + 5;
-        requiredWidth = accountNameFormat.realWidth();
-
-        for (int n = thisWidth; n < requiredWidth; ++n)
-            printf(" ");
-
-        passwordFormat.printf(password);
-        connectionsFormat.printf(connections);
-        maxConnectionsFormat.printf(maxConnections);
+        fullName.sprintf("%s'%s'%s@%s'%s'%s",
+                colorBegin, STR(accountName), colorEnd,
+                hostColorBegin, STR(hostName), hostColorEnd);
 
-        if (isTerminal && (int) grants.length() > columns && columns > 1)
-        {
-            grants.resize(columns - 1);
-            grants += "…";
-        }
+        // The 5 is the length of ''@''
+        table.addColoredCell(
+                fullName, accountName.length() + hostName.length() + 5);
 
-        printf("%s", STR(grants));
-        printf("\n");
+        table.addCell(account.password().empty() ? "N" : "Y");
+        table.addCell(account.connections());
+        table.addCell(account.maxConnections());
+        table.addCell(account.grants());
     }
     
+    table.print();
+
     if (!options->isBatchRequested())
         printf("Total: %d\n", operator[]("total").toInt());
 }
@@ -1576,7 +1482,7 @@ S9sRpcReply::printGroupList()
     
     if (options->isJsonRequested())
     {
-        printf("%s\n", STR(toString()));
+        printJson();
     } else if (!isOk())
     {
         PRINT_ERROR("%s", STR(errorString()));
@@ -1595,7 +1501,7 @@ S9sRpcReply::printMaintenanceList()
     S9sOptions *options = S9sOptions::instance();
     
     if (options->isJsonRequested())
-        printf("%s\n", STR(toString()));
+        printJson();
     else if (options->isLongRequested())
         printMaintenanceListLong();
     else
@@ -1611,9 +1517,11 @@ S9sRpcReply::printNodeList()
     S9sOptions *options = S9sOptions::instance();
 
     if (options->isJsonRequested())
-        printf("%s\n", STR(toString()));
+        printJson();
     else if (!isOk())
         PRINT_ERROR("%s", STR(errorString()));
+    else if (options->isNdJsonRequested())
+        printNodeListNdJson();
     else if (options->isStatRequested())
         printNodesStat();
     else if (options->isLongRequested())
@@ -1622,13 +1530,72 @@ S9sRpcReply::printNodeList()
         printNodeListBrief();
 }
 
+/**
+ * Prints the nodes of the clusters as NDJSON, one host map in every line. The
+ * same filters are applied as in the brief list.
+ */
+void 
+S9sRpcReply::printNodeListNdJson()
+{
+    S9sOptions     *options = S9sOptions::instance();
+    S9sVariantMap   properties = options->propertiesOption();
+    S9sString       clusterNameFilter = options->clusterName();
+    S9sVariantList  theList = clusters();
+    S9sJsonWriter   writer(stdout, true);
+
+    for (uint idx = 0; idx < theList.size(); ++idx)
+    {
+        S9sVariantMap  theMap      = theList[idx].toVariantMap();
+        S9sVariantList hosts       = theMap["hosts"].toVariantList();
+        S9sString      clusterName = theMap["cluster_name"].toString();
+
+        if (!clusterNameFilter.empty() && clusterNameFilter != clusterName)
+            continue;
+
+        for (uint idx2 = 0; idx2 < hosts.size(); ++idx2)
+        {
+            const S9sVariantMap &hostMap = hosts[idx2].toVariantMap();
+            S9sNode              node    = hostMap;
+                
+            if (!properties.isSubSet(hostMap))
+                continue;
+
+            if (!options->isStringMatchExtraArguments(node.name()))
+                continue;
+
+            writer.value(hostMap);
+            writer.write("\n");
+        }
+    }
+}
+
+/**
+ * \param theList The list of objects to print.
+ *
+ * Prints the elements of the list as NDJSON: every element is written as one
+ * compact JSON string followed by a new line. The text goes through the
+ * buffer of the JSON writer, no string is built for the whole list.
+ */
+void 
+S9sRpcReply::printNdJson(
+        const S9sVariantList &theList)
+{
+    S9sJsonWriter writer(stdout, true);
+
+    for (uint idx = 0; idx < theList.size(); ++idx)
+    {
+        writer.value(theList[idx]);
+        writer.write("\n");
+    }
+}
+
 void
 S9sRpcReply::printConfigList()
 {
     S9sOptions *options = S9sOptions::instance();
 
     if (options->isJsonRequested())
-        printf("%s\n", STR(toString()));
+        printJson();
     else if (options->isDebug())
         printConfigDebug();
     else if (options->isLongRequested())
@@ -1643,7 +1610,9 @@ S9sRpcReply::printLogList()
     S9sOptions *options = S9sOptions::instance();
 
     if (options->isJsonRequested())
-        printf("%s\n", STR(toString()));
+        printJson();
+    else if (options->isNdJsonRequested())
+        printNdJson(operator[]("log_entries").toVariantList());
     else if (options->isLongRequested())
         printLogLong();
     else 
@@ -1659,6 +1628,8 @@ S9sRpcReply::printLogBrief()
     S9sString       formatString = options->briefLogFormat();
     S9sVariantList  theList = operator[]("log_entries").toVariantList();
 
+    S9sFormatProgram program = S9sMessage::compileFormat(formatString);
+
     for (uint idx = 0; idx < theList.size(); ++idx)
     {
         S9sVariantMap theMap  = theList[idx].toVariantMap();
@@ -1672,7 +1643,7 @@ S9sRpcReply::printLogBrief()
             printf("%s\n", STR(S9sString::html2ansi(message.message())));
         else {
             printf("%s",
-                    STR(message.toString(syntaxHighlight, formatString)));
+                    STR(message.toString(syntaxHighlight, program)));
         }
     }
 }
@@ -1692,6 +1663,8 @@ S9sRpcReply::printLogLong()
     if (formatString.empty())
         formatString = "%C %36B:%-5L: %-8S %M\n";
 
+    S9sFormatProgram program = S9sMessage::compileFormat(formatString);
+
     for (uint idx = 0; idx < theList.size(); ++idx)
     {
         S9sVariantMap theMap  = theList[idx].toVariantMap();
@@ -1705,7 +1678,7 @@ S9sRpcReply::printLogLong()
             printf("%s\n", STR(S9sString::html2ansi(message.message())));
         else {
             printf("%s",
-                    STR(message.toString(syntaxHighlight, formatString)));
+                    STR(message.toString(syntaxHighlight, program)));
         }
     }
 }
@@ -1799,11 +1772,11 @@ S9sRpcReply::printConfigLong()
         nameFormat.widen("OPTION NAME");
         valueFormat.widen("VALUE");
         
-        printf("%s", headerColorBegin());
+        S9sOutput::write(headerColorBegin());
         sectionFormat.printf("GROUP");
         nameFormat.printf("OPTION NAME");
         valueFormat.printf("VALUE");
-        printf("%s", headerColorEnd());
+        S9sOutput::write(headerColorEnd());
         printf("\n");
     }
 
@@ -1915,9 +1888,9 @@ S9sRpcReply::printConfigBrief(
 
         sectionFormat.printf(section);
 
-        printf("%s", optNameColorBegin());
+        S9sOutput::write(optNameColorBegin());
         nameFormat.printf(name);
-        printf("%s", optNameColorEnd());
+        S9sOutput::write(optNameColorEnd());
         
         valueFormat.printf(value);
 
@@ -1989,11 +1962,11 @@ S9sRpcReply::printConfigBrief()
         nameFormat.widen("OPTION NAME");
         valueFormat.widen("VALUE");
         
-        printf("%s", headerColorBegin());
+        S9sOutput::write(headerColorBegin());
         sectionFormat.printf("GROUP");
         nameFormat.printf("OPTION NAME");
         valueFormat.printf("VALUE");
-        printf("%s", headerColorEnd());
+        S9sOutput::write(headerColorEnd());
         printf("\n");
     }
 
@@ -2036,9 +2009,9 @@ S9sRpcReply::printConfigBrief()
             
             sectionFormat.printf(section);
 
-            printf("%s", optNameColorBegin());
+            S9sOutput::write(optNameColorBegin());
             nameFormat.printf(name);
-            printf("%s", optNameColorEnd());
+            S9sOutput::write(optNameColorEnd());
 
             valueFormat.printf(valueMap["value"].toString());
             printf("\n");
@@ -2115,6 +2088,8 @@ S9sRpcReply::printClusterListBrief()
     S9sVariantList  theList   = clusters();
     int             nPrinted  = 0;
 
+    S9sFormatProgram program = S9sCluster::compileFormat(format);
+
     for (uint idx = 0; idx < theList.size(); ++idx)
     {
         S9sVariantMap theMap = theList[idx].toVariantMap();
@@ -2145,7 +2120,7 @@ S9sRpcReply::printClusterListBrief()
         //
         if (hasFormat)
         {
-            printf("%s", STR(cluster.toString(syntaxHighlight, format)));
+            printf("%s", STR(cluster.toString(syntaxHighlight, program)));
         } else {
             printf("%s%s%s ", 
                     clusterColorBegin(), 
@@ -2221,14 +2196,7 @@ S9sRpcReply::printAlarmListLong()
     S9sOptions     *options = S9sOptions::instance();
     bool            syntaxHighlight = options->useSyntaxHighlight();
     S9sVariantList  theList = alarms();
-    S9sFormat       idFormat;
-    S9sFormat       clusterIdFormat;
-    S9sFormat       severityFormat;
-    S9sFormat       typeNameFormat;
-    S9sFormat       componentNameFormat;
-    S9sFormat       titleFormat;
-    S9sFormat       hostNameFormat;
-    int             nLines = 0;
+    S9sTable        table;
     const char     *hostColorBegin = "";
     const char     *hostColorEnd   = "";
     const char     *keyColorBegin = "";
@@ -2243,78 +2211,38 @@ S9sRpcReply::printAlarmListLong()
         keyColorEnd     = TERM_NORMAL;
     }
 
-    for (uint idx = 0; idx < theList.size(); ++idx)
-    {
-        S9sVariantMap alarmMap  = theList[idx].toVariantMap();
-        S9sAlarm      alarm(alarmMap);
-
-        if (alarm.isIgnored())
-            continue;
-
-        idFormat.widen(alarm.alarmId());
-        clusterIdFormat.widen(alarm.clusterId());
-        componentNameFormat.widen(alarm.componentName());
-        severityFormat.widen(alarm.severityName());
-        typeNameFormat.widen(alarm.typeName());
-        titleFormat.widen(alarm.title());
-        hostNameFormat.widen(alarm.hostName());
-        ++nLines;
-    }
-
-    if (!options->isNoHeaderRequested() && nLines > 0)
-    {
-        idFormat.widen("ID");
-        clusterIdFormat.widen("CID");
-        severityFormat.widen("SEVERITY");
-        componentNameFormat.widen("COMPONENT");
-        typeNameFormat.widen("TYPE");
-        hostNameFormat.widen("HOSTNAME");
-        titleFormat.widen("TITLE");
-        
-        printf("%s", headerColorBegin());
-        idFormat.printf("ID");
-        clusterIdFormat.printf("CID");
-        severityFormat.printf("SEVERITY");
-        componentNameFormat.printf("COMPONENT");
-        typeNameFormat.printf("TYPE");
-        hostNameFormat.printf("HOSTNAME");
-        titleFormat.printf("TITLE");
-        
-        printf("%s", headerColorEnd());
-        printf("\n");
-    }
-
-    
+    table.addColumn("ID");
+    table.addColumn("CID");
+    table.addColumn("SEVERITY");
+    table.addColumn("COMPONENT");
+    table.addColumn("TYPE");
+    table.addColumn("HOSTNAME");
+    table.addColumn("TITLE");
+    table.setHeaderColor(headerColorBegin(), headerColorEnd());
 
     for (uint idx = 0; idx < theList.size(); ++idx)
     {
-        S9sVariantMap alarmMap  = theList[idx].toVariantMap();
-        S9sAlarm      alarm(alarmMap);
+        S9sAlarm      alarm(theList[idx].toVariantMap());
 
         if (alarm.isIgnored())
             continue;
 
-        idFormat.printf(alarm.alarmId());
-        clusterIdFormat.printf(alarm.clusterId());
-
-        ::printf("%s", alarm.severityColorBegin(syntaxHighlight));
-        severityFormat.printf(alarm.severityName());
-        ::printf("%s", alarm.severityColorEnd(syntaxHighlight));
+        table.addCell(alarm.alarmId());
+        table.addCell(alarm.clusterId());
+        table.addCell(alarm.severityName(),
+                alarm.severityColorBegin(syntaxHighlight),
+                alarm.severityColorEnd(syntaxHighlight));
 
-        ::printf("%s", keyColorBegin);
-        componentNameFormat.printf(alarm.componentName());
-        ::printf("%s", keyColorEnd);
-
-        ::printf("%s", keyColorBegin);
-        typeNameFormat.printf(alarm.typeName());
-        ::printf("%s", keyColorEnd);
+        table.addCell(alarm.componentName(), keyColorBegin, keyColorEnd);
+        table.addCell(alarm.typeName(), keyColorBegin, keyColorEnd);
+        table.addCell(alarm.hostName(), hostColorBegin, hostColorEnd);
+        table.addCell(alarm.title());
+    }
 
-        ::printf("%s", hostColorBegin);
-        hostNameFormat.printf(alarm.hostName());
-        ::printf("%s", hostColorEnd);
+    table.setHeaderVisible(
+            !options->isNoHeaderRequested() && table.nRows() > 0);
 
-        ::printf("%s\n", STR(alarm.title()));
-    }
+    table.print();
     
     if (!options->isBatchRequested())
     {
@@ -2339,12 +2267,7 @@ S9sRpcReply::printClusterListLong()
     int             isTerminal    = options->isTerminal();
     int             terminalWidth = options->terminalWidth();
     S9sString       formatString  = options->longClusterFormat();
-    int             nLines = 0;
-    S9sFormat       idFormat;
-    S9sFormat       stateFormat;
-    S9sFormat       typeFormat;
-    S9sFormat       ownerFormat, groupFormat;
-    S9sFormat       nameFormat;
+    S9sTable        table;
 
     if (options->hasClusterFormat())
         formatString = options->clusterFormat();
@@ -2354,6 +2277,8 @@ S9sRpcReply::printClusterListLong()
      */
     if (!formatString.empty())
     {
+        S9sFormatProgram program = S9sCluster::compileFormat(formatString);
+
         for (uint idx = 0; idx < theList.size(); ++idx)
         {
             S9sVariantMap clusterMap  = theList[idx].toVariantMap();
@@ -2382,7 +2307,7 @@ S9sRpcReply::printClusterListLong()
             /*
              * Printing using the formatstring.
              */
-            printf("%s", STR(cluster.toString(syntaxHighlight, formatString)));
+            printf("%s", STR(cluster.toString(syntaxHighlight, program)));
         }
 
         if (!options->isBatchRequested())
@@ -2391,83 +2316,18 @@ S9sRpcReply::printClusterListLong()
         return;
     }
 
-    /*
-     * First run-through: collecting some information.
-     */
-    for (uint idx = 0; idx < theList.size(); ++idx)
-    {
-        S9sVariantMap clusterMap  = theList[idx].toVariantMap();
-        S9sVariantMap ownerMap    = clusterMap["owner"].toVariantMap();
-        S9sString     ownerName   = ownerMap["user_name"].toString();
-        S9sVariantMap groupMap    = clusterMap["group_owner"].toVariantMap();
-        S9sString     groupName   = groupMap["group_name"].toString();
-        S9sString     clusterName = clusterMap["cluster_name"].toString();
-        int           clusterId   = clusterMap["cluster_id"].toInt();
-        S9sString     clusterType = clusterMap["cluster_type"].toString();
-        S9sString     state       = clusterMap["state"].toString();
-        S9sString     version     = 
-            clusterMap["vendor"].toString() + " " +
-            clusterMap["version"].toString();
-        
-        //
-        // Filtering.
-        //
-        if (options->hasClusterIdOption())
-        {
-            if (clusterId != options->clusterId())
-                continue;
-        }
-        
-        if (options->hasClusterNameOption())
-        {
-            if (clusterName != options->clusterName())
-                continue;
-        }
-
-        if (!options->isStringMatchExtraArguments(clusterName))
-            continue;
-
-        if (groupName.empty())
-            groupName = "0";
-
-        idFormat.widen(clusterId);
-        stateFormat.widen(state);
-        typeFormat.widen(clusterType);
-        ownerFormat.widen(ownerName);
-        groupFormat.widen(groupName);
-        nameFormat.widen(clusterName);
-
-        ++nLines;
-    }
-
-    /*
-     * Printing the header.
-     */
-    if (!options->isNoHeaderRequested() && nLines > 0)
-    {
-        idFormat.widen("ID");
-        stateFormat.widen("STATE");
-        typeFormat.widen("TYPE");
-        ownerFormat.widen("OWNER");
-        groupFormat.widen("GROUP");
-        nameFormat.widen("NAME");
+    table.addColumn("ID");
+    table.addColumn("STATE");
+    table.addColumn("TYPE");
+    table.addColumn("OWNER");
+    table.addColumn("GROUP");
+    table.addColumn("NAME");
+    table.addColumn("COMMENT");
+    table.setHeaderColor(headerColorBegin(), headerColorEnd());
 
-        printf("%s", headerColorBegin());
-        idFormat.printf("ID");
-        stateFormat.printf("STATE");
-        typeFormat.printf("TYPE");
-        ownerFormat.printf("OWNER");
-        groupFormat.printf("GROUP");
-        nameFormat.printf("NAME");
-        printf("COMMENT");
-        
-        printf("%s", headerColorEnd());
-        printf("\n");
-    }
+    if (isTerminal)
+        table.setMaxWidth(terminalWidth);
 
-    /*
-     * Second run: doing the actual printing.
-     */
     for (uint idx = 0; idx < theList.size(); ++idx)
     {
         S9sVariantMap clusterMap  = theList[idx].toVariantMap();
@@ -2477,13 +2337,9 @@ S9sRpcReply::printClusterListLong()
         S9sString     groupName   = groupMap["group_name"].toString();
         S9sString     clusterName = clusterMap["cluster_name"].toString();
         int           clusterId   = clusterMap["cluster_id"].toInt();
-        S9sString     clusterType = clusterMap["cluster_type"].toString();
         S9sString     state       = clusterMap["state"].toString();
-        S9sString     statusText  = clusterMap["status_text"].toString();
-        int           nColumns    = 0;
-        S9sString     version     = 
-            clusterMap["vendor"].toString() + " " +
-            clusterMap["version"].toString();
+        const char   *stateColorBegin = NULL;
+        const char   *stateColorEnd   = NULL;
         
         if (groupName.empty())
             groupName = "0";
@@ -2513,53 +2369,35 @@ S9sRpcReply::printClusterListLong()
         if (clusterName.empty())
             continue;
         
-        nColumns += idFormat.realWidth();
-        nColumns += stateFormat.realWidth();
-        nColumns += typeFormat.realWidth();
-        nColumns += ownerFormat.realWidth();
-        nColumns += groupFormat.realWidth();
-        nColumns += nameFormat.realWidth();
-
-        if (isTerminal && nColumns < terminalWidth)
-        {
-            int remaining  = terminalWidth - nColumns;
-            
-            if (remaining < (int) statusText.length())
-            {
-                statusText.resize(remaining - 1);
-                statusText += "…";
-            }
-        }
-        
         if (syntaxHighlight)
         {
             if (state == "STARTED")
-                stateFormat.setColor(XTERM_COLOR_GREEN, TERM_NORMAL);
+                stateColorBegin = XTERM_COLOR_GREEN;
             else if (state == "FAILED" || state == "FAILURE")
-                stateFormat.setColor(XTERM_COLOR_RED, TERM_NORMAL);
+                stateColorBegin = XTERM_COLOR_RED;
             else
-                stateFormat.setColor(XTERM_COLOR_YELLOW, TERM_NORMAL);
+                stateColorBegin = XTERM_COLOR_YELLOW;
+
+            stateColorEnd = TERM_NORMAL;
         }
 
-        idFormat.printf(clusterId); 
-        stateFormat.printf(state);
-        typeFormat.printf(clusterType.toLower());
-        
-        printf("%s", userColorBegin());
-        ownerFormat.printf(ownerName);
-        printf("%s", userColorEnd());
+        table.addCell(clusterId);
+        table.addCell(state, stateColorBegin, stateColorEnd);
 
-        printf("%s", groupColorBegin(groupName));
-        groupFormat.printf(groupName);
-        printf("%s", groupColorEnd());
-        
-        printf("%s", clusterColorBegin());
-        nameFormat.printf(clusterName);
-        printf("%s", clusterColorEnd());
+        table.addCell(clusterMap["cluster_type"].toString().toLower());
+        table.addCell(ownerName, userColorBegin(), userColorEnd());
+        table.addCell(groupName,
+                groupColorBegin(groupName), groupColorEnd());
 
-        printf("%s\n", STR(statusText));
+        table.addCell(clusterName, clusterColorBegin(), clusterColorEnd());
+        table.addCell(clusterMap["status_text"].toString());
     }
    
+    table.setHeaderVisible(
+            !options->isNoHeaderRequested() && table.nRows() > 0);
+
+    table.print();
+
     if (!options->isBatchRequested())
         printf("Total: %lu\n", (unsigned long int) theList.size());
 }
@@ -2570,9 +2408,11 @@ S9sRpcReply::printAlarmList()
     S9sOptions *options = S9sOptions::instance();
 
     if (options->isJsonRequested())
-        printf("%s\n", STR(toString()));
+        printJson();
     else if (!isOk())
         PRINT_ERROR("%s", STR(errorString()));
+    else if (options->isNdJsonRequested())
+        printNdJson(alarms());
     else if (options->isLongRequested())
         printAlarmListLong();
     //else
@@ -2589,24 +2429,28 @@ S9sRpcReply::printDatabaseListLong()
 { 
     S9sOptions     *options   = S9sOptions::instance();
     S9sVariantList  theList   = clusters();
-    S9sFormat       sizeFormat;
-    S9sFormat       nTablesFormat;
-    S9sFormat       nRowsFormat;
-    S9sFormat       clusterNameFormat;
-    S9sFormat       nameFormat;
-    S9sFormat       ownerFormat, groupFormat;
+    S9sTable        table;
     ulonglong       totalBytes = 0ull;
     ulonglong       totalTables = 0ull;
     int             nDatabases = 0;
 
+    table.addColumn("SIZE", S9sFormat::AlignRight);
+    table.addColumn("#TBL", S9sFormat::AlignRight);
+    table.addColumn("#ROWS", S9sFormat::AlignRight);
+    table.addColumn("OWNER");
+    table.addColumn("GROUP");
+    table.addColumn("CLUSTER");
+    table.addColumn("DATABASE");
+    table.setHeaderVisible(!options->isNoHeaderRequested());
+    table.setHeaderColor(headerColorBegin(), headerColorEnd());
+
     for (uint idx = 0; idx < theList.size(); ++idx)
     {
         S9sVariantMap  theMap = theList[idx].toVariantMap();
         S9sVariantList databases = theMap["databases"].toVariantList();
-        S9sCluster     cluster(theMap);
         S9sString      clusterName = theMap["cluster_name"].toString();
         int            clusterId   = theMap["cluster_id"].toInt();
-
+        
         //
         // Filtering.
         //
@@ -2627,9 +2471,7 @@ S9sRpcReply::printDatabaseListLong()
             S9sVariantMap database = databases[idx1].toVariantMap();
             S9sString     name = database["database_name"].toString();
             ulonglong     size = database["database_size"].toULongLong();
-            S9sString     sizeStr = m_formatter.mBytesToHuman(size / (1024*1024));
             ulonglong     nTables = database["number_of_tables"].toULongLong();
-            S9sString     ownerName = database["owner_user_name"].toString();
             S9sString     groupName = database["owner_group_name"].toString();
             S9sString     nTablesString;
             S9sString     nRowsString;
@@ -2649,130 +2491,29 @@ S9sRpcReply::printDatabaseListLong()
                 nRowsString = "-";
             }
 
+            nDatabases  += 1;
+            totalBytes  += size;
+            totalTables += nTables;
+
             nTablesString.sprintf("%'llu", nTables);
 
-            ownerFormat.widen(ownerName);
-            groupFormat.widen(groupName);
-            sizeFormat.widen(sizeStr);
-            nTablesFormat.widen(nTablesString);
-            nRowsFormat.widen(nRowsString);
-            clusterNameFormat.widen(clusterName);
-            nameFormat.widen(name);
+            table.addCell(m_formatter.mBytesToHuman(size / (1024*1024)));
+            table.addCell(nTablesString);
+            table.addCell(nRowsString);
+            table.addCell(database["owner_user_name"].toString(),
+                    userColorBegin(), userColorEnd());
 
+            table.addCell(groupName,
+                    groupColorBegin(groupName), groupColorEnd());
+
+            table.addCell(clusterName, clusterColorBegin(), clusterColorEnd());
+            table.addCell(name, databaseColorBegin(), databaseColorEnd());
         }
     }
-    
-    /*
-     * Printing the header.
-     */
-    if (!options->isNoHeaderRequested())
-    {
-        sizeFormat.widen("SIZE");
-        nTablesFormat.widen("#TBL");
-        nRowsFormat.widen("#ROWS");
-        ownerFormat.widen("OWNER");
-        groupFormat.widen("GROUP");
-        clusterNameFormat.widen("CLUSTER");
-        nameFormat.widen("DATABASE");
-
-        printf("%s", headerColorBegin());
 
-        sizeFormat.printf("SIZE");
-        nTablesFormat.printf("#TBL");
-        nRowsFormat.printf("#ROWS");
-        ownerFormat.printf("OWNER");
-        groupFormat.printf("GROUP");
-        clusterNameFormat.printf("CLUSTER");
-        nameFormat.printf("DATABASE");
- 
-        printf("%s", headerColorEnd());
-        printf("\n");
-    }
+    table.print();
 
-    sizeFormat.setRightJustify();
-    nTablesFormat.setRightJustify();
-    nRowsFormat.setRightJustify();
-    for (uint idx = 0; idx < theList.size(); ++idx)
-    {
-        S9sVariantMap  theMap = theList[idx].toVariantMap();
-        S9sVariantList databases = theMap["databases"].toVariantList();
-        S9sCluster     cluster(theMap);
-        S9sString      clusterName = theMap["cluster_name"].toString();
-        int            clusterId   = theMap["cluster_id"].toInt();
-        
-        //
-        // Filtering.
-        //
-        if (options->hasClusterIdOption())
-        {
-            if (clusterId != options->clusterId())
-                continue;
-        }
-        
-        if (options->hasClusterNameOption())
-        {
-            if (clusterName != options->clusterName())
-                continue;
-        }
-
-        for (uint idx1 = 0u; idx1 < databases.size(); ++idx1)
-        {
-            S9sVariantMap database = databases[idx1].toVariantMap();
-            S9sString     name = database["database_name"].toString();
-            ulonglong     size = database["database_size"].toULongLong();
-            S9sString     sizeStr = m_formatter.mBytesToHuman(size / (1024*1024));
-            ulonglong     nTables = database["number_of_tables"].toULongLong();
-            S9sString     ownerName = database["owner_user_name"].toString();
-            S9sString     groupName = database["owner_group_name"].toString();
-            S9sString     nTablesString;
-            S9sString     nRowsString;
-
-            if (name == "mysql" || name == "performance_schema")
-                continue;
-
-            if (!options->isStringMatchExtraArguments(name))
-                continue;
-
-            if (database.contains("number_of_rows"))
-            {
-                nRowsString.sprintf(
-                        "%'llu", 
-                        database["number_of_rows"].toULongLong());
-            } else {
-                nRowsString = "-";
-            }
-
-            nDatabases  += 1;
-            totalBytes  += size;
-            totalTables += nTables;
-
-            nTablesString.sprintf("%'llu", nTables);
-
-            sizeFormat.printf(sizeStr);
-            nTablesFormat.printf(nTablesString);
-            nRowsFormat.printf(nRowsString);
-
-            printf("%s", userColorBegin());
-            ownerFormat.printf(ownerName);
-            printf("%s", userColorEnd());
-
-            printf("%s", groupColorBegin(groupName));
-            groupFormat.printf(groupName);
-            printf("%s", groupColorEnd());
-
-            printf("%s", clusterColorBegin());
-            clusterNameFormat.printf(clusterName);
-            printf("%s", clusterColorEnd());
-
-            printf("%s", databaseColorBegin());
-            nameFormat.printf(name);
-            printf("%s", databaseColorEnd());
-
-            printf("\n");
-        }
-    }
-
-    if (!options->isBatchRequested())
+    if (!options->isBatchRequested())
     {
         printf("Total: %s%d%s databases, %s%s%s, %s%'llu%s tables.\n", 
                 numberColorBegin(), nDatabases, numberColorEnd(),
@@ -2811,6 +2552,8 @@ S9sRpcReply::printNodeListBrief()
      */
     if (!formatString.empty())
     {
+        S9sFormatProgram program = S9sNode::compileFormat(formatString);
+
         for (uint idx = 0; idx < theList.size(); ++idx)
         {
             S9sVariantMap  theMap      = theList[idx].toVariantMap();
@@ -2837,7 +2580,7 @@ S9sRpcReply::printNodeListBrief()
 
                 node.setCluster(cluster);
 
-                printf("%s", STR(node.toString(syntaxHighlight, formatString)));
+                printf("%s", STR(node.toString(syntaxHighlight, program)));
             }
         }
     
@@ -2947,7 +2690,7 @@ S9sRpcReply::printScriptTree()
 {
     S9sOptions *options = S9sOptions::instance();
     if (options->isJsonRequested())
-        printf("%s\n", STR(toString()));
+        printJson();
     else if (!isOk())
         PRINT_ERROR("%s", STR(errorString()));
     else 
@@ -3051,9 +2794,9 @@ S9sRpcReply::printProcessors(
     
     if (!options->isNoHeaderRequested() && compact)
     {
-        printf("%s", headerColorBegin());
+        S9sOutput::write(headerColorBegin());
         printf("QUA   PROCESSOR\n");
-        printf("%s", headerColorEnd());    
+        S9sOutput::write(headerColorEnd());    
     }
 
     for (uint idx = 0; idx < theList.size(); ++idx)
@@ -3209,9 +2952,9 @@ S9sRpcReply::printNics(
     
     if (!options->isNoHeaderRequested() && compact)
     {
-        printf("%s", headerColorBegin());
+        S9sOutput::write(headerColorBegin());
         printf("QUA   NIC\n");
-        printf("%s", headerColorEnd());
+        S9sOutput::write(headerColorEnd());
         
     }
 
@@ -3374,7 +3117,7 @@ S9sRpcReply::printPartitions(
         deviceFormat.widen("DEVICE");
         mountpointFormat.widen("MOUNT POINT");
 
-        printf("%s", headerColorBegin());
+        S9sOutput::write(headerColorBegin());
         totalFormat.printf("SIZE");
         usedFormat.printf("USED");
         freeFormat.printf("AVAIL");
@@ -3384,7 +3127,7 @@ S9sRpcReply::printPartitions(
         filesystemFormat.printf("FS");
         deviceFormat.printf("DEVICE");
         mountpointFormat.printf("MOUNT POINT");
-        printf("%s", headerColorEnd());
+        S9sOutput::write(headerColorEnd());
 
         printf("\n");
     }
@@ -3428,9 +3171,9 @@ S9sRpcReply::printPartitions(
             freeFormat.printf(freeStr);
             percentFormat.printf(percentStr);
             
-            printf("%s", serverColorBegin());
+            S9sOutput::write(serverColorBegin());
             hostnameFormat.printf(hostName);
-            printf("%s", serverColorEnd());
+            S9sOutput::write(serverColorEnd());
 
             printf("%s", XTERM_COLOR_FILESYSTEM);
             filesystemFormat.printf(filesystem);
@@ -3497,9 +3240,9 @@ S9sRpcReply::printMemoryBanks(
      */
     if (!options->isNoHeaderRequested() && compact)
     {
-        printf("%s", headerColorBegin());
+        S9sOutput::write(headerColorBegin());
         printf("QUA   MODULE\n");
-        printf("%s", headerColorEnd()); 
+        S9sOutput::write(headerColorEnd()); 
     }
 
     /*
@@ -3620,7 +3363,7 @@ S9sRpcReply::printTemplates()
     // If the json is requested we simply print it and that's all.
     if (options->isJsonRequested())
     {
-        printf("%s\n", STR(toString()));
+        printJson();
         return;
     }
 
@@ -3671,14 +3414,14 @@ S9sRpcReply::printTemplates()
         hostNameFormat.widen("SERVER");
         nameFormat.widen("TEMPLATE");
 
-        printf("%s", headerColorBegin());
+        S9sOutput::write(headerColorBegin());
         cloudFormat.printf("CLD");
         regionFormat.printf("REGION");
         cpuFormat.printf("CPU");
         memoryFormat.printf("MEMORY");
         hostNameFormat.printf("SERVER");
         nameFormat.printf("TEMPLATE", false);
-        printf("%s", headerColorEnd());
+        S9sOutput::write(headerColorEnd());
         printf("\n");
 
     }
@@ -3756,7 +3499,7 @@ S9sRpcReply::printSubnets()
     // If the json is requested we simply print it and that's all.
     if (options->isJsonRequested())
     {
-        printf("%s\n", STR(toString()));
+        printJson();
         return;
     }
 
@@ -3831,14 +3574,14 @@ S9sRpcReply::printSubnets()
         vpcFormat.widen("VPC");
         idFormat.widen("ID");
 
-        printf("%s", headerColorBegin());
+        S9sOutput::write(headerColorBegin());
         cloudFormat.printf("CLD");
         regionFormat.printf("REGION");
         hostNameFormat.printf("SERVER");
         cidrFormat.printf("CIDR", false);
         vpcFormat.printf("VPC");
         idFormat.printf("ID");
-        printf("%s", headerColorEnd());
+        S9sOutput::write(headerColorEnd());
         printf("\n");
 
     }
@@ -3902,7 +3645,7 @@ S9sRpcReply::printRegions()
     // If the json is requested we simply print it and that's all.
     if (options->isJsonRequested())
     {
-        printf("%s\n", STR(toString()));
+        printJson();
         return;
     }
     
@@ -3955,7 +3698,7 @@ S9sRpcReply::printRegions()
         hostNameFormat.widen("SERVER");
         nameFormat.widen("REGION");
 
-        printf("%s", headerColorBegin());
+        S9sOutput::write(headerColorBegin());
         hasCredentialsFormat.printf("CRED");
         providerFormat.printf("CLOUD");
         hostNameFormat.printf("SERVER");
@@ -4030,7 +3773,7 @@ S9sRpcReply::printSheets()
 
     if (options->isJsonRequested())
     {
-        printf("%s\n", STR(toString()));
+        printJson();
     } else if (!isOk())
     {
         PRINT_ERROR("%s", STR(errorString()));
@@ -4110,7 +3853,7 @@ S9sRpcReply::printSheetsLong()
         groupFormat.widen("GROUP");
         nameFormat.widen("NAME");
         
-        printf("%s", headerColorBegin());
+        S9sOutput::write(headerColorBegin());
         idFormat.printf("ID");
         ownerFormat.printf("OWNER");
         groupFormat.printf("GROUP");
@@ -4126,13 +3869,13 @@ S9sRpcReply::printSheetsLong()
         S9sString      name     = theMap["name"].toString();
 
         idFormat.printf(id);
-        printf("%s", userColorBegin());
+        S9sOutput::write(userColorBegin());
         ownerFormat.printf(sheet.ownerName());
-        printf("%s", userColorEnd());
+        S9sOutput::write(userColorEnd());
         
-        printf("%s", groupColorBegin());
+        S9sOutput::write(groupColorBegin());
         groupFormat.printf(sheet.groupOwnerName());
-        printf("%s", groupColorEnd());
+        S9sOutput::write(groupColorEnd());
 
         nameFormat.printf(name);
         printf("\n");
@@ -4146,20 +3889,20 @@ S9sRpcReply::printSheet()
 
     if (options->isJsonRequested())
     {
-        printf("%s\n", STR(toString()));
+        printJson();
     } else if (!isOk())
     {
         PRINT_ERROR("%s", STR(errorString()));
     } else if (options->isLongRequested()) 
     {
         //printImagesLong();
-        printf("%s\n", STR(toString()));
+        printJson();
     } else if (options->isStatRequested())
     {
         printSheetStat();
     } else {
         //printImagesBrief();
-        printf("%s\n", STR(toString()));
+        printJson();
     }
 }
 
@@ -4179,7 +3922,7 @@ S9sRpcReply::printImages()
 
     if (options->isJsonRequested())
     {
-        printf("%s\n", STR(toString()));
+        printJson();
     } else if (!isOk())
     {
         PRINT_ERROR("%s", STR(errorString()));
@@ -4304,12 +4047,12 @@ S9sRpcReply::printImagesLong()
         hostNameFormat.widen("SERVER");
         imageFormat.widen("IMAGE");
 
-        printf("%s", headerColorBegin());
+        S9sOutput::write(headerColorBegin());
         cloudFormat.printf("CLD");
         regionFormat.printf("REGION");
         hostNameFormat.printf("SERVER");
         imageFormat.printf("IMAGE");
-        printf("%s", headerColorEnd());
+        S9sOutput::write(headerColorEnd());
         printf("\n");
 
     }
@@ -4376,7 +4119,7 @@ S9sRpcReply::printServers()
 
     if (options->isJsonRequested())
     {
-        printf("%s\n", STR(toString()));
+        printJson();
     } else if (!isOk())
     {
         PRINT_ERROR("%s", STR(errorString()));
@@ -4425,70 +4168,17 @@ S9sRpcReply::printServersLong()
     bool            syntaxHighlight = options->useSyntaxHighlight();
     S9sVariantList  theList = operator[]("servers").toVariantList();
     int             total   = operator[]("total").toInt();
-    int             nLines = 0;
-    S9sFormat       protocolFormat;
-    S9sFormat       versionFormat;
-    S9sFormat       nContainersFormat;
-    S9sFormat       hostNameFormat;
-    S9sFormat       ownerFormat;
-    S9sFormat       groupFormat;
-    S9sFormat       ipFormat(ipColorBegin(), ipColorEnd());
-
-    for (uint idx = 0; idx < theList.size(); ++idx)
-    {
-        S9sVariantMap  theMap   = theList[idx].toVariantMap();
-        S9sServer      server   = theMap;
-        S9sString      hostName = server.hostName();
-        S9sString      prot     = server.protocol();
-        S9sString      version  = server.version();
-        S9sString      owner    = server.ownerName();
-        S9sString      group    = server.groupOwnerName();
-        int            nContainers = server.nContainers();
-        S9sString      ip       = server.ipAddress();
-
-        if (!options->isStringMatchExtraArguments(hostName))
-            continue;
-
-        if (version.empty())
-            version = "-";
-        
-        if (prot.empty())
-            prot = "-";
-
-        protocolFormat.widen(prot);
-        versionFormat.widen(version);
-        nContainersFormat.widen(nContainers);
-        hostNameFormat.widen(hostName);
-        ownerFormat.widen(owner);
-        groupFormat.widen(group);
-        ipFormat.widen(ip);
-        ++nLines;
-    }
-
-    /*
-     * Printing the header.
-     */
-    if (!options->isNoHeaderRequested() && nLines > 0)
-    {
-        protocolFormat.widen("CLD");
-        versionFormat.widen("VERSION");
-        nContainersFormat.widen("#C");
-        ownerFormat.widen("OWNER");
-        groupFormat.widen("GROUP");
-        hostNameFormat.widen("SERVER_NAME");
-        ipFormat.widen("IP");
-        
-        printf("%s", headerColorBegin());
-        protocolFormat.printf("CLD");
-        versionFormat.printf("VERSION");
-        nContainersFormat.printf("#C");
-        ownerFormat.printf("OWNER");
-        groupFormat.printf("GROUP");
-        hostNameFormat.printf("NAME");
-        ipFormat.printf("IP", false);
-        printf("COMMENT");
-        printf("%s\n", headerColorEnd());
-    }
+    S9sTable        table;
+
+    table.addColumn("CLD");
+    table.addColumn("VERSION");
+    table.addColumn("#C");
+    table.addColumn("OWNER");
+    table.addColumn("GROUP");
+    table.addColumn("NAME");
+    table.addColumn("IP");
+    table.addColumn("COMMENT");
+    table.setHeaderColor(headerColorBegin(), headerColorEnd());
 
     for (uint idx = 0; idx < theList.size(); ++idx)
     {
@@ -4497,12 +4187,7 @@ S9sRpcReply::printServersLong()
         S9sString      hostName = server.hostName();
         S9sString      prot     = theMap["protocol"].toString();
         S9sString      version  = theMap["version"].toString();
-        S9sString      status   = server.status();
-        S9sString      owner    = theMap["owner_user_name"].toString();
         S9sString      group    = theMap["owner_group_name"].toString();
-        S9sString      message  = server.message("-");
-        int            nContainers = theMap["containers"].size();
-        S9sString      ip       = server.ipAddress("-");
 
         if (!options->isStringMatchExtraArguments(hostName))
             continue;
@@ -4513,29 +4198,25 @@ S9sRpcReply::printServersLong()
         if (prot.empty())
             prot = "-";
 
-        hostNameFormat.setColor(
+        table.addCell(prot);
+        table.addCell(version);
+        table.addCell((int) theMap["containers"].size());
+        table.addCell(theMap["owner_user_name"].toString(),
+                userColorBegin(), userColorEnd());
+
+        table.addCell(group, groupColorBegin(group), groupColorEnd());
+        table.addCell(hostName,
                 server.colorBegin(syntaxHighlight),
                 server.colorEnd(syntaxHighlight));
-        
-        protocolFormat.printf(prot);
-        versionFormat.printf(version);
-        nContainersFormat.printf(nContainers);
-        
-        printf("%s", userColorBegin());
-        ownerFormat.printf(owner);
-        printf("%s", userColorEnd());
-        
-        printf("%s", groupColorBegin(group));
-        groupFormat.printf(group);
-        printf("%s", groupColorEnd());
 
-        hostNameFormat.printf(hostName);
-        ipFormat.printf(ip);
+        table.addCell(server.ipAddress("-"), ipColorBegin(), ipColorEnd());
+        table.addCell(server.message("-"));
+    }
 
-        printf("%s", STR(message));
+    table.setHeaderVisible(
+            !options->isNoHeaderRequested() && table.nRows() > 0);
 
-        printf("\n");
-    }
+    table.print();
 
     if (!options->isBatchRequested())
         printf("Total: %d server(s)\n", total);
@@ -4615,7 +4296,9 @@ S9sRpcReply::printContainers()
     if (!isOk())
         PRINT_ERROR("%s", STR(errorString()));
     else if (options->isJsonRequested())
-        printf("%s\n", STR(toString()));
+        printJson();
+    else if (options->isNdJsonRequested())
+        printNdJson(operator[]("containers").toVariantList());
     else if (options->isStatRequested())
         printContainersStat();
     else if (options->isLongRequested())
@@ -4650,24 +4333,17 @@ S9sRpcReply::printContainersLong()
     S9sString       subnetId  = options->subnetId();
     S9sString       vpcId     = options->vpcId();
     S9s::AddressType addressType = options->addressType();
-    int             terminalWidth = options->terminalWidth();
-    int             nColumns;
-    bool            truncate = options->truncate();
-    S9sString       cloudName = options->cloudName();
     S9sVariantList  theList = operator[]("containers").toVariantList();
+    S9sString       cloudName = options->cloudName();
     S9sString       formatString = options->containerFormat();
     int             total   = operator[]("total").toInt();
-    int             nLines = 0;
     int             totalRunning = 0;
-    S9sFormat       typeFormat;
-    S9sFormat       templateFormat;
-    S9sFormat       ipFormat(ipColorBegin(), ipColorEnd());
-    S9sFormat       userFormat(userColorBegin(), userColorEnd());
-    S9sFormat       groupFormat;
-    S9sFormat       parentFormat;
+    S9sTable        table;
 
     if (options->hasContainerFormat())
     {
+        S9sFormatProgram program = S9sContainer::compileFormat(formatString);
+
         for (uint idx = 0; idx < theList.size(); ++idx)
         {
             S9sVariantMap  theMap      = theList[idx].toVariantMap();
@@ -4688,7 +4364,7 @@ S9sRpcReply::printContainersLong()
                 continue;
 
             printf("%s", 
-                    STR(container.toString(syntaxHighlight, formatString)));
+                    STR(container.toString(syntaxHighlight, program)));
         }
     
         if (!options->isBatchRequested())
@@ -4697,83 +4373,19 @@ S9sRpcReply::printContainersLong()
         return;
     }
 
-    /*
-     * First run-through: collecting some information.
-     */
-    for (uint idx = 0; idx < theList.size(); ++idx)
-    {
-        S9sVariantMap  theMap = theList[idx].toVariantMap();
-        S9sContainer   container(theMap);
-        S9sString      alias  = container.name();
-        S9sString      ip     = container.ipAddress(addressType, "-");
-        S9sString      parent = theMap["parent_server"].toString();
-        S9sString      user   = theMap["owner_user_name"].toString();
-        S9sString      group  = theMap["owner_group_name"].toString();
-        S9sString      type   = container.provider("-");
-        S9sString      templateName = container.templateName("-", true);
-
-        if (!options->isStringMatchExtraArguments(container.name()))
-            continue;
-
-        if (!cloudName.empty() && container.provider() != cloudName)
-            continue;
-        
-        if (!subnetId.empty() && container.subnetId() != subnetId)
-            continue;
-        
-        if (!vpcId.empty() && vpcId != container.subnetVpcId())
-            continue;
-
-        if (ip.empty())
-            ip = "-";
-
-        userFormat.widen(user);
-        groupFormat.widen(group);
-        ipFormat.widen(ip);
-        parentFormat.widen(parent);
-        typeFormat.widen(type);
-        templateFormat.widen(templateName);
-        ++nLines;
-    }
-
-    /*
-     * Printing the header.
-     */
-    if (!options->isNoHeaderRequested() && nLines > 0)
-    {
-        typeFormat.widen("CLD");
-        templateFormat.widen("TEMPLATE");
-        userFormat.widen("OWNER");
-        groupFormat.widen("GROUP");
-        ipFormat.widen("IP ADDRESS");
-        parentFormat.widen("SERVER");
-
-        printf("%s", headerColorBegin());
-        printf("S ");
-        typeFormat.printf("CLD", false);
-        templateFormat.printf("TEMPLATE", false);
-        userFormat.printf("OWNER", false);
-        groupFormat.printf("GROUP", false);
-        ipFormat.printf("IP ADDRESS", false);
-        parentFormat.printf("SERVER", false);
-        ::printf("NAME");
+    table.addColumn("S");
+    table.addColumn("CLD");
+    table.addColumn("TEMPLATE");
+    table.addColumn("OWNER");
+    table.addColumn("GROUP");
+    table.addColumn("IP ADDRESS");
+    table.addColumn("SERVER");
+    table.addColumn("NAME");
+    table.setHeaderColor(headerColorBegin(), headerColorEnd());
 
-        printf("%s\n", headerColorEnd());
-    }
+    if (options->truncate())
+        table.setMaxWidth(options->terminalWidth());
 
-    nColumns  = 0;
-    nColumns += 2;
-    nColumns += typeFormat.realWidth();
-    nColumns += templateFormat.realWidth();
-    nColumns += userFormat.realWidth();
-    nColumns += groupFormat.realWidth();
-    nColumns += ipFormat.realWidth();
-    nColumns += parentFormat.realWidth();
-    
-    
-    /*
-     * Second run: doing the actual printing.
-     */    
     for (uint idx = 0; idx < theList.size(); ++idx)
     {
         S9sVariantMap  theMap = theList[idx].toVariantMap();
@@ -4781,11 +4393,8 @@ S9sRpcReply::printContainersLong()
         S9sString      alias  = container.name();
         S9sString      ip     = container.ipAddress(addressType, "-");
         bool           isRunning = theMap["status"] == "RUNNING";
-        S9sString      parent = theMap["parent_server"].toString();
-        S9sString      user   = theMap["owner_user_name"].toString();
         S9sString      group  = theMap["owner_group_name"].toString();
-        S9sString      type   = container.provider("-");
-        S9sString      templateName = container.templateName("-", true);
+        S9sString      state;
 
         if (isRunning)
             totalRunning++;
@@ -4805,44 +4414,29 @@ S9sRpcReply::printContainersLong()
         if (ip.empty())
             ip = "-";
 
-        if (truncate && nColumns < terminalWidth)
-        {
-            int remaining  = terminalWidth - nColumns;
-
-            if (remaining < (int) alias.length())
-            {
-                alias.resize(remaining - 1);
-                alias += "…";
-            }  
-        }
-       
-        printf("%c ", container.stateAsChar());
-        
-        typeFormat.printf(type);
-        templateFormat.printf(templateName);
-
-        printf("%s", userColorBegin());
-        userFormat.printf(user);
-        printf("%s", userColorEnd());
-        
-        printf("%s", groupColorBegin(group));
-        groupFormat.printf(group);
-        printf("%s", groupColorEnd());
+        state.sprintf("%c", container.stateAsChar());
 
-        ipFormat.printf(ip);
+        table.addCell(state);
+        table.addCell(container.provider("-"));
+        table.addCell(container.templateName("-", true));
+        table.addCell(theMap["owner_user_name"].toString(),
+                userColorBegin(), userColorEnd());
 
-        printf("%s", serverColorBegin());
-        parentFormat.printf(parent);
-        printf("%s", serverColorEnd());
+        table.addCell(group, groupColorBegin(group), groupColorEnd());
+        table.addCell(ip, ipColorBegin(), ipColorEnd());
+        table.addCell(theMap["parent_server"].toString(),
+                serverColorBegin(), serverColorEnd());
 
-        ::printf("%s%s%s", 
+        table.addCell(alias,
                 containerColorBegin(container.stateAsChar()), 
-                STR(alias),
                 containerColorEnd());
-
-        printf("\n");
     }
     
+    table.setHeaderVisible(
+            !options->isNoHeaderRequested() && table.nRows() > 0);
+
+    table.print();
+
     if (!options->isBatchRequested())
     {
         printf("Total: %s%d%s containers, %s%d%s running.\n", 
@@ -4864,6 +4458,8 @@ S9sRpcReply::printContainersBrief()
     
     if (options->hasContainerFormat())
     {
+        S9sFormatProgram program = S9sContainer::compileFormat(formatString);
+
         for (uint idx = 0; idx < theList.size(); ++idx)
         {
             S9sVariantMap  theMap      = theList[idx].toVariantMap();
@@ -4882,7 +4478,7 @@ S9sRpcReply::printContainersBrief()
                 continue;
 
             printf("%s", 
-                    STR(container.toString(syntaxHighlight, formatString)));
+                    STR(container.toString(syntaxHighlight, program)));
         }
 
         return;
@@ -4929,7 +4525,7 @@ S9sRpcReply::printObjectTree()
 
     if (options->isJsonRequested())
     {
-        printf("%s\n", STR(toString()));
+        printJson();
     } else if (!isOk())
     {
         PRINT_ERROR("%s", STR(errorString()));
@@ -5256,13 +4852,13 @@ S9sRpcReply::printObjectListLong(
     /*
      * The owner and the group owner.
      */
-    ::printf("%s", userColorBegin());
+    S9sOutput::write(userColorBegin());
     m_ownerFormat.printf(owner);
-    ::printf("%s", userColorEnd());
+    S9sOutput::write(userColorEnd());
 
-    ::printf("%s", groupColorBegin(group));
+    S9sOutput::write(groupColorBegin(group));
     m_groupFormat.printf(group);
-    ::printf("%s", groupColorEnd());
+    S9sOutput::write(groupColorEnd());
 
     /*
      * The name.
@@ -5510,7 +5106,7 @@ S9sRpcReply::printObjectList()
 
     if (options->isJsonRequested())
     {
-        printf("%s\n", STR(toString()));
+        printJson();
     } else if (!isOk())
     {
         PRINT_ERROR("%s", STR(errorString()));
@@ -5544,7 +5140,7 @@ S9sRpcReply::printObjectListLong()
 
     if (options->isJsonRequested())
     {
-        printf("%s\n", STR(toString()));
+        printJson();
         return;
     }
 
@@ -5567,7 +5163,7 @@ S9sRpcReply::printObjectListLong()
         m_ownerFormat.widen("OWNER");
         m_groupFormat.widen("GROUP");
 
-        printf("%s", headerColorBegin());
+        S9sOutput::write(headerColorBegin());
         printf("MODE        ");
         m_sizeFormat.printf("SIZE");
         m_ownerFormat.printf("OWNER");
@@ -5595,7 +5191,7 @@ S9sRpcReply::printObjectListBrief()
 
     if (options->isJsonRequested())
     {
-        printf("%s\n", STR(toString()));
+        printJson();
         return;
     }
 
@@ -5612,7 +5208,7 @@ S9sRpcReply::printScriptOutput()
 {
     S9sOptions *options = S9sOptions::instance();
     if (options->isJsonRequested())
-        printf("%s\n", STR(toString()));
+        printJson();
     else if (!isOk())
         PRINT_ERROR("%s", STR(errorString()));
     else 
@@ -5813,7 +5409,7 @@ S9sRpcReply::printGraph()
     S9S_DEBUG("Printing graphs.");
     if (options->isJsonRequested())
     {
-        printf("%s\n", STR(toString()));
+        printJson();
         return true;
     }
 
@@ -5995,14 +5591,9 @@ S9sRpcReply::printNodeListLong()
     S9sVariantList  theList = clusters();
     S9sString       formatString = options->longNodeFormat();
     S9sVariantList  hostList;
-    S9sFormat       cidFormat;
-    S9sFormat       hostNameFormat;
-    S9sFormat       versionFormat;
-    S9sFormat       clusterNameFormat;
-    S9sFormat       portFormat;
+    S9sTable        table;
     int             total = 0;
     int             terminalWidth = options->terminalWidth();
-    int             nColumns;
 
     if (options->hasNodeFormat())
         formatString = options->nodeFormat();
@@ -6012,6 +5603,8 @@ S9sRpcReply::printNodeListLong()
      */
     if (!formatString.empty())
     {
+        S9sFormatProgram program = S9sNode::compileFormat(formatString);
+
         for (uint idx = 0; idx < theList.size(); ++idx)
         {
             S9sVariantMap  theMap      = theList[idx].toVariantMap();
@@ -6039,7 +5632,7 @@ S9sRpcReply::printNodeListLong()
 
                 node.setCluster(cluster);
 
-                printf("%s", STR(node.toString(syntaxHighlight, formatString)));
+                printf("%s", STR(node.toString(syntaxHighlight, program)));
             }
         }
     
@@ -6050,7 +5643,7 @@ S9sRpcReply::printNodeListLong()
     }
 
     /*
-     * First run-through: collecting some information.
+     * Collecting the hosts, they are printed sorted.
      */
     for (uint idx = 0; idx < theList.size(); ++idx)
     {
@@ -6063,16 +5656,10 @@ S9sRpcReply::printNodeListLong()
         if (!clusterNameFilter.empty() && clusterNameFilter != clusterName)
             continue;
 
-        clusterNameFormat.widen(clusterName);
-
         for (uint idx2 = 0; idx2 < hosts.size(); ++idx2)
         {
             S9sVariantMap hostMap   = hosts[idx2].toVariantMap();
-            S9sNode       node      = hostMap;
-            S9sString     hostName  = node.name();
-            S9sString     version   = node.version();
-            int           port      = hostMap["port"].toInt(-1);
-            int           clusterId = hostMap["clusterid"].toInt();
+            S9sString     hostName  = S9sNode(hostMap).name();
 
             if (!properties.isSubSet(hostMap))
                 continue;
@@ -6080,70 +5667,40 @@ S9sRpcReply::printNodeListLong()
             if (!options->isStringMatchExtraArguments(hostName))
                 continue;
 
-            if (version.empty())
-                version = "-";
-            
-            hostNameFormat.widen(hostName);
-            cidFormat.widen(clusterId);
-            versionFormat.widen(version);
-            portFormat.widen(port);
-
             hostMap["cluster_name"] = clusterName;
             hostList << hostMap;
         }
     }
 
-    /*
-     * Sorting the hosts.
-     */
     sort(hostList.begin(), hostList.end(), compareHostMaps);
     
-    /*
-     * Printing the header.
-     */
-    if (!options->isNoHeaderRequested())
-    {
-        versionFormat.widen("VERSION");
-        cidFormat.widen("CID");
-        clusterNameFormat.widen("CLUSTER");
-        hostNameFormat.widen("HOST");
-        portFormat.widen("PORT");
-
-        printf("%s", headerColorBegin());
-        printf("STAT ");
-        versionFormat.printf("VERSION");
-        cidFormat.printf("CID");
-        clusterNameFormat.printf("CLUSTER");
-        hostNameFormat.printf("HOST");
-        portFormat.printf("PORT");
-        printf("COMMENT");
-        printf("%s\n", headerColorEnd());
-    }
-        
-    /*
-     * Second run: doing the actual printing.
-     */
-    for (uint idx2 = 0; idx2 < hostList.size(); ++idx2)
-    {
-        S9sVariantMap hostMap   = hostList[idx2].toVariantMap();
-        S9sNode       node      = hostMap;
-        S9sString     hostName  = node.name();
-        int           clusterId = node.clusterId();
-        S9sString     status    = node.hostStatus();
-        S9sString     className = hostMap["class_name"].toString();
-        //S9sString     nodeType  = hostMap["nodetype"].toString();
-        S9sString     message   = node.message();
-        S9sString     version   = node.version();
-        S9sString     clusterName = hostMap["cluster_name"].toString();
-        bool maintenance = hostMap["maintenance_mode_active"].toBoolean();
-        int           port      = hostMap["port"].toInt(-1);
-            
-        // Filtering...
-        if (!properties.isSubSet(hostMap))
-            continue;
-
-        if (!options->isStringMatchExtraArguments(hostName))
-            continue;
+    table.addColumn("STAT");
+    table.addColumn("VERSION");
+    table.addColumn("CID");
+    table.addColumn("CLUSTER");
+    table.addColumn("HOST");
+    table.addColumn("PORT");
+    table.addColumn("COMMENT");
+    table.setHeaderVisible(!options->isNoHeaderRequested());
+    table.setHeaderColor(headerColorBegin(), headerColorEnd());
+    table.setMaxWidth(terminalWidth);
+
+    for (uint idx = 0; idx < hostList.size(); ++idx)
+    {
+        const S9sVariantMap &hostMap = hostList[idx].toVariantMap();
+        S9sNode       node        = hostMap;
+        S9sString     status      = node.hostStatus();
+        S9sString     message     = node.message();
+        S9sString     version     = node.version();
+        S9sString     clusterName = hostMap.at("cluster_name").toString();
+        bool          maintenance = node.isMaintenanceActive();
+        int           port        = -1;
+        const char   *hostColorStart = NULL;
+        const char   *hostColorEnd   = NULL;
+        char          flags[5];
+
+        if (hostMap.contains("port"))
+            port = hostMap.at("port").toInt(-1);
 
         if (message.empty())
             message = "-";
@@ -6157,61 +5714,40 @@ S9sRpcReply::printNodeListLong()
             if (status == "CmonHostRecovery" ||
                     status == "CmonHostShutDown")
             {
-                hostNameFormat.setColor(XTERM_COLOR_YELLOW, TERM_NORMAL);
+                hostColorStart = XTERM_COLOR_YELLOW;
             } else if (status == "CmonHostUnknown" ||
                     status == "CmonHostOffLine")
             {
-                hostNameFormat.setColor(XTERM_COLOR_RED, TERM_NORMAL);
+                hostColorStart = XTERM_COLOR_RED;
             } else {
-                hostNameFormat.setColor(XTERM_COLOR_GREEN, TERM_NORMAL);
+                hostColorStart = XTERM_COLOR_GREEN;
             }
-        }
-
-        // Calculating how much space we have for the message column.
-        nColumns  = 3 + 1 + 1;
-        nColumns += cidFormat.realWidth();
-        nColumns += versionFormat.realWidth();
-        nColumns += clusterNameFormat.realWidth();
-        nColumns += hostNameFormat.realWidth();
-        nColumns += portFormat.realWidth();
 
-        if (nColumns < terminalWidth)
-        {
-            int remaining = terminalWidth - nColumns;
-            
-            if (remaining < (int) message.length())
-            {
-                message.resize(remaining - 1);
-                message += "…";
-            }
+            hostColorEnd = TERM_NORMAL;
         }
 
-        /*
-         * Printing.
-         */
-        printf("%c", node.nodeTypeFlag());
-        printf("%c", node.stateAsChar());
-        printf("%c", node.roleFlag());
-        printf("%c ", maintenance ? 'M' : '-');
-
-        versionFormat.printf(version);
-        cidFormat.printf(clusterId);
-
-        printf("%s", clusterColorBegin());
-        clusterNameFormat.printf(clusterName);
-        printf("%s", clusterColorEnd());
+        flags[0] = node.nodeTypeFlag();
+        flags[1] = node.stateAsChar();
+        flags[2] = node.roleFlag();
+        flags[3] = maintenance ? 'M' : '-';
+        flags[4] = '\0';
 
-        hostNameFormat.printf(hostName);
+        table.addCell(flags);
+        table.addCell(version);
+        table.addCell(node.clusterId());
+        table.addCell(clusterName, clusterColorBegin(), clusterColorEnd());
+        table.addCell(node.name(), hostColorStart, hostColorEnd);
 
         if (port >= 0)
-            portFormat.printf(port);
+            table.addCell(port);
         else
-            portFormat.printf("-");
+            table.addCell("-");
 
-
-        printf("%s\n", STR(message));
+        table.addCell(message);
     }
 
+    table.print();
+
     if (!options->isBatchRequested())
         printf("Total: %d\n", total); 
 }
@@ -6228,133 +5764,69 @@ S9sRpcReply::printJobListBrief()
     bool            syntaxHighlight = options->useSyntaxHighlight();
     S9sVariantList  requiredTags    = options->jobTags();
     int             total           = operator[]("total").toInt();
-    S9sFormat       idFormat;
-    S9sFormat       cidFormat;
-    S9sFormat       stateFormat;
-    S9sFormat       userFormat;
-    S9sFormat       groupFormat;
-    S9sFormat       dateFormat;
-    S9sFormat       percentFormat;
+    S9sTable        table;
+
+    table.addColumn("ID");
+    table.addColumn("CID");
+    table.addColumn("STATE");
+    table.addColumn("OWNER");
+    table.addColumn("GROUP");
+    table.addColumn("CREATED");
+    table.addColumn("RDY");
+    table.addColumn("TITLE");
+    table.setHeaderVisible(!options->isNoHeaderRequested());
+    table.setHeaderColor(headerColorBegin(), headerColorEnd());
 
     theList.reverse();
 
-    //
-    // First run, collecting some information. 
-    //
     for (uint idx = 0; idx < theList.size(); ++idx)
     {
-        S9sVariantMap  theMap = theList[idx].toVariantMap();
         S9sJob         job    = theList[idx].toVariantMap();
         int            jobId  = job.id();
         int            cid    = job.clusterId();
+        S9sString      status = job.status();
+        S9sString      title  = job.title();
         S9sString      user   = job.userName();
         S9sString      group  = job.groupName();
-        S9sString      status = job.status();
-        S9sDateTime    timeStamp;
-        S9sString      timeStampString;
+        S9sString      percent;
+        S9sDateTime    created;
+        S9sString      timeStamp;
+        const char    *stateColorStart = "";
+        const char    *stateColorEnd   = "";
         
         // Filtering.
         if (options->hasJobId() && options->jobId() != jobId)
             continue;
 
-        if (group.empty())
-            group = "-";
-
         if (!job.hasTags(requiredTags))
             continue;
 
+        // The title.
+        if (title.empty())
+            title = "Untitled Job";
+
+        // The user name or if it is not there the user ID.
+        if (user.empty())
+            user.sprintf("%d", job.userId());
+        
+        if (group.empty())
+            group = "-";
+        
+        // The progress.
+        if (job.hasProgressPercent())
+        {
+            percent.sprintf("%3.0f%%", job.progressPercent());
+        } else if (status == "FINISHED") 
+        {
+            percent = "100%";
+        } else {
+            percent = "  0%";
+        }
+
         // The timestamp. Now we use 'created' later we can make this
         // configurable.
-        timeStamp.parse(job.createdString());
-        timeStampString = options->formatDateTime(timeStamp);
-        
-        idFormat.widen(jobId);
-        cidFormat.widen(cid);
-        stateFormat.widen(status);
-        userFormat.widen(user);
-        groupFormat.widen(group);
-        dateFormat.widen(timeStampString);
-    }
-
-    //
-    // Printing the header.
-    //
-    if (!options->isNoHeaderRequested())
-    {
-        idFormat.widen("ID");
-        cidFormat.widen("CID");
-        stateFormat.widen("STATE");
-        userFormat.widen("OWNER");
-        groupFormat.widen("GROUP");
-        dateFormat.widen("CREATED");
-        percentFormat.widen("100%");
-
-        printf("%s", headerColorBegin());
-        idFormat.printf("ID");
-        cidFormat.printf("CID");
-        stateFormat.printf("STATE");
-        userFormat.printf("OWNER");
-        groupFormat.printf("GROUP");
-        dateFormat.printf("CREATED");
-        percentFormat.printf("RDY");
-        printf("TITLE");
-
-        printf("%s", headerColorEnd());
-
-        printf("\n");
-    }
-
-    //
-    // Second run, doing the actual printing.
-    //
-    for (uint idx = 0; idx < theList.size(); ++idx)
-    {
-        S9sVariantMap  theMap = theList[idx].toVariantMap();
-        S9sJob         job    = theList[idx].toVariantMap();
-        int            jobId  = job.id();
-        int            cid    = job.clusterId();
-        S9sString      status = job.status();
-        S9sString      title  = job.title();
-        S9sString      user   = job.userName();
-        S9sString      group  = job.groupName();
-        S9sString      percent;
-        S9sDateTime    created;
-        S9sString      timeStamp;
-        const char    *stateColorStart = "";
-        const char    *stateColorEnd   = "";
-        
-        // Filtering.
-        if (options->hasJobId() && options->jobId() != jobId)
-            continue;
-
-        // The title.
-        if (title.empty())
-            title = "Untitled Job";
-
-        // The user name or if it is not there the user ID.
-        if (user.empty())
-            user.sprintf("%d", theMap["user_id"].toInt());
-        
-        if (group.empty())
-            group = "-";
-        
-        if (!job.hasTags(requiredTags))
-            continue;
-
-        // The progress.
-        if (job.hasProgressPercent())
-        {
-            percent.sprintf("%3.0f%%", job.progressPercent());
-        } else if (status == "FINISHED") 
-        {
-            percent = "100%";
-        } else {
-            percent = "  0%";
-        }
-
-        // The timestamp.
-        created.parse(theMap["created"].toString());
-        timeStamp = options->formatDateTime(created);
+        created.parse(job.createdString());
+        timeStamp = options->formatDateTime(created);
 
         if (syntaxHighlight)
         {
@@ -6377,25 +5849,17 @@ S9sRpcReply::printJobListBrief()
             }
         }
 
-        idFormat.printf(jobId);
-        cidFormat.printf(cid);
-
-        printf("%s", stateColorStart);
-        stateFormat.printf(status);
-        printf("%s", stateColorEnd);
-        
-        printf("%s", userColorBegin());
-        userFormat.printf(user);
-        printf("%s", userColorEnd());
-
-        printf("%s", groupColorBegin(group));
-        groupFormat.printf(group);
-        printf("%s", groupColorEnd());
-
-        dateFormat.printf(timeStamp);
-        percentFormat.printf(percent);
-        printf("%s\n", STR(title));
+        table.addCell(jobId);
+        table.addCell(cid);
+        table.addCell(status, stateColorStart, stateColorEnd);
+        table.addCell(user, userColorBegin(), userColorEnd());
+        table.addCell(group, groupColorBegin(group), groupColorEnd());
+        table.addCell(timeStamp);
+        table.addCell(percent);
+        table.addCell(title);
     }
+
+    table.print();
     
     if (!options->isBatchRequested())
         printf("Total: %d\n", total);
@@ -6851,6 +6315,8 @@ S9sRpcReply::printBackupListFormatString(
     else if (contains("backup_records"))
         dataList = operator[]("backup_records").toVariantList();
 
+    S9sFormatProgram program = S9sBackup::compileFormat(formatString);
+
     S9S_DEBUG(" dataList.size(): %lu",  dataList.size());
     for (uint idx = 0; idx < dataList.size(); ++idx)
     {
@@ -6875,7 +6341,7 @@ S9sRpcReply::printBackupListFormatString(
                     
                 outString = backup.toString(
                         backupIdx, fileIdx, 
-                        syntaxHighlight, formatString);
+                        syntaxHighlight, program);
 
                 printf("%s", STR(outString));
             }        
@@ -6931,16 +6397,7 @@ S9sRpcReply::printBackupListLong()
     S9sOptions     *options = S9sOptions::instance();
     bool            syntaxHighlight = options->useSyntaxHighlight();
     S9sVariantList  dataList;
-    S9sFormat       sizeFormat;
-    S9sFormat       hostNameFormat;
-    S9sFormat       idFormat;
-    S9sFormat       parentIdFormat;
-    S9sFormat       cidFormat;
-    S9sFormat       verifyFormat;
-    S9sFormat       incrementalFormat;
-    S9sFormat       stateFormat;
-    S9sFormat       createdFormat;
-    S9sFormat       ownerFormat;
+    S9sTable        table;
    
     // One is RPC 1.0, the other is 2.0.
     if (contains("data"))
@@ -6948,111 +6405,28 @@ S9sRpcReply::printBackupListLong()
     else if (contains("backup_records"))
         dataList = operator[]("backup_records").toVariantList();
 
-    /*
-     * Collecting some information.
-     */
-    for (uint idx = 0; idx < dataList.size(); ++idx)
-    {
-        S9sVariantMap  theMap     = dataList[idx].toVariantMap();
-        S9sBackup      backup     = theMap;
-        S9sString      hostName   = backup.backupHost();
-        int            id         = backup.id(); 
-        int            parentId   = backup.parentId();
-        int            clusterId  = backup.clusterId(); 
-        S9sString      verifyFlag = backup.verificationFlag();
-        S9sString      owner      = backup.configOwner();
-        S9sString      status     = backup.status(); 
-        ulonglong      fullSize   = 0ull;
-        S9sString      sizeString;
-        S9sString      created;
-
-        if (options->hasBackupId() && options->backupId() != id)
-            continue;
-
-        cidFormat.widen(clusterId);
-        stateFormat.widen(status);
-        hostNameFormat.widen(hostName);
-        ownerFormat.widen(owner);
-        verifyFormat.widen(verifyFlag);
-        incrementalFormat.widen("-");
-
-        for (int backupIdx = 0; backupIdx < backup.nBackups(); ++backupIdx)
-        {
-            idFormat.widen(id);
-            parentIdFormat.widen(parentId);
-
-            for (int fileIdx = 0; 
-                    fileIdx < backup.nFiles(backupIdx); ++fileIdx)
-            {
-                ulonglong size = backup.fileSize(backupIdx, fileIdx).toUll();
-                
-                fullSize += size;
-            }
-                
-            sizeString = S9sFormat::toSizeString(fullSize);
-            sizeFormat.widen(sizeString);
-        }
-                
-        created = backup.beginAsString();
-        createdFormat.widen(created);
-    }
-
-    /*
-     * Printing the header.
-     */
-    if (!options->isNoHeaderRequested())
-    {
-        idFormat.widen("ID");
-        parentIdFormat.widen("PI");
-        cidFormat.widen("CID");
-        verifyFormat.widen("V");
-        incrementalFormat.widen("I");
-        stateFormat.widen("STATE");
-        ownerFormat.widen("OWNER");
-        hostNameFormat.widen("HOSTNAME");
-        createdFormat.widen("CREATED");
-        sizeFormat.widen("SIZE");
+    table.addColumn("ID");
+    table.addColumn("PI", S9sFormat::AlignRight);
+    table.addColumn("CID");
+    table.addColumn("V");
+    table.addColumn("I");
+    table.addColumn("STATE");
+    table.addColumn("OWNER");
+    table.addColumn("HOSTNAME");
+    table.addColumn("CREATED");
+    table.addColumn("SIZE", S9sFormat::AlignRight);
+    table.addColumn("TITLE");
+    table.setHeaderVisible(!options->isNoHeaderRequested());
+    table.setHeaderColor(headerColorBegin(), headerColorEnd());
 
-        printf("%s", headerColorBegin());
-        idFormat.printf("ID");
-        parentIdFormat.printf("PI");
-        cidFormat.printf("CID");
-        verifyFormat.printf("V");
-        incrementalFormat.printf("I");
-        stateFormat.printf("STATE");
-        ownerFormat.printf("OWNER");
-        hostNameFormat.printf("HOSTNAME");
-        createdFormat.printf("CREATED");
-        sizeFormat.printf("SIZE");
-        printf("TITLE");
- 
-        printf("%s", headerColorEnd());
-        printf("\n");
-    }
-    
-    sizeFormat.setRightJustify();
-    parentIdFormat.setRightJustify();
-
-    /*
-     * Second run, we print things here.
-     */
     for (uint idx = 0; idx < dataList.size(); ++idx)
     {
-        S9sVariantMap  theMap     = dataList[idx].toVariantMap();
-        S9sBackup      backup     = theMap;
-        S9sString      hostName   = backup.backupHost();
-        int            clusterId  = backup.clusterId();
-        S9sString      verifyFlag = backup.verificationFlag();
-        bool           hasInc     = false;
-        bool           hasNotInc  = false;
-        S9sString      owner      = backup.configOwner();
+        S9sBackup      backup     = dataList[idx].toVariantMap();
         int            id         = backup.id();
         int            parentId   = backup.parentId();
-        S9sString      status     = backup.status();
-        S9sString      root       = backup.rootDir();
+        bool           hasInc     = false;
+        bool           hasNotInc  = false;
         ulonglong      fullSize   = 0ull;
-        S9sString      sizeString;
-        S9sString      created;
 
         /*
          * Filtering.
@@ -7060,33 +6434,6 @@ S9sRpcReply::printBackupListLong()
         if (options->hasBackupId() && options->backupId() != id)
             continue;
 
-        /*
-         * Let's keep this for a while...
-         */
-#if 0
-        if (backups.size() == 0u)
-        {
-            S9sString     path          = "-";
-            S9sString     sizeString    = "-";
-            S9sString     createdString = "-";
-                
-            idFormat.printf(id);
-            cidFormat.printf(clusterId);
-
-            printf("%s", backup.statusColorBegin(syntaxHighlight));
-            stateFormat.printf(status);
-            printf("%s", backup.statusColorEnd(syntaxHighlight));
-
-            ownerFormat.printf(owner);
-            hostNameFormat.printf(hostName);
-            createdFormat.printf(createdString);
-            sizeFormat.printf(sizeString);
-            printf("%s", STR(path));
-            printf("\n");
-
-            continue;
-        }
-#endif
         for (int backupIdx = 0; backupIdx < backup.nBackups(); ++backupIdx)
         {
             for (int fileIdx = 0; fileIdx < backup.nFiles(backupIdx); ++fileIdx)
@@ -7105,45 +6452,38 @@ S9sRpcReply::printBackupListLong()
             }
         }
 
-        created = backup.beginAsString();
-        sizeString = S9sFormat::toSizeString(fullSize);
+        table.addCell(id);
 
-        idFormat.printf(id);
         if (parentId > 0)
-            parentIdFormat.printf(parentId);
+            table.addCell(parentId);
         else
-            parentIdFormat.printf("-");
+            table.addCell("-");
 
-        cidFormat.printf(clusterId);
-        verifyFormat.printf(verifyFlag);
+        table.addCell(backup.clusterId());
+        table.addCell(backup.verificationFlag());
         
         if (hasInc && hasNotInc)
-            printf("B ");
+            table.addCell("B");
         else if (hasInc)
-            printf("I ");
+            table.addCell("I");
         else if (hasNotInc)
-            printf("F ");
+            table.addCell("F");
         else 
-            printf("- ");
-
-        printf("%s", backup.statusColorBegin(syntaxHighlight));
-        stateFormat.printf(status);
-        printf("%s", backup.statusColorEnd(syntaxHighlight));
+            table.addCell("-");
 
-        printf("%s", userColorBegin());
-        ownerFormat.printf(owner);
-        printf("%s", userColorEnd());
+        table.addCell(backup.status(), 
+                backup.statusColorBegin(syntaxHighlight),
+                backup.statusColorEnd(syntaxHighlight));
 
-        printf("%s", ipColorBegin());
-        hostNameFormat.printf(hostName);
-        printf("%s", ipColorEnd());
-        
-        createdFormat.printf(created);
-        sizeFormat.printf(sizeString);
-        printf("%s", STR(backup.title()));
-        printf("\n");
+        table.addCell(backup.configOwner(), userColorBegin(), userColorEnd());
+        table.addCell(backup.backupHost(), ipColorBegin(), ipColorEnd());
+        table.addCell(backup.beginAsString());
+        table.addCell(S9sFormat::toSizeString(fullSize));
+        table.addCell(backup.title());
     }
 
+    table.print();
+
     /*
      * Footer.
      */
@@ -7206,16 +6546,7 @@ S9sRpcReply::printBackupListDatabasesLong()
     S9sOptions     *options = S9sOptions::instance();
     bool            syntaxHighlight = options->useSyntaxHighlight();
     S9sVariantList  dataList;
-    S9sFormat       sizeFormat;
-    S9sFormat       hostNameFormat;
-    S9sFormat       idFormat;
-    S9sFormat       parentIdFormat;
-    S9sFormat       cidFormat;
-    S9sFormat       verifyFormat;
-    S9sFormat       stateFormat;
-    S9sFormat       createdFormat;
-    S9sFormat       ownerFormat;
-    S9sFormat       incrementalFormat;
+    S9sTable        table;
    
     // One is RPC 1.0, the other is 2.0.
     if (contains("data"))
@@ -7223,124 +6554,30 @@ S9sRpcReply::printBackupListDatabasesLong()
     else if (contains("backup_records"))
         dataList = operator[]("backup_records").toVariantList();
 
-    /*
-     * Collecting some information.
-     */
-    for (uint idx = 0; idx < dataList.size(); ++idx)
-    {
-        S9sVariantMap  theMap    = dataList[idx].toVariantMap();
-        S9sBackup      backup    = theMap;
-        S9sVariantList backups   = theMap["backup"].toVariantList();
-        S9sString      hostName  = backup.backupHost();
-        int            clusterId = backup.clusterId(); 
-        S9sString      verifyFlag = backup.verificationFlag();
-        S9sString      owner     = backup.configOwner();
-        int            id        = backup.id(); 
-        int            parentId   = backup.parentId();
-        S9sString      status    = backup.status(); 
-        ulonglong      fullSize  = 0ull;
-        S9sString      sizeString;
-        S9sString      created;
-
-        if (options->hasBackupId() && options->backupId() != id)
-            continue;
-
-        cidFormat.widen(clusterId);
-        stateFormat.widen(status);
-        hostNameFormat.widen(hostName);
-        ownerFormat.widen(owner);
-        verifyFormat.widen(verifyFlag);
-        incrementalFormat.widen("-");
-        
-        if (backups.size() == 0u)
-        {
-            S9sString     sizeString    = "-";
-            S9sString     createdString = "-";
-            
-            createdFormat.widen(createdString);
-            sizeFormat.widen(sizeString);
-            
-            continue;
-        }
-
-        for (int backupIdx = 0; backupIdx < backup.nBackups(); ++backupIdx)
-        {
-            idFormat.widen(id);
-            parentIdFormat.widen(parentId);
-
-            for (int fileIdx = 0; 
-                    fileIdx < backup.nFiles(backupIdx); ++fileIdx)
-            {
-                ulonglong size = backup.fileSize(backupIdx, fileIdx).toUll();
-                
-                fullSize += size;
-            }
-                
-            sizeString = S9sFormat::toSizeString(fullSize);
-            sizeFormat.widen(sizeString);
-        }
-                
-        created = backup.beginAsString();
-        createdFormat.widen(created);
-    }
-
-    /*
-     * Printing the header.
-     */
-    if (!options->isNoHeaderRequested())
-    {
-        idFormat.widen("ID");
-        parentIdFormat.widen("PI");
-        cidFormat.widen("CID");
-        verifyFormat.widen("V");
-        incrementalFormat.widen("I");
-        stateFormat.widen("STATE");
-        ownerFormat.widen("OWNER");
-        hostNameFormat.widen("HOSTNAME");
-        createdFormat.widen("CREATED");
-        sizeFormat.widen("SIZE");
+    table.addColumn("ID");
+    table.addColumn("PI", S9sFormat::AlignRight);
+    table.addColumn("CID");
+    table.addColumn("V");
+    table.addColumn("I");
+    table.addColumn("STATE");
+    table.addColumn("OWNER");
+    table.addColumn("HOSTNAME");
+    table.addColumn("CREATED");
+    table.addColumn("SIZE", S9sFormat::AlignRight);
+    table.addColumn("DATABASES");
+    table.setHeaderVisible(!options->isNoHeaderRequested());
+    table.setHeaderColor(headerColorBegin(), headerColorEnd());
 
-        printf("%s", headerColorBegin());
-        idFormat.printf("ID");
-        parentIdFormat.printf("PI");
-        cidFormat.printf("CID");
-        verifyFormat.printf("V");
-        incrementalFormat.printf("I");
-        stateFormat.printf("STATE");
-        ownerFormat.printf("OWNER");
-        hostNameFormat.printf("HOSTNAME");
-        createdFormat.printf("CREATED");
-        sizeFormat.printf("SIZE");
-        printf("DATABASES");
- 
-        printf("%s", headerColorEnd());
-        printf("\n");
-    }
-    
-    sizeFormat.setRightJustify();
-    parentIdFormat.setRightJustify();
-
-    /*
-     * Second run, we print things here.
-     */
     for (uint idx = 0; idx < dataList.size(); ++idx)
     {
         S9sVariantMap  theMap    = dataList[idx].toVariantMap();
         S9sBackup      backup    = theMap;
         S9sVariantList backups   = theMap["backup"].toVariantList();
-        S9sString      hostName  = backup.backupHost();
-        int            clusterId = backup.clusterId();
-        S9sString      verifyFlag = backup.verificationFlag();
-        S9sString      owner     = backup.configOwner();
         int            id        = backup.id();
-        int            parentId   = backup.parentId();
-        S9sString      status    = backup.status();
-        S9sString      root      = backup.rootDir();
+        int            parentId  = backup.parentId();
         ulonglong      fullSize  = 0ull;
-        S9sString      sizeString;
-        S9sString      created;
-        bool           hasInc     = false;
-        bool           hasNotInc  = false;
+        bool           hasInc    = false;
+        bool           hasNotInc = false;
 
         /*
          * Filtering.
@@ -7348,43 +6585,30 @@ S9sRpcReply::printBackupListDatabasesLong()
         if (options->hasBackupId() && options->backupId() != id)
             continue;
 
-        /*
-         *
-         */
         if (backups.size() == 0u)
         {
-            S9sString     database      = "-";
-            S9sString     sizeString    = "-";
-            S9sString     createdString = "-";
-                
-            idFormat.printf(id);
+            table.addCell(id);
+
             if (parentId > 0)
-                parentIdFormat.printf(parentId);
+                table.addCell(parentId);
             else
-                parentIdFormat.printf("-");
-            
-            cidFormat.printf(clusterId);
-            verifyFormat.printf(verifyFlag);
-            
-            // incremental
-            printf("- ");
+                table.addCell("-");
 
-            printf("%s", backup.statusColorBegin(syntaxHighlight));
-            stateFormat.printf(status);
-            printf("%s", backup.statusColorEnd(syntaxHighlight));
-            
-            printf("%s", userColorBegin());
-            ownerFormat.printf(owner);
-            printf("%s", userColorEnd());
+            table.addCell(backup.clusterId());
+            table.addCell(backup.verificationFlag());
+            table.addCell("-");
 
-            printf("%s", ipColorBegin());
-            hostNameFormat.printf(hostName);
-            printf("%s", ipColorEnd());
+            table.addCell(backup.status(),
+                    backup.statusColorBegin(syntaxHighlight),
+                    backup.statusColorEnd(syntaxHighlight));
 
-            createdFormat.printf(createdString);
-            sizeFormat.printf(sizeString);
-            printf("%s", STR(database));
-            printf("\n");
+            table.addCell(backup.configOwner(),
+                    userColorBegin(), userColorEnd());
+
+            table.addCell(backup.backupHost(), ipColorBegin(), ipColorEnd());
+            table.addCell("-");
+            table.addCell("-");
+            table.addCell("-");
 
             continue;
         }
@@ -7409,50 +6633,45 @@ S9sRpcReply::printBackupListDatabasesLong()
                 }
             }
 
-            created = backup.beginAsString();
-            sizeString = S9sFormat::toSizeString(fullSize);
+            databaseNames = backup.databaseNamesAsString(backupIdx);
+            if (databaseNames.empty())
+                databaseNames = "-";
+
+            table.addCell(id);
 
-            idFormat.printf(id);
             if (parentId > 0)
-                parentIdFormat.printf(parentId);
+                table.addCell(parentId);
             else
-                parentIdFormat.printf("-");
+                table.addCell("-");
+
+            table.addCell(backup.clusterId());
+            table.addCell(backup.verificationFlag());
 
-            cidFormat.printf(clusterId);
-            verifyFormat.printf(verifyFlag);
-            
             if (hasInc && hasNotInc)
-                printf("B ");
+                table.addCell("B");
             else if (hasInc)
-                printf("I ");
+                table.addCell("I");
             else if (hasNotInc)
-                printf("F ");
+                table.addCell("F");
             else 
-                printf("- ");
-
-            databaseNames = backup.databaseNamesAsString(backupIdx);
-            if (databaseNames.empty())
-                databaseNames = "-";
-
-            printf("%s", backup.statusColorBegin(syntaxHighlight));
-            stateFormat.printf(status);
-            printf("%s", backup.statusColorEnd(syntaxHighlight));
+                table.addCell("-");
 
-            printf("%s", userColorBegin());
-            ownerFormat.printf(owner);
-            printf("%s", userColorEnd());
+            table.addCell(backup.status(),
+                    backup.statusColorBegin(syntaxHighlight),
+                    backup.statusColorEnd(syntaxHighlight));
 
-            printf("%s", ipColorBegin());
-            hostNameFormat.printf(hostName);
-            printf("%s", ipColorEnd());
+            table.addCell(backup.configOwner(),
+                    userColorBegin(), userColorEnd());
 
-            createdFormat.printf(created);
-            sizeFormat.printf(sizeString);
-            printf("%s", STR(databaseNames));
-            printf("\n");
+            table.addCell(backup.backupHost(), ipColorBegin(), ipColorEnd());
+            table.addCell(backup.beginAsString());
+            table.addCell(S9sFormat::toSizeString(fullSize));
+            table.addCell(databaseNames);
         }
     }
 
+    table.print();
+
     /*
      * Footer.
      */
@@ -7541,16 +6760,7 @@ S9sRpcReply::printBackupListFilesLong()
     S9sOptions     *options = S9sOptions::instance();
     S9sVariantList  dataList;
     bool            syntaxHighlight = options->useSyntaxHighlight();
-    S9sFormat       sizeFormat;
-    S9sFormat       hostNameFormat;
-    S9sFormat       idFormat;
-    S9sFormat       parentIdFormat;
-    S9sFormat       cidFormat;
-    S9sFormat       verifyFormat;
-    S9sFormat       incrementalFormat;
-    S9sFormat       stateFormat;
-    S9sFormat       createdFormat;
-    S9sFormat       ownerFormat;
+    S9sTable        table;
     const char     *colorBegin = "";
     const char     *colorEnd   = "";
    
@@ -7559,122 +6769,34 @@ S9sRpcReply::printBackupListFilesLong()
         dataList = operator[]("data").toVariantList();
     else if (contains("backup_records"))
         dataList = operator[]("backup_records").toVariantList();
-   
-    /*
-     * Collecting some information.
-     */
-    for (uint idx = 0; idx < dataList.size(); ++idx)
-    {
-        S9sVariantMap  theMap     = dataList[idx].toVariantMap();
-        S9sBackup      backup     = theMap;
-        S9sVariantList backups    = theMap["backup"].toVariantList();
-        S9sString      hostName   = backup.backupHost();
-        int            clusterId  = backup.clusterId(); 
-        S9sString      verifyFlag = backup.verificationFlag();
-        S9sString      owner      = backup.configOwner();
-        int            id         = backup.id(); 
-        int            parentId   = backup.parentId();
-        S9sString      status     = backup.status(); 
-
-        #if 0
-        S9S_DEBUG("*** hasBackupId: %s", 
-                options->hasBackupId() ? "true" : "false");
-        S9S_DEBUG("*** bakupId: %d", options->backupId());
-        S9S_DEBUG("*** id : %d", id);
-        #endif
 
-        if (options->hasBackupId() && options->backupId() != id)
-            continue;
+    table.addColumn("ID");
+    table.addColumn("PI", S9sFormat::AlignRight);
+    table.addColumn("CID");
+    table.addColumn("V");
+    table.addColumn("I");
+    table.addColumn("STATE");
+    table.addColumn("OWNER");
+    table.addColumn("HOSTNAME");
+    table.addColumn("CREATED");
+    table.addColumn("SIZE", S9sFormat::AlignRight);
+    table.addColumn("FILENAME");
+    table.setHeaderVisible(!options->isNoHeaderRequested());
+    table.setHeaderColor(headerColorBegin(), headerColorEnd());
 
-        cidFormat.widen(clusterId);
-        stateFormat.widen(status);
-        hostNameFormat.widen(hostName);
-        ownerFormat.widen(owner);
-        verifyFormat.widen(verifyFlag);
-        incrementalFormat.widen("-");
-        
-        if (backups.size() == 0u)
-        {
-            S9sString     sizeString    = "-";
-            S9sString     createdString = "-";
-            
-            createdFormat.widen(createdString);
-            sizeFormat.widen(sizeString);
-            
-            continue;
-        }
-
-        for (int backupIdx = 0; backupIdx < backup.nBackups(); ++backupIdx)
-        {
-            idFormat.widen(id);
-            parentIdFormat.widen(parentId);
-
-            for (int fileIdx = 0; 
-                    fileIdx < backup.nFiles(backupIdx); ++fileIdx)
-            {
-                ulonglong size = backup.fileSize(backupIdx, fileIdx).toUll();
-                S9sString sizeString;
-                S9sString created = backup.fileCreatedString(
-                        backupIdx, fileIdx);
-        
-                sizeString = S9sFormat::toSizeString(size);
-                createdFormat.widen(created);
-                sizeFormat.widen(sizeString);
-            }
-        }
-    }
-
-    /*
-     * Printing the header.
-     */
-    if (!options->isNoHeaderRequested())
+    if (syntaxHighlight)
     {
-        idFormat.widen("ID");
-        parentIdFormat.widen("PI");
-        cidFormat.widen("CID");
-        verifyFormat.widen("V");
-        incrementalFormat.widen("I");
-        stateFormat.widen("STATE");
-        ownerFormat.widen("OWNER");
-        hostNameFormat.widen("HOSTNAME");
-        createdFormat.widen("CREATED");
-        sizeFormat.widen("SIZE");
-
-        printf("%s", headerColorBegin());
-        idFormat.printf("ID");
-        parentIdFormat.printf("PI");
-        cidFormat.printf("CID");
-        verifyFormat.printf("V");
-        incrementalFormat.printf("I");
-        stateFormat.printf("STATE");
-        ownerFormat.printf("OWNER");
-        hostNameFormat.printf("HOSTNAME");
-        createdFormat.printf("CREATED");
-        sizeFormat.printf("SIZE");
-        printf("FILENAME");
- 
-        printf("%s", headerColorEnd());
-        printf("\n");
+        colorBegin = XTERM_COLOR_RED;
+        colorEnd   = TERM_NORMAL;
     }
-    
-    sizeFormat.setRightJustify();
-    parentIdFormat.setRightJustify();
 
-    /*
-     * Second run, we print things here.
-     */
     for (uint idx = 0; idx < dataList.size(); ++idx)
     {
         S9sVariantMap  theMap    = dataList[idx].toVariantMap();
         S9sBackup      backup    = theMap;
         S9sVariantList backups   = theMap["backup"].toVariantList();
-        S9sString      hostName  = backup.backupHost();
-        int            clusterId = backup.clusterId();
-        S9sString      verifyFlag = backup.verificationFlag();
-        S9sString      owner     = backup.configOwner();
         int            id        = backup.id();
-        int            parentId   = backup.parentId();
-        S9sString      status    = backup.status();
+        int            parentId  = backup.parentId();
         S9sString      root      = backup.rootDir();
 
         /*
@@ -7683,43 +6805,30 @@ S9sRpcReply::printBackupListFilesLong()
         if (options->hasBackupId() && options->backupId() != id)
             continue;
 
-        /*
-         *
-         */
         if (backups.size() == 0u)
         {
-            S9sString     path          = "-";
-            S9sString     sizeString    = "-";
-            S9sString     createdString = "-";
-                
-            idFormat.printf(id);
+            table.addCell(id);
+
             if (parentId > 0)
-                parentIdFormat.printf(parentId);
+                table.addCell(parentId);
             else
-                parentIdFormat.printf("-");
-            
-            cidFormat.printf(clusterId);
-            verifyFormat.printf(verifyFlag);
+                table.addCell("-");
 
-            // incremental
-            printf("- ");
+            table.addCell(backup.clusterId());
+            table.addCell(backup.verificationFlag());
+            table.addCell("-");
 
-            printf("%s", backup.statusColorBegin(syntaxHighlight));
-            stateFormat.printf(status);
-            printf("%s", backup.statusColorEnd(syntaxHighlight));
-            
-            printf("%s", userColorBegin());
-            ownerFormat.printf(owner);
-            printf("%s", userColorEnd());
+            table.addCell(backup.status(),
+                    backup.statusColorBegin(syntaxHighlight),
+                    backup.statusColorEnd(syntaxHighlight));
 
-            printf("%s", ipColorBegin());
-            hostNameFormat.printf(hostName);
-            printf("%s", ipColorEnd());
+            table.addCell(backup.configOwner(),
+                    userColorBegin(), userColorEnd());
 
-            createdFormat.printf(createdString);
-            sizeFormat.printf(sizeString);
-            printf("%s", STR(path));
-            printf("\n");
+            table.addCell(backup.backupHost(), ipColorBegin(), ipColorEnd());
+            table.addCell("-");
+            table.addCell("-");
+            table.addCell("-");
 
             continue;
         }
@@ -7730,11 +6839,8 @@ S9sRpcReply::printBackupListFilesLong()
             {
                 S9sString   path = backup.fileName(backupIdx, fileIdx);
                 ulonglong   size = backup.fileSize(backupIdx, fileIdx).toUll();
-                S9sString   sizeString;
                 bool        incremental = 
                     backup.incremental(backupIdx, fileIdx).toBoolean();
-                S9sString   created = backup.fileCreatedString(
-                        backupIdx, fileIdx);
 
                 if (options->fullPathRequested())
                 {
@@ -7744,52 +6850,38 @@ S9sRpcReply::printBackupListFilesLong()
                     path = root + path;
                 }
 
-                sizeString = S9sFormat::toSizeString(size);
+                table.addCell(id);
 
-                if (syntaxHighlight)
-                {
-                    colorBegin = XTERM_COLOR_RED;
-                    colorEnd   = TERM_NORMAL;
-                } else {
-                    colorBegin = "";
-                    colorEnd   = "";
-                }
-
-                idFormat.printf(id);
-        
                 if (parentId > 0)
-                    parentIdFormat.printf(parentId);
+                    table.addCell(parentId);
                 else
-                    parentIdFormat.printf("-");
+                    table.addCell("-");
 
-                cidFormat.printf(clusterId);
-                verifyFormat.printf(verifyFlag);
-        
-                if (incremental)
-                    printf("I ");
-                else
-                    printf("F ");
-                
-                printf("%s", backup.statusColorBegin(syntaxHighlight));
-                stateFormat.printf(status);
-                printf("%s", backup.statusColorEnd(syntaxHighlight));
+                table.addCell(backup.clusterId());
+                table.addCell(backup.verificationFlag());
+                table.addCell(incremental ? "I" : "F");
 
-                printf("%s", userColorBegin());
-                ownerFormat.printf(owner);
-                printf("%s", userColorEnd());
+                table.addCell(backup.status(),
+                        backup.statusColorBegin(syntaxHighlight),
+                        backup.statusColorEnd(syntaxHighlight));
 
-                printf("%s", ipColorBegin());
-                hostNameFormat.printf(hostName);
-                printf("%s", ipColorEnd());
+                table.addCell(backup.configOwner(),
+                        userColorBegin(), userColorEnd());
 
-                createdFormat.printf(created);
-                sizeFormat.printf(sizeString);
-                printf("%s%s%s", colorBegin, STR(path), colorEnd);
-                printf("\n");
+                table.addCell(backup.backupHost(),
+                        ipColorBegin(), ipColorEnd());
+
+                table.addCell(
+                        backup.fileCreatedString(backupIdx, fileIdx));
+
+                table.addCell(S9sFormat::toSizeString(size));
+                table.addCell(path, colorBegin, colorEnd);
             }
         }
     }
 
+    table.print();
+
     /*
      * Footer.
      */
@@ -7897,7 +6989,7 @@ S9sRpcReply::printMaintenanceListLong()
         endFormat.widen("END");
         nameFormat.widen("HOST/CLUSTER");
 
-        printf("%s", headerColorBegin());
+        S9sOutput::write(headerColorBegin());
         printf("ST ");
         uuidFormat.printf("UUID");
         ownerFormat.printf("OWNER");
@@ -7907,7 +6999,7 @@ S9sRpcReply::printMaintenanceListLong()
         nameFormat.printf("HOST/CLUSTER");
         printf("REASON");
         
-        printf("%s", headerColorEnd());
+        S9sOutput::write(headerColorEnd());
 
         printf("\n");
     }
@@ -7963,13 +7055,13 @@ S9sRpcReply::printMaintenanceListLong()
                 
             printf("%s ", STR(uuid));
 
-            printf("%s", userColorBegin());
+            S9sOutput::write(userColorBegin());
             ownerFormat.printf(userName);
-            printf("%s", userColorEnd());
+            S9sOutput::write(userColorEnd());
             
-            printf("%s", groupColorBegin(groupName));
+            S9sOutput::write(groupColorBegin(groupName));
             groupOwnerFormat.printf(groupName);
-            printf("%s", groupColorEnd());
+            S9sOutput::write(groupColorEnd());
 
             startFormat.printf(startString);
             endFormat.printf(endString);
@@ -7978,9 +7070,9 @@ S9sRpcReply::printMaintenanceListLong()
             {
                 nameFormat.printf(STR(hostName));
             } else {
-                printf("%s", clusterColorBegin());
+                S9sOutput::write(clusterColorBegin());
                 nameFormat.printf(STR(clusterName));
-                printf("%s", groupColorEnd());
+                S9sOutput::write(groupColorEnd());
             }
 
             printf("%s ", STR(reason));
@@ -8063,12 +7155,12 @@ S9sRpcReply::printGroupListLong()
         ownerFormat.widen("OWNER");
         groupOwnerFormat.widen("GOWNER");
 
-        printf("%s", headerColorBegin());
+        S9sOutput::write(headerColorBegin());
         idFormat.printf("ID");
         ownerFormat.printf("OWNER");
         groupOwnerFormat.printf("GOWNER");
         nameFormat.printf("NAME");
-        printf("%s", headerColorEnd());
+        S9sOutput::write(headerColorEnd());
 
         printf("\n");
     }
@@ -8153,7 +7245,7 @@ S9sRpcReply::printUserList()
     
     if (options->isJsonRequested())
     {
-        printf("%s\n", STR(toString()));
+        printJson();
         return;
     }
 
@@ -8225,6 +7317,8 @@ S9sRpcReply::printUserListBrief()
 
     if (!formatString.empty())
     {
+        S9sFormatProgram program = S9sUser::compileFormat(formatString);
+
         for (uint idx = 0; idx < userList.size(); ++idx)
         {
             S9sVariantMap  userMap      = userList[idx].toVariantMap();
@@ -8244,7 +7338,7 @@ S9sRpcReply::printUserListBrief()
             if (!groupFilter.empty() && !user.isMemberOf(groupFilter))
                 continue;
    
-            printf("%s", STR(user.toString(syntaxHighlight, formatString)));
+            printf("%s", STR(user.toString(syntaxHighlight, program)));
             
         }
 
@@ -8306,16 +7400,15 @@ S9sRpcReply::printUserListLong()
     const char     *colorEnd   = "";
     const char     *groupColorBegin = "";
     const char     *groupColorEnd   = "";
-    S9sFormat       idFormat;
-    S9sFormat       userNameFormat;
-    S9sFormat       groupNamesFormat;
-    S9sFormat       emailFormat;
+    S9sTable        table;
 
     if (options->hasUserFormat())
         formatString = options->userFormat();
 
     if (!formatString.empty())
     {
+        S9sFormatProgram program = S9sUser::compileFormat(formatString);
+
         for (uint idx = 0; idx < userList.size(); ++idx)
         {
             S9sVariantMap  userMap      = userList[idx].toVariantMap();
@@ -8335,7 +7428,7 @@ S9sRpcReply::printUserListLong()
             if (!groupFilter.empty() && !user.isMemberOf(groupFilter))
                 continue;
    
-            printf("%s", STR(user.toString(syntaxHighlight, formatString)));
+            printf("%s", STR(user.toString(syntaxHighlight, program)));
         }
 
         if (!options->isBatchRequested())
@@ -8344,71 +7437,18 @@ S9sRpcReply::printUserListLong()
         return;
     }
 
-    /*
-     * Going through first and collecting some informations.
-     */
-    for (uint idx = 0; idx < userList.size(); ++idx)
-    {
-        S9sVariantMap  userMap      = userList[idx].toVariantMap();
-        S9sUser        user         = userMap;
-        S9sString      userName     = user.userName();
-        S9sString      emailAddress = user.emailAddress();
-        int            userId       = user.userId();
-        S9sString      groupNames   = user.groupNames(); 
-        
-        /*
-         * Filtering.
-         */
-        if (whoAmIRequested && userId != authUserId)
-            continue;
-        
-        if (!options->isStringMatchExtraArguments(userName))
-            continue;
-
-        if (!groupFilter.empty() && !user.isMemberOf(groupFilter))
-            continue;
-
-        if (groupNames.empty())
-            groupNames = "-";
-        
-        if (emailAddress.empty())
-            emailAddress = "-";
-
-        userNameFormat.widen(userName);
-        emailFormat.widen(emailAddress);
-        idFormat.widen(userId);
-        groupNamesFormat.widen(groupNames);
-    }
-
-    /*
-     * Printing the header.
-     */
-    if (!options->isNoHeaderRequested())
-    {
-        idFormat.widen("ID");
-        userNameFormat.widen("UNAME");
-        groupNamesFormat.widen("GROUPS");
-        emailFormat.widen("EMAIL");
-
-        printf("%s", headerColorBegin());
-        printf("A ");
-        idFormat.printf("ID");
-        userNameFormat.printf("UNAME");
-        groupNamesFormat.printf("GROUPS");
-        emailFormat.printf("EMAIL");
-        printf("REALNAME");
-        printf("%s", headerColorEnd());
-
-        printf("\n");
-    }
+    table.addColumn("A");
+    table.addColumn("ID");
+    table.addColumn("UNAME");
+    table.addColumn("GROUPS");
+    table.addColumn("EMAIL");
+    table.addColumn("REALNAME");
+    table.setHeaderVisible(!options->isNoHeaderRequested());
+    table.setHeaderColor(headerColorBegin(), headerColorEnd());
 
-    /*
-     * Going through again and printing.
-     */
     for (uint idx = 0; idx < userList.size(); ++idx)
     {
-        S9sVariantMap  userMap      = userList[idx].toVariantMap();
-        S9sUser        user         = userMap;
+        S9sUser        user         = userList[idx].toVariantMap();
         S9sString      userName     = user.userName();
         int            userId       = user.userId();
         S9sString      emailAddress = user.emailAddress();
@@ -8444,29 +7484,15 @@ S9sRpcReply::printUserListLong()
             groupColorEnd   = TERM_NORMAL;
         }
 
-        //
-        // Printing the fields.
-        //
-        if (userId == authUserId)
-            printf("A ");
-        else
-            printf("- ");
-        
-        idFormat.printf(userId);
-
-        printf("%s", colorBegin);
-        userNameFormat.printf(userName);
-        printf("%s", colorEnd);
-        
-        printf("%s", groupColorBegin);
-        groupNamesFormat.printf(groupNames);
-        printf("%s", groupColorEnd);
-
-        emailFormat.printf(emailAddress);
-
-        printf("%s", STR(fullName));
-        printf("\n");
+        table.addCell(userId == authUserId ? "A" : "-");
+        table.addCell(userId);
+        table.addCell(userName, colorBegin, colorEnd);
+        table.addCell(groupNames, groupColorBegin, groupColorEnd);
+        table.addCell(emailAddress);
+        table.addCell(fullName);
     }
+
+    table.print();
     
     if (!options->isBatchRequested())
         printf("Total: %d\n", operator[]("total").toInt());
@@ -9251,7 +8277,7 @@ S9sRpcReply::printMetaTypeList()
     S9sOptions *options = S9sOptions::instance();
     
     if (options->isJsonRequested())
-        printf("%s\n", STR(toString()));
+        printJson();
     else if (options->isLongRequested())
         printMetaTypeListLong();
     else
@@ -9291,12 +8317,12 @@ S9sRpcReply::printMetaTypeListLong()
     {
         nameFormat.widen("NAME");
             
-        printf("%s", headerColorBegin());
+        S9sOutput::write(headerColorBegin());
          
         nameFormat.printf("NAME");
         printf("DESCRIPTION");
 
-        printf("%s", headerColorEnd());
+        S9sOutput::write(headerColorEnd());
         printf("\n");
     }
 
@@ -9318,9 +8344,9 @@ S9sRpcReply::printMetaTypeListLong()
         if (description.empty())
             description = "-";
 
-        printf("%s", typeColorBegin());
+        S9sOutput::write(typeColorBegin());
         nameFormat.printf(typeName);
-        printf("%s", typeColorEnd());
+        S9sOutput::write(typeColorEnd());
 
         printf("%s", STR(description));
         printf("\n");
@@ -9371,9 +8397,9 @@ S9sRpcReply::printMetaTypeListBrief()
         if (!options->isStringMatchExtraArguments(typeName))
             continue;
 
-        printf("%s", typeColorBegin());
+        S9sOutput::write(typeColorBegin());
         nameFormat.printf(typeName);
-        printf("%s", typeColorEnd());
+        S9sOutput::write(typeColorEnd());
 
         currentPosition += nameFormat.realWidth();
         if (currentPosition + nameFormat.realWidth() > terminalWidth ||
@@ -9394,7 +8420,7 @@ S9sRpcReply::printMetaTypePropertyList()
     S9sOptions *options = S9sOptions::instance();
     
     if (options->isJsonRequested())
-        printf("%s\n", STR(toString()));
+        printJson();
     else if (options->isLongRequested())
         printMetaTypePropertyListLong();
     else
@@ -9445,14 +8471,14 @@ S9sRpcReply::printMetaTypePropertyListLong()
         nameFormat.widen("NAME");
         unitFormat.widen("UNIT");
 
-        printf("%s", headerColorBegin());
+        S9sOutput::write(headerColorBegin());
          
         statFormat.printf("ST");
         nameFormat.printf("NAME");
         unitFormat.printf("UNIT");
         printf("DESCRIPTION");
 
-        printf("%s", headerColorEnd());
+        S9sOutput::write(headerColorEnd());
         printf("\n");
     }
 
@@ -9498,9 +8524,9 @@ S9sRpcReply::printMetaTypePropertyListLong()
         }
         
         statFormat.printf(stat);
-        printf("%s", propertyColorBegin());
+        S9sOutput::write(propertyColorBegin());
         nameFormat.printf(typeName);
-        printf("%s", propertyColorEnd());
+        S9sOutput::write(propertyColorEnd());
 
         unitFormat.printf(unit);
 
@@ -9545,9 +8571,9 @@ S9sRpcReply::printMetaTypePropertyListBrief()
         if (!options->isStringMatchExtraArguments(typeName))
             continue;
 
-        printf("%s", propertyColorBegin());
+        S9sOutput::write(propertyColorBegin());
         nameFormat.printf(typeName);
-        printf("%s", propertyColorEnd());
+        S9sOutput::write(propertyColorEnd());
         
         currentPosition += nameFormat.realWidth();
         if (currentPosition + nameFormat.realWidth() > terminalWidth ||
@@ -89,6 +89,7 @@ class S9sRpcReply : public S9sVariantMap
         void printJobList();
         void printBackupList();
         void printKeys();
+        void printNdJson(const S9sVariantList &theList);
         
         // Methods handling users.
         void printUserList();
@@ -276,6 +277,7 @@ class S9sRpcReply : public S9sVariantMap
         void printNodesStat();
         void printNodeListBrief();
         void printNodeListLong();
+        void printNodeListNdJson();
 
         
         void printJobListBrief();
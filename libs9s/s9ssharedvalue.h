@@ -0,0 +1,311 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2018  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <utility>
+
+#include "s9sarena.h"
+
+class S9sVariantMap;
+class S9sVariantList;
+
+/**
+ * The interface of the objects that fill the shared values that are created
+ * empty and loaded only when they are first accessed (e.g. the maps and lists
+ * of a lazily parsed JSON document). The loader is reference counted, every
+ * value that is not loaded yet holds a reference.
+ */
+class S9sValueLoader
+{
+    public:
+        virtual ~S9sValueLoader() {};
+
+        virtual void ref() = 0;
+        virtual void unRef() = 0;
+        virtual void lock() = 0;
+        virtual void unlock() = 0;
+
+        virtual void load(unsigned int index, S9sVariantMap &value) = 0;
+        virtual void load(unsigned int index, S9sVariantList &value) = 0;
+};
+
+/**
+ * A reference counted value the copies of a S9sVariant share. Copying the
+ * variant only increments the reference counter, the value is copied when one
+ * of the variants holding it is about to be changed (copy-on-write).
+ *
+ * The reference counter is changed atomically, the copies can be used in
+ * different threads.
+ *
+ * The values created by create() with an arena are allocated in the arena
+ * together with their elements, they hold a reference to the arena.
+ *
+ * A value can be loaded on demand: setLoader() registers the loader that fills
+ * the value the first time it is accessed through value().
+ */
+template <typename T>
+class S9sSharedValue
+{
+    public:
+        S9sSharedValue() :
+            m_referenceCounter(1), m_arena(NULL), m_loader(NULL),
+            m_loaderIndex(0) {};
+
+        S9sSharedValue(const T &value) :
+            m_value(value), m_referenceCounter(1), m_arena(NULL),
+            m_loader(NULL), m_loaderIndex(0) {};
+
+        S9sSharedValue(T &&value) :
+            m_value(std::move(value)), m_referenceCounter(1), m_arena(NULL),
+            m_loader(NULL), m_loaderIndex(0) {};
+
+        void ref();
+        int unRef();
+        bool isShared() const;
+
+        void setLoader(S9sValueLoader *loader, unsigned int index);
+        T &value();
+        const T &value() const;
+
+        static S9sSharedValue<T> *create(S9sArena *arena);
+        static S9sSharedValue<T> *create(S9sArena *arena, const T &value);
+        static void destroy(S9sSharedValue<T> *shared);
+        static T &detach(S9sSharedValue<T> *&shared);
+
+        T               m_value;
+
+    private:
+        S9sSharedValue(S9sArena *arena) :
+            m_value(arena), m_referenceCounter(1), m_arena(arena),
+            m_loader(NULL), m_loaderIndex(0) {};
+
+        void load();
+
+        S9sSharedValue(const S9sSharedValue<T> &orig);
+        S9sSharedValue<T> &operator=(const S9sSharedValue<T> &rhs);
+
+    private:
+        volatile int    m_referenceCounter;
+        S9sArena       *m_arena;
+        S9sValueLoader *m_loader;
+        unsigned int    m_loaderIndex;
+};
+
+template <typename T>
+inline void
+S9sSharedValue<T>::ref()
+{
+    __sync_add_and_fetch(&m_referenceCounter, 1);
+}
+
+/**
+ * \returns The number of references left, the value should be deleted when
+ *   this is 0.
+ */
+template <typename T>
+inline int
+S9sSharedValue<T>::unRef()
+{
+    return __sync_sub_and_fetch(&m_referenceCounter, 1);
+}
+
+/**
+ * \returns true if the value is held by more than one variant.
+ */
+template <typename T>
+inline bool
+S9sSharedValue<T>::isShared() const
+{
+    return m_referenceCounter > 1;
+}
+
+/**
+ * \param loader The loader that fills the value when it is first accessed.
+ * \param index The index the loader uses to find the value.
+ *
+ * The value has to be empty and it must not be shared yet, the loader is
+ * referenced until the value is loaded.
+ */
+template <typename T>
+void
+S9sSharedValue<T>::setLoader(
+        S9sValueLoader *loader,
+        unsigned int    index)
+{
+    loader->ref();
+
+    m_loader      = loader;
+    m_loaderIndex = index;
+}
+
+/**
+ * \returns The value, loaded first if it was not loaded yet.
+ */
+template <typename T>
+inline T &
+S9sSharedValue<T>::value()
+{
+    if (__atomic_load_n(&m_loader, __ATOMIC_ACQUIRE) != NULL)
+        load();
+
+    return m_value;
+}
+
+/**
+ * \returns The value, loaded first if it was not loaded yet.
+ *
+ * Loading does not change the value as the variants holding it see it, so the
+ * value is loaded through the const accessor too.
+ */
+template <typename T>
+inline const T &
+S9sSharedValue<T>::value() const
+{
+    if (__atomic_load_n(&m_loader, __ATOMIC_ACQUIRE) != NULL)
+        const_cast<S9sSharedValue<T> *>(this)->load();
+
+    return m_value;
+}
+
+/**
+ * Private method to load the value. The copies of a variant may be used in
+ * different threads, so the value is loaded while the loader is locked and
+ * the loader is released only by the thread that loaded the value.
+ */
+template <typename T>
+void
+S9sSharedValue<T>::load()
+{
+    S9sValueLoader *loader = __atomic_load_n(&m_loader, __ATOMIC_ACQUIRE);
+    bool            loaded = false;
+
+    if (loader == NULL)
+        return;
+
+    loader->lock();
+
+    if (__atomic_load_n(&m_loader, __ATOMIC_RELAXED) != NULL)
+    {
+        loader->load(m_loaderIndex, m_value);
+        __atomic_store_n(&m_loader, (S9sValueLoader *) NULL, __ATOMIC_RELEASE);
+        loaded = true;
+    }
+
+    loader->unlock();
+
+    if (loaded)
+        loader->unRef();
+}
+
+/**
+ * \param arena The arena where the value and its elements are allocated or
+ *   NULL to allocate them on the heap.
+ * \returns A new, empty value with one reference.
+ */
+template <typename T>
+S9sSharedValue<T> *
+S9sSharedValue<T>::create(
+        S9sArena *arena)
+{
+    void *memory;
+
+    if (arena == NULL)
+        return new S9sSharedValue<T>;
+
+    memory = arena->allocate(
+            sizeof(S9sSharedValue<T>), alignof(S9sSharedValue<T>));
+
+    arena->ref();
+    return new (memory) S9sSharedValue<T>(arena);
+}
+
+/**
+ * \param arena The arena where the value is allocated or NULL to allocate it
+ *   on the heap.
+ * \param value The value that is copied.
+ * \returns A new value with one reference.
+ */
+template <typename T>
+S9sSharedValue<T> *
+S9sSharedValue<T>::create(
+        S9sArena *arena,
+        const T  &value)
+{
+    S9sSharedValue<T> *retval;
+    void              *memory;
+
+    if (arena == NULL)
+        return new S9sSharedValue<T>(value);
+
+    memory = arena->allocate(
+            sizeof(S9sSharedValue<T>), alignof(S9sSharedValue<T>));
+
+    retval = new (memory) S9sSharedValue<T>(value);
+    retval->m_arena = arena;
+    arena->ref();
+
+    return retval;
+}
+
+/**
+ * Destroys the value when the last reference is released.
+ */
+template <typename T>
+void
+S9sSharedValue<T>::destroy(
+        S9sSharedValue<T> *shared)
+{
+    S9sArena *arena = shared->m_arena;
+
+    // The value was never accessed.
+    if (shared->m_loader != NULL)
+        shared->m_loader->unRef();
+
+    if (arena == NULL)
+    {
+        delete shared;
+    } else {
+        shared->~S9sSharedValue<T>();
+        arena->unRef();
+    }
+}
+
+/**
+ * \param shared The value that is about to be changed, replaced by a copy if
+ *   it is shared.
+ * \returns The value that can be changed without changing the other variants.
+ */
+template <typename T>
+T &
+S9sSharedValue<T>::detach(
+        S9sSharedValue<T> *&shared)
+{
+    if (shared->isShared())
+    {
+        S9sSharedValue<T> *copy = new S9sSharedValue<T>(shared->value());
+
+        if (shared->unRef() == 0)
+            destroy(shared);
+
+        shared = copy;
+    }
+
+    return shared->value();
+}
@@ -66,6 +66,28 @@ S9sString::S9sString(
 {
 }
 
+S9sString::S9sString(
+        const S9sString &str) :
+    std::string(str)
+{
+}
+
+/**
+ * Move constructor, takes over the characters of the other string, the other
+ * string is left empty.
+ */
+S9sString::S9sString(
+        std::string &&str) noexcept :
+    std::string(std::move(str))
+{
+}
+
+S9sString::S9sString(
+        S9sString &&str) noexcept :
+    std::string(std::move(str))
+{
+}
+
 S9sString &
 S9sString::operator= (
         const S9sString &rhs)
@@ -75,6 +97,24 @@ S9sString::operator= (
     return *this;
 }
 
+S9sString &
+S9sString::operator= (
+        S9sString &&rhs) noexcept
+{
+    std::string::operator=(std::move(rhs));
+
+    return *this;
+}
+
+S9sString &
+S9sString::operator= (
+        std::string &&rhs) noexcept
+{
+    std::string::operator=(std::move(rhs));
+
+    return *this;
+}
+
 /**
  * This method is protected against segfaults when it received a NULL pointer
  * as argument. That's a very annoying issue with std::string, especially
@@ -234,14 +274,25 @@ S9sString::appendWord(
     return *this;
 }
 
+/**
+ * \returns The number of characters the string takes on the terminal. The only
+ *   multibyte character counted as one is the ellipsis the truncated values
+ *   end with.
+ */
 int
 S9sString::terminalLength() const
 {
-    S9sString copy = *this;
+    static const char ellipsis[] = "…";
+    const size_t      ellipsisLength = sizeof(ellipsis) - 1;
+    int               retval = length();
 
-    copy.replace("…", ".");
+    for (size_t pos = find(ellipsis); pos != std::string::npos;
+            pos = find(ellipsis, pos + ellipsisLength))
+    {
+        retval -= ellipsisLength - 1;
+    }
 
-    return copy.length();
+    return retval;
 }
 
 /**
@@ -834,9 +885,286 @@ S9sString::decimalSeparator()
     return retval;
 }
 
+/**
+ * \param input The string with the markup the controller uses in the messages.
+ * \returns The string with the markup converted to terminal escape sequences.
+ */
 S9sString 
 S9sString::html2ansi(
         const S9sString &input)
+{
+    S9sString retval;
+
+    if (!convertHtml(input, true, retval))
+        retval = html2ansiByReplace(input);
+
+    return retval;
+}
+
+/**
+ * \param input The string with the markup the controller uses in the messages.
+ * \returns The string with the markup removed.
+ */
+S9sString 
+S9sString::html2text(
+        const S9sString &input)
+{
+    S9sString retval;
+
+    if (!convertHtml(input, false, retval))
+        retval = html2textByReplace(input);
+
+    return retval;
+}
+
+/*
+ * The tags the controller uses in the messages with the escape sequences they
+ * are converted to. The tags with other colors are matched by matchColorTag().
+ */
+static const struct
+{
+    const char *tag;
+    const char *ansi;
+    const char *text;
+} htmlTags[] = 
+{
+    { "<em style='color: #c66211;'>",     XTERM_COLOR_3,      "" },
+    { "<em style='color: #75599b;'>",     XTERM_COLOR_3,      "" },
+    { "<strong style='color: #110679;'>", XTERM_COLOR_16,     "" },
+    { "<strong style='color: #59a449;'>", XTERM_COLOR_9,      "" },
+    // This is the file name color for normal files.
+    { "<em style='color: #007e18;'>",     XTERM_COLOR_17,     "" },
+    { "<em style='color: #7415f6;'>",     XTERM_COLOR_5,      "" },
+    { "<em style='color: #1abc9c;'>",     XTERM_COLOR_6,      "" },
+    { "<em style='color: #d35400;'>",     XTERM_COLOR_7,      "" },
+    { "<em style='color: #c0392b;'>",     XTERM_COLOR_8,      "" },
+    { "<em style='color: #0b33b5;'>",     XTERM_COLOR_BLUE,   "" },
+    { "<em style='color: #34495e;'>",     XTERM_COLOR_CYAN,   "" },
+    { "<em style='color: #f3990b;'>",     XTERM_COLOR_7,      "" },
+    { "<em style='color: #c49854;'>",     XTERM_COLOR_7,      "" },
+    { "<em style='color: #877d0f;'>",     XTERM_COLOR_7,      "" },
+    { "<strong style='color: red;'>",     XTERM_COLOR_RED,    "" },
+    { "</em>",                            TERM_NORMAL,        "" },
+    { "</strong>",                        TERM_NORMAL,        "" },
+    { "<BR/>",                            "\n",               "\n" },
+    { "<br/>",                            "\n",               "\n" },
+    { NULL,                               NULL,               NULL }
+};
+
+enum HtmlMatch
+{
+    HtmlNoMatch,
+    HtmlMatched,
+    HtmlUndecided
+};
+
+/*
+ * Checks one character of a tag. A '<' (the start of an other tag that may be
+ * replaced), a '\0' or a non-ASCII character leaves the match undecided.
+ */
+static inline HtmlMatch
+checkTagChar(
+        const S9sString &input,
+        size_t           index,
+        const char       expected)
+{
+    unsigned char c;
+
+    if (index >= input.length())
+        return HtmlNoMatch;
+
+    c = input[index];
+    if (c == '<' || c == '\0' || c >= 0x80)
+        return HtmlUndecided;
+
+    if (expected != '\0' && tolower(c) != expected)
+        return HtmlNoMatch;
+
+    return HtmlMatched;
+}
+
+/*
+ * Matches a tag at the given position the way the 
+ * "<em style=.color:[^;]+;.>" and "<strong style=.color:[^;]+;.>" regular
+ * expressions matched it, ignoring the case. The '[^;]+' ends at the first ';'
+ * so the match is decided character by character.
+ */
+static HtmlMatch
+matchColorTag(
+        const S9sString &input,
+        const size_t     position,
+        const char      *prefix,
+        size_t          &length)
+{
+    size_t     index = position + 1;
+    HtmlMatch  match;
+    bool       hasColor = false;
+
+    for (const char *c = prefix + 1; *c != '\0'; ++c, ++index)
+    {
+        if ((match = checkTagChar(input, index, *c)) != HtmlMatched)
+            return match;
+    }
+
+    // The '.' before "color:".
+    if ((match = checkTagChar(input, index++, '\0')) != HtmlMatched)
+        return match;
+
+    for (const char *c = "color:"; *c != '\0'; ++c, ++index)
+    {
+        if ((match = checkTagChar(input, index, *c)) != HtmlMatched)
+            return match;
+    }
+
+    // The color, it ends at the first ';'.
+    for (;; ++index)
+    {
+        if ((match = checkTagChar(input, index, '\0')) != HtmlMatched)
+            return match;
+
+        if (input[index] == ';')
+            break;
+
+        hasColor = true;
+    }
+
+    if (!hasColor)
+        return HtmlNoMatch;
+
+    // The '.' after the ';' and the closing '>'.
+    if ((match = checkTagChar(input, index + 1, '\0')) != HtmlMatched)
+        return match;
+
+    if ((match = checkTagChar(input, index + 2, '>')) != HtmlMatched)
+        return match;
+
+    length = index + 3 - position;
+    return HtmlMatched;
+}
+
+/**
+ * Private function that converts the markup in one pass, every tag is replaced
+ * where it starts. 
+ *
+ * \returns false if the string has a '<' that is not a tag but might become
+ *   part of one when the tags around it are replaced. The conversion by
+ *   replacing the tags until the string does not change has to be used for
+ *   these (rare) strings to get the same result.
+ */
+bool
+S9sString::convertHtml(
+        const S9sString &input,
+        const bool       toAnsi,
+        S9sString       &output)
+{
+    const char *data   = input.c_str();
+    size_t      length = input.length();
+    size_t      position = 0;
+
+    output.clear();
+
+    // The regular expressions did not see beyond a '\0'.
+    if (memchr(data, '\0', length) != NULL)
+        return false;
+
+    output.reserve(length);
+
+    while (position < length)
+    {
+        const char *next;
+        size_t      tagLength = 0;
+        bool        found     = false;
+
+        next = (const char *) memchr(data + position, '<', length - position);
+        if (next == NULL)
+        {
+            output.append(data + position, length - position);
+            break;
+        }
+
+        output.append(data + position, next - data - position);
+        position = next - data;
+
+        for (uint idx = 0u; htmlTags[idx].tag != NULL && !found; ++idx)
+        {
+            if (next[1] != htmlTags[idx].tag[1])
+                continue;
+
+            tagLength = strlen(htmlTags[idx].tag);
+            if (strncmp(next, htmlTags[idx].tag, tagLength) != 0)
+                continue;
+
+            output += toAnsi ? htmlTags[idx].ansi : htmlTags[idx].text;
+            position += tagLength;
+            found = true;
+        }
+
+        if (found)
+            continue;
+
+        for (uint idx = 0u; idx < 2u && !found; ++idx)
+        {
+            switch (matchColorTag(
+                        input, position, 
+                        idx == 0u ? "<em style=" : "<strong style=",
+                        tagLength))
+            {
+                case HtmlMatched:
+                    if (toAnsi)
+                        output += idx == 0u ? 
+                            XTERM_COLOR_ORANGE : XTERM_COLOR_8;
+
+                    position += tagLength;
+                    found = true;
+                    break;
+
+                case HtmlUndecided:
+                    return false;
+
+                case HtmlNoMatch:
+                    break;
+            }
+        }
+
+        if (found)
+            continue;
+
+        // A '<' that is not a tag. If the next '<' is where a tag could 
+        // continue the tag might be completed when the next one is removed.
+        next = (const char *) memchr(
+                data + position + 1, '<', length - position - 1);
+
+        if (next != NULL)
+        {
+            size_t distance = next - data - position;
+
+            for (uint idx = 0u; htmlTags[idx].tag != NULL; ++idx)
+            {
+                if (distance < strlen(htmlTags[idx].tag) &&
+                        strncmp(data + position, htmlTags[idx].tag, distance)
+                        == 0)
+                {
+                    return false;
+                }
+            }
+        }
+
+        output += '<';
+        ++position;
+    }
+
+    return true;
+}
+
+/**
+ * Private function that converts the tags by replacing them one by one until
+ * the string does not change any more. This is used for the strings the single
+ * pass conversion can not convert the same way (e.g. tags broken by other
+ * tags).
+ */
+S9sString 
+S9sString::html2ansiByReplace(
+        const S9sString &input)
 {
     S9sString s           = input;
     S9sString origString;
@@ -882,8 +1210,12 @@ do_again:
     return s;
 }
 
+/**
+ * Private function that removes the tags the way html2ansiByReplace() replaces
+ * them.
+ */
 S9sString 
-S9sString::html2text(
+S9sString::html2textByReplace(
         const S9sString &input)
 {
     S9sString s           = input;
@@ -47,8 +47,13 @@ class S9sString : public std::string
         S9sString();
         S9sString(const char *str);
         S9sString(const std::string &str);
+        S9sString(const S9sString &str);
+        S9sString(std::string &&str) noexcept;
+        S9sString(S9sString &&str) noexcept;
 
         S9sString &operator=(const S9sString &rhs);
+        S9sString &operator=(S9sString &&rhs) noexcept;
+        S9sString &operator=(std::string &&rhs) noexcept;
         S9sString &operator=(const std::string &rhs);
         S9sString &operator=(const char *rhs);
         S9sString  operator*(const int rhs) const;
@@ -145,6 +150,17 @@ class S9sString : public std::string
 
         static const S9sString space;
         static const S9sString dash;
+
+    private:
+        static bool convertHtml(
+                const S9sString &input,
+                const bool       toAnsi,
+                S9sString       &output);
+
+        static S9sString html2ansiByReplace(const S9sString &input);
+        static S9sString html2textByReplace(const S9sString &input);
+
+    friend class UtS9sString;
 };
 
 typedef S9sString S9sFilePath;
@@ -0,0 +1,315 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2018  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "s9stable.h"
+
+#include "S9sOutput"
+
+//#define DEBUG
+//#define WARNING
+#include "s9sdebug.h"
+
+S9sTable::S9sTable() :
+    m_nextColumn(0u),
+    m_headerVisible(true),
+    m_headerColorStart(NULL),
+    m_headerColorEnd(NULL),
+    m_maxWidth(0)
+{
+}
+
+/**
+ * \param title The title of the column printed in the header.
+ * \param alignment How the cells that are not numbers are aligned.
+ *
+ * The columns have to be added before the cells.
+ */
+void
+S9sTable::addColumn(
+        const S9sString      &title,
+        S9sFormat::Alignment  alignment)
+{
+    Column column;
+
+    column.title     = title;
+    column.alignment = alignment;
+    column.width     = 0;
+
+    m_columns << column;
+}
+
+/**
+ * \param visible If the header should be printed. The titles of the columns
+ *   make the columns wider only if the header is printed.
+ */
+void
+S9sTable::setHeaderVisible(
+        bool visible)
+{
+    m_headerVisible = visible;
+}
+
+void
+S9sTable::setHeaderColor(
+        const char *colorStart,
+        const char *colorEnd)
+{
+    m_headerColorStart = colorStart;
+    m_headerColorEnd   = colorEnd;
+}
+
+/**
+ * \param maxWidth The width of the screen, the cells of the last column are
+ *   truncated so that the rows are not wider than this. 0 means no limit.
+ */
+void
+S9sTable::setMaxWidth(
+        int maxWidth)
+{
+    m_maxWidth = maxWidth;
+}
+
+/**
+ * \param value The value of the next cell.
+ * \param colorStart The escape sequence printed before the cell or NULL.
+ * \param colorEnd The escape sequence printed after the cell or NULL.
+ *
+ * Adds a cell to the current row, the row is finished when a cell was added
+ * to every column.
+ */
+void
+S9sTable::addCell(
+        const S9sString &value,
+        const char      *colorStart,
+        const char      *colorEnd)
+{
+    addCell(value, colorStart, colorEnd, false, 
+            value.length(), value.terminalLength());
+}
+
+void
+S9sTable::addCell(
+        const char *value)
+{
+    addCell(S9sString(value));
+}
+
+void
+S9sTable::addCell(
+        const int value)
+{
+    S9sString tmp;
+
+    tmp.sprintf("%d", value);
+    addCell(tmp, NULL, NULL, true, tmp.length(), tmp.length());
+}
+
+void
+S9sTable::addCell(
+        const ulonglong value)
+{
+    S9sString tmp;
+
+    tmp.sprintf("%llu", value);
+    addCell(tmp, NULL, NULL, true, tmp.length(), tmp.length());
+}
+
+/**
+ * \param value The value of the next cell with the escape sequences of its
+ *   colors in it.
+ * \param length The number of characters the value shows on the screen.
+ *
+ * Adds a cell that has more than one color. The cell should not be in the last
+ * column, the last column is truncated by the bytes of the values.
+ */
+void
+S9sTable::addColoredCell(
+        const S9sString &value,
+        int              length)
+{
+    addCell(value, NULL, NULL, false, length, length);
+}
+
+/**
+ * Private method to add a cell, the length is the number of bytes the cell is
+ * padded for, the width is the number of characters it shows.
+ */
+void
+S9sTable::addCell(
+        const S9sString &value,
+        const char      *colorStart,
+        const char      *colorEnd,
+        bool             isNumber,
+        int              length,
+        int              width)
+{
+    Column &column = m_columns[m_nextColumn];
+
+    if (width > column.width)
+        column.width = width;
+
+    column.values      << value;
+    column.colorStarts << colorStart;
+    column.colorEnds   << colorEnd;
+    column.isNumber.push_back(isNumber);
+    column.lengths.push_back(length);
+
+    m_nextColumn = (m_nextColumn + 1) % m_columns.size();
+}
+
+uint
+S9sTable::nColumns() const
+{
+    return m_columns.size();
+}
+
+/**
+ * \returns The number of the rows added, not counting the header.
+ */
+uint
+S9sTable::nRows() const
+{
+    return m_columns.empty() ? 0u : m_columns.back().values.size();
+}
+
+/**
+ * Prints the header and the rows that are complete to the standard output.
+ */
+void
+S9sTable::print() const
+{
+    S9sVector<int> widths;
+    S9sString      line;
+    S9sString      lastValue;
+    int            lastColumnWidth = -1;
+    uint           last;
+
+    if (m_columns.empty())
+        return;
+
+    last = m_columns.size() - 1;
+
+    for (uint column = 0u; column < m_columns.size(); ++column)
+    {
+        int width = m_columns[column].width;
+
+        if (m_headerVisible && 
+                m_columns[column].title.terminalLength() > width)
+        {
+            width = m_columns[column].title.terminalLength();
+        }
+
+        widths << width;
+    }
+
+    if (m_maxWidth > 0)
+    {
+        int used = 0;
+
+        for (uint column = 0u; column < last; ++column)
+            used += widths[column] + 1;
+
+        if (used < m_maxWidth)
+            lastColumnWidth = m_maxWidth - used;
+    }
+
+    if (m_headerVisible)
+    {
+        if (m_headerColorStart != NULL)
+            line += m_headerColorStart;
+
+        for (uint column = 0u; column < last; ++column)
+        {
+            appendCell(line, m_columns[column].title, 
+                    m_columns[column].title.length(), widths[column], false);
+        }
+
+        line += m_columns[last].title;
+
+        if (m_headerColorEnd != NULL)
+            line += m_headerColorEnd;
+
+        line += "\n";
+        S9sOutput::write(line);
+    }
+
+    for (uint row = 0u; row < nRows(); ++row)
+    {
+        line.clear();
+
+        for (uint column = 0u; column <= last; ++column)
+        {
+            const Column    &theColumn = m_columns[column];
+            const S9sString &value     = theColumn.values[row];
+            
+            if (theColumn.colorStarts[row] != NULL)
+                line += theColumn.colorStarts[row];
+
+            if (column < last)
+            {
+                appendCell(line, value, theColumn.lengths[row], widths[column],
+                        theColumn.isNumber[row] || 
+                        theColumn.alignment == S9sFormat::AlignRight);
+            } else if (lastColumnWidth > 0 && 
+                    lastColumnWidth < (int) value.length())
+            {
+                lastValue = value;
+                lastValue.resize(lastColumnWidth - 1);
+                lastValue += "…";
+                line += lastValue;
+            } else {
+                line += value;
+            }
+            
+            if (theColumn.colorEnds[row] != NULL)
+                line += theColumn.colorEnds[row];
+        }
+
+        line += "\n";
+        S9sOutput::write(line);
+    }
+}
+
+/**
+ * Private method to add one cell padded to the given width and followed by
+ * the field separator to the line.
+ */
+void
+S9sTable::appendCell(
+        S9sString       &line,
+        const S9sString &value,
+        int              length,
+        int              width,
+        bool             alignRight) const
+{
+    int padding = width - length;
+
+    if (padding < 0)
+        padding = 0;
+
+    if (alignRight)
+        line.append(padding, ' ');
+
+    line += value;
+
+    if (!alignRight)
+        line.append(padding, ' ');
+
+    line += " ";
+}
@@ -0,0 +1,100 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2018  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "S9sString"
+#include "S9sVector"
+#include "S9sFormat"
+
+/**
+ * A table the list printers fill row by row and print when all the rows are
+ * added. The cells are stored by columns and the width of every column is
+ * computed while the cells are added, so the rows are processed only once.
+ *
+ * The table is printed the way the S9sFormat based printers printed: the
+ * numbers are aligned to the right, the other cells as the column is aligned
+ * and the titles to the left, every cell is followed by a space as field
+ * separator. The last column is not padded, it is truncated if the rows would
+ * be wider than the screen.
+ */
+class S9sTable
+{
+    public:
+        S9sTable();
+
+        void addColumn(
+                const S9sString      &title,
+                S9sFormat::Alignment  alignment = S9sFormat::AlignLeft);
+
+        void setHeaderVisible(bool visible);
+        void setHeaderColor(const char *colorStart, const char *colorEnd);
+        void setMaxWidth(int maxWidth);
+
+        void addCell(
+                const S9sString &value,
+                const char      *colorStart = NULL,
+                const char      *colorEnd   = NULL);
+
+        void addCell(const char *value);
+        void addCell(const int value);
+        void addCell(const ulonglong value);
+        void addColoredCell(const S9sString &value, int length);
+
+        uint nColumns() const;
+        uint nRows() const;
+
+        void print() const;
+
+    private:
+        void addCell(
+                const S9sString &value,
+                const char      *colorStart,
+                const char      *colorEnd,
+                bool             isNumber,
+                int              length,
+                int              width);
+
+        void appendCell(
+                S9sString       &line,
+                const S9sString &value,
+                int              length,
+                int              width,
+                bool             alignRight) const;
+
+    private:
+        struct Column
+        {
+            S9sString                 title;
+            S9sFormat::Alignment      alignment;
+            int                       width;
+            S9sVector<S9sString>      values;
+            S9sVector<const char *>   colorStarts;
+            S9sVector<const char *>   colorEnds;
+            S9sVector<bool>           isNumber;
+            S9sVector<int>            lengths;
+        };
+
+        S9sVector<Column>  m_columns;
+        uint               m_nextColumn;
+        bool               m_headerVisible;
+        const char        *m_headerColorStart;
+        const char        *m_headerColorEnd;
+        int                m_maxWidth;
+};
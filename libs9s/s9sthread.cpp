@@ -9,6 +9,15 @@
 //#define WARNING
 #include "s9sdebug.h"
 
+S9sThread::S9sThread() :
+    m_state(Created),
+    m_retval(0)
+{
+}
+
+S9sThread::~S9sThread()
+{
+}
 
 /**
  * \returns true if the thread was successfully started, false on an error
@@ -19,12 +28,36 @@ bool
 S9sThread::start()
 {
     S9S_DEBUG("");
+    m_state = Starting;
     if (pthread_create(&m_thread, NULL, S9sThread::threadEntryPoint, this))
     {
         S9S_WARNING("pthread_create() failed: %m");
+        m_state = Created;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * \returns true if the thread was joined, false if it was never started or
+ *   the join failed.
+ *
+ * Waits until the thread started by start() finishes.
+ */
+bool
+S9sThread::wait()
+{
+    if (m_state == Created)
+        return false;
+
+    if (pthread_join(m_thread, NULL))
+    {
+        S9S_WARNING("pthread_join() failed: %m");
         return false;
     }
 
+    m_state = Stopped;
     return true;
 }
 
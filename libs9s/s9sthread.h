@@ -8,7 +8,11 @@
 class S9sThread
 {
     public:
+        S9sThread();
+        virtual ~S9sThread();
+
         bool start();
+        bool wait();
 
     protected:
         enum State 
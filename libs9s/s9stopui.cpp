@@ -104,6 +104,7 @@ S9sTopUi::processButton(
             if (m_communicating)
             {
                 m_communicating = false;
+                m_client.abortBatch();
             } else {
                 m_reloadRequested = true;
             }
@@ -418,6 +419,13 @@ S9sTopUi::executeTop()
     }
 }
 
+/**
+ * Sends the requests of one refresh and stores the replies. This runs on the
+ * main thread, the screen is refreshed and the keys are read by the display
+ * thread meanwhile. The abort button stops the batch through
+ * S9sRpcClient::abortBatch(), so it does not have to wait for the slowest
+ * request.
+ */
 bool
 S9sTopUi::executeTopOnce()
 {
@@ -432,71 +440,58 @@ S9sTopUi::executeTopOnce()
     S9sRpcReply            cpuStatsReply;
     S9sRpcReply            memoryStatsReply;
     S9sRpcReply            processReply;
+    S9sVector<S9sRpcReply> replies;
     S9sVector<S9sProcess>  processes;
     int                    clusterId;
     S9sString              clusterName;
 
+    bool                   needClusters;
     bool                   success = true;
 
     m_communicating   = true;
     m_reloadRequested = false;
 
     /*
-     * The cluster information.
+     * The cluster information is refreshed only every 30 seconds, the
+     * statistics and the processes are refreshed every time. The requests
+     * are sent in one batch, so we wait only for the slowest one.
      */
     clustersReplyReceived = m_clustersReplyReceived;
     clusterId   = options->clusterId();
     clusterName = options->clusterName();
+    needClusters = time(NULL) - clustersReplyReceived > 30;
 
-    if (time(NULL) - clustersReplyReceived > 30)
-    {
-        success = m_client.getCluster(clusterName, clusterId);
+    m_client.beginBatch();
 
-        // If the user aborted download.
-        if (!m_communicating)
-            return true;
+    if (needClusters)
+        m_client.getCluster(clusterName, clusterId);
 
-        clustersReply = m_client.reply();
-        if (!success)
-            return success;
-
-        clustersReplyReceived = time(NULL);
-    } else {
-        clustersReply = m_clustersReply;
-    }
-
-    /*
-     * The CPU statistics.
-     */
     m_client.getCpuStats(clusterId);
-    
-    // If the user aborted download.
-    if (!m_communicating)
-        return true;
-
-    cpuStatsReply = m_client.reply();
-    
-    /*
-     * The memory statistics.
-     */
     m_client.getMemoryStats(clusterId);
+    m_client.getRunningProcesses();
 
-    // If the user aborted download.
-    if (!m_communicating)
-        return true;
+    success = m_client.executeBatch(replies);
 
-    memoryStatsReply = m_client.reply();
-    
-    /*
-     * Getting the list of the running processes.
-     */
-    m_client.getRunningProcesses();
-    
     // If the user aborted download.
     if (!m_communicating)
         return true;
 
-    processReply = m_client.reply();
+    if (needClusters)
+    {
+        // Without the cluster information there is nothing to show.
+        if (!success)
+            return success;
+
+        clustersReply         = replies.front();
+        clustersReplyReceived = time(NULL);
+        replies.erase(replies.begin());
+    } else {
+        clustersReply = m_clustersReply;
+    }
+
+    cpuStatsReply    = replies[0];
+    memoryStatsReply = replies[1];
+    processReply     = replies[2];
    
     hostList = processReply["data"].toVariantList();
     for (uint idx = 0u; idx < hostList.size(); ++idx)
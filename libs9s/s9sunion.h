@@ -29,6 +29,8 @@ class S9sNode;
 class S9sAccount;
 class S9sContainer;
 
+template <typename T> class S9sSharedValue;
+
 /** 
  * An enum to identify the basic types for S9s. Well, basic types are types that
  * we consider basic, some of them are quite complex.
@@ -48,16 +50,38 @@ enum S9sBasicType
     List
 };
 
+/**
+ * The strings with at most this many bytes are stored in the variant itself.
+ */
+#define S9S_SHORT_STRING_SIZE 23
+
+/**
+ * The length of the string value that marks a string that is longer than
+ * S9S_SHORT_STRING_SIZE, stored in a S9sSharedValue.
+ */
+#define S9S_SHARED_STRING     0xff
+
+/**
+ * The string value of a variant. A short string is stored in the data array, a
+ * longer string is stored in a S9sSharedValue and the data array holds the
+ * pointer to it.
+ */
+struct S9sStringValue
+{
+    char              data[S9S_SHORT_STRING_SIZE];
+    unsigned char     length;
+};
+
 union S9sUnion 
 {
     int               iVal;
     double            dVal;
     bool              bVal;
     ulonglong         ullVal;
-    S9sVariantMap    *mapValue;
-    S9sVariantList   *listValue;
+    S9sSharedValue<S9sVariantMap>  *mapValue;
+    S9sSharedValue<S9sVariantList> *listValue;
     S9sVariantArray  *arrayValue;
-    S9sString        *stringValue;
+    S9sStringValue    stringValue;
     S9sNode          *nodeValue;
     S9sContainer     *containerValue;
     S9sAccount       *accountValue;
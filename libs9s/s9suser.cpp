@@ -429,167 +429,99 @@ S9sString
 S9sUser::toString(
         const bool       syntaxHighlight,
         const S9sString &formatString) const
+{
+    return toString(syntaxHighlight, compileFormat(formatString));
+}
+
+/**
+ * \param formatString The format string with markup.
+ * \returns The format string compiled for the toString() method, the
+ *   program can be used to print any number of users.
+ */
+S9sFormatProgram
+S9sUser::compileFormat(
+        const S9sString &formatString)
+{
+    return S9sFormatProgram(formatString, '\0', true);
+}
+
+/**
+ * \param syntaxHighlight Controls if the string will have colors or not.
+ * \param program The compiled format string.
+ * \returns The string representation according to the format string.
+ *
+ * Converts the user to a string executing the compiled format string, the
+ * format string is not parsed again for every user.
+ */
+S9sString
+S9sUser::toString(
+        const bool              syntaxHighlight,
+        const S9sFormatProgram &program) const
 {
     S9sString    retval;
-    S9sString    tmp;
-    char         c;
-    S9sString    partFormat;
-    bool         percent      = false;
-    bool         escaped      = false;
 
-    for (uint n = 0; n < formatString.size(); ++n)
+    for (uint n = 0; n < program.size(); ++n)
     {
-        c = formatString[n];
-       
-        if (c == '%' && !percent)
-        {
-            percent    = true;
-            partFormat = "%";
-            continue;
-        } else if (c == '\\' && !escaped)
+        const S9sFormatOp &op = program.at(n);
+
+        if (op.isLiteral())
         {
-            escaped = true;
+            retval += op.literal();
             continue;
         }
 
-        if (escaped)
+        switch (op.directive())
         {
-            switch (c)
-            {
-                case '\"':
-                    retval += '\"';
-                    break;
-
-                case '\\':
-                    retval += '\\';
-                    break;
-       
-                case 'a':
-                    retval += '\a';
-                    break;
-
-                case 'b':
-                    retval += '\b';
-                    break;
-
-                case 'e':
-                    retval += '\027';
-                    break;
-
-                case 'n':
-                    retval += '\n';
-                    break;
-
-                case 'r':
-                    retval += '\r';
-                    break;
-
-                case 't':
-                    retval += '\t';
-                    break;
-            }
-        } else if (percent)
-        {
-            switch (c)
-            {
-                case 'F':
-                    // The full name of the user.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(fullName()));
-                    retval += tmp;
-                    break;
-                
-                case 'f':
-                    // The first name of the user.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(firstName()));
-                    retval += tmp;
-                    break;
-                
-                case 'G':
-                    // The group names of the user.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(groupNames()));
-                    retval += tmp;
-                    break;
-
-                case 'I':
-                    // The user ID.
-                    partFormat += 'd';
-                    tmp.sprintf(STR(partFormat), userId());
-                    retval += tmp;
-                    break;
-                
-                case 'j':
-                    // The job title of the user.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(jobTitle()));
-                    retval += tmp;
-                    break;
-                
-                case 'l':
-                    // The last name of the user.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(lastName()));
-                    retval += tmp;
-                    break;
-
-                case 'M':
-                    // The email address. 
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(emailAddress()));
-                    retval += tmp;
-                    break;
-                
-                case 'm':
-                    // The middle name of the user.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(middleName()));
-                    retval += tmp;
-                    break;
-                
-                case 'N':
-                    // The username of the user.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(userName()));
-                    retval += tmp;
-                    break;
-                
-                case 't':
-                    // The title of the user.
-                    partFormat += 's';
-                    tmp.sprintf(STR(partFormat), STR(title()));
-                    retval += tmp;
-                    break;
-
-                
-                case '%':
-                    retval += '%';
-                    break;
-
-                case '0':
-                case '1':
-                case '2':
-                case '3':
-                case '4':
-                case '5':
-                case '6':
-                case '7':
-                case '8':
-                case '9':
-                case '-':
-                case '+':
-                case '.':
-                case '\'':
-                    partFormat += c;
-                    continue;
-            }
-        } else {
-            retval += c;
+            case 'F':
+                // The full name of the user.
+                op.appendString(retval, fullName());
+                break;
+            
+            case 'f':
+                // The first name of the user.
+                op.appendString(retval, firstName());
+                break;
+            
+            case 'G':
+                // The group names of the user.
+                op.appendString(retval, groupNames());
+                break;
+
+            case 'I':
+                // The user ID.
+                op.appendInt(retval, userId());
+                break;
+            
+            case 'j':
+                // The job title of the user.
+                op.appendString(retval, jobTitle());
+                break;
+            
+            case 'l':
+                // The last name of the user.
+                op.appendString(retval, lastName());
+                break;
+
+            case 'M':
+                // The email address. 
+                op.appendString(retval, emailAddress());
+                break;
+            
+            case 'm':
+                // The middle name of the user.
+                op.appendString(retval, middleName());
+                break;
+            
+            case 'N':
+                // The username of the user.
+                op.appendString(retval, userName());
+                break;
+            
+            case 't':
+                // The title of the user.
+                op.appendString(retval, title());
+                break;
         }
-
-        percent      = false;
-        escaped      = false;
     }
 
     return retval;
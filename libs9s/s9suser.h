@@ -20,6 +20,7 @@
 #pragma once
 
 #include "S9sObject"
+#include "S9sFormatProgram"
 
 /**
  * A class that represents a user on the controller. 
@@ -68,4 +69,10 @@ class S9sUser : public S9sObject
         S9sString toString(
                 const bool       syntaxHighlight,
                 const S9sString &formatString) const;
+
+        S9sString toString(
+                const bool              syntaxHighlight,
+                const S9sFormatProgram &program) const;
+
+        static S9sFormatProgram compileFormat(const S9sString &formatString);
 };
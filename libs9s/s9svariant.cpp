@@ -69,16 +69,21 @@ S9sVariant::S9sVariant(
             m_union = orig.m_union;
             break;
         
+        /* The values are shared, they will be copied when changed. */
         case String:
-            m_union.stringValue = new S9sString(*orig.m_union.stringValue);
+            m_union = orig.m_union;
+            if (isSharedString())
+                sharedString()->ref();
             break;
 
         case List:
-            m_union.listValue = new S9sVariantList(*orig.m_union.listValue);
+            m_union = orig.m_union;
+            m_union.listValue->ref();
             break;
 
         case Map:
-            m_union.mapValue = new S9sVariantMap(*orig.m_union.mapValue);
+            m_union = orig.m_union;
+            m_union.mapValue->ref();
             break;
 
         case Node:
@@ -120,14 +125,38 @@ S9sVariant::S9sVariant(
         const S9sVariantMap &mapValue) :
     m_type(Map)
 {
-    m_union.mapValue = new S9sVariantMap(mapValue);
+    m_union.mapValue = new S9sSharedValue<S9sVariantMap>(mapValue);
 }
 
 S9sVariant::S9sVariant(
         const S9sVariantList &listValue) :
     m_type(List)
 {
-    m_union.listValue = new S9sVariantList(listValue);
+    m_union.listValue = new S9sSharedValue<S9sVariantList>(listValue);
+}
+
+/**
+ * Takes over the elements of the map without copying them, the map is left
+ * empty.
+ */
+S9sVariant::S9sVariant(
+        S9sVariantMap &&mapValue) :
+    m_type(Map)
+{
+    m_union.mapValue = new S9sSharedValue<S9sVariantMap>(
+            std::move(mapValue));
+}
+
+/**
+ * Takes over the elements of the list without copying them, the list is left
+ * empty.
+ */
+S9sVariant::S9sVariant(
+        S9sVariantList &&listValue) :
+    m_type(List)
+{
+    m_union.listValue = new S9sSharedValue<S9sVariantList>(
+            std::move(listValue));
 }
 
 S9sVariant::~S9sVariant()
@@ -146,47 +175,38 @@ S9sVariant::operator=(
     if (this == &rhs)
         return *this;
 
-    clear();
+    /*
+     * The copy is made first, the right hand side may be an element of this
+     * variant. Copying the strings, lists and maps only adds a reference.
+     */
+    S9sVariant copy(rhs);
 
-    m_type         = rhs.m_type;
-    
-    switch (m_type)
-    {
-        case Invalid:
-        case Int:
-        case Ulonglong:
-        case Double:
-        case Bool:
-            /* We don't need to copy here. */
-            m_union = rhs.m_union;
-            break;
-        
-        case String:
-            m_union.stringValue = new S9sString(*rhs.m_union.stringValue);
-            break;
+    return operator=(std::move(copy));
+}
 
-        case List:
-            m_union.listValue = new S9sVariantList(*rhs.m_union.listValue);
-            break;
+/**
+ * Move assignment, takes over the value of the right hand side variant without
+ * copying it, the right hand side is left invalid. The right hand side may be
+ * an element of this variant.
+ */
+S9sVariant &
+S9sVariant::operator=(
+        S9sVariant &&rhs) noexcept
+{
+    S9sBasicType type;
+    S9sUnion     value;
 
-        case Map:
-            m_union.mapValue = new S9sVariantMap(*rhs.m_union.mapValue);
-            break;
+    if (this == &rhs)
+        return *this;
 
-        case Node:
-            m_union.nodeValue = new S9sNode(*rhs.m_union.nodeValue);
-            break;
-        
-        case Container:
-            m_union.containerValue = new S9sContainer(
-                    *rhs.m_union.containerValue);
-            break;
+    type       = rhs.m_type;
+    value      = rhs.m_union;
+    rhs.m_type = Invalid;
+
+    clear();
+    m_type  = type;
+    m_union = value;
 
-        case Account:
-            m_union.accountValue = new S9sAccount(*rhs.m_union.accountValue);
-            break;
-    }
-    
     return *this;
 }
 
@@ -429,7 +449,8 @@ S9sVariant::operator[] (
         return this->operator[](index);
     } else if (m_type == List)
     {
-        return m_union.listValue->S9sVariantList::operator[](index);
+        return S9sSharedValue<S9sVariantList>::detach(
+                m_union.listValue).S9sVariantList::operator[](index);
     }
     
     S9S_WARNING("");
@@ -448,8 +469,8 @@ S9sVariant::operator[] (
         return this->operator[](index);
     } else if (m_type == Map)
     {
-        return m_union.mapValue->S9sMap<
-                S9sString, S9sVariant>::operator[](index);
+        return S9sSharedValue<S9sVariantMap>::detach(
+                m_union.mapValue).S9sVariantMapBase::operator[](index);
     } 
    
     S9S_WARNING("Unhandled type %s", STR(typeName()));
@@ -604,7 +625,7 @@ S9sVariant::toVariantMap() const
             return sm_emptyMap;
 
         case Map:
-            return *m_union.mapValue;
+            return m_union.mapValue->value();
 
         case Container:
             return m_union.containerValue->toVariantMap();
@@ -640,7 +661,7 @@ S9sVariant::toVariantList() const
             return sm_emptyList;
 
         case List:
-            return *m_union.listValue;
+            return m_union.listValue->value();
     }
             
     return sm_emptyList;
@@ -654,7 +675,7 @@ S9sVariant::size() const
         return 0;
     } else if (m_type == List)
     {
-        return m_union.listValue->size();
+        return m_union.listValue->value().size();
     }
     
     S9S_WARNING("");
@@ -918,7 +939,11 @@ S9sVariant::toString() const
 
     if (m_type == String)
     {
-        retval = *m_union.stringValue;
+        if (isSharedString())
+            retval = sharedString()->m_value;
+        else
+            retval.assign(
+                    m_union.stringValue.data, m_union.stringValue.length);
     } else if (m_type == Invalid)
     {
         // Nothing to do, empty string...
@@ -1314,9 +1339,9 @@ S9sVariant::contains(
 {
     if (isVariantList())
     {
-        for (uint idx = 0u; idx < m_union.listValue->size(); ++idx)
+        for (uint idx = 0u; idx < m_union.listValue->value().size(); ++idx)
         {
-            const S9sVariant &thisValue = (*m_union.listValue)[idx];
+            const S9sVariant &thisValue = m_union.listValue->value()[idx];
 
             if (thisValue == value)
                 return true;
@@ -1332,7 +1357,7 @@ S9sVariant::contains(
 {
     if (m_type == Map)
     {
-        return m_union.mapValue->contains(key);
+        return m_union.mapValue->value().contains(key);
     }
 
     return false;
@@ -1344,7 +1369,7 @@ S9sVariant::contains(
 {
     if (m_type == Map)
     {
-        return m_union.mapValue->contains(key);
+        return m_union.mapValue->value().contains(key);
     }
 
     return false;
@@ -1369,17 +1394,28 @@ S9sVariant::clear()
             break;
 
         case String:
-            delete m_union.stringValue;
-            m_union.stringValue = NULL;
+            if (isSharedString())
+            {
+                S9sSharedValue<S9sString> *shared = sharedString();
+
+                if (shared->unRef() == 0)
+                    S9sSharedValue<S9sString>::destroy(shared);
+            }
+
+            m_union.stringValue.length = 0;
             break;
 
         case Map:
-            delete m_union.mapValue;
+            if (m_union.mapValue->unRef() == 0)
+                S9sSharedValue<S9sVariantMap>::destroy(m_union.mapValue);
+
             m_union.mapValue = NULL;
             break;
 
         case List:
-            delete m_union.listValue;
+            if (m_union.listValue->unRef() == 0)
+                S9sSharedValue<S9sVariantList>::destroy(m_union.listValue);
+
             m_union.listValue = NULL;
             break;
 
@@ -20,8 +20,11 @@
 #pragma once
 
 #include "s9sunion.h"
+#include "s9ssharedvalue.h"
 #include "S9sString"
 
+#include <cstring>
+
 class S9sNode;
 class S9sContainer;
 class S9sVariantMap;
@@ -58,6 +61,7 @@ class S9sVariant
 
         inline S9sVariant();
         S9sVariant(const S9sVariant &orig);
+        inline S9sVariant(S9sVariant &&orig) noexcept;
         inline S9sVariant(const int integerValue);
         inline S9sVariant(const ulonglong ullValue);
         inline S9sVariant(const double doubleValue);
@@ -65,16 +69,20 @@ class S9sVariant
         inline S9sVariant(const char *stringValue);
         inline S9sVariant(const std::string &stringValue);
         inline S9sVariant(const S9sString &stringValue);
+        inline S9sVariant(S9sString &&stringValue);
         S9sVariant(const S9sNode &nodeValue);
         S9sVariant(const S9sContainer &containerValue);
         S9sVariant(const S9sAccount &accountValue);
         
         S9sVariant(const S9sVariantMap &mapValue);
         S9sVariant(const S9sVariantList &listValue);
+        S9sVariant(S9sVariantMap &&mapValue);
+        S9sVariant(S9sVariantList &&listValue);
 
-        virtual ~S9sVariant();
+        ~S9sVariant();
 
         S9sVariant &operator=(const S9sVariant &rhs);
+        S9sVariant &operator=(S9sVariant &&rhs) noexcept;
         bool operator==(const S9sVariant &rhs) const;
         bool operator!=(const S9sVariant &rhs) const;
         S9sVariant &operator+=(const S9sVariant &rhs);
@@ -131,6 +139,12 @@ class S9sVariant
         static bool fuzzyCompare(double first, double second);
         void additionWithOverflow(const int arg1, const int arg2);
 
+    private:
+        inline void setString(const char *data, const size_t length);
+        inline bool isSharedString() const;
+        inline S9sSharedValue<S9sString> *sharedString() const;
+        inline void setSharedString(S9sSharedValue<S9sString> *value);
+
     private:
         static const S9sVariantMap  sm_emptyMap;
         static const S9sVariantList sm_emptyList;
@@ -138,6 +152,9 @@ class S9sVariant
     private:
         S9sBasicType    m_type;
         S9sUnion        m_union;
+
+        friend class S9sJsonParser;
+        friend class S9sJsonWriter;
 };
 
 inline 
@@ -149,6 +166,19 @@ S9sVariant::S9sVariant() :
     m_union.iVal = 0;
 }
 
+/**
+ * Move constructor, takes over the value of the other variant without copying
+ * it, the other variant is left invalid.
+ */
+inline 
+S9sVariant::S9sVariant(
+        S9sVariant &&orig) noexcept :
+    m_type(orig.m_type),
+    m_union(orig.m_union)
+{
+    orig.m_type = Invalid;
+}
+
 inline 
 S9sVariant::S9sVariant(
         const int integerValue) :
@@ -187,9 +217,9 @@ S9sVariant::S9sVariant(
     m_type (String)
 {
     if (stringValue == NULL)
-        m_union.stringValue = new S9sString;
+        setString("", 0);
     else
-        m_union.stringValue = new S9sString(stringValue);
+        setString(stringValue, strlen(stringValue));
 }
 
 inline 
@@ -197,7 +227,7 @@ S9sVariant::S9sVariant(
         const std::string &stringValue) :
     m_type (String)
 {
-    m_union.stringValue = new S9sString(stringValue);
+    setString(stringValue.data(), stringValue.length());
 }
 
 inline 
@@ -205,6 +235,66 @@ S9sVariant::S9sVariant(
         const S9sString &stringValue) :
     m_type (String)
 {
-    m_union.stringValue = new S9sString(stringValue);
+    setString(stringValue.data(), stringValue.length());
+}
+
+/**
+ * Takes over the characters of a long string without copying them.
+ */
+inline 
+S9sVariant::S9sVariant(
+        S9sString &&stringValue) :
+    m_type (String)
+{
+    if (stringValue.length() <= S9S_SHORT_STRING_SIZE)
+    {
+        setString(stringValue.data(), stringValue.length());
+    } else {
+        setSharedString(
+                new S9sSharedValue<S9sString>(std::move(stringValue)));
+    }
+}
+
+/**
+ * Private method to set the string value, the short strings are stored in the
+ * variant, the longer ones are allocated.
+ */
+inline void
+S9sVariant::setString(
+        const char   *data,
+        const size_t  length)
+{
+    if (length <= S9S_SHORT_STRING_SIZE)
+    {
+        memcpy(m_union.stringValue.data, data, length);
+        m_union.stringValue.length = length;
+    } else {
+        setSharedString(
+                new S9sSharedValue<S9sString>(
+                    S9sString(std::string(data, length))));
+    }
+}
+
+inline bool
+S9sVariant::isSharedString() const
+{
+    return m_union.stringValue.length == S9S_SHARED_STRING;
+}
+
+inline S9sSharedValue<S9sString> *
+S9sVariant::sharedString() const
+{
+    S9sSharedValue<S9sString> *retval;
+
+    memcpy(&retval, m_union.stringValue.data, sizeof(retval));
+    return retval;
+}
+
+inline void
+S9sVariant::setSharedString(
+        S9sSharedValue<S9sString> *value)
+{
+    memcpy(m_union.stringValue.data, &value, sizeof(value));
+    m_union.stringValue.length = S9S_SHARED_STRING;
 }
 
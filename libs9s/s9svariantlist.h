@@ -5,10 +5,20 @@
 
 #include "S9sVariant"
 #include "S9sVector"
+#include "S9sArena"
 
-class S9sVariantList : public S9sVector<S9sVariant>
+/**
+ * A list of variants, it can allocate its elements in an arena.
+ */
+class S9sVariantList : 
+    public S9sVector<S9sVariant, S9sArenaAllocator<S9sVariant> >
 {
     public:
+        S9sVariantList() {};
+        explicit S9sVariantList(S9sArena *arena) :
+            S9sVector<S9sVariant, S9sArenaAllocator<S9sVariant> >(
+                    allocator_type(arena)) {};
+
         S9sVariant sum() const;
         S9sVariant average() const;
         S9sVariant max() const;
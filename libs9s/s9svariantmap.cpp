@@ -4,19 +4,17 @@
 #include "S9sVariantMap"
 
 #include <cmath>
+#include <cstdio>
+#include <cstring>
 
 #include "S9sVariantList"
-#include "S9sJsonParseContext"
-
-#define YY_EXTRA_TYPE S9sJsonParseContext *
-#include "json_parser.h"
-#include "json_lexer.h"
+#include "S9sJsonParser"
+#include "S9sJsonWriter"
 
 //#define DEBUG
 //#define WARNING
 #include "s9sdebug.h"
 
-static const char dblQuot = '"';
 const S9sVariant S9sVariantMap::sm_invalid;
 
 S9sVector<S9sString> 
@@ -24,7 +22,7 @@ S9sVariantMap::keys() const
 {
     S9sVector<S9sString> retval;
 
-    for (std::map<S9sString,S9sVariant>::const_iterator it = this->begin(); it != this->end(); ++it) 
+    for (const_iterator it = this->begin(); it != this->end(); ++it) 
     {
         retval.push_back(it->first);
     }
@@ -32,11 +30,47 @@ S9sVariantMap::keys() const
     return retval;
 }
 
+/**
+ * \param path The keys of the nested maps leading to the value.
+ * \returns The value or an invalid variant if there is no such value.
+ *
+ * Walks the nested maps without copying them, one lookup on every level.
+ */
+const S9sVariant &
+S9sVariantMap::valueByPath(
+        const S9sVariantPath &path) const
+{
+    const S9sVariantMap *map = this;
+    const_iterator       it;
+
+    if (path.empty())
+        return S9sVariantMap::sm_invalid;
+
+    for (size_t idx = 0; ; ++idx)
+    {
+        it = map->find(path[idx]);
+        if (it == map->end())
+            return S9sVariantMap::sm_invalid;
+
+        if (idx + 1 == path.size())
+            return it->second;
+
+        if (!it->second.isVariantMap())
+            return S9sVariantMap::sm_invalid;
+
+        map = &it->second.toVariantMap();
+    }
+}
+
+/**
+ * \param path The keys of the nested maps separated by '/'.
+ * \returns The value or an invalid variant if there is no such value.
+ */
 const S9sVariant &
 S9sVariantMap::valueByPath(
         const S9sString &path) const
 {
-    return valueByPath(path.split("/"));
+    return valueByPath(S9sVariantPath(path));
 }
 
 const S9sVariant &
@@ -64,6 +98,28 @@ S9sVariantMap::valueByPath(
     return S9sVariantMap::sm_invalid;
 }
 
+S9sVariantMap &
+S9sVariantMap::operator=(
+        const S9sVariantMap &rhs)
+{
+    S9sVariantMapBase::operator=(rhs);
+
+    return *this;
+}
+
+/**
+ * Move assignment, takes over the elements of the other map without copying
+ * them.
+ */
+S9sVariantMap &
+S9sVariantMap::operator=(
+        S9sVariantMap &&rhs) noexcept
+{
+    S9sVariantMapBase::operator=(std::move(rhs));
+
+    return *this;
+}
+
 /**
  * \returns true if and only if the string was successfully parsed
  *
@@ -75,28 +131,109 @@ bool
 S9sVariantMap::parse(
         const char *source)
 {
-    S9sJsonParseContext context(source);
-    int retval;
-    bool success;
+    if (source == NULL)
+        source = "";
+
+    return parse(source, strlen(source));
+}
+
+/**
+ * \param source The JSON string to parse, it does not need to be null
+ *   terminated.
+ * \param length The length of the JSON string in bytes.
+ * \param arena The arena where the parsed values are allocated or NULL to
+ *   allocate them on the heap.
+ * \returns true if and only if the string was successfully parsed
+ *
+ * This version parses the string where it is (e.g. in the network buffer)
+ * without copying it first.
+ */
+bool
+S9sVariantMap::parse(
+        const char *source,
+        size_t      length,
+        S9sArena   *arena)
+{
+    S9sJsonParser parser(source, length);
 
-    json_lex_init(&context.m_flex_scanner);
-    json_set_extra(&context, context.m_flex_scanner);
+    parser.setArena(arena);
+    return parser.parse(*this);
+}
 
-    retval = json_parse(context);
-    success = retval == 0;
+/**
+ * \param reader The function the parser calls to read the JSON string.
+ * \param userData The pointer passed to the reader function.
+ * \param arena The arena where the parsed values are allocated or NULL to
+ *   allocate them on the heap.
+ * \returns true if and only if the string was successfully parsed
+ *
+ * This version parses a JSON string that is produced while it is parsed (e.g.
+ * decompressed), so the whole string never has to be in the memory.
+ */
+bool
+S9sVariantMap::parse(
+        S9sParseReader  reader,
+        void           *userData,
+        S9sArena       *arena)
+{
+    S9sJsonParser parser(reader, userData);
 
-    json_lex_destroy(context.m_flex_scanner);
+    parser.setArena(arena);
+    return parser.parse(*this);
+}
 
-    if (success)
-    {
-        clear();
+/**
+ * \param source The JSON string to parse, it does not need to be null
+ *   terminated.
+ * \param length The length of the JSON string in bytes.
+ * \param arena The arena where the parsed values are allocated or NULL to
+ *   allocate them on the heap.
+ * \returns true if and only if the string was successfully parsed.
+ *
+ * This version copies the string and parses the maps and the lists inside the
+ * top level map only when they are accessed, so the values that are never
+ * used are never built. The syntax of the whole string is checked here, the
+ * errors inside the maps and the lists are reported too.
+ */
+bool
+S9sVariantMap::parseLazy(
+        const char *source,
+        size_t      length,
+        S9sArena   *arena)
+{
+    S9sJsonParser parser(source, length);
 
-        std::vector<S9sString> newKeys = context.keys();
-        for (uint idx = 0; idx < newKeys.size(); ++idx)
-            (*this)[newKeys[idx]] = context[newKeys[idx]];
-    }
+    parser.setArena(arena);
+    parser.setLazy(true);
+    return parser.parse(*this);
+}
 
-    return success;
+/**
+ * \param buffer The buffer allocated by malloc() the JSON string is in, it
+ *   must have room for a null byte after the string.
+ * \param offset The offset of the JSON string in the buffer.
+ * \param length The length of the JSON string in bytes.
+ * \param arena The arena where the parsed values are allocated or NULL to
+ *   allocate them on the heap.
+ * \returns true if and only if the string was successfully parsed.
+ *
+ * The lazy version of parse() that does not copy the string: the values take
+ * the ownership of the buffer if the string is parsed, the buffer is released
+ * with them. If the parsing fails the buffer is left to the caller.
+ */
+bool
+S9sVariantMap::parseLazy(
+        char       *buffer,
+        size_t      offset,
+        size_t      length,
+        S9sArena   *arena)
+{
+    S9sJsonParser parser(buffer + offset, length);
+
+    parser.setArena(arena);
+    parser.setLazy(true);
+    parser.adoptBuffer(buffer);
+    return parser.parse(*this);
 }
 
 /**
@@ -105,41 +242,53 @@ S9sVariantMap::parse(
 S9sString
 S9sVariantMap::toString() const
 {
-    return toString(0, *this);
+    S9sString retval;
+
+    {
+        S9sJsonWriter writer(retval);
+
+        writer.value(*this);
+    }
+
+    return retval;
 }
 
 /**
- * Private function, part of the S9sVariantMap::toString() implemtation.
+ * Converts the variant map to a JSON string without any whitespace. This is
+ * the format that is sent to the controller, it is smaller than the format of
+ * toString().
  */
 S9sString
-S9sVariantMap::toString(
-        int                  depth, 
-        const S9sVariantMap &variantMap) const
+S9sVariantMap::toCompactString() const
 {
-    S9sVector<S9sString> theKeys = variantMap.keys();
-    S9sString            retval;
+    S9sString retval;
 
-    retval = indent(depth) + "{\n";
-    for (uint idx = 0; idx < theKeys.size(); ++idx)
     {
-        retval += indent(depth + 1);
-        retval += quote(theKeys[idx]);
-        retval += ": ";
-       
-        S9sVariant value = variantMap.at(theKeys[idx]);
-        retval += toString(depth, value);
+        S9sJsonWriter writer(retval, true);
 
-        if (idx + 1 < theKeys.size())
-            retval += ',';
-
-        retval += "\n";
+        writer.value(*this);
     }
 
-    retval += indent(depth) + "}";
-
     return retval;
 }
 
+/**
+ * \param output The file where the map is printed.
+ *
+ * Prints the map in the format of toString() followed by a new line. The
+ * text is written while the map is processed, so the whole string is never
+ * built.
+ */
+void
+S9sVariantMap::printJson(
+        FILE *output) const
+{
+    S9sJsonWriter writer(output);
+
+    writer.value(*this);
+    writer.write("\n");
+}
+
 enum AssignmentState
 {
     Start,
@@ -307,16 +456,15 @@ bool
 S9sVariantMap::isSubSet(
         const S9sVariantMap &superSet) const
 {
-    S9sVector<S9sString> theKeys = keys();
+    const_iterator found;
 
-    for (uint idx = 0u; idx < theKeys.size(); ++idx)
+    for (const_iterator it = begin(); it != end(); ++it)
     {
-        const S9sString &key = theKeys[idx];
-
-        if (!superSet.contains(key))
+        found = superSet.find(it->first);
+        if (found == superSet.end())
             return false;
 
-        if (at(key) == superSet.at(key))
+        if (it->second == found->second)
             continue;
             
         return false;
@@ -325,146 +473,3 @@ S9sVariantMap::isSubSet(
     return true;
 }
 
-/**
- * Private function, part of the S9sVariantMap::toString() implemtation.
- */
-S9sString
-S9sVariantMap::toString (
-        int                   depth,
-        const S9sVariantList &theList) const
-{
-    S9sString retval;
-
-    retval += "[ ";
-    
-    for (uint idx = 0; idx < theList.size(); ++idx)
-    {
-        if (idx > 0)
-            retval += ", ";
-
-        retval += toString(depth, theList[idx]);
-    }
-
-    retval += " ]";
-
-    return retval;
-}
-
-/**
- * Private function, part of the S9sVariantMap::toString() implemtation.
- */
-S9sString
-S9sVariantMap::toString (
-        int               depth,
-        const S9sVariant &value) const
-{
-    S9sString retval;
-
-    switch (value.type())
-    {
-        case String:
-            retval += quote(value.toString());
-            break;
-
-        case Int:
-        case Bool:
-        case Ulonglong:
-            retval += value.toString();
-            break;
-
-        case Double: 
-            {
-                // FIXME: maybe this classification shouldn't be here, but here
-                // we return 'JSon' compatible strings, so might be this is the
-                // correct place
-                double dblval = value.toDouble();
-                bool   m_enableSpecialNums = true;
-                
-                if (std::isnan (dblval)) 
-                {
-                    retval += m_enableSpecialNums ? "NaN" : "0.0";
-                } else if (std::isinf (dblval))
-                {
-                    retval += m_enableSpecialNums ? "Infinity" : "0.0";
-                } else {
-                    retval += value.toString();
-                }
-            break;
-        }
-
-        case Map:
-        case Node:
-        case Account:
-            retval += "\n";
-            retval += toString(depth + 1, value.toVariantMap());
-            break;
-
-        case List:
-            retval += toString(depth, value.toVariantList());
-            break;
-        
-        default:
-            // Let's use 'null' for invalid/null data (http://www.json.org/)
-            retval.sprintf ("null");
-            break;
-    }
-
-    return retval;
-}
-
-/**
- * Private function, part of the S9sVariantMap::toString() implemtation.
- */
-S9sString
-S9sVariantMap::indent(
-        int depth) const
-{
-    S9sString retval;
-    
-    for (int n = 0; n < depth; ++n)
-        retval += "    ";
-
-    return retval;
-}
-
-/**
- * Private function, part of the S9sVariantMap::toString() implemtation.
- */
-S9sString
-S9sVariantMap::quote(
-        const S9sString &s) const
-{
-    S9sString retval;
-
-    retval += dblQuot;
-
-    // lets encode the double quote, and some
-    // other special chars in the returned JSon
-    for (uint idx = 0; idx < s.length(); ++idx)
-    {
-        if (s[idx] == dblQuot) 
-        {
-            retval += '\\';
-            retval += dblQuot;
-        } else if (s[idx] == '\n') 
-        {
-            retval += "\\n";
-        } else if (s[idx] == '\r') 
-        {
-            retval += "\\r";
-        } else if (s[idx] == '\t') 
-        {
-            retval += "\\t";
-        } else if (s[idx] == '\\') 
-        {
-            retval += "\\\\";
-        } else 
-        {
-            retval += s[idx];
-        }
-    }
-
-    retval += dblQuot;
-    return retval;
-}
-
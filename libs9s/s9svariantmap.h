@@ -3,48 +3,79 @@
  */
 #pragma once
 
+#include <cstdio>
+
 #include "S9sVariant"
-#include "S9sMap"
+#include "S9sFlatMap"
 #include "S9sVector"
 #include "S9sString"
 #include "S9sParseContext"
+#include "S9sArena"
+#include "S9sAtom"
+#include "S9sVariantPath"
 
 class S9sVariantList;
 
-class S9sVariantMap : public S9sMap<S9sString, S9sVariant>
+/**
+ * The map the variant map is built on, the keys are interned, the elements are
+ * stored in one sorted vector that can be allocated in an arena.
+ */
+typedef S9sFlatMap<
+        S9sAtom, S9sVariant, 
+        S9sArenaAllocator<std::pair<S9sAtom, S9sVariant> > >
+    S9sVariantMapBase;
+
+class S9sVariantMap : public S9sVariantMapBase
 {
     public:
-        S9sVariantMap() : S9sMap<S9sString, S9sVariant>() {};
+        S9sVariantMap() : S9sVariantMapBase() {};
+        explicit S9sVariantMap(S9sArena *arena) : 
+            S9sVariantMapBase(allocator_type(arena)) {};
+        S9sVariantMap(const S9sVariantMap &orig) : 
+            S9sVariantMapBase(orig) {};
+        S9sVariantMap(S9sVariantMap &&orig) noexcept : 
+            S9sVariantMapBase(std::move(orig)) {};
         virtual ~S9sVariantMap() {};
 
+        S9sVariantMap &operator=(const S9sVariantMap &rhs);
+        S9sVariantMap &operator=(S9sVariantMap &&rhs) noexcept;
+
         S9sVector<S9sString> keys() const;
 
+        const S9sVariant &valueByPath(const S9sVariantPath &path) const;
         const S9sVariant &valueByPath(const S9sString &path) const;
         const S9sVariant &valueByPath(S9sVariantList path) const;
 
         bool parse(const char *source);
+        bool parse(
+                const char *source, 
+                size_t      length, 
+                S9sArena   *arena = NULL);
+
+        bool parse(
+                S9sParseReader  reader, 
+                void           *userData,
+                S9sArena       *arena = NULL);
+
+        bool parseLazy(
+                const char *source, 
+                size_t      length, 
+                S9sArena   *arena = NULL);
+
+        bool parseLazy(
+                char       *buffer, 
+                size_t      offset,
+                size_t      length, 
+                S9sArena   *arena);
+
         S9sString toString() const;
+        S9sString toCompactString() const;
+        void printJson(FILE *output = stdout) const;
         bool parseAssignments(const S9sString &input);
         bool isSubSet(const S9sVariantMap &superSet) const;
 
     protected:
         static const S9sVariant sm_invalid;
-
-    private:
-        S9sString toString(
-                int                  depth, 
-                const S9sVariantMap &variantMap) const;
-
-        S9sString toString (
-                int                   depth,
-                const S9sVariantList &theList) const;
-
-        S9sString toString (
-                int               depth,
-                const S9sVariant &value) const;
-
-        S9sString indent(int depth) const;
-        S9sString quote(const S9sString &s) const;
 };
 
 
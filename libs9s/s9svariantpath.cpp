@@ -0,0 +1,88 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2018  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "s9svariantpath.h"
+
+#include <cstring>
+
+S9sVariantPath::S9sVariantPath()
+{
+}
+
+/**
+ * \param path The keys separated by '/'.
+ */
+S9sVariantPath::S9sVariantPath(
+        const char *path)
+{
+    if (path != NULL)
+        split(path, strlen(path));
+}
+
+/**
+ * \param path The keys separated by '/'.
+ */
+S9sVariantPath::S9sVariantPath(
+        const S9sString &path)
+{
+    split(path.data(), path.length());
+}
+
+/**
+ * \returns The path as a string, the keys separated by '/'.
+ */
+S9sString
+S9sVariantPath::toString() const
+{
+    S9sString retval;
+
+    for (uint idx = 0u; idx < m_keys.size(); ++idx)
+    {
+        if (idx > 0u)
+            retval += '/';
+
+        retval += m_keys[idx].toString();
+    }
+
+    return retval;
+}
+
+/**
+ * Private method to split the path and intern the keys.
+ */
+void
+S9sVariantPath::split(
+        const char *path,
+        size_t      length)
+{
+    const char *end = path + length;
+    const char *separator;
+
+    while (path < end)
+    {
+        separator = (const char *) memchr(path, '/', end - path);
+        if (separator == NULL)
+            separator = end;
+
+        if (separator > path)
+            m_keys.push_back(S9sAtom(path, separator - path));
+
+        path = separator + 1;
+    }
+}
@@ -0,0 +1,79 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2018  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "S9sAtom"
+#include "S9sVector"
+
+/**
+ * A path of keys in nested variant maps (e.g. "event_specifics/host/hostname")
+ * split and interned once, so it can be looked up many times without
+ * splitting the string or allocating memory. The empty fields are skipped,
+ * "/a//b" is the same as "a/b".
+ *
+ * The paths used by the getters can be static:
+ *
+ *   static const S9sVariantPath path("event_specifics/host");
+ *   return m_properties.valueByPath(path).isVariantMap();
+ */
+class S9sVariantPath
+{
+    public:
+        S9sVariantPath();
+        explicit S9sVariantPath(const char *path);
+        explicit S9sVariantPath(const S9sString &path);
+
+        inline size_t size() const;
+        inline bool empty() const;
+        inline const S9sAtom &operator[](size_t index) const;
+
+        S9sString toString() const;
+
+    private:
+        void split(const char *path, size_t length);
+
+    private:
+        S9sVector<S9sAtom> m_keys;
+};
+
+/**
+ * \returns The number of keys in the path.
+ */
+inline size_t
+S9sVariantPath::size() const
+{
+    return m_keys.size();
+}
+
+inline bool
+S9sVariantPath::empty() const
+{
+    return m_keys.empty();
+}
+
+/**
+ * \returns The key on the given level, the first key is on level 0.
+ */
+inline const S9sAtom &
+S9sVariantPath::operator[](
+        size_t index) const
+{
+    return m_keys[index];
+}
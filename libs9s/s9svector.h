@@ -20,33 +20,39 @@
 #pragma once
 
 #include <vector>
+#include <utility>
 #include <algorithm>
 #include <assert.h>
 
-template <typename T>
-class S9sVector : public std::vector<T>
+template <typename T, typename Allocator = std::allocator<T> >
+class S9sVector : public std::vector<T, Allocator>
 {
     public:
+        S9sVector() {};
+        explicit S9sVector(const Allocator &allocator) :
+            std::vector<T, Allocator>(allocator) {};
+
         bool contains(const T &item) const;
 
-        S9sVector<T> &operator=(const std::vector<T> &rhs);
-        S9sVector<T> &operator<<(const T &item);
-        S9sVector<T> &operator<<(const S9sVector<T> &toInsert);
+        S9sVector<T, Allocator> &operator=(const std::vector<T, Allocator> &rhs);
+        S9sVector<T, Allocator> &operator<<(const T &item);
+        S9sVector<T, Allocator> &operator<<(T &&item);
+        S9sVector<T, Allocator> &operator<<(const S9sVector<T, Allocator> &toInsert);
 
-        void append(const S9sVector<T> &toInsert);
-        void append(const std::vector<T> &toInsert);
+        void append(const S9sVector<T, Allocator> &toInsert);
+        void append(const std::vector<T, Allocator> &toInsert);
 
         void copyElements(
-                const S9sVector<T> &toCopy,
+                const S9sVector<T, Allocator> &toCopy,
                 const unsigned int from,
                 const unsigned int to);
 
         void copyElements(
-                const std::vector<T> &toCopy,
+                const std::vector<T, Allocator> &toCopy,
                 const unsigned int from,
                 const unsigned int to );
 
-        S9sVector<T> unique() const;
+        S9sVector<T, Allocator> unique() const;
         void sort();
         void reverse();
 
@@ -56,10 +62,10 @@ class S9sVector : public std::vector<T>
         void limit(const int sizeLimit);
 };
 
-template <typename T>
-S9sVector<T> &
-S9sVector<T>::operator=(
-        const std::vector<T> &rhs)
+template <typename T, typename Allocator>
+S9sVector<T, Allocator> &
+S9sVector<T, Allocator>::operator=(
+        const std::vector<T, Allocator> &rhs)
 {
     if (&rhs == this)
         return *this;
@@ -75,11 +81,11 @@ S9sVector<T>::operator=(
 /**
  * \returns true if the vector contains the given element.
  */
-template <typename T>
-bool S9sVector<T>::contains(
+template <typename T, typename Allocator>
+bool S9sVector<T, Allocator>::contains(
         const T &item) const
 {
-    for (typename std::vector<T>::const_iterator it = this->begin(); it != this->end (); it++) 
+    for (typename std::vector<T, Allocator>::const_iterator it = this->begin(); it != this->end (); it++) 
     {
         if (item == *it)
             return true;
@@ -91,17 +97,29 @@ bool S9sVector<T>::contains(
 /**
  * Appends one elements to the end of the vector.
  */
-template <typename T>
-S9sVector<T> &S9sVector<T>::operator<<(
+template <typename T, typename Allocator>
+S9sVector<T, Allocator> &S9sVector<T, Allocator>::operator<<(
         const T &item)
 {
     this->push_back(item);
     return *this;
 }
 
-template <typename T>
-S9sVector<T> &S9sVector<T>::operator<<(
-        const S9sVector<T> &toInsert)
+/**
+ * Appends the item to the end of the vector taking over its value instead of
+ * copying it.
+ */
+template <typename T, typename Allocator>
+S9sVector<T, Allocator> &S9sVector<T, Allocator>::operator<<(
+        T &&item)
+{
+    this->push_back(std::move(item));
+    return *this;
+}
+
+template <typename T, typename Allocator>
+S9sVector<T, Allocator> &S9sVector<T, Allocator>::operator<<(
+        const S9sVector<T, Allocator> &toInsert)
 {
     this->insert(this->end(), toInsert.begin(), toInsert.end());
     return *this;
@@ -110,9 +128,9 @@ S9sVector<T> &S9sVector<T>::operator<<(
 /**
  * Appends several elements to the end of the vector.
  */
-template <typename T>
-void S9sVector<T>::append(
-        const S9sVector<T> &toInsert)
+template <typename T, typename Allocator>
+void S9sVector<T, Allocator>::append(
+        const S9sVector<T, Allocator> &toInsert)
 {
     this->insert(this->end(), toInsert.begin(), toInsert.end());
 }
@@ -120,9 +138,9 @@ void S9sVector<T>::append(
 /**
  * Appends several elements to the end of the vector.
  */
-template <typename T>
-void S9sVector<T>::append(
-        const std::vector<T> &toInsert)
+template <typename T, typename Allocator>
+void S9sVector<T, Allocator>::append(
+        const std::vector<T, Allocator> &toInsert)
 {
     this->insert(this->end(), toInsert.begin(), toInsert.end());
 }
@@ -130,22 +148,22 @@ void S9sVector<T>::append(
 /**
  * Removes and returns the last element of the vector.
  */
-template <typename T>
-T S9sVector<T>::takeLast()
+template <typename T, typename Allocator>
+T S9sVector<T, Allocator>::takeLast()
 {
     assert(!this->empty());
 
-    T retval = this->back();
+    T retval = std::move(this->back());
     this->pop_back();
     return retval;
 }
 
-template <typename T>
-T S9sVector<T>::takeFirst()
+template <typename T, typename Allocator>
+T S9sVector<T, Allocator>::takeFirst()
 {
     assert(!this->empty());
 
-    T retval = this->front();
+    T retval = std::move(this->front());
     this->erase(this->begin());
     return retval;
 }
@@ -153,18 +171,18 @@ T S9sVector<T>::takeFirst()
 /**
  *  several elements to the end of the vector.
  */
-template <typename T>
-void S9sVector<T>::copyElements(
-        const std::vector<T> &toInsert,
+template <typename T, typename Allocator>
+void S9sVector<T, Allocator>::copyElements(
+        const std::vector<T, Allocator> &toInsert,
         const unsigned int from,
         const unsigned int to)
 {
     this->insert(this->end(), toInsert.begin()+from, to>toInsert.size() ? toInsert.end() : toInsert.begin() + to );
 }
 
-template <typename T>
-void S9sVector<T>::copyElements(
-        const S9sVector<T> &toInsert,
+template <typename T, typename Allocator>
+void S9sVector<T, Allocator>::copyElements(
+        const S9sVector<T, Allocator> &toInsert,
         const unsigned int from,
         const unsigned int to)
 {
@@ -175,12 +193,12 @@ void S9sVector<T>::copyElements(
  * \returns a new S9sVector which doesn't contain any duplicates,
  *   so every item is unique in the new vector
  */
-template <typename T>
-S9sVector<T> S9sVector<T>::unique() const
+template <typename T, typename Allocator>
+S9sVector<T, Allocator> S9sVector<T, Allocator>::unique() const
 {
-    S9sVector<T> retval;
+    S9sVector<T, Allocator> retval;
 
-    for (typename std::vector<T>::iterator it = this->begin(); it != this->end(); ++it)
+    for (typename std::vector<T, Allocator>::iterator it = this->begin(); it != this->end(); ++it)
     {
         if (retval.contains (*it))
             continue;
@@ -199,9 +217,9 @@ S9sVector<T> S9sVector<T>::unique() const
  * FIXME: maybe we should store this limit in the object and then we could
  * investigate the size before trying to add items.
  */
-template <typename T>
+template <typename T, typename Allocator>
 void
-S9sVector<T>::limit(
+S9sVector<T, Allocator>::limit(
         const int sizeLimit)
 {
     if (sizeLimit < 0)
@@ -214,9 +232,9 @@ S9sVector<T>::limit(
 /**
  * Sorts the list in ascending alphabetical order.
  */
-template <typename T>
+template <typename T, typename Allocator>
 void
-S9sVector<T>::sort()
+S9sVector<T, Allocator>::sort()
 {
     std::sort(this->begin(), this->end());
 }
@@ -224,9 +242,9 @@ S9sVector<T>::sort()
 /**
  * Reverse order. 
  */
-template <typename T>
+template <typename T, typename Allocator>
 void
-S9sVector<T>::reverse()
+S9sVector<T, Allocator>::reverse()
 {
     std::reverse(this->begin(), this->end());
 }
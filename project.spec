@@ -13,6 +13,7 @@ BuildRequires: bison
 BuildRequires: automake
 BuildRequires: gcc-c++
 BuildRequires: openssl-devel
+BuildRequires: zlib-devel
 BuildRequires: flex
 
 %description
@@ -21,6 +21,7 @@
 #include "S9sOptions"
 #include "S9sRpcClient"
 #include "S9sBusinessLogic"
+#include "S9sOutput"
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -54,6 +55,8 @@ main(int argc, char **argv)
     bool        success, finished;
     int         exitStatus;
 
+    S9sOutput::init();
+
     setlocale(LC_NUMERIC, getenv("C"));
     setlocale(LC_ALL,     getenv("C"));
     //setlocale(LC_NUMERIC, getenv("LC_NUMERIC"));
@@ -0,0 +1,636 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2018  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "bm_s9sperformance.h"
+
+#include "s9stestdata.h"
+
+#include "S9sVariantMap"
+#include "S9sVariantList"
+#include "S9sArena"
+#include "S9sVariantPath"
+#include "S9sNode"
+#include "S9sFormatProgram"
+#include "S9sOptions"
+#include "S9sOutput"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdarg>
+#include <sys/time.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+//#define DEBUG
+#include "s9sdebug.h"
+
+BmS9sPerformance::BmS9sPerformance()
+{
+}
+
+BmS9sPerformance::~BmS9sPerformance()
+{
+}
+
+bool
+BmS9sPerformance::runTest(
+        const char *testName)
+{
+    bool retval = true;
+
+    PERFORM_TEST(testParseAllocations, retval);
+    PERFORM_TEST(testParseArena,       retval);
+    PERFORM_TEST(testPropertyLookups,  retval);
+    PERFORM_TEST(testSerialize,        retval);
+    PERFORM_TEST(testLazyParse,        retval);
+    PERFORM_TEST(testPathLookups,      retval);
+    PERFORM_TEST(testListPrinting,     retval);
+    PERFORM_TEST(testFormatString,     retval);
+    PERFORM_TEST(testHtmlConversion,   retval);
+
+    return retval;
+}
+
+/**
+ * Parses a reply with a list of hosts the way the controller sends it and
+ * prints the number of the memory allocations and the time it takes.
+ */
+bool
+BmS9sPerformance::testParseAllocations()
+{
+    const int           nHosts  = 1000;
+    const int           nRounds = 10;
+    S9sString           reply   = S9sTestData::controllerReply(nHosts);
+    unsigned long long  allocations;
+    double              start, elapsed;
+    S9sVariantMap       theMap;
+
+    allocations = S9sTestData::allocations();
+    start       = milliseconds();
+
+    for (int round = 0; round < nRounds; ++round)
+    {
+        theMap.clear();
+        S9S_VERIFY(theMap.parse(STR(reply), reply.length()));
+    }
+
+    elapsed     = (milliseconds() - start) / nRounds;
+    allocations = (S9sTestData::allocations() - allocations) / nRounds;
+
+    S9S_COMPARE(theMap["hosts"].toVariantList().size(), nHosts);
+
+    report("reply: %lu bytes, %d hosts", 
+            (unsigned long) reply.length(), nHosts);
+
+    report("parse: %llu allocations, %.1f per host, %.2f ms",
+            allocations, (double) allocations / nHosts, elapsed);
+
+    return true;
+}
+
+/**
+ * Parses the same reply on the heap and in an arena and prints the memory
+ * allocations and the time it takes to parse and to release the document.
+ */
+bool
+BmS9sPerformance::testParseArena()
+{
+    const int           nHosts  = 1000;
+    const int           nRounds = 10;
+    S9sString           reply   = S9sTestData::controllerReply(nHosts);
+    unsigned long long  allocations[2] = { 0ull, 0ull };
+    double              parseTime[2]   = { 0.0, 0.0 };
+    double              releaseTime[2] = { 0.0, 0.0 };
+    unsigned long long  start;
+    double              startTime;
+
+    for (int round = 0; round < nRounds; ++round)
+    {
+        for (int useArena = 0; useArena < 2; ++useArena)
+        {
+            S9sArena      *arena = useArena ? new S9sArena : NULL;
+            S9sVariantMap  theMap;
+
+            start     = S9sTestData::allocations();
+            startTime = milliseconds();
+            S9S_VERIFY(theMap.parse(STR(reply), reply.length(), arena));
+
+            if (arena != NULL)
+                arena->unRef();
+
+            parseTime[useArena]   += milliseconds() - startTime;
+            allocations[useArena] += S9sTestData::allocations() - start;
+
+            S9S_COMPARE(theMap["hosts"].toVariantList().size(), nHosts);
+
+            startTime = milliseconds();
+            theMap    = S9sVariantMap();
+            releaseTime[useArena] += milliseconds() - startTime;
+        }
+    }
+
+    report("heap:  %llu allocations, parse %.2f ms, release %.2f ms",
+            allocations[0] / nRounds, 
+            parseTime[0] / nRounds, releaseTime[0] / nRounds);
+
+    report("arena: %llu allocations, parse %.2f ms, release %.2f ms",
+            allocations[1] / nRounds, 
+            parseTime[1] / nRounds, releaseTime[1] / nRounds);
+
+    return true;
+}
+
+/**
+ * Calls the property getters of the hosts the way the list printing code does
+ * and prints the time of one lookup.
+ */
+bool
+BmS9sPerformance::testPropertyLookups()
+{
+    const int           nHosts  = 1000;
+    const int           nRounds = 100;
+    S9sString           reply   = S9sTestData::controllerReply(nHosts);
+    S9sVector<S9sNode>  nodes;
+    S9sVariantList      hosts;
+    S9sVariantMap       theMap;
+    int                 nLookups = 0;
+    double              start, elapsed;
+
+    S9S_VERIFY(theMap.parse(STR(reply), reply.length()));
+    hosts = theMap["hosts"].toVariantList();
+
+    for (uint idx = 0u; idx < hosts.size(); ++idx)
+        nodes << S9sNode(hosts[idx].toVariantMap());
+
+    start = milliseconds();
+    for (int round = 0; round < nRounds; ++round)
+    {
+        for (uint idx = 0u; idx < nodes.size(); ++idx)
+        {
+            const S9sNode &node = nodes[idx];
+
+            nLookups += node.className().empty() ? 0 : 1;
+            nLookups += node.hostName().empty() ? 0 : 1;
+            nLookups += node.port() > 0 ? 1 : 0;
+            nLookups += node.role().empty() ? 0 : 1;
+            nLookups += node.hostStatus().empty() ? 0 : 1;
+        }
+    }
+
+    elapsed = milliseconds() - start;
+    S9S_COMPARE(nLookups, nRounds * nHosts * 5);
+
+    report("lookups: %d, %.1f ns per lookup", 
+            nLookups, elapsed * 1000000.0 / nLookups);
+
+    return true;
+}
+
+/**
+ * Converts a parsed reply back to JSON in both formats and prints the time it
+ * takes, then prints it to a file without building the string.
+ */
+bool
+BmS9sPerformance::testSerialize()
+{
+    const int           nHosts  = 1000;
+    const int           nRounds = 10;
+    S9sString           reply   = S9sTestData::controllerReply(nHosts);
+    S9sVariantMap       theMap;
+    S9sString           compact;
+    S9sString           indented;
+    double              start, compactTime, indentedTime, printTime;
+    unsigned long long  allocations[2];
+    FILE               *output;
+
+    S9S_VERIFY(theMap.parse(STR(reply), reply.length()));
+
+    start = milliseconds();
+    for (int round = 0; round < nRounds; ++round)
+        compact = theMap.toCompactString();
+
+    compactTime = (milliseconds() - start) / nRounds;
+
+    allocations[0] = S9sTestData::allocations();
+    start = milliseconds();
+    for (int round = 0; round < nRounds; ++round)
+        indented = theMap.toString();
+
+    indentedTime   = (milliseconds() - start) / nRounds;
+    allocations[0] = (S9sTestData::allocations() - allocations[0]) / nRounds;
+
+    S9S_COMPARE(indented, reply);
+
+    // The same text written to a file while the map is processed.
+    output = fopen("/dev/null", "w");
+    S9S_VERIFY(output != NULL);
+
+    allocations[1] = S9sTestData::allocations();
+    start = milliseconds();
+    for (int round = 0; round < nRounds; ++round)
+        theMap.printJson(output);
+
+    printTime      = (milliseconds() - start) / nRounds;
+    allocations[1] = (S9sTestData::allocations() - allocations[1]) / nRounds;
+    fclose(output);
+
+    report("compact:  %lu bytes, %.2f ms", 
+            (unsigned long) compact.length(), compactTime);
+
+    report("indented: %lu bytes, %.2f ms, %llu allocations", 
+            (unsigned long) indented.length(), indentedTime, allocations[0]);
+
+    report("printed:  %lu bytes, %.2f ms, %llu allocations", 
+            (unsigned long) indented.length() + 1, printTime, allocations[1]);
+
+    return true;
+}
+
+/**
+ * Parses a job list reply eagerly and lazily, reads the fields the brief job
+ * list prints and prints the memory allocations and the time it takes.
+ */
+bool
+BmS9sPerformance::testLazyParse()
+{
+    const int           nJobs   = 1000;
+    const int           nRounds = 10;
+    S9sString           reply   = S9sTestData::jobsReply(nJobs);
+    unsigned long long  allocations[2] = { 0ull, 0ull };
+    double              elapsed[2]     = { 0.0, 0.0 };
+    unsigned long long  start;
+    double              startTime;
+
+    for (int round = 0; round < nRounds; ++round)
+    {
+        for (int lazy = 0; lazy < 2; ++lazy)
+        {
+            S9sVariantMap  theMap;
+            S9sVariantList jobs;
+            int            nFields = 0;
+
+            start     = S9sTestData::allocations();
+            startTime = milliseconds();
+
+            if (lazy)
+            {
+                S9S_VERIFY(theMap.parseLazy(STR(reply), reply.length()));
+            } else {
+                S9S_VERIFY(theMap.parse(STR(reply), reply.length()));
+            }
+
+            jobs = theMap["jobs"].toVariantList();
+            for (uint idx = 0u; idx < jobs.size(); ++idx)
+            {
+                const S9sVariantMap &job = jobs[idx].toVariantMap();
+
+                nFields += job.at("job_id").toInt() >= 0 ? 1 : 0;
+                nFields += job.at("cluster_id").toInt() > 0 ? 1 : 0;
+                nFields += job.at("user_name").toString().empty() ? 0 : 1;
+                nFields += job.at("group_name").toString().empty() ? 0 : 1;
+                nFields += job.at("status").toString().empty() ? 0 : 1;
+                nFields += job.at("created").toString().empty() ? 0 : 1;
+                nFields += job.at("title").toString().empty() ? 0 : 1;
+            }
+
+            elapsed[lazy]     += milliseconds() - startTime;
+            allocations[lazy] += S9sTestData::allocations() - start;
+
+            S9S_COMPARE(nFields, nJobs * 7);
+        }
+    }
+
+    report("reply: %lu bytes, %d jobs", 
+            (unsigned long) reply.length(), nJobs);
+
+    report("eager: %llu allocations, %.2f ms",
+            allocations[0] / nRounds, elapsed[0] / nRounds);
+
+    report("lazy:  %llu allocations, %.2f ms",
+            allocations[1] / nRounds, elapsed[1] / nRounds);
+
+    return true;
+}
+
+/**
+ * Looks up a value three levels deep the way the event getters do, with the
+ * path string and with the path that is split once, and prints the time of
+ * one lookup and the memory allocations.
+ */
+bool
+BmS9sPerformance::testPathLookups()
+{
+    const int              nLookups = 100000;
+    const char            *source;
+    const S9sString        pathString("event_specifics/host/hostname");
+    const S9sVariantPath   path(pathString);
+    S9sVariantMap          event;
+    unsigned long long     allocations[2];
+    double                 elapsed[2];
+    unsigned long long     start;
+    double                 startTime;
+    int                    nFound = 0;
+
+    source = 
+        "{ \"class_name\": \"CmonEvent\", \"event_class\": \"EventHost\", "
+        "\"event_specifics\": { \"host\": { \"class_name\": "
+        "\"CmonMySqlHost\", \"hostname\": \"10.0.0.1\", \"port\": 3306 }, "
+        "\"cluster_id\": 1 }, \"event_origins\": { \"sender_line\": 10 } }";
+
+    S9S_VERIFY(event.parse(source));
+
+    for (int compiled = 0; compiled < 2; ++compiled)
+    {
+        start     = S9sTestData::allocations();
+        startTime = milliseconds();
+
+        for (int idx = 0; idx < nLookups; ++idx)
+        {
+            const S9sVariant &value = compiled ? 
+                event.valueByPath(path) : event.valueByPath(pathString);
+
+            nFound += value.isString() ? 1 : 0;
+        }
+
+        elapsed[compiled]     = milliseconds() - startTime;
+        allocations[compiled] = S9sTestData::allocations() - start;
+    }
+
+    S9S_COMPARE(nFound, 2 * nLookups);
+
+    report("string:   %.1f ns per lookup, %.1f allocations", 
+            elapsed[0] * 1000000.0 / nLookups, 
+            (double) allocations[0] / nLookups);
+
+    report("compiled: %.1f ns per lookup, %.1f allocations", 
+            elapsed[1] * 1000000.0 / nLookups, 
+            (double) allocations[1] / nLookups);
+
+    return true;
+}
+
+/**
+ * Prints the job list and the long node list of 50k rows to /dev/null line
+ * buffered (as on a terminal), with the default buffer of a pipe and with the
+ * buffer of S9sOutput and prints the time it takes.
+ */
+bool
+BmS9sPerformance::testListPrinting()
+{
+    const int    nRows = 50000;
+    const char  *modeNames[] = { "line buffered", "4 KiB buffer", "S9sOutput" };
+    S9sOptions  *options = S9sOptions::instance();
+    S9sRpcReply  jobs;
+    S9sRpcReply  nodes;
+    double       elapsed[3];
+    const char  *jobArgv[] = 
+    { 
+        "/bin/s9s", "job", "--list", "--color=always", NULL 
+    };
+    const char  *nodeArgv[] = 
+    { 
+        "/bin/s9s", "node", "--list", "--long", "--color=always", NULL 
+    };
+    int          argc;
+
+    jobs  = S9sTestData::jobListReply(nRows);
+    nodes = S9sTestData::nodeListReply(nRows);
+
+    argc = sizeof(jobArgv) / sizeof(char *) - 1;
+    S9S_VERIFY(options->readOptions(&argc, (char **) jobArgv));
+    
+    for (int mode = 0; mode < 3; ++mode)
+        elapsed[mode] = printList(jobs, mode);
+    
+    for (int mode = 0; mode < 3; ++mode)
+        report("job --list, %s: %.2f ms", modeNames[mode], elapsed[mode]);
+
+    S9sOptions::uninit();
+    
+    options = S9sOptions::instance();
+    argc    = sizeof(nodeArgv) / sizeof(char *) - 1;
+    S9S_VERIFY(options->readOptions(&argc, (char **) nodeArgv));
+    
+    for (int mode = 0; mode < 3; ++mode)
+        elapsed[mode] = printList(nodes, mode);
+    
+    for (int mode = 0; mode < 3; ++mode)
+    {
+        report("node --list --long, %s: %.2f ms", 
+                modeNames[mode], elapsed[mode]);
+    }
+
+    S9sOptions::uninit();
+
+    return true;
+}
+
+/**
+ * Converts 100k nodes to strings with the format string and with the format
+ * string compiled once, checks that the results are the same and prints the
+ * time and the memory allocations of one node.
+ */
+bool
+BmS9sPerformance::testFormatString()
+{
+    const int           nNodes = 100000;
+    const S9sString     formatString = 
+        "%5P %8I %-6R %-14S\\t%-20V %N %.12M\\n";
+    S9sFormatProgram    program = S9sNode::compileFormat(formatString);
+    S9sVariantMap       reply = S9sTestData::nodeListReply(nNodes);
+    S9sVariantList      clusters = reply["clusters"].toVariantList();
+    S9sVariantList      hosts = clusters[0u]["hosts"].toVariantList();
+    S9sVector<S9sNode>  nodes;
+    S9sString           lines[2];
+    unsigned long long  allocations[2];
+    double              elapsed[2];
+    unsigned long long  start;
+    double              startTime;
+
+    for (uint idx = 0u; idx < hosts.size(); ++idx)
+        nodes.push_back(S9sNode(hosts[idx].toVariantMap()));
+
+    for (int compiled = 0; compiled < 2; ++compiled)
+    {
+        start     = S9sTestData::allocations();
+        startTime = milliseconds();
+
+        for (uint idx = 0u; idx < nodes.size(); ++idx)
+        {
+            if (compiled)
+                lines[compiled] += nodes[idx].toString(true, program);
+            else
+                lines[compiled] += nodes[idx].toString(true, formatString);
+        }
+
+        elapsed[compiled]     = milliseconds() - startTime;
+        allocations[compiled] = S9sTestData::allocations() - start;
+    }
+
+    S9S_VERIFY(lines[0] == lines[1]);
+    S9S_COMPARE(lines[1].substr(0, 37), 
+            " 3306        0 master CmonHostOnline\t");
+
+    report("format string: %.1f ns per node, %.1f allocations", 
+            elapsed[0] * 1000000.0 / nNodes, 
+            (double) allocations[0] / nNodes);
+
+    report("compiled:      %.1f ns per node, %.1f allocations", 
+            elapsed[1] * 1000000.0 / nNodes, 
+            (double) allocations[1] / nNodes);
+
+    return true;
+}
+
+/**
+ * Converts the markup of 100k job messages to terminal escape sequences and to
+ * plain text and prints the time and the memory allocations of one message.
+ */
+bool
+BmS9sPerformance::testHtmlConversion()
+{
+    const int           nMessages = 100000;
+    const char         *modeNames[] = { "html2ansi", "html2text" };
+    S9sString           message;
+    S9sString           converted;
+    unsigned long long  allocations;
+    unsigned long long  start;
+    double              startTime;
+    double              elapsed;
+
+    message = 
+        "<em style='color: #c66211;'>10.0.0.5</em>:3306: Installing "
+        "<strong style='color: #59a449;'>mysql</strong> from "
+        "<em style='color: #ff00ff;'>percona</em>.<br/>Done.";
+
+    for (int mode = 0; mode < 2; ++mode)
+    {
+        start     = S9sTestData::allocations();
+        startTime = milliseconds();
+
+        for (int idx = 0; idx < nMessages; ++idx)
+        {
+            if (mode == 0)
+                converted = S9sString::html2ansi(message);
+            else
+                converted = S9sString::html2text(message);
+        }
+
+        elapsed     = milliseconds() - startTime;
+        allocations = S9sTestData::allocations() - start;
+
+        report("%s: %.1f ns per message, %.1f allocations", 
+                modeNames[mode], 
+                elapsed * 1000000.0 / nMessages, 
+                (double) allocations / nMessages);
+    }
+
+    S9S_COMPARE(converted, 
+            "10.0.0.5:3306: Installing mysql from percona.\nDone.");
+
+    return true;
+}
+
+/**
+ * \param reply The reply to print as a job list or a node list.
+ * \param bufferMode 0 for line buffering, 1 for the 4 KiB buffer, 2 for the
+ *   buffer of S9sOutput.
+ * \returns The time in milliseconds the printing took.
+ *
+ * The standard output is redirected to /dev/null while the list is printed.
+ */
+double
+BmS9sPerformance::printList(
+        S9sRpcReply &reply,
+        int          bufferMode)
+{
+    S9sOptions *options = S9sOptions::instance();
+    int         savedOutput;
+    int         nullOutput;
+    double      start, retval;
+
+    fflush(stdout);
+    savedOutput = dup(STDOUT_FILENO);
+    nullOutput  = open("/dev/null", O_WRONLY);
+    dup2(nullOutput, STDOUT_FILENO);
+
+    switch (bufferMode)
+    {
+        case 0:
+            setvbuf(stdout, NULL, _IOLBF, BUFSIZ);
+            break;
+
+        case 1:
+            setvbuf(stdout, NULL, _IOFBF, 4096);
+            break;
+
+        default:
+            S9sOutput::init();
+    }
+
+    start = milliseconds();
+    
+    if (options->isNodeOperation())
+        reply.printNodeList();
+    else
+        reply.printJobList();
+
+    S9sOutput::flush();
+    retval = milliseconds() - start;
+
+    dup2(savedOutput, STDOUT_FILENO);
+    close(savedOutput);
+    close(nullOutput);
+    setvbuf(stdout, NULL, _IOLBF, BUFSIZ);
+
+    return retval;
+}
+
+/**
+ * \returns The monotonic time in milliseconds.
+ */
+double
+BmS9sPerformance::milliseconds()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+}
+
+/**
+ * Prints one line of the benchmark results.
+ */
+void
+BmS9sPerformance::report(
+        const char *formatString,
+        ...)
+{
+    S9sString  theString;
+    va_list    arguments;
+    
+    va_start(arguments, formatString);
+    theString.vsprintf(formatString, arguments);
+    va_end(arguments);
+
+    printf("    %s\n", STR(theString));
+    fflush(stdout);
+}
+
+S9S_UNIT_TEST_MAIN(BmS9sPerformance)
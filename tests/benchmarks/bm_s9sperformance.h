@@ -0,0 +1,51 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2018  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include "s9sunittest.h"
+#include "S9sRpcReply"
+
+/**
+ * Benchmarks of the code that processes the controller replies. The time and
+ * the memory allocations are printed, nothing fails when the code becomes
+ * slower. Not built by "make check", run it with "make benchmark".
+ */
+class BmS9sPerformance : public S9sUnitTest
+{
+    public:
+        BmS9sPerformance();
+        virtual ~BmS9sPerformance();
+        virtual bool runTest(const char *testName = 0);
+    
+    protected:
+        bool testParseAllocations();
+        bool testParseArena();
+        bool testPropertyLookups();
+        bool testSerialize();
+        bool testLazyParse();
+        bool testPathLookups();
+        bool testListPrinting();
+        bool testFormatString();
+        bool testHtmlConversion();
+
+    private:
+        double printList(S9sRpcReply &reply, int bufferMode);
+        static double milliseconds();
+        void report(const char *formatString, ...);
+};
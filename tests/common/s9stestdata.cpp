@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2011-2018 severalnines.com
+ */
+#include "s9stestdata.h"
+
+#include "S9sVariantList"
+
+#include <cstdlib>
+#include <new>
+
+/*
+ * Every memory allocation of the test program is counted. The replacements are
+ * not inlined, so that the compiler does not see the new and the free() in the
+ * same function.
+ */
+static unsigned long long sm_allocations = 0ull;
+
+__attribute__((noinline)) void *
+operator new(
+        size_t size)
+{
+    void *retval;
+
+    ++sm_allocations;
+    retval = malloc(size > 0 ? size : 1);
+    if (retval == NULL)
+        throw std::bad_alloc();
+
+    return retval;
+}
+
+__attribute__((noinline)) void
+operator delete(
+        void *pointer) noexcept
+{
+    free(pointer);
+}
+
+/**
+ * \returns The number of memory allocations made by operator new since the
+ *   program started.
+ */
+unsigned long long
+S9sTestData::allocations()
+{
+    return sm_allocations;
+}
+
+/**
+ * \returns A reply with the given number of hosts, similar to the reply of the
+ *   getAllClusterInfo request.
+ */
+S9sString
+S9sTestData::controllerReply(
+        int nHosts)
+{
+    S9sVariantMap  reply;
+    S9sVariantList hosts;
+
+    for (int idx = 0; idx < nHosts; ++idx)
+    {
+        S9sVariantMap  host;
+        S9sVariantList tags;
+        S9sVariantMap  stats;
+        S9sString      hostName;
+
+        hostName.sprintf("10.0.%d.%d", idx / 256, idx % 256);
+        tags << "production" << "db";
+        stats["load_average"] = 0.25;
+        stats["connections"]  = idx % 100;
+
+        host["class_name"]    = "CmonMySqlHost";
+        host["hostname"]      = hostName;
+        host["hostId"]        = idx;
+        host["port"]          = 3306;
+        host["role"]          = idx % 3 == 0 ? "master" : "slave";
+        host["hoststatus"]    = "CmonHostOnline";
+        host["connected"]     = true;
+        host["version"]       = "10.4.12-MariaDB-log";
+        host["description"]   = "A database server in the production cluster.";
+        host["uptime"]        = 1234567 + idx;
+        host["tags"]          = tags;
+        host["stats"]         = stats;
+
+        hosts << host;
+    }
+
+    reply["request_status"] = "Ok";
+    reply["total"]          = nHosts;
+    reply["hosts"]          = hosts;
+
+    return reply.toString();
+}
+
+/**
+ * \returns A reply with the given number of jobs, similar to the reply of the
+ *   getJobInstances request: most of the reply is the job specification the
+ *   list printers don't show.
+ */
+S9sString
+S9sTestData::jobsReply(
+        int nJobs)
+{
+    S9sVariantMap  reply;
+    S9sVariantList jobs;
+
+    for (int idx = 0; idx < nJobs; ++idx)
+    {
+        S9sVariantMap  job;
+        S9sVariantMap  spec;
+        S9sVariantMap  jobData;
+        S9sVariantMap  data;
+        S9sVariantList nodes;
+        S9sVariantList messages;
+        S9sString      title;
+
+        for (int node = 0; node < 3; ++node)
+        {
+            S9sVariantMap theNode;
+            S9sString     hostName;
+
+            hostName.sprintf("10.0.%d.%d", idx % 256, node);
+            theNode["class_name"] = "CmonMySqlHost";
+            theNode["hostname"]   = hostName;
+            theNode["port"]       = 3306;
+            nodes << theNode;
+        }
+
+        jobData["cluster_type"]   = "galera";
+        jobData["vendor"]         = "percona";
+        jobData["version"]        = "8.0";
+        jobData["nodes"]          = nodes;
+        jobData["enable_uninstall"] = true;
+        spec["command"]           = "create_cluster";
+        spec["job_data"]          = jobData;
+
+        messages << "Verifying job parameters.";
+        data["progress"]          = idx % 100;
+        data["messages"]          = messages;
+
+        title.sprintf("Create Galera Cluster %d", idx);
+        job["class_name"]         = "CmonJobInstance";
+        job["job_id"]             = idx;
+        job["cluster_id"]         = 1 + idx % 10;
+        job["user_name"]          = "admin";
+        job["group_name"]         = "admins";
+        job["status"]             = "FINISHED";
+        job["created"]            = "2020-01-08T11:23:18.000Z";
+        job["title"]              = title;
+        job["job_spec"]           = spec;
+        job["job_data"]           = data;
+
+        jobs << job;
+    }
+
+    reply["request_status"] = "Ok";
+    reply["total"]          = nJobs;
+    reply["jobs"]           = jobs;
+
+    return reply.toString();
+}
+
+/**
+ * \returns A reply with the given number of jobs with the fields the job list
+ *   prints.
+ */
+S9sVariantMap
+S9sTestData::jobListReply(
+        int nJobs)
+{
+    S9sVariantMap  reply;
+    S9sVariantList jobs;
+
+    for (int idx = 0; idx < nJobs; ++idx)
+    {
+        S9sVariantMap  job;
+        S9sString      title;
+
+        title.sprintf("Create Galera Cluster %d", idx);
+        job["class_name"]         = "CmonJobInstance";
+        job["job_id"]             = idx;
+        job["cluster_id"]         = 1 + idx % 10;
+        job["user_name"]          = "admin";
+        job["group_name"]         = "admins";
+        job["status"]             = idx % 7 == 0 ? "FAILED" : "FINISHED";
+        job["created"]            = "2020-01-08T11:23:18.000Z";
+        job["title"]              = title;
+
+        jobs << job;
+    }
+
+    reply["request_status"] = "Ok";
+    reply["total"]          = nJobs;
+    reply["jobs"]           = jobs;
+
+    return reply;
+}
+
+/**
+ * \returns A reply with one cluster that has the given number of hosts, with
+ *   the fields the long node list prints.
+ */
+S9sVariantMap
+S9sTestData::nodeListReply(
+        int nNodes)
+{
+    S9sVariantMap  reply;
+    S9sVariantMap  cluster;
+    S9sVariantList clusters;
+    S9sVariantList hosts;
+
+    for (int idx = 0; idx < nNodes; ++idx)
+    {
+        S9sVariantMap  host;
+        S9sString      hostName;
+
+        hostName.sprintf("10.%d.%d.%d",
+                idx / 65536, idx / 256 % 256, idx % 256);
+        host["class_name"]    = "CmonMySqlHost";
+        host["hostname"]      = hostName;
+        host["hostId"]        = idx;
+        host["clusterid"]     = 1;
+        host["port"]          = 3306;
+        host["nodetype"]      = "galera";
+        host["role"]          = idx % 3 == 0 ? "master" : "slave";
+        host["hoststatus"]    = "CmonHostOnline";
+        host["version"]       = "10.4.12-MariaDB-log";
+        host["message"]       = "Up and running.";
+
+        hosts << host;
+    }
+
+    cluster["cluster_id"]   = 1;
+    cluster["cluster_name"] = "production";
+    cluster["hosts"]        = hosts;
+    clusters << cluster;
+
+    reply["request_status"] = "Ok";
+    reply["total"]          = 1;
+    reply["clusters"]       = clusters;
+
+    return reply;
+}
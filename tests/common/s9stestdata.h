@@ -0,0 +1,22 @@
+/*
+ * Copyright (C) 2011-2018 severalnines.com
+ */
+#pragma once
+
+#include "S9sString"
+#include "S9sVariantMap"
+
+/**
+ * Controller replies of any size for the performance tests and the benchmarks,
+ * and the number of memory allocations the program made so far.
+ */
+class S9sTestData
+{
+    public:
+        static unsigned long long allocations();
+
+        static S9sString controllerReply(int nHosts);
+        static S9sString jobsReply(int nJobs);
+        static S9sVariantMap jobListReply(int nJobs);
+        static S9sVariantMap nodeListReply(int nNodes);
+};
@@ -77,6 +77,8 @@ runTest ut_s9suser $@
 runTest ut_s9sregexp $@
 runTest ut_s9soptions $@
 runTest ut_s9srpcclient $@
+runTest ut_s9seventloop $@
+runTest ut_s9stable $@
 runTest ut_s9sconfigfile $@
 
 echo
@@ -0,0 +1,397 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2018  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ut_s9seventloop.h"
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+
+//#define DEBUG
+#define WARNING
+#include "s9sdebug.h"
+
+/**
+ * What the callbacks of the tests do and what happened to them. The
+ * callbacks change the watched file descriptors as the client does while
+ * the event loop is calling them.
+ */
+struct Context
+{
+    S9sEventLoop  *loop;
+    int            nCalls;
+    int            events;
+    int            otherFd;
+    Context       *otherContext;
+    int            pipeFds[2];
+};
+
+static void
+countCallback(
+        int   fd,
+        int   events,
+        void *userData)
+{
+    Context *context = (Context *) userData;
+
+    S9S_UNUSED(fd);
+    context->nCalls += 1;
+    context->events  = events;
+}
+
+static void
+unwatchOtherCallback(
+        int   fd,
+        int   events,
+        void *userData)
+{
+    Context *context = (Context *) userData;
+
+    countCallback(fd, events, userData);
+    context->loop->unwatch(context->otherFd);
+}
+
+static void
+watchOtherCallback(
+        int   fd,
+        int   events,
+        void *userData)
+{
+    Context *context = (Context *) userData;
+
+    countCallback(fd, events, userData);
+    context->loop->watch(
+            context->otherFd, POLLIN, countCallback, context->otherContext);
+}
+
+static void
+modifyCallback(
+        int   fd,
+        int   events,
+        void *userData)
+{
+    Context *context = (Context *) userData;
+
+    countCallback(fd, events, userData);
+    context->loop->modify(fd, POLLIN);
+}
+
+/*
+ * Reads what is ready, closes the other file descriptor and watches a new
+ * pipe that most likely gets the same file descriptor number.
+ */
+static void
+replaceOtherCallback(
+        int   fd,
+        int   events,
+        void *userData)
+{
+    Context *context = (Context *) userData;
+    char     buffer[16];
+
+    countCallback(fd, events, userData);
+
+    if (::read(fd, buffer, sizeof(buffer)) <= 0)
+        return;
+
+    context->loop->unwatch(context->otherFd);
+    ::close(context->otherFd);
+
+    if (::pipe(context->pipeFds) != 0)
+        return;
+
+    context->loop->watch(
+            context->pipeFds[0], POLLIN, countCallback, context->otherContext);
+}
+
+UtS9sEventLoop::UtS9sEventLoop()
+{
+}
+
+UtS9sEventLoop::~UtS9sEventLoop()
+{
+}
+
+bool
+UtS9sEventLoop::runTest(
+        const char *testName)
+{
+    bool retval = true;
+
+    PERFORM_TEST(testWatch,             retval);
+    PERFORM_TEST(testModify,            retval);
+    PERFORM_TEST(testUnwatchInCallback, retval);
+    PERFORM_TEST(testWatchInCallback,   retval);
+    PERFORM_TEST(testReusedDescriptor,  retval);
+
+    return retval;
+}
+
+/**
+ * The callback is called when the file descriptor is ready and only then.
+ */
+bool
+UtS9sEventLoop::testWatch()
+{
+    S9sEventLoop  loop;
+    Context       context = { &loop, 0, 0, -1, NULL, { -1, -1 } };
+    int           fds[2];
+
+    S9S_VERIFY(loop.isEmpty());
+    S9S_COMPARE(loop.runOnce(0), 0);
+
+    S9S_VERIFY(openPipe(fds));
+    S9S_VERIFY(loop.watch(fds[0], POLLIN, countCallback, &context));
+    S9S_VERIFY(!loop.watch(fds[0], POLLIN, countCallback, &context));
+    S9S_VERIFY(!loop.watch(-1, POLLIN, countCallback, &context));
+    S9S_VERIFY(!loop.isEmpty());
+
+    S9S_COMPARE(loop.runOnce(10), 0);
+    S9S_COMPARE(context.nCalls, 0);
+
+    S9S_VERIFY(::write(fds[1], "x", 1) == 1);
+    S9S_COMPARE(loop.runOnce(1000), 1);
+    S9S_COMPARE(context.nCalls, 1);
+    S9S_VERIFY((context.events & POLLIN) != 0);
+
+    // The writer closed the pipe.
+    ::close(fds[1]);
+    S9S_COMPARE(loop.runOnce(1000), 1);
+    S9S_VERIFY((context.events & (POLLIN | POLLHUP)) != 0);
+
+    loop.unwatch(fds[0]);
+    loop.unwatch(fds[0]);
+    S9S_VERIFY(loop.isEmpty());
+    S9S_COMPARE(loop.runOnce(0), 0);
+    S9S_COMPARE(context.nCalls, 2);
+
+    ::close(fds[0]);
+    return true;
+}
+
+/**
+ * The callback of a writable file descriptor switches to reading, the loop
+ * waits for the new events from the next round on.
+ */
+bool
+UtS9sEventLoop::testModify()
+{
+    S9sEventLoop  loop;
+    Context       context = { &loop, 0, 0, -1, NULL, { -1, -1 } };
+    int           fds[2];
+
+    S9S_VERIFY(openPipe(fds));
+    S9S_VERIFY(loop.watch(fds[1], POLLOUT, modifyCallback, &context));
+    S9S_VERIFY(!loop.modify(fds[0], POLLIN));
+
+    S9S_COMPARE(loop.runOnce(1000), 1);
+    S9S_COMPARE(context.nCalls, 1);
+    S9S_VERIFY((context.events & POLLOUT) != 0);
+
+    // The write end of the pipe is never readable.
+    S9S_COMPARE(loop.runOnce(10), 0);
+    S9S_COMPARE(context.nCalls, 1);
+
+    S9S_VERIFY(loop.modify(fds[1], POLLOUT));
+    S9S_COMPARE(loop.runOnce(1000), 1);
+    S9S_COMPARE(context.nCalls, 2);
+
+    loop.unwatch(fds[1]);
+    ::close(fds[0]);
+    ::close(fds[1]);
+
+    return true;
+}
+
+/**
+ * Two file descriptors are ready at the same time, the one called first
+ * unwatches the other, so only one of the callbacks is called.
+ */
+bool
+UtS9sEventLoop::testUnwatchInCallback()
+{
+    S9sEventLoop  loop;
+    Context       first  = { &loop, 0, 0, -1, NULL, { -1, -1 } };
+    Context       second = { &loop, 0, 0, -1, NULL, { -1, -1 } };
+    int           fds1[2];
+    int           fds2[2];
+
+    S9S_VERIFY(openPipe(fds1));
+    S9S_VERIFY(openPipe(fds2));
+
+    first.otherFd  = fds2[0];
+    second.otherFd = fds1[0];
+
+    S9S_VERIFY(loop.watch(fds1[0], POLLIN, unwatchOtherCallback, &first));
+    S9S_VERIFY(loop.watch(fds2[0], POLLIN, unwatchOtherCallback, &second));
+
+    S9S_VERIFY(::write(fds1[1], "x", 1) == 1);
+    S9S_VERIFY(::write(fds2[1], "x", 1) == 1);
+
+    S9S_COMPARE(loop.runOnce(1000), 1);
+    S9S_COMPARE(first.nCalls + second.nCalls, 1);
+
+    // The one that was called is still watched.
+    S9S_VERIFY(!loop.isEmpty());
+    S9S_COMPARE(loop.runOnce(1000), 1);
+    S9S_COMPARE(first.nCalls + second.nCalls, 2);
+    S9S_VERIFY(first.nCalls == 0 || second.nCalls == 0);
+
+    loop.unwatch(fds1[0]);
+    loop.unwatch(fds2[0]);
+    S9S_VERIFY(loop.isEmpty());
+
+    for (int idx = 0; idx < 2; ++idx)
+    {
+        ::close(fds1[idx]);
+        ::close(fds2[idx]);
+    }
+
+    return true;
+}
+
+/**
+ * A callback starts watching a file descriptor that is already readable, it is
+ * called in the next round.
+ */
+bool
+UtS9sEventLoop::testWatchInCallback()
+{
+    S9sEventLoop  loop;
+    Context       second = { &loop, 0, 0, -1, NULL, { -1, -1 } };
+    Context       first  = { &loop, 0, 0, -1, &second, { -1, -1 } };
+    int           fds1[2];
+    int           fds2[2];
+
+    S9S_VERIFY(openPipe(fds1));
+    S9S_VERIFY(openPipe(fds2));
+
+    first.otherFd = fds2[0];
+
+    S9S_VERIFY(loop.watch(fds1[0], POLLIN, watchOtherCallback, &first));
+    S9S_VERIFY(::write(fds1[1], "x", 1) == 1);
+    S9S_VERIFY(::write(fds2[1], "x", 1) == 1);
+
+    S9S_COMPARE(loop.runOnce(1000), 1);
+    S9S_COMPARE(first.nCalls, 1);
+    S9S_COMPARE(second.nCalls, 0);
+
+    loop.unwatch(fds1[0]);
+    S9S_COMPARE(loop.runOnce(1000), 1);
+    S9S_COMPARE(first.nCalls, 1);
+    S9S_COMPARE(second.nCalls, 1);
+
+    loop.unwatch(fds2[0]);
+    S9S_VERIFY(loop.isEmpty());
+
+    for (int idx = 0; idx < 2; ++idx)
+    {
+        ::close(fds1[idx]);
+        ::close(fds2[idx]);
+    }
+
+    return true;
+}
+
+/**
+ * A callback closes an other file descriptor that is also ready and watches a
+ * new one that gets the same number: the event of the closed one is not
+ * delivered to the new watcher.
+ */
+bool
+UtS9sEventLoop::testReusedDescriptor()
+{
+    S9sEventLoop  loop;
+    Context       fresh    = { &loop, 0, 0, -1, NULL, { -1, -1 } };
+    Context       first    = { &loop, 0, 0, -1, &fresh, { -1, -1 } };
+    Context       second   = { &loop, 0, 0, -1, &fresh, { -1, -1 } };
+    int           fds1[2];
+    int           fds2[2];
+    int           newFds[2];
+
+    S9S_VERIFY(openPipe(fds1));
+    S9S_VERIFY(openPipe(fds2));
+
+    first.otherFd  = fds2[0];
+    second.otherFd = fds1[0];
+
+    // Whichever is called first replaces the other.
+    S9S_VERIFY(loop.watch(fds1[0], POLLIN, replaceOtherCallback, &first));
+    S9S_VERIFY(loop.watch(fds2[0], POLLIN, replaceOtherCallback, &second));
+    S9S_VERIFY(::write(fds1[1], "x", 1) == 1);
+    S9S_VERIFY(::write(fds2[1], "x", 1) == 1);
+
+    S9S_COMPARE(loop.runOnce(1000), 1);
+    S9S_COMPARE(first.nCalls + second.nCalls, 1);
+    S9S_COMPARE(fresh.nCalls, 0);
+
+    // The new pipe is empty, nothing to read from it.
+    S9S_COMPARE(loop.runOnce(10), 0);
+    S9S_COMPARE(fresh.nCalls, 0);
+
+    if (first.nCalls == 1)
+    {
+        newFds[0] = first.pipeFds[0];
+        newFds[1] = first.pipeFds[1];
+        loop.unwatch(fds1[0]);
+        ::close(fds1[0]);
+    } else {
+        newFds[0] = second.pipeFds[0];
+        newFds[1] = second.pipeFds[1];
+        loop.unwatch(fds2[0]);
+        ::close(fds2[0]);
+    }
+
+    S9S_VERIFY(::write(newFds[1], "x", 1) == 1);
+    S9S_COMPARE(loop.runOnce(1000), 1);
+    S9S_COMPARE(fresh.nCalls, 1);
+    S9S_VERIFY((fresh.events & POLLIN) != 0);
+
+    loop.unwatch(newFds[0]);
+    S9S_VERIFY(loop.isEmpty());
+
+    ::close(newFds[0]);
+    ::close(newFds[1]);
+    ::close(fds1[1]);
+    ::close(fds2[1]);
+
+    return true;
+}
+
+/**
+ * Creates a non-blocking pipe.
+ */
+bool
+UtS9sEventLoop::openPipe(
+        int fds[2])
+{
+    if (::pipe(fds) != 0)
+        return false;
+
+    for (int idx = 0; idx < 2; ++idx)
+    {
+        int flags = ::fcntl(fds[idx], F_GETFL);
+
+        ::fcntl(fds[idx], F_SETFL, flags | O_NONBLOCK);
+    }
+
+    return true;
+}
+
+S9S_UNIT_TEST_MAIN(UtS9sEventLoop)
@@ -111,6 +111,7 @@ UtS9sNode::runTest(const char *testName)
     PERFORM_TEST(testSetProperties,   retval);
     PERFORM_TEST(testAssign,          retval);
     PERFORM_TEST(testToString,        retval);
+    PERFORM_TEST(testFormatProgram,   retval);
     PERFORM_TEST(testVariant01,       retval);
     PERFORM_TEST(testVariant02,       retval);
     PERFORM_TEST(testParse,           retval);
@@ -267,6 +268,54 @@ UtS9sNode::testToString()
     return true;
 }
 
+/**
+ * The compiled format strings executed on a node: the flags, the escapes, the
+ * "%%" and the 'f' modifier.
+ */
+bool
+UtS9sNode::testFormatProgram()
+{
+    S9sVariantMap    theMap;
+    S9sNode          theNode;
+    S9sFormatProgram program;
+    S9sString        longName;
+
+    S9S_VERIFY(theMap.parse(hostJson1));
+    theNode = theMap;
+
+    S9S_COMPARE(theNode.toString(false, "%-16N|"), "192.168.1.189   |");
+    S9S_COMPARE(theNode.toString(false, "%16N|"),  "   192.168.1.189|");
+    S9S_COMPARE(theNode.toString(false, "%.3N|"),  "192|");
+    S9S_COMPARE(theNode.toString(false, "%-6P|"),  "3306  |");
+    S9S_COMPARE(theNode.toString(false, "%05P"),   "03306");
+    S9S_COMPARE(theNode.toString(false, "%+P"),    "+3306");
+    S9S_COMPARE(theNode.toString(false, "%'8P"),   "    3306");
+    S9S_COMPARE(theNode.toString(false, "100%% %N"), "100% 192.168.1.189");
+    S9S_COMPARE(theNode.toString(false, "\\t%N\\n"), "\t192.168.1.189\n");
+    
+    // The modifier is not printed, the directives without the modified
+    // version ignore it.
+    S9S_COMPARE(theNode.toString(false, "%fN"), "192.168.1.189");
+    
+    // Longer than the buffer of the printf() fallback.
+    longName = theNode.toString(false, "%+300N");
+    S9S_COMPARE(longName.length(), 300);
+    S9S_VERIFY(longName.endsWith(" 192.168.1.189"));
+
+    // The same program can be executed any number of times.
+    program = S9sNode::compileFormat("%N:%P %a\\n");
+    S9S_COMPARE(program.size(), 6);
+    S9S_COMPARE(
+            theNode.toString(false, program),
+            theNode.toString(false, "%N:%P %a\\n"));
+    
+    S9S_COMPARE(
+            theNode.toString(false, program),
+            "192.168.1.189:3306 M\n");
+
+    return true;
+}
+
 
 /**
  * Here we put the node into a variant map, then we convert the variant map to a
@@ -55,6 +55,7 @@ UtS9sOptions::runTest(const char *testName)
     PERFORM_TEST(testReadOptions05, retval);
     PERFORM_TEST(testReadOptions06, retval);
     PERFORM_TEST(testReadOptions07, retval);
+    PERFORM_TEST(testReadOptions08, retval);
     PERFORM_TEST(testSetNodes,      retval);
 
     return retval;
@@ -184,6 +185,71 @@ UtS9sOptions::testController()
     S9S_COMPARE(options->controllerProtocol(), "https");
     S9S_COMPARE(options->controllerHostName(), "127.0.0.1");
     S9S_COMPARE(options->controllerPort(),     8080);
+    S9S_COMPARE(options->failoverControllers().size(), 0);
+    
+    options->setController("https://[fd00::10]:9501");
+    S9S_COMPARE(options->controllerHostName(), "fd00::10");
+    S9S_COMPARE(options->controllerPort(),     9501);
+
+    /*
+     * The IPv6 addresses in brackets with and without the port and the path.
+     */
+    S9sVariantMap parts;
+
+    parts = options->parseControllerUrl("https://[::1]");
+    S9S_COMPARE(parts["controller_protocol"].toString(), "https");
+    S9S_COMPARE(parts["controller"].toString(),          "::1");
+    S9S_VERIFY(!parts.contains("controller_port"));
+    S9S_VERIFY(!parts.contains("controller_path"));
+    
+    parts = options->parseControllerUrl("[fd00::10]");
+    S9S_COMPARE(parts["controller"].toString(),          "fd00::10");
+    S9S_VERIFY(!parts.contains("controller_port"));
+    
+    parts = options->parseControllerUrl("https://[::1]:9501");
+    S9S_COMPARE(parts["controller"].toString(),          "::1");
+    S9S_COMPARE(parts["controller_port"].toInt(),        9501);
+    S9S_COMPARE(parts["controller_path"].toString(),     "");
+    
+    parts = options->parseControllerUrl("https://[::1]:9501/v2");
+    S9S_COMPARE(parts["controller"].toString(),          "::1");
+    S9S_COMPARE(parts["controller_port"].toInt(),        9501);
+    S9S_COMPARE(parts["controller_path"].toString(),     "/v2");
+    
+    parts = options->parseControllerUrl("https://[::1]/v2");
+    S9S_COMPARE(parts["controller"].toString(),          "::1");
+    S9S_VERIFY(!parts.contains("controller_port"));
+    S9S_COMPARE(parts["controller_path"].toString(),     "/v2");
+
+    parts = options->parseControllerUrl("https://cc1/path:9501");
+    S9S_COMPARE(parts["controller"].toString(),          "cc1");
+    S9S_VERIFY(!parts.contains("controller_port"));
+    S9S_COMPARE(parts["controller_path"].toString(),     "/path:9501");
+    
+    parts = options->parseControllerUrl("cc1:9501/a/b");
+    S9S_COMPARE(parts["controller"].toString(),          "cc1");
+    S9S_COMPARE(parts["controller_port"].toInt(),        9501);
+    S9S_COMPARE(parts["controller_path"].toString(),     "/a/b");
+    
+    options->setController("https://[::1]");
+    S9S_COMPARE(options->controllerHostName(), "::1");
+
+    /*
+     * More controllers, the first is used, the others are for failover.
+     */
+    options->setController("https://cc1:9501, http://cc2:9500/path,cc3");
+    S9S_COMPARE(options->controllerProtocol(), "https");
+    S9S_COMPARE(options->controllerHostName(), "cc1");
+    S9S_COMPARE(options->controllerPort(),     9501);
+    
+    S9sVariantList others = options->failoverControllers();
+    S9S_COMPARE(others.size(), 2);
+    S9S_COMPARE(others[0]["controller_protocol"].toString(), "http");
+    S9S_COMPARE(others[0]["controller"].toString(),          "cc2");
+    S9S_COMPARE(others[0]["controller_port"].toInt(),        9500);
+    S9S_COMPARE(others[0]["controller_path"].toString(),     "/path");
+    S9S_COMPARE(others[1]["controller"].toString(),          "cc3");
+    S9S_VERIFY(!others[1].toVariantMap().contains("controller_port"));
 
     return true;
 }
@@ -413,6 +479,35 @@ UtS9sOptions::testReadOptions07()
     return true;
 }
 
+/**
+ * The --print-ndjson option is accepted by the list commands and it does not
+ * turn on the --print-json mode.
+ */
+bool
+UtS9sOptions::testReadOptions08()
+{
+    S9sOptions *options = S9sOptions::instance();
+    bool  success;
+    const char *argv[] = 
+    { 
+        "/bin/s9s", "job", "--list", "--print-ndjson", NULL
+    };
+    int   argc   = sizeof(argv) / sizeof(char *) - 1;
+
+
+    success = options->readOptions(&argc, (char**)argv);
+    S9S_VERIFY(success);
+    
+    S9S_COMPARE(options->binaryName(),     "s9s");
+    S9S_COMPARE(options->m_operationMode,  S9sOptions::Job);
+    S9S_VERIFY(options->isListRequested());
+    S9S_VERIFY(options->isNdJsonRequested());
+    S9S_VERIFY(!options->isJsonRequested());
+
+    S9sOptions::uninit();
+    return true;
+}
+
 bool
 UtS9sOptions::testSetNodes()
 {
@@ -0,0 +1,288 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2018  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ut_s9sperformance.h"
+
+#include "s9stestdata.h"
+
+#include "S9sVariantMap"
+#include "S9sVariantList"
+#include "S9sArena"
+#include "S9sVariantPath"
+#include "S9sNode"
+#include "S9sFormatProgram"
+
+//#define DEBUG
+#include "s9sdebug.h"
+
+UtS9sPerformance::UtS9sPerformance()
+{
+}
+
+UtS9sPerformance::~UtS9sPerformance()
+{
+}
+
+bool
+UtS9sPerformance::runTest(
+        const char *testName)
+{
+    bool retval = true;
+
+    PERFORM_TEST(testParseAllocations, retval);
+    PERFORM_TEST(testParseArena,       retval);
+    PERFORM_TEST(testLazyParse,        retval);
+    PERFORM_TEST(testPathLookups,      retval);
+    PERFORM_TEST(testFormatString,     retval);
+    PERFORM_TEST(testHtmlConversion,   retval);
+
+    return retval;
+}
+
+/**
+ * Parses a reply with a list of hosts the way the controller sends it and
+ * checks the number of the memory allocations.
+ */
+bool
+UtS9sPerformance::testParseAllocations()
+{
+    const int           nHosts  = 1000;
+    S9sString           reply   = S9sTestData::controllerReply(nHosts);
+    unsigned long long  allocations;
+    S9sVariantMap       theMap;
+
+    allocations = S9sTestData::allocations();
+    S9S_VERIFY(theMap.parse(STR(reply), reply.length()));
+    allocations = S9sTestData::allocations() - allocations;
+
+    S9S_COMPARE(theMap["hosts"].toVariantList().size(), nHosts);
+    S9S_VERIFY(allocations / nHosts < 25);
+
+    return true;
+}
+
+/**
+ * Parses the same reply on the heap and in an arena and checks that the arena
+ * needs a lot less memory allocations.
+ */
+bool
+UtS9sPerformance::testParseArena()
+{
+    const int           nHosts  = 1000;
+    S9sString           reply   = S9sTestData::controllerReply(nHosts);
+    unsigned long long  allocations[2] = { 0ull, 0ull };
+    unsigned long long  start;
+
+    for (int useArena = 0; useArena < 2; ++useArena)
+    {
+        S9sArena      *arena = useArena ? new S9sArena : NULL;
+        S9sVariantMap  theMap;
+
+        start = S9sTestData::allocations();
+        S9S_VERIFY(theMap.parse(STR(reply), reply.length(), arena));
+
+        if (arena != NULL)
+            arena->unRef();
+
+        allocations[useArena] = S9sTestData::allocations() - start;
+        S9S_COMPARE(theMap["hosts"].toVariantList().size(), nHosts);
+    }
+
+    S9S_VERIFY(allocations[1] * 4 < allocations[0]);
+
+    return true;
+}
+
+/**
+ * Parses a job list reply eagerly and lazily, reads the fields the brief job
+ * list prints and checks that the lazy parser needs less memory allocations.
+ */
+bool
+UtS9sPerformance::testLazyParse()
+{
+    const int           nJobs   = 1000;
+    S9sString           reply   = S9sTestData::jobsReply(nJobs);
+    unsigned long long  allocations[2] = { 0ull, 0ull };
+    unsigned long long  start;
+
+    for (int lazy = 0; lazy < 2; ++lazy)
+    {
+        S9sVariantMap  theMap;
+        S9sVariantList jobs;
+        int            nFields = 0;
+
+        start = S9sTestData::allocations();
+
+        if (lazy)
+        {
+            S9S_VERIFY(theMap.parseLazy(STR(reply), reply.length()));
+        } else {
+            S9S_VERIFY(theMap.parse(STR(reply), reply.length()));
+        }
+
+        jobs = theMap["jobs"].toVariantList();
+        for (uint idx = 0u; idx < jobs.size(); ++idx)
+        {
+            const S9sVariantMap &job = jobs[idx].toVariantMap();
+
+            nFields += job.at("job_id").toInt() >= 0 ? 1 : 0;
+            nFields += job.at("cluster_id").toInt() > 0 ? 1 : 0;
+            nFields += job.at("user_name").toString().empty() ? 0 : 1;
+            nFields += job.at("group_name").toString().empty() ? 0 : 1;
+            nFields += job.at("status").toString().empty() ? 0 : 1;
+            nFields += job.at("created").toString().empty() ? 0 : 1;
+            nFields += job.at("title").toString().empty() ? 0 : 1;
+        }
+
+        allocations[lazy] = S9sTestData::allocations() - start;
+        S9S_COMPARE(nFields, nJobs * 7);
+    }
+
+    S9S_VERIFY(allocations[1] * 2 < allocations[0]);
+
+    return true;
+}
+
+/**
+ * Looks up a value three levels deep the way the event getters do with the
+ * path that is split once and checks that it needs no memory allocations.
+ */
+bool
+UtS9sPerformance::testPathLookups()
+{
+    const int              nLookups = 1000;
+    const char            *source;
+    const S9sString        pathString("event_specifics/host/hostname");
+    const S9sVariantPath   path(pathString);
+    S9sVariantMap          event;
+    unsigned long long     allocations;
+    int                    nFound = 0;
+
+    source = 
+        "{ \"class_name\": \"CmonEvent\", \"event_class\": \"EventHost\", "
+        "\"event_specifics\": { \"host\": { \"class_name\": "
+        "\"CmonMySqlHost\", \"hostname\": \"10.0.0.1\", \"port\": 3306 }, "
+        "\"cluster_id\": 1 }, \"event_origins\": { \"sender_line\": 10 } }";
+
+    S9S_VERIFY(event.parse(source));
+
+    allocations = S9sTestData::allocations();
+    for (int idx = 0; idx < nLookups; ++idx)
+    {
+        const S9sVariant &value = event.valueByPath(path);
+
+        nFound += value.isString() ? 1 : 0;
+    }
+
+    allocations = S9sTestData::allocations() - allocations;
+
+    S9S_COMPARE(nFound, nLookups);
+    S9S_COMPARE(event.valueByPath(pathString).toString(), "10.0.0.1");
+    S9S_COMPARE(allocations, 0ull);
+
+    return true;
+}
+
+/**
+ * Converts nodes to strings with the format string and with the format string
+ * compiled once, checks that the results are the same and that the compiled
+ * format string needs less memory allocations.
+ */
+bool
+UtS9sPerformance::testFormatString()
+{
+    const int           nNodes = 1000;
+    const S9sString     formatString = 
+        "%5P %8I %-6R %-14S\\t%-20V %N %.12M\\n";
+    S9sFormatProgram    program = S9sNode::compileFormat(formatString);
+    S9sVariantMap       reply = S9sTestData::nodeListReply(nNodes);
+    S9sVariantList      clusters = reply["clusters"].toVariantList();
+    S9sVariantList      hosts = clusters[0u]["hosts"].toVariantList();
+    S9sVector<S9sNode>  nodes;
+    S9sString           lines[2];
+    unsigned long long  allocations[2];
+    unsigned long long  start;
+
+    for (uint idx = 0u; idx < hosts.size(); ++idx)
+        nodes.push_back(S9sNode(hosts[idx].toVariantMap()));
+
+    for (int compiled = 0; compiled < 2; ++compiled)
+    {
+        start = S9sTestData::allocations();
+
+        for (uint idx = 0u; idx < nodes.size(); ++idx)
+        {
+            if (compiled)
+                lines[compiled] += nodes[idx].toString(true, program);
+            else
+                lines[compiled] += nodes[idx].toString(true, formatString);
+        }
+
+        allocations[compiled] = S9sTestData::allocations() - start;
+    }
+
+    S9S_VERIFY(lines[0] == lines[1]);
+    S9S_COMPARE(lines[1].substr(0, 37), 
+            " 3306        0 master CmonHostOnline\t");
+
+    S9S_VERIFY(allocations[1] < allocations[0]);
+
+    return true;
+}
+
+/**
+ * Converts the markup of job messages to terminal escape sequences and to
+ * plain text and checks the memory allocations of one message.
+ */
+bool
+UtS9sPerformance::testHtmlConversion()
+{
+    const int           nMessages = 1000;
+    S9sString           message;
+    S9sString           converted;
+    unsigned long long  allocations;
+
+    message = 
+        "<em style='color: #c66211;'>10.0.0.5</em>:3306: Installing "
+        "<strong style='color: #59a449;'>mysql</strong> from "
+        "<em style='color: #ff00ff;'>percona</em>.<br/>Done.";
+
+    for (int mode = 0; mode < 2; ++mode)
+    {
+        allocations = S9sTestData::allocations();
+
+        for (int idx = 0; idx < nMessages; ++idx)
+        {
+            if (mode == 0)
+                converted = S9sString::html2ansi(message);
+            else
+                converted = S9sString::html2text(message);
+        }
+
+        allocations = S9sTestData::allocations() - allocations;
+        S9S_VERIFY(allocations <= 2ull * nMessages);
+    }
+
+    S9S_COMPARE(converted, 
+            "10.0.0.5:3306: Installing mysql from percona.\nDone.");
+
+    return true;
+}
+
+S9S_UNIT_TEST_MAIN(UtS9sPerformance)
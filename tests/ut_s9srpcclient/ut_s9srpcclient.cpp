@@ -21,6 +21,18 @@
 
 #include "S9sNode"
 #include "S9sOptions"
+#include "S9sMutexLocker"
+#include "S9sFile"
+
+#include <cstring>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <zlib.h>
 
 //#define DEBUG
 #define WARNING
@@ -110,6 +122,28 @@ UtS9sRpcClient::runTest(
     PERFORM_TEST(testCreateReplication,   retval);
     PERFORM_TEST(testCreateNdbCluster,    retval);
     PERFORM_TEST(testAddNode,             retval);
+    PERFORM_TEST(testReplyContentLength,  retval);
+    PERFORM_TEST(testReplyChunked,        retval);
+    PERFORM_TEST(testReplyTrailers,       retval);
+    PERFORM_TEST(testReplyBadChunks,      retval);
+    PERFORM_TEST(testReplyBadContentLength, retval);
+    PERFORM_TEST(testReplyCloseDelimited, retval);
+    PERFORM_TEST(testReplyConnectionClosed, retval);
+    PERFORM_TEST(testBufferAllocation,    retval);
+    PERFORM_TEST(testStreamRecords,       retval);
+    PERFORM_TEST(testCompressedReply,     retval);
+    PERFORM_TEST(testReplyBuffer,         retval);
+    PERFORM_TEST(testSessionFile,         retval);
+    PERFORM_TEST(testSessionResend,       retval);
+    PERFORM_TEST(testBatchOrder,          retval);
+    PERFORM_TEST(testBatchAuthRequired,   retval);
+    PERFORM_TEST(testTlsSessionFile,      retval);
+    PERFORM_TEST(testBestEndpoint,        retval);
+    PERFORM_TEST(testFailOver,            retval);
+    PERFORM_TEST(testProbeControllers,    retval);
+    PERFORM_TEST(testBatchNextAddress,    retval);
+    PERFORM_TEST(testResolveAgain,        retval);
+    PERFORM_TEST(testBatchAbort,          retval);
 
     return retval;
 }
@@ -645,5 +679,1724 @@ UtS9sRpcClient::testAddNode()
     return true;
 }
 
+/**
+ * The reply with a Content-Length header, received in one piece and split
+ * into small pieces.
+ */
+bool
+UtS9sRpcClient::testReplyContentLength()
+{
+    S9sRpcClientPrivate priv;
+    S9sString           reply = 
+        "HTTP/1.1 200 OK\r\n"
+        "Server: cmon\r\n"
+        "Content-Length: 8\r\n"
+        "\r\n"
+        "{\"x\": 1}";
+
+    for (size_t pieceSize = 1; pieceSize <= reply.length(); ++pieceSize)
+    {
+        S9S_COMPARE(feedReply(priv, reply, pieceSize), 
+                S9sRpcClientPrivate::Finished);
+
+        S9S_COMPARE(replyBody(priv), "{\"x\": 1}");
+        S9S_VERIFY(priv.m_serverKeepsAlive);
+    }
+
+    // The headers are not complete yet.
+    S9S_COMPARE(feedReply(priv, "HTTP/1.1 200 OK\r\nContent-Le", 3),
+            S9sRpcClientPrivate::Receiving);
+
+    // The body is not complete yet.
+    S9S_COMPARE(feedReply(priv, reply.substr(0, reply.length() - 1), 7),
+            S9sRpcClientPrivate::Receiving);
+
+    return true;
+}
+
+/**
+ * The reply in chunked transfer encoding with a chunk extension, received in
+ * pieces of every size.
+ */
+bool
+UtS9sRpcClient::testReplyChunked()
+{
+    S9sRpcClientPrivate priv;
+    S9sString           reply = 
+        "HTTP/1.1 200 OK\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n"
+        "4\r\n"
+        "{\"x\"\r\n"
+        "4;name=value\r\n"
+        ": 1}\r\n"
+        "0\r\n"
+        "\r\n";
+
+    for (size_t pieceSize = 1; pieceSize <= reply.length(); ++pieceSize)
+    {
+        S9S_COMPARE(feedReply(priv, reply, pieceSize), 
+                S9sRpcClientPrivate::Finished);
+
+        S9S_COMPARE(replyBody(priv), "{\"x\": 1}");
+        S9S_VERIFY(priv.m_serverKeepsAlive);
+    }
+
+    // The empty line after the last chunk is missing.
+    S9S_COMPARE(feedReply(priv, reply.substr(0, reply.length() - 2), 1),
+            S9sRpcClientPrivate::Receiving);
+
+    return true;
+}
+
+/**
+ * The last chunk of the reply followed by trailers.
+ */
+bool
+UtS9sRpcClient::testReplyTrailers()
+{
+    S9sRpcClientPrivate priv;
+    S9sString           reply = 
+        "HTTP/1.1 200 OK\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n"
+        "a\r\n"
+        "0123456789\r\n"
+        "0\r\n"
+        "X-Checksum: 42\r\n"
+        "X-Other: 43\r\n"
+        "\r\n";
+
+    for (size_t pieceSize = 1; pieceSize <= reply.length(); ++pieceSize)
+    {
+        S9S_COMPARE(feedReply(priv, reply, pieceSize), 
+                S9sRpcClientPrivate::Finished);
+
+        S9S_COMPARE(replyBody(priv), "0123456789");
+    }
+
+    S9S_COMPARE(feedReply(priv, reply.substr(0, reply.length() - 2), 5),
+            S9sRpcClientPrivate::Receiving);
+
+    return true;
+}
+
+/**
+ * Invalid chunk sizes and chunks without the closing CRLF fail the request,
+ * they are not taken as the last chunk.
+ */
+bool
+UtS9sRpcClient::testReplyBadChunks()
+{
+    S9sRpcClientPrivate priv;
+    S9sString           header = 
+        "HTTP/1.1 200 OK\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n";
+    const char *chunks[] = 
+    {
+        "ffffffffffffffff\r\nabc\r\n0\r\n\r\n",
+        "fffffffffffffffff\r\nabc\r\n0\r\n\r\n",
+        "7fffffff\r\nabc\r\n0\r\n\r\n",
+        "zz\r\nabc\r\n0\r\n\r\n",
+        "\r\nabc\r\n0\r\n\r\n",
+        " 3\r\nabc\r\n0\r\n\r\n",
+        "-3\r\nabc\r\n0\r\n\r\n",
+        "3x\r\nabc\r\n0\r\n\r\n",
+        "3\r\nabcXY0\r\n\r\n",
+        "3\r\nabc\n0\r\n\r\n",
+        NULL
+    };
+
+    for (int idx = 0; chunks[idx] != NULL; ++idx)
+    {
+        S9S_COMPARE(feedReply(priv, header + chunks[idx], 1000),
+                S9sRpcClientPrivate::Failed);
+
+        S9S_COMPARE(feedReply(priv, header + chunks[idx], 1),
+                S9sRpcClientPrivate::Failed);
+
+        S9S_VERIFY(!priv.m_errorString.empty());
+    }
+
+    return true;
+}
+
+/**
+ * Content-Length values that are not numbers or are too large fail the
+ * request before anything is allocated for the body.
+ */
+bool
+UtS9sRpcClient::testReplyBadContentLength()
+{
+    S9sRpcClientPrivate priv;
+    const char *values[] = 
+    {
+        "99999999999999999999",
+        "9223372036854775808",
+        "18446744073709551615",
+        "2147483648",
+        "-1",
+        "12abc",
+        "0x10",
+        "",
+        NULL
+    };
+
+    for (int idx = 0; values[idx] != NULL; ++idx)
+    {
+        S9sString reply;
+
+        reply.sprintf(
+                "HTTP/1.1 200 OK\r\n"
+                "Content-Length: %s\r\n"
+                "\r\n"
+                "{}", 
+                values[idx]);
+
+        S9S_COMPARE(feedReply(priv, reply, 1000),
+                S9sRpcClientPrivate::Failed);
+
+        S9S_VERIFY(priv.m_errorString.contains("Content-Length"));
+        S9S_VERIFY(priv.m_bufferSize < 1024 * 1024);
+    }
+
+    return true;
+}
+
+/**
+ * The reply without framing is read until the controller closes the
+ * connection, and then the connection is not kept.
+ */
+bool
+UtS9sRpcClient::testReplyCloseDelimited()
+{
+    S9sRpcClientPrivate priv;
+    S9sString           reply = 
+        "HTTP/1.1 200 OK\r\n"
+        "\r\n"
+        "{\"x\": 1}";
+
+    S9S_COMPARE(feedReply(priv, reply, 3), S9sRpcClientPrivate::Receiving);
+    S9S_COMPARE(priv.receivedData("", 0), S9sRpcClientPrivate::Finished);
+    S9S_COMPARE(replyBody(priv), "{\"x\": 1}");
+    S9S_VERIFY(!priv.m_serverKeepsAlive);
+
+    // HTTP/1.0 closes the connection after the reply by default.
+    reply = 
+        "HTTP/1.0 200 OK\r\n"
+        "Content-Length: 2\r\n"
+        "\r\n"
+        "{}";
+
+    S9S_COMPARE(feedReply(priv, reply, 3), S9sRpcClientPrivate::Finished);
+    S9S_VERIFY(!priv.m_serverKeepsAlive);
+    
+    reply = 
+        "HTTP/1.1 200 OK\r\n"
+        "Connection: close\r\n"
+        "Content-Length: 2\r\n"
+        "\r\n"
+        "{}";
+
+    S9S_COMPARE(feedReply(priv, reply, 3), S9sRpcClientPrivate::Finished);
+    S9S_VERIFY(!priv.m_serverKeepsAlive);
+
+    return true;
+}
+
+/**
+ * A kept connection closed by the controller before sending anything is
+ * reported as ConnectionClosed, so the request is sent again on a new
+ * connection. Closing it in the middle of the reply is an error.
+ */
+bool
+UtS9sRpcClient::testReplyConnectionClosed()
+{
+    S9sRpcClientPrivate priv;
+
+    priv.startReceiving();
+    S9S_COMPARE(priv.receivedData("", 0), 
+            S9sRpcClientPrivate::ConnectionClosed);
+    
+    S9S_COMPARE(
+            feedReply(priv, "HTTP/1.1 200 OK\r\nContent-Length: 8\r\n", 4),
+            S9sRpcClientPrivate::Receiving);
+    S9S_COMPARE(priv.receivedData("", 0), S9sRpcClientPrivate::Failed);
+
+    S9S_COMPARE(
+            feedReply(priv, 
+                "HTTP/1.1 200 OK\r\nContent-Length: 8\r\n\r\n{}", 4),
+            S9sRpcClientPrivate::Receiving);
+    S9S_COMPARE(priv.receivedData("", 0), S9sRpcClientPrivate::Failed);
+    
+    S9S_COMPARE(
+            feedReply(priv, 
+                "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+                "2\r\n{}\r\n", 4),
+            S9sRpcClientPrivate::Receiving);
+    S9S_COMPARE(priv.receivedData("", 0), S9sRpcClientPrivate::Failed);
+
+    return true;
+}
+
+/**
+ * A failed allocation leaves the buffer as it was and it is reported as an
+ * error.
+ */
+bool
+UtS9sRpcClient::testBufferAllocation()
+{
+    S9sRpcClientPrivate priv;
+    char               *buffer;
+
+    S9S_VERIFY(priv.ensureHasBuffer(100));
+    S9S_COMPARE(priv.m_bufferSize, 100);
+    
+    // Growing geometrically.
+    S9S_VERIFY(priv.ensureHasBuffer(101));
+    S9S_COMPARE(priv.m_bufferSize, 200);
+
+    buffer = priv.m_buffer;
+    memcpy(buffer, "data", 5);
+
+    S9S_VERIFY(!priv.ensureHasBuffer(((size_t) -1) / 2));
+    S9S_VERIFY(!priv.m_errorString.empty());
+    S9S_VERIFY(priv.m_buffer == buffer);
+    S9S_COMPARE(priv.m_bufferSize, 200);
+    S9S_COMPARE(S9sString(priv.m_buffer), "data");
+
+    return true;
+}
+
+/**
+ * The records of a JSON stream are found when the stream is read in pieces of
+ * different sizes, the records separated by '\\036' and by empty lines both.
+ */
+bool
+UtS9sRpcClient::testStreamRecords()
+{
+    S9sString  stream;
+    S9sString  emptyLines = "{\"id\": 0}\n\n{\"id\": 1}\n\n\n{\"id\": 2}";
+    size_t     pieceSizes[] = { 1, 2, 7, 100, 4096, READ_SIZE - 1 };
+
+    for (int idx = 0; idx < 300; ++idx)
+    {
+        S9sString record;
+
+        record.sprintf("\036{\"id\": %d, \"data\": \"%s\"}\n",
+                idx, STR(S9sString(std::string(idx * 7 % 500, 'x'))));
+
+        stream += record;
+    }
+
+    for (uint size = 0u; size < sizeof(pieceSizes) / sizeof(size_t); ++size)
+    {
+        S9sRpcClientPrivate priv;
+        S9sVariantList      records;
+
+        S9S_VERIFY(feedStream(priv, stream, pieceSizes[size], records));
+        S9S_COMPARE(records.size(), 300);
+
+        for (uint idx = 0u; idx < records.size(); ++idx)
+        {
+            S9S_COMPARE(records[idx].toVariantMap().at("id").toInt(), 
+                    (int) idx);
+        }
+
+        records.clear();
+        S9S_VERIFY(feedStream(priv, emptyLines, pieceSizes[size], records));
+        S9S_COMPARE(records.size(), 3);
+        
+        for (uint idx = 0u; idx < records.size(); ++idx)
+        {
+            S9S_COMPARE(records[idx].toVariantMap().at("id").toInt(), 
+                    (int) idx);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * \returns The state of the request after the reply is processed.
+ *
+ * Feeds the reply to the client in pieces as if it was read from the socket
+ * in several reads. Stops when the request gets to a final state.
+ */
+S9sRpcClientPrivate::RequestState
+UtS9sRpcClient::feedReply(
+        S9sRpcClientPrivate &priv,
+        const S9sString     &reply,
+        size_t               pieceSize)
+{
+    S9sRpcClientPrivate::RequestState state = S9sRpcClientPrivate::Receiving;
+
+    priv.startReceiving();
+    priv.m_errorString.clear();
+
+    for (size_t offset = 0; offset < reply.length(); offset += pieceSize)
+    {
+        size_t length = reply.length() - offset;
+
+        if (length > pieceSize)
+            length = pieceSize;
+
+        state = priv.receivedData(reply.c_str() + offset, length);
+        if (state != S9sRpcClientPrivate::Receiving)
+            break;
+    }
+
+    return state;
+}
+
+/**
+ * \returns false if a record could not be parsed.
+ *
+ * Feeds the JSON stream to the client in pieces the way the stream is read
+ * from the socket: the processed records are dropped from the buffer before
+ * every read and the records are taken from the buffer after every read.
+ */
+bool
+UtS9sRpcClient::feedStream(
+        S9sRpcClientPrivate &priv,
+        const S9sString     &stream,
+        size_t               pieceSize,
+        S9sVariantList      &records)
+{
+    size_t offset = 0;
+    bool   atEnd  = false;
+
+    priv.clearBuffer();
+
+    while (!atEnd)
+    {
+        const char *record;
+        size_t      recordLength;
+        size_t      length = stream.length() - offset;
+
+        if (length > pieceSize)
+            length = pieceSize;
+
+        priv.compactBuffer();
+        if (!priv.ensureHasBuffer(priv.m_dataSize + READ_SIZE))
+            return false;
+
+        memcpy(priv.m_buffer + priv.m_dataSize, stream.c_str() + offset, 
+                length);
+
+        priv.m_dataSize += length;
+        offset          += length;
+        atEnd            = length == 0;
+
+        while (priv.nextRecord(record, recordLength, atEnd))
+        {
+            S9sVariantMap map;
+
+            if (!map.parse(std::string(record, recordLength).c_str()))
+                return false;
+
+            records << map;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * \returns The body of the reply that is received.
+ */
+S9sString
+UtS9sRpcClient::replyBody(
+        const S9sRpcClientPrivate &priv) const
+{
+    return std::string(priv.m_buffer + priv.m_headerLength, priv.m_bodyLength);
+}
+
+/**
+ * The compressed replies are received from the controller stand-in and
+ * decompressed while they are parsed, both with and without keep-alive. The
+ * replies that can not be decompressed are errors.
+ */
+bool
+UtS9sRpcClient::testCompressedReply()
+{
+    S9sString body = 
+        "{\"request_status\": \"Ok\", \"request_id\": 1, "
+        "\"data\": \"" + S9sString(std::string(100000, 'x')) + "\"}";
+
+    for (int keepAlive = 0; keepAlive < 2; ++keepAlive)
+    {
+        S9sControllerStandIn controller;
+        S9sRpcClient         client("127.0.0.1", 0, "", false);
+
+        controller.addReply(S9sControllerStandIn::httpReply(
+                    gzipped(body), "Content-Encoding: gzip\r\n"));
+        
+        controller.addReply(S9sControllerStandIn::httpReply(
+                    gzipped(body).substr(0, 100), 
+                    "Content-Encoding: gzip\r\n"));
+        
+        controller.addReply(S9sControllerStandIn::httpReply(
+                    "this is not compressed", 
+                    "Content-Encoding: gzip\r\n"));
+        
+        S9S_VERIFY(controller.listen());
+
+        client.m_priv->m_port = controller.port();
+        client.setKeepAlive(keepAlive);
+        client.setCompression(true);
+
+        S9S_VERIFY(client.ping());
+        S9S_VERIFY(client.reply().isOk());
+        S9S_COMPARE(client.reply().at("data").toString().length(), 100000);
+        S9S_VERIFY(controller.header(0).contains(
+                    "Accept-Encoding: gzip, deflate\r\n"));
+
+        S9S_VERIFY(!client.ping());
+        S9S_COMPARE(client.errorString(), "The compressed data is truncated.");
+        
+        S9S_VERIFY(!client.ping());
+        S9S_VERIFY(client.errorString().startsWith("Error decompressing"));
+
+        controller.stop();
+        S9S_COMPARE(controller.nRequests(), 3);
+    }
+
+    return true;
+}
+
+/**
+ * The reply is parsed in the buffer it was received in, the reply keeps the
+ * buffer and the next reply is received in a new one. A reply that can not be
+ * parsed, even if the error is in a map that is not loaded yet, leaves the
+ * buffer to the client.
+ */
+bool
+UtS9sRpcClient::testReplyBuffer()
+{
+    S9sControllerStandIn controller;
+    S9sRpcClient         client("127.0.0.1", 0, "", false);
+    S9sRpcReply          first;
+    S9sRpcReply          second;
+
+    controller.addReply(S9sControllerStandIn::httpReply(
+                "{\"request_status\": \"Ok\", "
+                "\"hosts\": [ { \"hostname\": \"192.168.0.1\" } ]}"));
+    
+    controller.addReply(S9sControllerStandIn::httpReply(
+                "{\"request_status\": \"Ok\", "
+                "\"hosts\": [ { \"hostname\": \"192.168.0.2\" } ]}"));
+
+    controller.addReply(S9sControllerStandIn::httpReply(
+                "{\"request_status\": \"Ok\", \"hosts\" [ ]}"));
+    
+    controller.addReply(S9sControllerStandIn::httpReply(
+                "{\"request_status\": \"Ok\", "
+                "\"hosts\": [ { \"port\": 3306 \"hostname\": 1 } ]}"));
+
+    S9S_VERIFY(controller.listen());
+    client.m_priv->m_port = controller.port();
+
+    S9S_VERIFY(client.ping());
+    S9S_VERIFY(client.m_priv->m_buffer == NULL);
+    first = client.reply();
+
+    S9S_VERIFY(client.ping());
+    S9S_VERIFY(client.m_priv->m_buffer == NULL);
+    second = client.reply();
+
+    // The first reply is loaded from its own buffer.
+    S9S_COMPARE(
+            first["hosts"][0]["hostname"].toString(), "192.168.0.1");
+    S9S_COMPARE(
+            second["hosts"][0]["hostname"].toString(), "192.168.0.2");
+
+    S9S_VERIFY(!client.ping());
+    S9S_COMPARE(client.errorString(), "Error parsing JSON reply.");
+    S9S_VERIFY(client.m_priv->m_buffer != NULL);
+
+    // The errors deep in the reply are found before the values are loaded.
+    S9S_VERIFY(!client.ping());
+    S9S_COMPARE(client.errorString(), "Error parsing JSON reply.");
+
+    controller.stop();
+    return true;
+}
+
+/**
+ * The saved session is loaded only by the same user for the same controller,
+ * only until it expires and only if the file is not accessible by others.
+ */
+bool
+UtS9sRpcClient::testSessionFile()
+{
+    S9sOptions          *options  = S9sOptions::instance();
+    S9sString            fileName = sessionFileName();
+    S9sRpcClientPrivate  saver;
+    struct stat          fileStat;
+    S9sString            tmpFile;
+    char                 buffer[16];
+    int                  reader;
+
+    options->m_options.clear();
+    options->m_options["cmon_user"] = "pipas";
+
+    saver.m_hostName        = "127.0.0.1";
+    saver.m_port            = 9501;
+    saver.m_sessionFile     = fileName;
+    saver.m_sessionLifetime = 3600;
+    saver.m_cookies["cmon-sid"] = "0123456789";
+
+    // A file left by an other program, with permissions too broad.
+    S9S_VERIFY(S9sFile(fileName).writeTxtFile("{}"));
+    S9S_COMPARE(::chmod(STR(fileName), 0644), 0);
+
+    // A process reading the old file while the new one is saved.
+    reader = ::open(STR(fileName), O_RDONLY);
+    S9S_VERIFY(reader >= 0);
+
+    saver.saveSession();
+    S9S_COMPARE(::stat(STR(fileName), &fileStat), 0);
+    S9S_COMPARE(fileStat.st_mode & 0777, 0600);
+
+    // The old file is replaced, not truncated, and no temporary file is left.
+    S9S_VERIFY(::read(reader, buffer, sizeof(buffer)) == 2);
+    ::close(reader);
+
+    tmpFile.sprintf("%s.%d", STR(fileName), (int) getpid());
+    S9S_VERIFY(::access(STR(tmpFile), F_OK) != 0);
+
+    {
+        S9sRpcClientPrivate loader;
+
+        loader.m_hostName    = "127.0.0.1";
+        loader.m_port        = 9501;
+        loader.m_sessionFile = fileName;
+
+        S9S_VERIFY(loader.loadSession());
+        S9S_VERIFY(loader.m_sessionFromFile);
+        S9S_COMPARE(loader.m_cookies["cmon-sid"].toString(), "0123456789");
+
+        // An other controller.
+        loader.m_port = 9502;
+        S9S_VERIFY(!loader.loadSession());
+        loader.m_port = 9501;
+
+        // An other user.
+        options->m_options["cmon_user"] = "system";
+        S9S_VERIFY(!loader.loadSession());
+        options->m_options["cmon_user"] = "pipas";
+
+        // Readable by others.
+        S9S_COMPARE(::chmod(STR(fileName), 0640), 0);
+        S9S_VERIFY(!loader.loadSession());
+        S9S_COMPARE(::chmod(STR(fileName), 0600), 0);
+        S9S_VERIFY(loader.loadSession());
+
+        // Owned by an other user, only root can try this.
+        if (getuid() == 0)
+        {
+            S9S_COMPARE(::chown(STR(fileName), 1, (gid_t) -1), 0);
+            S9S_VERIFY(!loader.loadSession());
+            S9S_COMPARE(::chown(STR(fileName), 0, (gid_t) -1), 0);
+            S9S_VERIFY(loader.loadSession());
+        }
+    }
+
+    // The session expired.
+    saver.m_sessionLifetime = 0;
+    saver.saveSession();
+
+    {
+        S9sRpcClientPrivate loader;
+
+        loader.m_hostName    = "127.0.0.1";
+        loader.m_port        = 9501;
+        loader.m_sessionFile = fileName;
+
+        S9S_VERIFY(!loader.loadSession());
+        S9S_VERIFY(!loader.m_sessionFromFile);
+        S9S_VERIFY(loader.m_cookies.empty());
+
+        loader.removeSession();
+        S9S_VERIFY(!S9sFile(fileName).exists());
+    }
+
+    options->m_options.clear();
+    return true;
+}
+
+/**
+ * The controller does not accept the saved session: the client removes it,
+ * authenticates, saves the new session and sends the request again.
+ */
+bool
+UtS9sRpcClient::testSessionResend()
+{
+    S9sOptions           *options  = S9sOptions::instance();
+    S9sString             fileName = sessionFileName();
+    S9sControllerStandIn  controller;
+    S9sString             content;
+    S9sVariantMap         session;
+
+    options->m_options.clear();
+    options->m_options["cmon_user"] = "pipas";
+    options->m_options["password"]  = "secret";
+
+    controller.addReply(S9sControllerStandIn::httpReply(
+                "{\"request_status\": \"AuthRequired\"}"));
+
+    controller.addReply(S9sControllerStandIn::httpReply(
+                "{\"request_status\": \"Ok\"}",
+                "Set-Cookie: cmon-sid=new; Path=/\r\n"));
+
+    S9S_VERIFY(controller.listen());
+
+    {
+        S9sRpcClientPrivate saver;
+
+        saver.m_hostName        = "127.0.0.1";
+        saver.m_port            = controller.port();
+        saver.m_sessionFile     = fileName;
+        saver.m_sessionLifetime = 3600;
+        saver.m_cookies["cmon-sid"] = "old";
+        saver.saveSession();
+    }
+
+    S9sRpcClient client("127.0.0.1", controller.port(), "", false);
+
+    client.setSessionFile(fileName, 3600);
+    S9S_VERIFY(client.maybeAuthenticate());
+    S9S_VERIFY(client.m_priv->m_sessionFromFile);
+
+    S9S_VERIFY(client.ping());
+    S9S_VERIFY(client.reply().isOk());
+    S9S_VERIFY(!client.m_priv->m_sessionFromFile);
+
+    controller.stop();
+    S9S_COMPARE(controller.nRequests(), 3);
+    S9S_VERIFY(controller.header(0).contains("Cookie: cmon-sid=old\r\n"));
+    S9S_COMPARE(controller.request(0).at("operation").toString(), "ping");
+    S9S_COMPARE(controller.request(1).at("operation").toString(), 
+            "authenticateWithPassword");
+    S9S_VERIFY(!controller.header(1).contains("cmon-sid"));
+    S9S_VERIFY(controller.header(2).contains("Cookie: cmon-sid=new\r\n"));
+    S9S_COMPARE(controller.request(2).at("operation").toString(), "ping");
+    S9S_VERIFY(controller.request(2).at("request_id").toInt() > 
+            controller.request(0).at("request_id").toInt());
+
+    // The new session is saved.
+    S9S_VERIFY(S9sFile(fileName).readTxtFile(content));
+    S9S_VERIFY(session.parse(STR(content)));
+    S9S_COMPARE(session["cookies"]["cmon-sid"].toString(), "new");
+
+    ::unlink(STR(fileName));
+    options->m_options.clear();
+
+    return true;
+}
+
+/**
+ * The requests of the batch are sent concurrently and the controller stand-in
+ * answers them in the reverse order, the replies are still returned in the
+ * order the requests were recorded.
+ */
+bool
+UtS9sRpcClient::testBatchOrder()
+{
+    S9sOptions             *options = S9sOptions::instance();
+    S9sControllerStandIn    controller;
+    S9sVector<S9sRpcReply>  replies;
+    const char             *names[] = { "cpustat", "sqlstat", "memorystat" };
+
+    options->m_options.clear();
+    controller.holdReplies(3u);
+    S9S_VERIFY(controller.listen());
+
+    S9sRpcClient client("127.0.0.1", controller.port(), "", false);
+
+    client.beginBatch();
+    S9S_VERIFY(client.getCpuStats(1));
+    S9S_VERIFY(client.getSqlStats(1));
+    S9S_VERIFY(client.getMemStats(1));
+    S9S_COMPARE(controller.nRequests(), 0);
+
+    S9S_VERIFY(client.executeBatch(replies));
+    S9S_COMPARE(replies.size(), 3);
+    S9S_COMPARE(controller.nRequests(), 3);
+
+    for (uint idx = 0u; idx < replies.size(); ++idx)
+    {
+        int requestId = replies[idx].at("request_id").toInt();
+        
+        S9S_VERIFY(replies[idx].isOk());
+
+        if (idx > 0u)
+        {
+            S9S_VERIFY(requestId > 
+                    replies[idx - 1].at("request_id").toInt());
+        }
+
+        for (uint req = 0u; req < controller.nRequests(); ++req)
+        {
+            S9sVariantMap request = controller.request(req);
+
+            if (request.at("request_id").toInt() == requestId)
+            {
+                S9S_COMPARE(request.at("name").toString(), names[idx]);
+            }
+        }
+    }
+
+    // Not in batch mode any more.
+    S9S_VERIFY(client.ping());
+    S9S_COMPARE(controller.nRequests(), 4);
+    S9S_COMPARE(client.reply().at("operation").toString(), "ping");
+
+    return true;
+}
+
+/**
+ * The controller does not accept the saved session the batch is sent with:
+ * the client authenticates and sends the whole batch again with new request
+ * IDs.
+ */
+bool
+UtS9sRpcClient::testBatchAuthRequired()
+{
+    S9sOptions             *options = S9sOptions::instance();
+    S9sControllerStandIn    controller;
+    S9sVector<S9sRpcReply>  replies;
+
+    options->m_options.clear();
+    options->m_options["cmon_user"] = "pipas";
+    options->m_options["password"]  = "secret";
+
+    controller.addReply(S9sControllerStandIn::httpReply(
+                "{\"request_status\": \"AuthRequired\"}"));
+
+    controller.addReply(S9sControllerStandIn::httpReply(
+                "{\"request_status\": \"AuthRequired\"}"));
+
+    controller.addReply(S9sControllerStandIn::httpReply(
+                "{\"request_status\": \"Ok\"}",
+                "Set-Cookie: cmon-sid=new; Path=/\r\n"));
+
+    S9S_VERIFY(controller.listen());
+
+    S9sRpcClient client("127.0.0.1", controller.port(), "", false);
+
+    client.m_priv->m_cookies["cmon-sid"] = "old";
+    client.m_priv->m_sessionFromFile     = true;
+
+    client.beginBatch();
+    S9S_VERIFY(client.getCpuStats(1));
+    S9S_VERIFY(client.getMemStats(1));
+    S9S_VERIFY(client.executeBatch(replies));
+
+    controller.stop();
+    S9S_COMPARE(controller.nRequests(), 5);
+    S9S_COMPARE(controller.request(2).at("operation").toString(), 
+            "authenticateWithPassword");
+
+    S9S_COMPARE(replies.size(), 2);
+    for (uint idx = 0u; idx < replies.size(); ++idx)
+    {
+        S9S_VERIFY(replies[idx].isOk());
+        S9S_VERIFY(replies[idx].at("request_id").toInt() > 
+                controller.request(2).at("request_id").toInt());
+    }
+
+    for (uint idx = 0u; idx < controller.nRequests(); ++idx)
+    {
+        S9sString header = controller.header(idx);
+        
+        if (idx < 2u)
+        {
+            S9S_VERIFY(header.contains("Cookie: cmon-sid=old\r\n"));
+        } else if (idx > 2u)
+        {
+            S9S_VERIFY(header.contains("Cookie: cmon-sid=new\r\n"));
+        }
+    }
+
+    S9S_VERIFY(!client.m_priv->m_sessionFromFile);
+    options->m_options.clear();
+
+    return true;
+}
+
+/**
+ * Every controller has its own TLS session file, the one set is for the
+ * controller the client was created with.
+ */
+bool
+UtS9sRpcClient::testTlsSessionFile()
+{
+    S9sRpcClient client("cc1", 9501, "", true);
+
+    S9S_COMPARE(client.m_priv->tlsSessionFile(), "");
+
+    client.setTlsSessionFile("/tmp/s9s/cc1_9501.tls_session");
+    client.addController("cc2", 9502, "", true);
+    S9S_COMPARE(client.m_priv->tlsSessionFile(), 
+            "/tmp/s9s/cc1_9501.tls_session");
+
+    client.m_priv->useEndpoint(1u);
+    S9S_COMPARE(client.m_priv->tlsSessionFile(), 
+            "/tmp/s9s/cc2_9502.tls_session");
+    
+    client.m_priv->useEndpoint(0u);
+    S9S_COMPARE(client.m_priv->tlsSessionFile(), 
+            "/tmp/s9s/cc1_9501.tls_session");
+
+    client.setTlsSessionFile("");
+    S9S_COMPARE(client.m_priv->tlsSessionFile(), "");
+
+    return true;
+}
+
+/**
+ * The fastest controller that did not fail is the best, the ones that were
+ * not probed come after the probed ones in the order they were added.
+ */
+bool
+UtS9sRpcClient::testBestEndpoint()
+{
+    S9sRpcClient client("cc1", 9501, "", true);
+    S9sVector<S9sRpcClientPrivate::Endpoint> &endpoints = 
+        client.m_priv->m_endpoints;
+
+    S9S_COMPARE(client.m_priv->bestEndpoint(), -1);
+
+    client.addController("cc2", 9501, "", true);
+    client.addController("cc3", 9501, "", true);
+    client.addController("cc4", 9501, "", true);
+    S9S_COMPARE(endpoints.size(), 4);
+    S9S_COMPARE(endpoints[0].hostName, "cc1");
+
+    // None of them probed.
+    S9S_COMPARE(client.m_priv->bestEndpoint(), 0);
+
+    endpoints[0].failed = true;
+    S9S_COMPARE(client.m_priv->bestEndpoint(), 1);
+
+    // The probed ones are preferred, the fastest one first.
+    endpoints[2].latency = 30;
+    endpoints[3].latency = 10;
+    S9S_COMPARE(client.m_priv->bestEndpoint(), 3);
+    
+    endpoints[0].failed  = false;
+    endpoints[0].latency = 20;
+    S9S_COMPARE(client.m_priv->bestEndpoint(), 3);
+
+    endpoints[3].failed = true;
+    S9S_COMPARE(client.m_priv->bestEndpoint(), 0);
+
+    for (uint idx = 0u; idx < endpoints.size(); ++idx)
+        endpoints[idx].failed = true;
+
+    S9S_COMPARE(client.m_priv->bestEndpoint(), -1);
+
+    return true;
+}
+
+/**
+ * The first controller refuses the connection, the client fails over to the
+ * fastest of the others, drops the session cookies, authenticates on the new
+ * controller and sends the request again. Both with and without keep-alive.
+ */
+bool
+UtS9sRpcClient::testFailOver()
+{
+    S9sOptions *options = S9sOptions::instance();
+
+    options->m_options.clear();
+    options->m_options["cmon_user"] = "pipas";
+    options->m_options["password"]  = "secret";
+
+    for (int keepAlive = 0; keepAlive < 2; ++keepAlive)
+    {
+        S9sControllerStandIn  slow;
+        S9sControllerStandIn  fast;
+        int                   downPort = refusedPort();
+
+        fast.addReply(S9sControllerStandIn::httpReply(
+                    "{\"request_status\": \"AuthRequired\"}"));
+
+        S9S_VERIFY(slow.listen());
+        S9S_VERIFY(fast.listen());
+
+        S9sRpcClient client("127.0.0.1", downPort, "", false);
+
+        client.setKeepAlive(keepAlive);
+        client.addController("127.0.0.1", slow.port(), "", false);
+        client.addController("127.0.0.1", fast.port(), "", false);
+        client.m_priv->m_endpoints[1].latency = 50;
+        client.m_priv->m_endpoints[2].latency = 5;
+        client.m_priv->m_cookies["cmon-sid"]  = "old";
+
+        S9S_VERIFY(client.ping());
+        S9S_VERIFY(client.reply().isOk());
+        S9S_COMPARE(client.reply().at("operation").toString(), "ping");
+
+        S9S_COMPARE(client.m_priv->m_port, fast.port());
+        S9S_COMPARE(client.m_priv->m_endpointIndex, 2);
+        S9S_VERIFY(client.m_priv->m_endpoints[0].failed);
+        S9S_VERIFY(!client.m_priv->m_failedOver);
+
+        fast.stop();
+        slow.stop();
+        S9S_COMPARE(slow.nRequests(), 0);
+        S9S_COMPARE(fast.nRequests(), 3);
+        S9S_VERIFY(!fast.header(0).contains("cmon-sid"));
+        S9S_COMPARE(fast.request(1).at("operation").toString(), 
+                "authenticateWithPassword");
+        S9S_COMPARE(fast.request(2).at("operation").toString(), "ping");
+    }
+
+    options->m_options.clear();
+    return true;
+}
+
+/**
+ * Probing the controllers marks the one that refuses the connection as
+ * failed and switches to one that answered.
+ */
+bool
+UtS9sRpcClient::testProbeControllers()
+{
+    S9sOptions           *options = S9sOptions::instance();
+    S9sControllerStandIn  controller;
+    int                   downPort = refusedPort();
+
+    options->m_options.clear();
+    S9S_VERIFY(controller.listen());
+
+    S9sRpcClient client("127.0.0.1", downPort, "", false);
+
+    // Only one controller, nothing to probe.
+    S9S_VERIFY(client.probeControllers());
+    S9S_COMPARE(client.m_priv->m_port, downPort);
+
+    client.addController("127.0.0.1", controller.port(), "", false);
+    S9S_VERIFY(client.probeControllers());
+    
+    S9S_COMPARE(client.m_priv->m_port, controller.port());
+    S9S_VERIFY(client.m_priv->m_endpoints[0].failed);
+    S9S_VERIFY(!client.m_priv->m_endpoints[1].failed);
+    S9S_VERIFY(client.m_priv->m_endpoints[1].latency >= 0);
+    S9S_COMPARE(controller.nRequests(), 1);
+    S9S_COMPARE(controller.request(0).at("operation").toString(), "ping");
+
+    // None of them answers.
+    controller.stop();
+    client.m_priv->m_endpoints[1].port = refusedPort();
+    S9S_VERIFY(!client.probeControllers());
+    S9S_VERIFY(!client.errorString().empty());
+
+    return true;
+}
+
+/**
+ * The host name of the controller resolves to two addresses and the first one
+ * refuses the connections only while the event loop waits for them: the
+ * requests of the batch connect to the second address from the event loop. The
+ * new sockets usually get the file descriptors of the closed ones, they still
+ * have to be watched.
+ */
+bool
+UtS9sRpcClient::testBatchNextAddress()
+{
+    S9sOptions             *options = S9sOptions::instance();
+    S9sControllerStandIn    controller;
+    S9sBusyListener         busy;
+    S9sVector<S9sRpcReply>  replies;
+    S9sString               key;
+    S9sString               service;
+    struct addrinfo         hints;
+    struct addrinfo        *first  = NULL;
+    struct addrinfo        *second = NULL;
+    long long               started;
+
+    options->m_options.clear();
+    S9S_VERIFY(controller.listen());
+    S9S_VERIFY(busy.listen());
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family   = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+
+    service.sprintf("%d", busy.port());
+    S9S_VERIFY(getaddrinfo("127.0.0.1", STR(service), &hints, &first) == 0);
+    
+    service.sprintf("%d", controller.port());
+    S9S_VERIFY(getaddrinfo("127.0.0.1", STR(service), &hints, &second) == 0);
+
+    // The addresses of the host name as if it was resolved.
+    first->ai_next = second;
+    key.sprintf("controller.invalid:%d", controller.port());
+    S9sRpcClientPrivate::sm_addresses[key]     = first;
+    S9sRpcClientPrivate::sm_addressRefs[first] = 1;
+
+    S9sRpcClient client("controller.invalid", controller.port(), "", false);
+
+    client.setTimeouts(5000, 5000);
+    client.beginBatch();
+    S9S_VERIFY(client.getCpuStats(1));
+    S9S_VERIFY(client.getSqlStats(1));
+    S9S_VERIFY(client.getMemStats(1));
+
+    started = S9sRpcClientPrivate::monotonicMs();
+    busy.closeAfter(200);
+    S9S_VERIFY(client.executeBatch(replies));
+    S9S_VERIFY(S9sRpcClientPrivate::monotonicMs() - started < 5000ll);
+    
+    controller.stop();
+    S9S_COMPARE(replies.size(), 3);
+    S9S_COMPARE(controller.nRequests(), 3);
+
+    for (uint idx = 0u; idx < replies.size(); ++idx)
+        S9S_VERIFY(replies[idx].isOk());
+
+    return true;
+}
+
+/**
+ * None of the addresses of the controller could be connected: they are
+ * removed from the cache, so the host name is resolved again (and now it is
+ * not found), and freed when the last client releases them.
+ */
+bool
+UtS9sRpcClient::testResolveAgain()
+{
+    S9sOptions      *options = S9sOptions::instance();
+    int              port = refusedPort();
+    S9sString        key;
+    S9sString        service;
+    struct addrinfo  hints;
+    struct addrinfo *addresses = NULL;
+
+    options->m_options.clear();
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family   = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+
+    service.sprintf("%d", port);
+    S9S_VERIFY(
+            getaddrinfo("127.0.0.1", STR(service), &hints, &addresses) == 0);
+
+    key.sprintf("controller.invalid:%d", port);
+    S9sRpcClientPrivate::sm_addresses[key]         = addresses;
+    S9sRpcClientPrivate::sm_addressRefs[addresses] = 1;
+
+    {
+        S9sRpcClient client("controller.invalid", port, "", false);
+        
+        S9S_VERIFY(!client.ping());
+        S9S_VERIFY(client.errorString().contains("refused"));
+        S9S_VERIFY(!S9sRpcClientPrivate::sm_addresses.contains(key));
+        S9S_COMPARE(S9sRpcClientPrivate::sm_addressRefs[addresses], 1);
+
+        S9S_VERIFY(!client.ping());
+        S9S_VERIFY(client.errorString().contains("not found"));
+    }
+
+    S9S_VERIFY(!S9sRpcClientPrivate::sm_addressRefs.contains(addresses));
+
+    return true;
+}
+
+/**
+ * The batch is aborted before it is executed and while the controller holds
+ * the replies: executeBatch() returns without replies, and the next batch is
+ * not aborted.
+ */
+bool
+UtS9sRpcClient::testBatchAbort()
+{
+    S9sOptions             *options = S9sOptions::instance();
+    S9sControllerStandIn    controller;
+    S9sVector<S9sRpcReply>  replies;
+    long long               started;
+
+    options->m_options.clear();
+    S9S_VERIFY(controller.listen());
+
+    S9sRpcClient    client("127.0.0.1", controller.port(), "", false);
+    S9sBatchAborter aborter(client);
+
+    client.setTimeouts(5000, 5000);
+
+    // Aborted before executing.
+    client.beginBatch();
+    S9S_VERIFY(client.getCpuStats(1));
+    client.abortBatch();
+    S9S_VERIFY(!client.executeBatch(replies));
+    S9S_COMPARE(replies.size(), 0);
+    S9S_COMPARE(client.errorString(), "The batch was aborted.");
+
+    // The next one is sent.
+    client.beginBatch();
+    S9S_VERIFY(client.getCpuStats(1));
+    S9S_VERIFY(client.executeBatch(replies));
+    S9S_COMPARE(replies.size(), 1);
+    S9S_VERIFY(replies[0].isOk());
+
+    // Aborted from an other thread while waiting for the replies.
+    controller.holdReplies(10u);
+    client.beginBatch();
+    S9S_VERIFY(client.getCpuStats(1));
+    S9S_VERIFY(client.getSqlStats(1));
+    S9S_VERIFY(client.getMemStats(1));
+
+    started = S9sRpcClientPrivate::monotonicMs();
+    aborter.abortAfter(200);
+    S9S_VERIFY(!client.executeBatch(replies));
+    S9S_VERIFY(S9sRpcClientPrivate::monotonicMs() - started < 5000ll);
+    S9S_COMPARE(replies.size(), 0);
+    S9S_COMPARE(client.errorString(), "The batch was aborted.");
+
+    controller.stop();
+    return true;
+}
+
+/**
+ * \returns The name of a temporary file to save the sessions.
+ */
+S9sString
+UtS9sRpcClient::sessionFileName() const
+{
+    S9sString retval;
+
+    retval.sprintf("/tmp/ut_s9srpcclient_session.%d", getpid());
+    return retval;
+}
+
+/**
+ * \returns A port on the loopback interface where nothing is listening.
+ */
+int
+UtS9sRpcClient::refusedPort() const
+{
+    struct sockaddr_in address;
+    socklen_t          addressLength = sizeof(address);
+    int                socketFd = ::socket(AF_INET, SOCK_STREAM, 0);
+    int                retval = 0;
+
+    memset(&address, 0, sizeof(address));
+    address.sin_family      = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (::bind(socketFd, (struct sockaddr *) &address, sizeof(address)) == 0 &&
+            ::getsockname(socketFd, (struct sockaddr *) &address, 
+                &addressLength) == 0)
+    {
+        retval = ntohs(address.sin_port);
+    }
+
+    ::close(socketFd);
+    return retval;
+}
+
+/**
+ * \returns The data compressed in gzip format.
+ */
+S9sString
+UtS9sRpcClient::gzipped(
+        const S9sString &data) const
+{
+    z_stream  stream;
+    char      buffer[4096];
+    S9sString retval;
+    int       status;
+
+    memset(&stream, 0, sizeof(stream));
+    deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS + 16,
+            8, Z_DEFAULT_STRATEGY);
+
+    stream.next_in  = (Bytef *) data.c_str();
+    stream.avail_in = data.length();
+
+    do {
+        stream.next_out  = (Bytef *) buffer;
+        stream.avail_out = sizeof(buffer);
+        status = deflate(&stream, Z_FINISH);
+
+        retval.append(buffer, sizeof(buffer) - stream.avail_out);
+    } while (status == Z_OK);
+
+    deflateEnd(&stream);
+    return retval;
+}
+
+/******************************************************************************
+ *
+ */
+S9sControllerStandIn::S9sControllerStandIn() :
+    m_listenSocket(-1),
+    m_port(0),
+    m_stopRequested(false),
+    m_replyIndex(0u),
+    m_holdRequests(0u)
+{
+}
+
+S9sControllerStandIn::~S9sControllerStandIn()
+{
+    stop();
+}
+
+/**
+ * \returns true if the stand-in is listening.
+ *
+ * Starts listening on a free port of the loopback interface (see port()) and
+ * starts the thread that answers the requests.
+ */
+bool
+S9sControllerStandIn::listen()
+{
+    struct sockaddr_in address;
+    socklen_t          addressLength = sizeof(address);
+    int                yes = 1;
+
+    m_listenSocket = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (m_listenSocket < 0)
+        return false;
+
+    ::setsockopt(m_listenSocket, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+    memset(&address, 0, sizeof(address));
+    address.sin_family      = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port        = 0;
+
+    if (::bind(m_listenSocket, (struct sockaddr *) &address, 
+                sizeof(address)) != 0 ||
+            ::listen(m_listenSocket, 16) != 0 ||
+            ::getsockname(m_listenSocket, (struct sockaddr *) &address, 
+                &addressLength) != 0)
+    {
+        ::close(m_listenSocket);
+        m_listenSocket = -1;
+        return false;
+    }
+
+    m_port = ntohs(address.sin_port);
+    return start();
+}
+
+/**
+ * Stops the thread and the listening, the requests received are kept.
+ */
+void
+S9sControllerStandIn::stop()
+{
+    if (m_listenSocket < 0 || m_stopRequested)
+        return;
+
+    m_stopRequested = true;
+    wait();
+
+    ::close(m_listenSocket);
+}
+
+/**
+ * \returns The port the stand-in is listening on.
+ */
+int
+S9sControllerStandIn::port() const
+{
+    return m_port;
+}
+
+/**
+ * \param reply The whole HTTP reply (see httpReply()).
+ *
+ * Queues a reply, the replies are sent in the order they were queued, one
+ * for every request.
+ */
+void
+S9sControllerStandIn::addReply(
+        const S9sString &reply)
+{
+    S9sMutexLocker locker(m_mutex);
+
+    m_replies << reply;
+}
+
+/**
+ * \param nRequests The number of requests to wait for.
+ *
+ * The next replies are not sent until the given number of requests are
+ * received, then they are sent in the reverse order.
+ */
+void
+S9sControllerStandIn::holdReplies(
+        const uint nRequests)
+{
+    S9sMutexLocker locker(m_mutex);
+
+    m_holdRequests = nRequests;
+}
+
+uint
+S9sControllerStandIn::nRequests()
+{
+    S9sMutexLocker locker(m_mutex);
+
+    return m_requests.size();
+}
+
+/**
+ * \returns The HTTP header of the request with the given index.
+ */
+S9sString
+S9sControllerStandIn::header(
+        const uint index)
+{
+    S9sMutexLocker locker(m_mutex);
+
+    return index < m_headers.size() ? m_headers[index] : S9sString();
+}
+
+/**
+ * \returns The JSON payload of the request with the given index.
+ */
+S9sVariantMap
+S9sControllerStandIn::request(
+        const uint index)
+{
+    S9sMutexLocker locker(m_mutex);
+
+    return index < m_requests.size() ? m_requests[index] : S9sVariantMap();
+}
+
+/**
+ * \param body The body of the reply, it is not necessarily a JSON string.
+ * \param extraHeaders Header lines added to the reply.
+ * \returns The HTTP reply that closes the connection.
+ */
+S9sString
+S9sControllerStandIn::httpReply(
+        const S9sString &body,
+        const S9sString &extraHeaders)
+{
+    S9sString retval;
+
+    retval.sprintf(
+            "HTTP/1.1 200 OK\r\n"
+            "Server: cmon/1.9.0\r\n"
+            "Content-Type: application/json\r\n"
+            "Connection: close\r\n"
+            "%s"
+            "Content-Length: %zu\r\n"
+            "\r\n",
+            STR(extraHeaders), body.length());
+
+    return retval + body;
+}
+
+int
+S9sControllerStandIn::exec()
+{
+    S9sVector<int>       heldSockets;
+    S9sVector<S9sString> heldReplies;
+
+    while (!shouldStop())
+    {
+        struct pollfd pollFd = { m_listenSocket, POLLIN, 0 };
+        S9sString     header, body;
+        S9sVariantMap request;
+        S9sString     reply;
+        uint          holdRequests;
+        int           socketFd;
+
+        if (::poll(&pollFd, 1, 20) <= 0)
+            continue;
+
+        socketFd = ::accept(m_listenSocket, NULL, NULL);
+        if (socketFd < 0)
+            continue;
+
+        if (!readRequest(socketFd, header, body))
+        {
+            ::close(socketFd);
+            continue;
+        }
+
+        request.parse(STR(body));
+
+        m_mutex.lock();
+        m_headers    << header;
+        m_requests   << request;
+        reply         = nextReply(request);
+        holdRequests  = m_holdRequests;
+        m_mutex.unlock();
+
+        heldSockets << socketFd;
+        heldReplies << reply;
+
+        if (heldSockets.size() < holdRequests)
+            continue;
+
+        for (int idx = (int) heldSockets.size() - 1; idx >= 0; --idx)
+            sendReply(heldSockets[idx], heldReplies[idx]);
+
+        heldSockets.clear();
+        heldReplies.clear();
+        holdReplies(0u);
+    }
+
+    for (uint idx = 0u; idx < heldSockets.size(); ++idx)
+        ::close(heldSockets[idx]);
+
+    return 0;
+}
+
+bool
+S9sControllerStandIn::shouldStop() const
+{
+    return m_stopRequested || S9sThread::shouldStop();
+}
+
+/**
+ * Reads one request, the header and the body that is as long as the
+ * Content-Length header says.
+ */
+bool
+S9sControllerStandIn::readRequest(
+        int        socketFd,
+        S9sString &header,
+        S9sString &body)
+{
+    struct timeval timeout = { 5, 0 };
+    std::string    data;
+    size_t         headerEnd = std::string::npos;
+    size_t         contentLength = 0;
+    char           buffer[4096];
+
+    ::setsockopt(socketFd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    for (;;)
+    {
+        ssize_t readLength;
+
+        if (headerEnd == std::string::npos)
+        {
+            headerEnd = data.find("\r\n\r\n");
+            if (headerEnd != std::string::npos)
+            {
+                size_t field = data.find("Content-Length: ");
+
+                headerEnd += 4;
+                if (field != std::string::npos && field < headerEnd)
+                    contentLength = strtoul(data.c_str() + field + 16, NULL, 10);
+            }
+        }
+
+        if (headerEnd != std::string::npos && 
+                data.length() >= headerEnd + contentLength)
+        {
+            break;
+        }
+
+        readLength = ::read(socketFd, buffer, sizeof(buffer));
+        if (readLength <= 0)
+            return false;
+
+        data.append(buffer, readLength);
+    }
+
+    header = data.substr(0, headerEnd);
+    body   = data.substr(headerEnd, contentLength);
+
+    return true;
+}
+
+void
+S9sControllerStandIn::sendReply(
+        int              socketFd,
+        const S9sString &reply)
+{
+    size_t  offset = 0;
+
+    while (offset < reply.length())
+    {
+        ssize_t written = ::write(
+                socketFd, reply.c_str() + offset, reply.length() - offset);
+
+        if (written <= 0)
+            break;
+
+        offset += written;
+    }
+
+    ::close(socketFd);
+}
+
+/**
+ * \returns The next queued reply or, if there is none, an "Ok" reply that
+ *   repeats the request_id and the operation of the request.
+ */
+S9sString
+S9sControllerStandIn::nextReply(
+        const S9sVariantMap &request)
+{
+    S9sVariantMap  reply;
+
+    if (m_replyIndex < m_replies.size())
+        return m_replies[m_replyIndex++];
+
+    reply["request_status"] = "Ok";
+
+    if (request.contains("request_id"))
+        reply["request_id"] = request.at("request_id");
+
+    if (request.contains("operation"))
+        reply["operation"]  = request.at("operation");
+
+    return httpReply(reply.toCompactString());
+}
+
+/******************************************************************************
+ *
+ */
+S9sBusyListener::S9sBusyListener() :
+    m_listenSocket(-1),
+    m_port(0),
+    m_delayMs(0)
+{
+}
+
+S9sBusyListener::~S9sBusyListener()
+{
+    wait();
+
+    if (m_listenSocket >= 0)
+        ::close(m_listenSocket);
+
+    for (uint idx = 0u; idx < m_clientSockets.size(); ++idx)
+        ::close(m_clientSockets[idx]);
+}
+
+/**
+ * \returns true if the socket is listening and its accept queue is full.
+ *
+ * The backlog is 0, the queue is filled by connecting to the socket from here
+ * until a connection is not established any more.
+ */
+bool
+S9sBusyListener::listen()
+{
+    struct sockaddr_in address;
+    socklen_t          addressLength = sizeof(address);
+
+    m_listenSocket = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (m_listenSocket < 0)
+        return false;
+
+    memset(&address, 0, sizeof(address));
+    address.sin_family      = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port        = 0;
+
+    if (::bind(m_listenSocket, (struct sockaddr *) &address, 
+                sizeof(address)) != 0 ||
+            ::listen(m_listenSocket, 0) != 0 ||
+            ::getsockname(m_listenSocket, (struct sockaddr *) &address, 
+                &addressLength) != 0)
+    {
+        return false;
+    }
+
+    m_port = ntohs(address.sin_port);
+
+    for (int idx = 0; idx < 8; ++idx)
+    {
+        struct pollfd pollFd;
+        int           socketFd = ::socket(AF_INET, SOCK_STREAM, 0);
+
+        ::fcntl(socketFd, F_SETFL, O_NONBLOCK);
+        ::connect(socketFd, (struct sockaddr *) &address, sizeof(address));
+        m_clientSockets << socketFd;
+
+        pollFd.fd      = socketFd;
+        pollFd.events  = POLLOUT;
+        pollFd.revents = 0;
+
+        if (::poll(&pollFd, 1, 100) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ * Closes the listening socket in the thread after the given time.
+ */
+void
+S9sBusyListener::closeAfter(
+        const int delayMs)
+{
+    m_delayMs = delayMs;
+    start();
+}
+
+/**
+ * \returns The port of the listening socket.
+ */
+int
+S9sBusyListener::port() const
+{
+    return m_port;
+}
+
+int
+S9sBusyListener::exec()
+{
+    ::usleep(m_delayMs * 1000);
+    ::close(m_listenSocket);
+    m_listenSocket = -1;
+
+    return 0;
+}
+
+/******************************************************************************
+ *
+ */
+S9sBatchAborter::S9sBatchAborter(
+        S9sRpcClient &client) :
+    m_client(client),
+    m_delayMs(0)
+{
+}
+
+S9sBatchAborter::~S9sBatchAborter()
+{
+    wait();
+}
+
+/**
+ * Calls abortBatch() of the client in the thread after the given time.
+ */
+void
+S9sBatchAborter::abortAfter(
+        const int delayMs)
+{
+    m_delayMs = delayMs;
+    start();
+}
+
+int
+S9sBatchAborter::exec()
+{
+    ::usleep(m_delayMs * 1000);
+    m_client.abortBatch();
+
+    return 0;
+}
 
 S9S_UNIT_TEST_MAIN(UtS9sRpcClient)
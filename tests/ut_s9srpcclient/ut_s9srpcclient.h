@@ -20,6 +20,9 @@
 #include "s9sunittest.h"
 
 #include <S9sRpcClient>
+#include <S9sThread>
+#include <S9sMutex>
+#include "s9srpcclient_p.h"
 
 class UtS9sRpcClient : public S9sUnitTest
 {
@@ -50,6 +53,93 @@ class UtS9sRpcClient : public S9sUnitTest
         bool testCreateReplication();
         bool testCreateNdbCluster();
         bool testAddNode();
+        bool testReplyContentLength();
+        bool testReplyChunked();
+        bool testReplyTrailers();
+        bool testReplyBadChunks();
+        bool testReplyBadContentLength();
+        bool testReplyCloseDelimited();
+        bool testReplyConnectionClosed();
+        bool testBufferAllocation();
+        bool testStreamRecords();
+        bool testCompressedReply();
+        bool testReplyBuffer();
+        bool testSessionFile();
+        bool testSessionResend();
+        bool testBatchOrder();
+        bool testBatchAuthRequired();
+        bool testTlsSessionFile();
+        bool testBestEndpoint();
+        bool testFailOver();
+        bool testProbeControllers();
+        bool testBatchNextAddress();
+        bool testResolveAgain();
+        bool testBatchAbort();
+
+    private:
+        S9sRpcClientPrivate::RequestState feedReply(
+                S9sRpcClientPrivate &priv,
+                const S9sString     &reply,
+                size_t               pieceSize);
+
+        S9sString replyBody(const S9sRpcClientPrivate &priv) const;
+        
+        bool feedStream(
+                S9sRpcClientPrivate &priv,
+                const S9sString     &stream,
+                size_t               pieceSize,
+                S9sVariantList      &records);
+        S9sString gzipped(const S9sString &data) const;
+        S9sString sessionFileName() const;
+        int refusedPort() const;
+};
+
+/**
+ * A controller stand-in listening on a local port. It answers the requests in
+ * its own thread with the replies queued by addReply() or, if there are none
+ * left, with an "Ok" reply that repeats the request_id and the operation of
+ * the request.
+ */
+class S9sControllerStandIn : public S9sThread
+{
+    public:
+        S9sControllerStandIn();
+        virtual ~S9sControllerStandIn();
+
+        bool listen();
+        void stop();
+        int port() const;
+
+        void addReply(const S9sString &reply);
+        void holdReplies(const uint nRequests);
+
+        uint nRequests();
+        S9sString header(const uint index);
+        S9sVariantMap request(const uint index);
+
+        static S9sString httpReply(
+                const S9sString &body,
+                const S9sString &extraHeaders = "");
+
+    protected:
+        virtual int exec();
+        virtual bool shouldStop() const;
+
+    private:
+        bool readRequest(int socketFd, S9sString &header, S9sString &body);
+        void sendReply(int socketFd, const S9sString &reply);
+        S9sString nextReply(const S9sVariantMap &request);
+
+    private:
+        int                       m_listenSocket;
+        int                       m_port;
+        volatile bool             m_stopRequested;
+        S9sMutex                  m_mutex;
+        S9sVector<S9sString>      m_replies;
+        uint                      m_replyIndex;
+        uint                      m_holdRequests;
+        S9sVector<S9sString>      m_headers;
+        S9sVector<S9sVariantMap>  m_requests;
 };
 
 class S9sRpcClientTester : public S9sRpcClient
@@ -71,3 +161,48 @@ class S9sRpcClientTester : public S9sRpcClient
         S9sVariantMap     m_lastPayload;
 };
 
+/**
+ * A listening socket with a full accept queue: the connections to it are not
+ * accepted and not refused until closeAfter() closes it. Then the connections
+ * waiting for it are refused when the SYN is sent again (about a second
+ * later), so the client finds it out while waiting for the socket.
+ */
+class S9sBusyListener : public S9sThread
+{
+    public:
+        S9sBusyListener();
+        virtual ~S9sBusyListener();
+
+        bool listen();
+        void closeAfter(const int delayMs);
+        int port() const;
+
+    protected:
+        virtual int exec();
+
+    private:
+        int                       m_listenSocket;
+        int                       m_port;
+        int                       m_delayMs;
+        S9sVector<int>            m_clientSockets;
+};
+
+/**
+ * Aborts the batch of a client from its own thread after a given time, like
+ * the display thread of a screen UI does.
+ */
+class S9sBatchAborter : public S9sThread
+{
+    public:
+        S9sBatchAborter(S9sRpcClient &client);
+        virtual ~S9sBatchAborter();
+
+        void abortAfter(const int delayMs);
+
+    protected:
+        virtual int exec();
+
+    private:
+        S9sRpcClient             &m_client;
+        int                       m_delayMs;
+};
@@ -25,6 +25,7 @@
 
 #include "S9sVariantList"
 #include "S9sFormat"
+#include "S9sFormatProgram"
 #include "S9sOptions"
 
 //#define DEBUG
@@ -57,6 +58,10 @@ UtS9sString::runTest(const char *testName)
     PERFORM_TEST(testEscape,        retval);
     PERFORM_TEST(testSplit,         retval);
     PERFORM_TEST(testSizeString,    retval);
+    PERFORM_TEST(testHtml,          retval);
+    PERFORM_TEST(testHtmlFallback,  retval);
+    PERFORM_TEST(testFormatProgram, retval);
+    PERFORM_TEST(testFormatOp,      retval);
 
     return retval;
 }
@@ -404,5 +409,280 @@ UtS9sString::testSizeString()
     return true;
 }
 
+/**
+ * Testing the html2ansi() and html2text() functions with the markup the
+ * controller uses and with tags broken by other tags.
+ */
+bool
+UtS9sString::testHtml()
+{
+    S9sString input;
+
+    input = 
+        "<em style='color: #c66211;'>10.0.0.5</em>:3306: Installing "
+        "<strong style='color: #59a449;'>mysql</strong>.<br/>Done.";
+
+    S9S_COMPARE(S9sString::html2ansi(input), 
+            XTERM_COLOR_3 "10.0.0.5" TERM_NORMAL ":3306: Installing "
+            XTERM_COLOR_9 "mysql" TERM_NORMAL ".\nDone.");
+    
+    S9S_COMPARE(S9sString::html2text(input), 
+            "10.0.0.5:3306: Installing mysql.\nDone.");
+
+    input = 
+        "File <em style='color: #ff00ff;'>a.txt</em> and "
+        "<strong style=\"color:blue;\">b</strong> x<BR/>";
+    
+    S9S_COMPARE(S9sString::html2ansi(input), 
+            "File " XTERM_COLOR_ORANGE "a.txt" TERM_NORMAL " and "
+            XTERM_COLOR_8 "b" TERM_NORMAL " x\n");
+    
+    S9S_COMPARE(S9sString::html2text(input), "File a.txt and b x\n");
+    
+    input = "a < b and c > d";
+    S9S_COMPARE(S9sString::html2ansi(input), input);
+    S9S_COMPARE(S9sString::html2text(input), input);
+
+    // Removing the inner tag completes the outer one.
+    input = "<e</em>m style='color: #c66211;'>x</em>";
+    S9S_COMPARE(S9sString::html2ansi(input), 
+            "<e" TERM_NORMAL "m style='color: #c66211;'>x" TERM_NORMAL);
+    
+    S9S_COMPARE(S9sString::html2text(input), "x");
+
+    return true;
+}
+
+/**
+ * The single pass conversion of the markup compared to the conversion by
+ * replacing the tags until the string does not change. Wherever the single pass
+ * conversion is used it has to give the same result, the strings it can not
+ * convert are converted by the replacing.
+ */
+bool
+UtS9sString::testHtmlFallback()
+{
+    const char *fragments[] = 
+    {
+        "<em style='color: #c66211;'>", "<strong style='color: #59a449;'>",
+        "<em style='color: #877d0f;'>", "<strong style='color: red;'>",
+        "<em style='color: #ff00ff;'>", "<EM STYLE=\"COLOR:BLUE;\">",
+        "<strong style=\"color: #123;\">", "<em style='color:;'>",
+        "<em style='color: \xc3\xa9;'>", "<em style='color: #c66211;'",
+        "</em>", "</strong>", "<br/>", "<BR/>", "<Br/>",
+        "<", ">", "<e", "m style='", "color: #c66211;'>", "</", "em>", 
+        "<em style=", "x", "10.0.0.5", " ", ";", "\xc3\xa1"
+    };
+    const uint  nFragments = sizeof(fragments) / sizeof(char *);
+    const char *strings[] = 
+    {
+        "",
+        "no markup at all",
+        "a < b and c > d",
+        "<e</em>m style='color: #c66211;'>x</em>",
+        "<<br/>br/>",
+        "<em <em style='color: #c66211;'>style='color: #c66211;'>x",
+        "<em style='color: #c66211;</em>'>x",
+        "<strong style='color: <br/>;'>x</strong>",
+        "<em style='color: #ff00ff;'",
+        "trailing <",
+        "<em style='color:;'>x</em>",
+        "<EM Style='Color: #C66211;'>x</EM>",
+        "<em style='color: \xc3\xa9;'>x</em>"
+    };
+    S9sString   input;
+    S9sString   converted;
+    uint        seed = 1u;
+    int         nConverted = 0;
+    int         nFallbacks = 0;
+
+    for (int idx = 0; idx < 2000; ++idx)
+    {
+        uint nPieces;
+
+        if (idx < (int) (sizeof(strings) / sizeof(char *)))
+        {
+            input = strings[idx];
+        } else {
+            seed    = seed * 1103515245u + 12345u;
+            nPieces = 1 + (seed >> 16) % 8;
+            input.clear();
+
+            for (uint piece = 0u; piece < nPieces; ++piece)
+            {
+                seed   = seed * 1103515245u + 12345u;
+                input += fragments[(seed >> 16) % nFragments];
+            }
+        }
+
+        if (idx % 100 == 99)
+            input += std::string(1, '\0') + "<br/>";
+
+        for (int toAnsi = 0; toAnsi < 2; ++toAnsi)
+        {
+            S9sString expected = toAnsi ? 
+                S9sString::html2ansiByReplace(input) :
+                S9sString::html2textByReplace(input);
+
+            if (S9sString::convertHtml(input, toAnsi, converted))
+            {
+                ++nConverted;
+                S9S_COMPARE(converted, expected);
+            } else {
+                ++nFallbacks;
+            }
+
+            if (toAnsi)
+            {
+                S9S_COMPARE(S9sString::html2ansi(input), expected);
+            } else {
+                S9S_COMPARE(S9sString::html2text(input), expected);
+            }
+        }
+    }
+
+    // Both ways of the conversion were used.
+    S9S_VERIFY(nConverted > 1000);
+    S9S_VERIFY(nFallbacks > 0);
+
+    return true;
+}
+
+/**
+ * The format strings compiled into literals and directives: the escapes, the
+ * "%%", the modifier character and the apostrophe flag.
+ */
+bool
+UtS9sString::testFormatProgram()
+{
+    S9sFormatProgram program;
+
+    // The consecutive literal characters are merged, "%%" included.
+    program = S9sFormatProgram("100%% of %-10N\\n");
+    S9S_COMPARE(program.size(), 3);
+    S9S_VERIFY(program.at(0).isLiteral());
+    S9S_COMPARE(program.at(0).literal(), "100% of ");
+    S9S_COMPARE(program.at(1).directive(), 'N');
+    S9S_COMPARE(program.at(2).literal(), "\n");
+
+    program = S9sFormatProgram("%%N");
+    S9S_COMPARE(program.size(), 1);
+    S9S_COMPARE(program.at(0).literal(), "%N");
+
+    // The escapes, the unknown ones are dropped. The "\e" was always
+    // '\027'.
+    program = S9sFormatProgram(
+            "\\\"\\\\\\a\\b\\e\\n\\r\\t\\x.");
+
+    S9S_COMPARE(program.size(), 1);
+    S9S_COMPARE(program.at(0).literal(), "\"\\\a\b\027\n\r\t.");
+    
+    // The modifier is only a modifier where the class has one.
+    program = S9sFormatProgram("%fk %k", 'f');
+    S9S_COMPARE(program.size(), 3);
+    S9S_COMPARE(program.at(0).directive(), 'k');
+    S9S_VERIFY(program.at(0).isModified());
+    S9S_COMPARE(program.at(2).directive(), 'k');
+    S9S_VERIFY(!program.at(2).isModified());
+    
+    program = S9sFormatProgram("%fk");
+    S9S_COMPARE(program.size(), 2);
+    S9S_COMPARE(program.at(0).directive(), 'f');
+    S9S_VERIFY(!program.at(0).isModified());
+    S9S_COMPARE(program.at(1).literal(), "k");
+
+    // The apostrophe is a flag only where the class accepts it.
+    program = S9sFormatProgram("%'8I", '\0', true);
+    S9S_COMPARE(program.size(), 1);
+    S9S_COMPARE(program.at(0).directive(), 'I');
+    
+    program = S9sFormatProgram("%'8I", '\0', false);
+    S9S_COMPARE(program.size(), 2);
+    S9S_COMPARE(program.at(0).directive(), '\'');
+    S9S_COMPARE(program.at(1).literal(), "8I");
+
+    // A percent sign at the end of the string is dropped.
+    program = S9sFormatProgram("abc%-");
+    S9S_COMPARE(program.size(), 1);
+    S9S_COMPARE(program.at(0).literal(), "abc");
+
+    return true;
+}
+
+/**
+ * The directives format the values exactly as printf() formats them with the
+ * same flags: the simple flags are handled without printf(), the others are
+ * passed to it and the long results are formatted by S9sString::sprintf().
+ */
+bool
+UtS9sString::testFormatOp()
+{
+    const char *flagList[] = 
+    {
+        "", "-", "12", "-12", ".3", "12.3", "-12.3", ".0", "0", 
+        "+", "+12", "012", "-012", "'", "'12", "+.2", "300", "-300",
+        "+300", "0300", "--12", "1.2.3"
+    };
+    const char *strings[] = 
+    {
+        "", "a", "192.168.1.189", "árvíztűrő"
+    };
+    int         ints[] = { 0, 7, -42, 1234567 };
+    double      doubles[] = { 0.0, -1.5, 1234567.891 };
+    S9sString   longFlags = "%-" + S9sString("-") * 70 + "20";
+
+    for (uint idx = 0u; idx < sizeof(flagList) / sizeof(char *); ++idx)
+    {
+        S9sString          flags   = "%" + S9sString(flagList[idx]);
+        S9sFormatProgram   program(flags + "X");
+        const S9sFormatOp &op      = program.at(0);
+
+        S9S_COMPARE(program.size(), 1);
+        S9S_COMPARE(op.directive(), 'X');
+
+        for (uint n = 0u; n < sizeof(strings) / sizeof(char *); ++n)
+        {
+            S9sString expected, actual;
+
+            expected.sprintf(STR(flags + "s"), strings[n]);
+            op.appendString(actual, strings[n]);
+            S9S_COMPARE(actual, expected);
+        }
+        
+        for (uint n = 0u; n < sizeof(ints) / sizeof(int); ++n)
+        {
+            S9sString expected, actual;
+
+            expected.sprintf(STR(flags + "d"), ints[n]);
+            op.appendInt(actual, ints[n]);
+            S9S_COMPARE(actual, expected);
+        }
+        
+        for (uint n = 0u; n < sizeof(doubles) / sizeof(double); ++n)
+        {
+            S9sString expected, actual;
+
+            expected.sprintf(STR(flags + "f"), doubles[n]);
+            op.appendDouble(actual, doubles[n]);
+            S9S_COMPARE(actual, expected);
+        }
+    }
+
+    // The flags do not fit the buffer of the format.
+    {
+        S9sFormatProgram   program(longFlags + "X");
+        S9sString          actual;
+
+        program.at(0).appendString(actual, "192.168.1.189");
+        S9S_COMPARE(actual, "192.168.1.189       ");
+        
+        actual.clear();
+        program.at(0).appendULongLong(actual, 18446744073709551615ull);
+        S9S_COMPARE(actual, "18446744073709551615");
+    }
+
+    return true;
+}
+
 S9S_UNIT_TEST_MAIN(UtS9sString)
 
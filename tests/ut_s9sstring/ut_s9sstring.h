@@ -40,5 +40,9 @@ class UtS9sString : public S9sUnitTest
         bool testEscape();
         bool testSplit();
         bool testSizeString();
+        bool testHtml();
+        bool testHtmlFallback();
+        bool testFormatProgram();
+        bool testFormatOp();
 };
 
@@ -0,0 +1,407 @@
+/*
+ * Severalnines Tools
+ * Copyright (C) 2018  Severalnines AB
+ *
+ * This file is part of s9s-tools.
+ *
+ * s9s-tools is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * s9s-tools is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with s9s-tools. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ut_s9stable.h"
+
+#include "S9sOptions"
+#include "S9sRpcReply"
+
+#include <unistd.h>
+#include <cstdlib>
+
+//#define DEBUG
+#define WARNING
+#include "s9sdebug.h"
+
+UtS9sTable::UtS9sTable() :
+    m_savedStdout(-1),
+    m_captureFile(NULL)
+{
+}
+
+UtS9sTable::~UtS9sTable()
+{
+}
+
+bool
+UtS9sTable::runTest(
+        const char *testName)
+{
+    bool retval = true;
+
+    PERFORM_TEST(testAlignment,   retval);
+    PERFORM_TEST(testColors,      retval);
+    PERFORM_TEST(testColoredCell, retval);
+    PERFORM_TEST(testHeader,      retval);
+    PERFORM_TEST(testTruncation,  retval);
+    PERFORM_TEST(testNodeList,    retval);
+    PERFORM_TEST(testBackupList,  retval);
+
+    return retval;
+}
+
+/**
+ * The numbers are aligned to the right, the strings as the column is aligned,
+ * the titles always to the left. The last column is not padded.
+ */
+bool
+UtS9sTable::testAlignment()
+{
+    S9sTable table;
+
+    table.addColumn("ID");
+    table.addColumn("NAME");
+    table.addColumn("SIZE", S9sFormat::AlignRight);
+    table.addColumn("COMMENT");
+
+    table.addCell(7);
+    table.addCell("a");
+    table.addCell("1.2MB");
+    table.addCell("first");
+
+    table.addCell(1234ull);
+    table.addCell("longer");
+    table.addCell("10KB");
+    table.addCell("second");
+    
+    table.addCell("-");
+    table.addCell("b");
+    table.addCell(5);
+    table.addCell("-");
+
+    S9S_COMPARE(table.nColumns(), 4);
+    S9S_COMPARE(table.nRows(), 3);
+    S9S_COMPARE(printed(table),
+            "ID   NAME   SIZE  COMMENT\n"
+            "   7 a      1.2MB first\n"
+            "1234 longer  10KB second\n"
+            "-    b          5 -\n");
+
+    return true;
+}
+
+/**
+ * The color of a cell is around the padding and the field separator, so the
+ * colors do not change the width of the columns.
+ */
+bool
+UtS9sTable::testColors()
+{
+    S9sTable table;
+
+    table.addColumn("STATE");
+    table.addColumn("CID");
+    table.addColumn("HOST");
+    table.setHeaderColor("<h>", "</h>");
+
+    table.addCell("OK", "<g>", "</g>");
+    table.addCell(1);
+    table.addCell("db1");
+
+    table.addCell("FAILED", "<r>", "</r>");
+    table.addCell(12);
+    table.addCell("db2", "<b>", "</b>");
+
+    S9S_COMPARE(printed(table),
+            "<h>STATE  CID HOST</h>\n"
+            "<g>OK     </g>  1 db1\n"
+            "<r>FAILED </r> 12 <b>db2</b>\n");
+
+    return true;
+}
+
+/**
+ * A cell with several colors inside is padded by the length of its printed
+ * text, not by the length of the string with the color codes.
+ */
+bool
+UtS9sTable::testColoredCell()
+{
+    S9sTable  table;
+    S9sString value;
+
+    table.addColumn("NAME");
+    table.addColumn("P");
+    table.setHeaderVisible(false);
+
+    value.sprintf("%s'%s'%s@%s'%s'%s", "<o>", "admin", "</o>",
+            "<g>", "%", "</g>");
+
+    table.addColoredCell(value, 11);
+    table.addCell("Y");
+
+    table.addCell("'pipas'@'localhost'");
+    table.addCell("N");
+
+    S9S_COMPARE(printed(table),
+            "<o>'admin'</o>@<g>'%'</g>         Y\n"
+            "'pipas'@'localhost' N\n");
+
+    return true;
+}
+
+/**
+ * The titles make the columns wider only if the header is printed.
+ */
+bool
+UtS9sTable::testHeader()
+{
+    S9sTable table;
+
+    table.addColumn("HOSTNAME");
+    table.addColumn("PORT");
+    table.addColumn("COMMENT");
+
+    table.addCell("db1");
+    table.addCell(3306);
+    table.addCell("-");
+
+    S9S_COMPARE(printed(table),
+            "HOSTNAME PORT COMMENT\n"
+            "db1      3306 -\n");
+
+    table.setHeaderVisible(false);
+    S9S_COMPARE(printed(table),
+            "db1 3306 -\n");
+
+    // A row that is not complete is not printed.
+    table.addCell("db2");
+    S9S_COMPARE(table.nRows(), 1);
+    S9S_COMPARE(printed(table),
+            "db1 3306 -\n");
+
+    // No columns, nothing to print.
+    S9S_COMPARE(printed(S9sTable()), "");
+
+    return true;
+}
+
+/**
+ * The last column is truncated to the width of the screen, the other columns
+ * are never truncated.
+ */
+bool
+UtS9sTable::testTruncation()
+{
+    S9sTable table;
+
+    table.addColumn("ID");
+    table.addColumn("MESSAGE");
+    table.setHeaderVisible(false);
+    table.setMaxWidth(12);
+
+    table.addCell(1);
+    table.addCell("short");
+
+    table.addCell(2);
+    table.addCell("exactly 9");
+
+    table.addCell(3);
+    table.addCell("this is too long");
+
+    S9S_COMPARE(printed(table),
+            "1 short\n"
+            "2 exactly 9\n"
+            "3 this is t…\n");
+
+    // Without the limit.
+    table.setMaxWidth(0);
+    S9S_COMPARE(printed(table),
+            "1 short\n"
+            "2 exactly 9\n"
+            "3 this is too long\n");
+
+    // No room for the last column at all.
+    table.setMaxWidth(2);
+    S9S_COMPARE(printed(table),
+            "1 short\n"
+            "2 exactly 9\n"
+            "3 this is too long\n");
+
+    return true;
+}
+
+/**
+ * The cluster of the hosts that are filtered out does not make the CLUSTER
+ * column wider.
+ */
+bool
+UtS9sTable::testNodeList()
+{
+    S9sOptions     *options = S9sOptions::instance();
+    S9sRpcReply     reply;
+    S9sVariantMap   cluster1, cluster2;
+    S9sVariantMap   host1, host2;
+    S9sVariantList  hosts1, hosts2;
+    S9sVariantList  clusters;
+
+    options->m_options.clear();
+    options->m_options["color"] = "never";
+    options->m_options["long"]  = true;
+    options->m_extraArguments.clear();
+    options->m_extraArguments << "db1";
+    setenv("COLUMNS", "80", 1);
+
+    host1["class_name"]   = "CmonGaleraHost";
+    host1["nodetype"]     = "galera";
+    host1["hostname"]     = "db1";
+    host1["port"]         = 3306;
+    host1["clusterid"]    = 1;
+    host1["hoststatus"]   = "CmonHostOnline";
+    host1["version"]      = "10.1.22";
+    host1["message"]      = "Up and running.";
+
+    host2                 = host1;
+    host2["hostname"]     = "db2";
+    host2["clusterid"]    = 2;
+
+    cluster1["cluster_id"]   = 1;
+    cluster1["cluster_name"] = "ft";
+    hosts1 << host1;
+    cluster1["hosts"]        = hosts1;
+    
+    cluster2["cluster_id"]   = 2;
+    cluster2["cluster_name"] = "a_long_cluster_name";
+    hosts2 << host2;
+    cluster2["hosts"]        = hosts2;
+
+    clusters << cluster1 << cluster2;
+    reply["request_status"] = "Ok";
+    reply["clusters"]       = clusters;
+
+    startCapture();
+    reply.printNodeList();
+
+    S9S_COMPARE(endCapture(),
+            "STAT VERSION CID CLUSTER HOST PORT COMMENT\n"
+            "go-- 10.1.22   1 ft      db1  3306 Up and running.\n"
+            "Total: 2\n");
+
+    options->m_extraArguments.clear();
+    options->m_options.clear();
+
+    return true;
+}
+
+/**
+ * The backups without backup entries are aligned the same way as the others.
+ */
+bool
+UtS9sTable::testBackupList()
+{
+    S9sOptions     *options = S9sOptions::instance();
+    S9sRpcReply     reply;
+    S9sVariantMap   backup1, backup2, entry, file, config;
+    S9sVariantList  files, entries, backups;
+
+    options->m_options.clear();
+    options->m_options["color"] = "never";
+    options->m_options["long"]  = true;
+
+    file["size"]         = 2048;
+    file["incremental"]  = false;
+    files << file;
+    entry["files"]       = files;
+    config["createdBy"]  = "pipas";
+
+    backup1["id"]          = 1;
+    backup1["cid"]         = 1;
+    backup1["status"]      = "completed";
+    backup1["backup_host"] = "db1";
+    backup1["config"]      = config;
+    backup1["title"]       = "first";
+    entries << entry;
+    backup1["backup"]      = entries;
+
+    backup2                = backup1;
+    backup2["id"]          = 12345;
+    backup2["chain_up"]    = 1;
+    backup2["status"]      = "failed";
+    backup2["title"]       = "second";
+    backup2["backup"]      = S9sVariantList();
+
+    backups << backup1 << backup2;
+    reply["request_status"] = "Ok";
+    reply["backup_records"] = backups;
+    reply["total"]          = 2;
+
+    startCapture();
+    reply.printBackupList();
+
+    S9S_COMPARE(endCapture(),
+            "ID    PI CID V I STATE     OWNER HOSTNAME CREATED SIZE TITLE\n"
+            "    1  -   1 - F COMPLETED pipas db1      -       2048 first\n"
+            "12345  1   1 - - FAILED    pipas db1      -          0 second\n"
+            "Total 2\n");
+
+    options->m_options.clear();
+    return true;
+}
+
+/**
+ * \returns What the table printed.
+ */
+S9sString
+UtS9sTable::printed(
+        const S9sTable &table)
+{
+    startCapture();
+    table.print();
+
+    return endCapture();
+}
+
+/**
+ * Starts capturing what is printed to the standard output.
+ */
+void
+UtS9sTable::startCapture()
+{
+    fflush(stdout);
+
+    m_captureFile = tmpfile();
+    m_savedStdout = dup(STDOUT_FILENO);
+    dup2(fileno(m_captureFile), STDOUT_FILENO);
+}
+
+/**
+ * \returns What was printed since startCapture().
+ */
+S9sString
+UtS9sTable::endCapture()
+{
+    S9sString retval;
+    char      buffer[1024];
+    size_t    length;
+
+    fflush(stdout);
+    dup2(m_savedStdout, STDOUT_FILENO);
+    ::close(m_savedStdout);
+
+    rewind(m_captureFile);
+    while ((length = fread(buffer, 1, sizeof(buffer), m_captureFile)) > 0)
+        retval.append(buffer, length);
+
+    fclose(m_captureFile);
+    m_captureFile = NULL;
+
+    return retval;
+}
+
+S9S_UNIT_TEST_MAIN(UtS9sTable)
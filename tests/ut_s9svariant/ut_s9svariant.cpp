@@ -50,6 +50,8 @@ UtS9sVariant::runTest(const char *testName)
     PERFORM_TEST(testToULongLong, retval);
     PERFORM_TEST(testOperators01, retval);
     PERFORM_TEST(testEqual,       retval);
+    PERFORM_TEST(testMove,        retval);
+    PERFORM_TEST(testCopyOnWrite, retval);
 
     return retval;
 }
@@ -304,5 +306,89 @@ UtS9sVariant::testEqual()
     return true;
 }
 
+/**
+ * The moved values are taken over and the source is left empty or invalid.
+ */
+bool
+UtS9sVariant::testMove()
+{
+    S9sVariantMap  theMap;
+    S9sVariantList theList;
+    S9sVariant     variant1;
+    S9sVariant     variant2;
+
+    theMap["key1"] = "value1";
+    theMap["key2"] = 42;
+    theList << "item1" << 2;
+
+    variant1 = S9sVariant(std::move(theMap));
+    S9S_VERIFY(theMap.empty());
+    S9S_VERIFY(variant1.isVariantMap());
+    S9S_COMPARE(variant1.toVariantMap().size(), 2);
+
+    variant2 = std::move(variant1);
+    S9S_VERIFY(variant1.isInvalid());
+    S9S_COMPARE(variant2["key1"], "value1");
+
+    S9sVariant variant3(std::move(variant2));
+    S9S_VERIFY(variant2.isInvalid());
+    S9S_COMPARE(variant3["key2"], 42);
+
+    // Moving an element of the variant into the variant itself.
+    variant3["key3"] = std::move(theList);
+    S9S_VERIFY(theList.empty());
+    variant3 = std::move(variant3["key3"]);
+    S9S_VERIFY(variant3.isVariantList());
+    S9S_COMPARE(variant3.size(), 2);
+    S9S_COMPARE(variant3[0], "item1");
+
+    return true;
+}
+
+/**
+ * The copies share the values, but changing one copy does not change the
+ * others.
+ */
+bool
+UtS9sVariant::testCopyOnWrite()
+{
+    S9sVariant     original;
+    S9sVariantList theList;
+
+    theList << "item1" << "item2";
+    original["name"]          = "original";
+    original["inner"]["list"] = theList;
+
+    S9sVariant copy1(original);
+    S9sVariant copy2;
+
+    copy2 = original;
+
+    // The copies share the same map.
+    S9S_VERIFY(
+            &copy1.toVariantMap() == &original.toVariantMap());
+    S9S_VERIFY(
+            &copy2.toVariantMap() == &original.toVariantMap());
+
+    copy1["name"] = "copy1";
+    copy2["inner"]["list"][0] = "changed";
+
+    S9S_VERIFY(
+            &copy1.toVariantMap() != &original.toVariantMap());
+    S9S_COMPARE(original["name"], "original");
+    S9S_COMPARE(copy1["name"], "copy1");
+    S9S_COMPARE(copy2["name"], "original");
+    S9S_COMPARE(original["inner"]["list"][0], "item1");
+    S9S_COMPARE(copy1["inner"]["list"][0], "item1");
+    S9S_COMPARE(copy2["inner"]["list"][0], "changed");
+
+    // Assigning an element of the variant to the variant itself.
+    copy1 = copy1["inner"];
+    S9S_COMPARE(copy1["list"][1], "item2");
+    S9S_COMPARE(original["inner"]["list"][1], "item2");
+
+    return true;
+}
+
 S9S_UNIT_TEST_MAIN(UtS9sVariant)
 
@@ -36,6 +36,8 @@ class UtS9sVariant : public S9sUnitTest
         bool testToULongLong();
         bool testOperators01();
         bool testEqual();
+        bool testMove();
+        bool testCopyOnWrite();
 };
 
 
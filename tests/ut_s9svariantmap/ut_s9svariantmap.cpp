@@ -19,7 +19,17 @@
  */
 #include "ut_s9svariantmap.h"
 
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <climits>
+
 #include "S9sVariantMap"
+#include "S9sInflater"
+#include "S9sArena"
+#include "S9sJsonWriter"
+
+#include <zlib.h>
 
 //#define DEBUG
 #define WARNING
@@ -44,11 +54,22 @@ UtS9sVariantMap::runTest(
     PERFORM_TEST(testAssignMap,     retval);
     PERFORM_TEST(testVariant,       retval);
     PERFORM_TEST(testToString,      retval);
+    PERFORM_TEST(testToCompactString, retval);
+    PERFORM_TEST(testJsonWriter,    retval);
     PERFORM_TEST(testParser01,      retval);
     PERFORM_TEST(testParser02,      retval);
     PERFORM_TEST(testParser03,      retval);
     PERFORM_TEST(testParser04,      retval);
     PERFORM_TEST(testParser05,      retval);
+    PERFORM_TEST(testParser06,      retval);
+    PERFORM_TEST(testParser07,      retval);
+    PERFORM_TEST(testParser08,      retval);
+    PERFORM_TEST(testParser09,      retval);
+    PERFORM_TEST(testArena,         retval);
+    PERFORM_TEST(testAtoms,         retval);
+    PERFORM_TEST(testFlatMap,       retval);
+    PERFORM_TEST(testLazy,          retval);
+    PERFORM_TEST(testValueByPath,   retval);
     PERFORM_TEST(testAssignments01, retval);
 
     return retval;
@@ -146,6 +167,105 @@ UtS9sVariantMap::testToString()
     return true;
 }
 
+/**
+ * The compact format has no whitespace, it should be parsed back to the same
+ * values.
+ */
+bool
+UtS9sVariantMap::testToCompactString()
+{
+    S9sVariantMap  theMap;
+    S9sVariantMap  parsed;
+    S9sVariantMap  inner;
+    S9sVariantList theList;
+    S9sString      theString;
+
+    inner["quoted"] = "say \"hello\"\n\tand\\bye";
+    theList << 1 << 2.5 << true;
+
+    theMap["one"]   = "egy";
+    theMap["six"]   = 6;
+    theMap["inner"] = inner;
+    theMap["list"]  = theList;
+    theMap["empty"] = S9sVariantMap();
+
+    theString = theMap.toCompactString();
+    S9S_COMPARE(theString,
+            "{\"empty\":{},"
+            "\"inner\":{\"quoted\":\"say \\\"hello\\\"\\n\\tand\\\\bye\"},"
+            "\"list\":[1,2.5,true],"
+            "\"one\":\"egy\",\"six\":6}");
+
+    S9S_VERIFY(parsed.parse(STR(theString)));
+    S9S_COMPARE(parsed.toString(), theMap.toString());
+
+    return true;
+}
+
+/**
+ * The documents written piece by piece have the same format as the maps
+ * converted to strings, the buffer of the writer is flushed as it fills up.
+ */
+bool
+UtS9sVariantMap::testJsonWriter()
+{
+    S9sVariantMap  theMap;
+    S9sVariantMap  host;
+    S9sVariantList hosts;
+    S9sString      pretty;
+    S9sString      compact;
+    S9sString      longString(std::string(S9S_JSON_WRITER_BUFFER_SIZE + 10, 'x'));
+
+    host["hostname"] = "192.168.0.1";
+    host["port"]     = 3306;
+    hosts << host;
+    hosts.push_back(S9sVariant(S9sVariantList()));
+    hosts << 0.5;
+
+    theMap["hosts"]  = hosts;
+    theMap["long"]   = longString;
+    theMap["empty"]  = S9sVariantMap();
+    theMap["total"]  = 2;
+
+    {
+        S9sJsonWriter prettyWriter(pretty);
+        S9sJsonWriter compactWriter(compact, true);
+        S9sJsonWriter *writers[] = { &prettyWriter, &compactWriter };
+
+        for (int idx = 0; idx < 2; ++idx)
+        {
+            S9sJsonWriter &writer = *writers[idx];
+
+            writer.beginMap();
+            writer.key("empty");
+            writer.beginMap();
+            writer.endMap();
+            writer.key("hosts");
+            writer.beginList();
+            writer.value(host);
+            writer.beginList();
+            writer.endList();
+            writer.value(0.5);
+            writer.endList();
+            writer.key("long");
+            writer.value(longString);
+            writer.key("total");
+            writer.value(2);
+            writer.endMap();
+        }
+    }
+
+    S9S_COMPARE(pretty, theMap.toString());
+    S9S_COMPARE(compact, theMap.toCompactString());
+    S9S_VERIFY(pretty.find(
+                "    \"hosts\": [ \n"
+                "    {\n"
+                "        \"hostname\": \"192.168.0.1\",\n") != 
+            std::string::npos);
+
+    return true;
+}
+
 /**
  * Parsing a JSON message that has only two string values.
  */
@@ -285,6 +405,498 @@ UtS9sVariantMap::testParser05()
     return true;
 }
 
+/**
+ * Parsing a JSON string that is in a buffer, followed by other data without
+ * a terminating null byte.
+ */
+bool
+UtS9sVariantMap::testParser06()
+{
+    S9sVariantMap   theMap;
+    bool            success;
+    const char     *buffer =
+"HTTP/1.1 200 OK\r\n"
+"Content-Length: 20\r\n"
+"\r\n"
+"{ \"key1\": \"value1\" }HTTP/1.1 200 OK";
+    const char     *body = strstr(buffer, "\r\n\r\n") + 4;
+
+    success = theMap.parse(body, 20);
+    S9S_VERIFY(success);
+
+    S9S_COMPARE(theMap.size(), 1);
+    S9S_COMPARE(theMap["key1"].toString(), "value1");
+
+    // The data after the JSON string is not part of the input.
+    success = theMap.parse(body, 25);
+    S9S_VERIFY(!success);
+    S9S_COMPARE(theMap.size(), 1);
+
+    return true;
+}
+
+/**
+ * Parsing a compressed JSON string while it is decompressed.
+ */
+bool
+UtS9sVariantMap::testParser07()
+{
+    S9sVariantMap   theMap;
+    S9sString       source;
+    Bytef           compressed[1024];
+    uLongf          compressedLength = sizeof(compressed);
+    bool            success;
+
+    source = "{ \"key1\": \"value1\", \"key2\": [ 1, 2, 3 ] }";
+    success = compress(
+            compressed, &compressedLength, 
+            (const Bytef *) STR(source), source.length()) == Z_OK;
+    S9S_VERIFY(success);
+
+    {
+        S9sInflater inflater((const char *) compressed, compressedLength);
+
+        success = theMap.parse(S9sInflater::reader, &inflater);
+        S9S_VERIFY(success);
+        S9S_VERIFY(!inflater.hasError());
+        S9S_COMPARE(theMap.size(), 2);
+        S9S_COMPARE(theMap["key1"].toString(), "value1");
+        S9S_COMPARE(theMap["key2"].toVariantList().size(), 3);
+    }
+
+    // The truncated data is reported as an error.
+    {
+        S9sInflater inflater((const char *) compressed, compressedLength - 8);
+
+        theMap.parse(S9sInflater::reader, &inflater);
+        S9S_VERIFY(inflater.hasError());
+    }
+
+    /*
+     * The data that expands over the limit is an error, it is not
+     * decompressed into the memory.
+     */
+    {
+        S9sString  bomb = "{ \"key\": \"" + 
+            S9sString(std::string(1024 * 1024, 'x')) + "\" }";
+        Bytef     *bombCompressed;
+        uLongf     bombLength = compressBound(bomb.length());
+
+        bombCompressed = new Bytef[bombLength];
+        success = compress(
+                bombCompressed, &bombLength, 
+                (const Bytef *) STR(bomb), bomb.length()) == Z_OK;
+        S9S_VERIFY(success);
+        S9S_VERIFY(bombLength < 16 * 1024);
+
+        {
+            S9sInflater inflater(
+                    (const char *) bombCompressed, bombLength, 64 * 1024);
+
+            success = theMap.parse(S9sInflater::reader, &inflater);
+            S9S_VERIFY(!success);
+            S9S_VERIFY(inflater.hasError());
+            S9S_VERIFY(inflater.errorString().contains("larger"));
+        }
+        
+        {
+            S9sInflater inflater(
+                    (const char *) bombCompressed, bombLength, 
+                    bomb.length());
+
+            success = theMap.parse(S9sInflater::reader, &inflater);
+            S9S_VERIFY(success);
+            S9S_VERIFY(!inflater.hasError());
+            S9S_COMPARE(theMap["key"].toString().length(), 1024 * 1024);
+        }
+
+        delete[] bombCompressed;
+    }
+
+    return true;
+}
+
+/**
+ * The syntax the controller uses besides the standard JSON and the invalid
+ * strings.
+ */
+bool
+UtS9sVariantMap::testParser08()
+{
+    S9sVariantMap   theMap;
+    bool            success;
+
+    success = theMap.parse(
+            "/* comment */ {\n"
+            "  // line comment\n"
+            "  'single': 'quoted', bare: word,\n"
+            "  \"int\": -2147483648, \"ull\": 3000000000,\n"
+            "  \"double\": -.5e1, \"nan\": NaN, \"inf\": -Infinity,\n"
+            "  \"escaped\": \"a\\\"b\\\\c\\u00e9\\ud83d\\ude00\\t\",\n"
+            "  \"list\": [ true, false, [], {} ]\n"
+            "}\n");
+
+    S9S_VERIFY(success);
+    S9S_COMPARE(theMap.size(), 9);
+    S9S_COMPARE(theMap["single"].toString(), "quoted");
+    S9S_COMPARE(theMap["bare"].toString(), "word");
+    S9S_VERIFY(theMap["int"].isInt());
+    S9S_COMPARE(theMap["int"].toInt(), INT_MIN);
+    S9S_VERIFY(theMap["ull"].isULongLong());
+    S9S_COMPARE(theMap["ull"].toULongLong(), 3000000000ull);
+    S9S_COMPARE(theMap["double"].toDouble(), -5.0);
+    S9S_VERIFY(std::isnan(theMap["nan"].toDouble()));
+    S9S_VERIFY(std::isinf(theMap["inf"].toDouble()));
+    S9S_VERIFY(theMap["inf"].toDouble() < 0.0);
+    S9S_COMPARE(
+            theMap["escaped"].toString(), 
+            "a\"b\\c\xc3\xa9\xf0\x9f\x98\x80\t");
+    S9S_COMPARE(theMap["list"].toVariantList().size(), 4);
+    S9S_VERIFY(theMap["list"].toVariantList()[0].toBoolean());
+    S9S_VERIFY(theMap["list"].toVariantList()[3].isVariantMap());
+
+    // The invalid strings are rejected and the map is not changed.
+    S9S_VERIFY(!theMap.parse(""));
+    S9S_VERIFY(!theMap.parse("[ 1, 2 ]"));
+    S9S_VERIFY(!theMap.parse("{ \"a\": 1, }"));
+    S9S_VERIFY(!theMap.parse("{ \"a\": [ 1, ] }"));
+    S9S_VERIFY(!theMap.parse("{ \"a\": 1 } x"));
+    S9S_VERIFY(!theMap.parse("{ \"a\": \"unterminated }"));
+    S9S_VERIFY(!theMap.parse("{ \"a\": 1. }"));
+    S9S_VERIFY(!theMap.parse("{ true: 1 }"));
+    S9S_VERIFY(!theMap.parse("{ \"a\": 1 "));
+    S9S_COMPARE(theMap.size(), 9);
+
+    return true;
+}
+
+/**
+ * A reader that gives one byte at a time, so every token is split between the
+ * reads.
+ */
+static int
+readByBytes(
+        char *buffer, 
+        int   maxSize, 
+        void *userData)
+{
+    const char **source = (const char **) userData;
+
+    if (maxSize < 1 || **source == '\0')
+        return 0;
+
+    *buffer = **source;
+    ++*source;
+
+    return 1;
+}
+
+/**
+ * Parsing the string in small chunks.
+ */
+bool
+UtS9sVariantMap::testParser09()
+{
+    S9sVariantMap   theMap;
+    const char     *source;
+    bool            success;
+
+    source = 
+        "{ /* comment */ \"key1\": \"value\\n1\", \"key2\": [ 1, -2.5e-1, "
+        "3000000000, \"\\u00e9\" ], \"key3\": { \"inner\": -inf } }";
+
+    success = theMap.parse(readByBytes, &source);
+    S9S_VERIFY(success);
+    S9S_COMPARE(theMap.size(), 3);
+    S9S_COMPARE(theMap["key1"].toString(), "value\n1");
+    S9S_COMPARE(theMap["key2"].toVariantList().size(), 4);
+    S9S_COMPARE(theMap["key2"].toVariantList()[1].toDouble(), -0.25);
+    S9S_COMPARE(theMap["key2"].toVariantList()[2].toULongLong(), 3000000000ull);
+    S9S_COMPARE(theMap["key2"].toVariantList()[3].toString(), "\xc3\xa9");
+    S9S_VERIFY(theMap["key3"]["inner"].toDouble() < 0.0);
+
+    return true;
+}
+
+/**
+ * Parsing into an arena, the values copied out of the document remain valid
+ * after the document and the arena are released.
+ */
+bool
+UtS9sVariantMap::testArena()
+{
+    S9sArena       *arena = new S9sArena;
+    S9sVariantMap  *theMap = new S9sVariantMap;
+    S9sVariantList  hosts;
+    S9sVariantMap   host;
+    S9sVariantMap   copy;
+    const char     *source;
+    bool            success;
+
+    source = 
+        "{ \"hosts\": [ { \"hostname\": \"192.168.0.1\", \"port\": 3306 }, "
+        "{ \"hostname\": \"192.168.0.2\", \"port\": 3307 } ], "
+        "\"description\": \"A string that is too long to be inlined.\" }";
+
+    success = theMap->parse(source, strlen(source), arena);
+
+    arena->unRef();
+
+    S9S_VERIFY(success);
+    S9S_VERIFY(theMap->get_allocator().arena() == arena);
+    S9S_COMPARE((*theMap)["hosts"].toVariantList().size(), 2);
+    S9S_COMPARE((*theMap)["hosts"][1]["hostname"].toString(), "192.168.0.2");
+
+    /*
+     * The copies are allocated on the heap, the shared values hold the arena.
+     */
+    copy  = *theMap;
+    hosts = (*theMap)["hosts"].toVariantList();
+    host  = hosts[0].toVariantMap();
+    S9S_VERIFY(copy.get_allocator().arena() == NULL);
+    S9S_VERIFY(hosts.get_allocator().arena() == NULL);
+
+    // Changing the document allocates in the arena.
+    (*theMap)["hosts"][0]["port"] = 3308;
+    (*theMap)["cluster_id"]       = 1;
+    S9S_COMPARE((*theMap)["hosts"][0]["port"].toInt(), 3308);
+    S9S_COMPARE((*theMap)["cluster_id"].toInt(), 1);
+
+    delete theMap;
+
+    S9S_COMPARE(host["port"].toInt(), 3306);
+    S9S_COMPARE(hosts[1]["hostname"].toString(), "192.168.0.2");
+    S9S_COMPARE(
+            copy["description"].toString(), 
+            "A string that is too long to be inlined.");
+    S9S_COMPARE(copy["hosts"][1]["port"].toInt(), 3307);
+
+    return true;
+}
+
+/**
+ * The keys of the maps are interned, the equal keys share one string and the
+ * maps are still ordered by the keys.
+ */
+bool
+UtS9sVariantMap::testAtoms()
+{
+    S9sVariantMap  map1;
+    S9sVariantMap  map2;
+    S9sString      hostName = "hostname";
+    S9sAtom        atom1(hostName);
+    S9sAtom        atom2("hostname");
+    S9sAtom        atom3("port");
+
+    S9S_VERIFY(atom1 == atom2);
+    S9S_VERIFY(atom1 != atom3);
+    S9S_VERIFY(atom1 < atom3);
+    S9S_VERIFY(!(atom1 < atom2));
+    S9S_VERIFY(atom1 == "hostname");
+    S9S_VERIFY(atom1 == hostName);
+    S9S_VERIFY(atom3 != "hostname");
+    S9S_VERIFY(&atom1.toString() == &atom2.toString());
+    S9S_COMPARE(atom3.length(), 4);
+    S9S_VERIFY(S9sAtom().empty());
+
+    S9S_VERIFY(map1.parse("{ \"port\": 1, \"hostname\": \"a\" }"));
+    S9S_VERIFY(map2.parse("{ \"hostname\": \"b\", \"port\": 2 }"));
+
+    S9S_COMPARE(map1.keys().size(), 2);
+    S9S_COMPARE(map1.keys()[0], "hostname");
+    S9S_COMPARE(map1.keys()[1], "port");
+    S9S_VERIFY(
+            &map1.begin()->first.toString() == 
+            &map2.begin()->first.toString());
+
+    S9S_VERIFY(map1.contains("hostname"));
+    S9S_VERIFY(map1.contains(hostName));
+    S9S_VERIFY(!map1.contains("hostId"));
+    S9S_COMPARE(map2.at("port").toInt(), 2);
+
+    return true;
+}
+
+/**
+ * The map keeps its elements ordered, the small maps are searched one by one,
+ * the bigger ones with binary search.
+ */
+bool
+UtS9sVariantMap::testFlatMap()
+{
+    S9sVariantMap        theMap;
+    S9sString            key;
+    S9sVector<S9sString> keys;
+
+    for (int idx = 39; idx >= 0; --idx)
+    {
+        key.sprintf("key%02d", idx);
+        theMap[key] = idx;
+
+        if (idx == 30)
+        {
+            S9S_COMPARE(theMap.size(), 10);
+            S9S_VERIFY(theMap.contains("key35"));
+            S9S_VERIFY(!theMap.contains("key29"));
+        }
+    }
+
+    S9S_COMPARE(theMap.size(), 40);
+    S9S_COMPARE(theMap.at("key07").toInt(), 7);
+    S9S_VERIFY(theMap.find("key40") == theMap.end());
+
+    keys = theMap.keys();
+    for (uint idx = 0u; idx < keys.size(); ++idx)
+    {
+        key.sprintf("key%02d", idx);
+        S9S_COMPARE(keys[idx], key);
+    }
+
+    S9S_VERIFY(
+            !theMap.insert(S9sVariantMap::value_type("key10", 100)).second);
+    S9S_COMPARE(theMap["key10"].toInt(), 10);
+
+    S9S_COMPARE(theMap.erase("key10"), 1);
+    S9S_COMPARE(theMap.erase("key10"), 0);
+    S9S_COMPARE(theMap.size(), 39);
+    S9S_VERIFY(!theMap.contains("key10"));
+    S9S_COMPARE(theMap.begin()->first, "key00");
+    S9S_COMPARE((theMap.begin() + 10)->first, "key11");
+
+    return true;
+}
+
+/**
+ * The lazily parsed maps and lists are loaded when they are accessed, the
+ * copies made before that share the value that is loaded once.
+ */
+bool
+UtS9sVariantMap::testLazy()
+{
+    S9sArena       *arena = new S9sArena;
+    S9sVariantMap   theMap;
+    S9sVariantMap   eager;
+    S9sVariantMap   adopted;
+    S9sVariant      hosts;
+    S9sVariant      copy;
+    const char     *source;
+    char           *buffer;
+    bool            success;
+
+    source = 
+        "{ \"hosts\": [ { \"hostname\": \"192.168.0.1\", \"port\": 3306, "
+        "\"tags\": [ \"a]\", 'b}' ] }, "
+        "{ \"hostname\": \"192.168.0.2\", \"port\": 3307, "
+        "\"config\": { \"text\": \"\\\"{\\\\\" } } ], "
+        "/* [ { */ \"total\": 2 // }\n"
+        "}";
+
+    success = theMap.parseLazy(source, strlen(source), arena);
+    arena->unRef();
+
+    S9S_VERIFY(success);
+    S9S_VERIFY(eager.parse(source));
+    S9S_COMPARE(theMap["total"].toInt(), 2);
+
+    // The copy shares the list that is not loaded yet.
+    hosts = theMap["hosts"];
+    copy  = hosts;
+    S9S_COMPARE(hosts.size(), 2);
+    S9S_COMPARE(copy[1]["hostname"].toString(), "192.168.0.2");
+    S9S_COMPARE(copy[0]["tags"][1].toString(), "b}");
+    S9S_COMPARE(copy[1]["config"]["text"].toString(), "\"{\\");
+    S9S_COMPARE(theMap.toString(), eager.toString());
+
+    // Changing a lazily parsed value.
+    theMap["hosts"][0]["port"] = 3308;
+    S9S_COMPARE(theMap["hosts"][0]["port"].toInt(), 3308);
+    S9S_COMPARE(hosts[0]["port"].toInt(), 3306);
+
+    // The values take the buffer the string is in, it is not copied.
+    buffer = (char *) malloc(strlen(source) + 5);
+    strcpy(buffer, "HTTP");
+    strcpy(buffer + 4, source);
+    S9S_VERIFY(adopted.parseLazy(buffer, 4, strlen(source), NULL));
+    S9S_COMPARE(adopted.toString(), eager.toString());
+    adopted.clear();
+
+    // If the string can not be parsed the buffer is left to the caller.
+    buffer = strdup("{ \"hosts\": [ 1 }");
+    S9S_VERIFY(!adopted.parseLazy(buffer, 0, strlen(buffer), NULL));
+    S9S_COMPARE(buffer, "{ \"hosts\": [ 1 }");
+    free(buffer);
+
+    buffer = strdup("{ \"hosts\" [ 1 ] }");
+    S9S_VERIFY(!adopted.parseLazy(buffer, 0, strlen(buffer), NULL));
+    free(buffer);
+
+    // The errors in the structure are found when the string is parsed.
+    source = "{ \"hosts\": [ { \"port\": 3306 ] }";
+    S9S_VERIFY(!theMap.parseLazy(source, strlen(source)));
+
+    source = "{ \"hosts\": [ \"192.168.0.1 ] }";
+    S9S_VERIFY(!theMap.parseLazy(source, strlen(source)));
+
+    // The other errors inside the maps and the lists are found too.
+    source = "{ \"host\": { \"port\": 3306 \"hostname\": 1 }, \"total\": 1 }";
+    S9S_VERIFY(!theMap.parseLazy(source, strlen(source)));
+
+    source = "{ \"hosts\": [ { \"port\": 33x06 } ], \"total\": 1 }";
+    S9S_VERIFY(!theMap.parseLazy(source, strlen(source)));
+
+    source = "{ \"hosts\": [ { true: 1 } ], \"total\": 1 }";
+    S9S_VERIFY(!theMap.parseLazy(source, strlen(source)));
+
+    source = "{ \"hosts\": [ [ \"\\u12\" ] ], \"total\": 1 }";
+    S9S_VERIFY(!theMap.parseLazy(source, strlen(source)));
+    S9S_COMPARE(theMap["total"].toInt(), 2);
+
+    return true;
+}
+
+/**
+ * The values found by the paths that are split once and by the strings.
+ */
+bool
+UtS9sVariantMap::testValueByPath()
+{
+    S9sVariantMap  theMap;
+    S9sVariantPath path("/event_specifics//host/hostname");
+    S9sVariantPath empty("//");
+    const char    *source;
+
+    source = 
+        "{ \"event_specifics\": { \"host\": { \"hostname\": \"192.168.0.1\", "
+        "\"port\": 3306 }, \"cluster_id\": 1 } }";
+
+    S9S_VERIFY(theMap.parse(source));
+
+    S9S_COMPARE(path.size(), 3);
+    S9S_COMPARE(path.toString(), "event_specifics/host/hostname");
+    S9S_VERIFY(empty.empty());
+
+    S9S_COMPARE(theMap.valueByPath(path).toString(), "192.168.0.1");
+    S9S_COMPARE(
+            theMap.valueByPath(S9sVariantPath("event_specifics/cluster_id")),
+            1);
+    S9S_VERIFY(theMap.valueByPath(
+            S9sVariantPath("event_specifics/host")).isVariantMap());
+
+    // The strings are split the same way.
+    S9S_COMPARE(
+            theMap.valueByPath(S9sString("event_specifics/host/port")), 3306);
+
+    // The missing values and the values that are not maps on the way.
+    S9S_VERIFY(theMap.valueByPath(empty).isInvalid());
+    S9S_VERIFY(theMap.valueByPath(
+            S9sVariantPath("event_specifics/job")).isInvalid());
+    S9S_VERIFY(theMap.valueByPath(
+            S9sVariantPath("event_specifics/cluster_id/name")).isInvalid());
+    S9S_VERIFY(theMap.valueByPath(S9sString("")).isInvalid());
+
+    return true;
+}
+
 bool
 UtS9sVariantMap::testAssignments01()
 {
@@ -31,11 +31,22 @@ class UtS9sVariantMap : public S9sUnitTest
         bool testAssignMap();
         bool testVariant();
         bool testToString();
+        bool testToCompactString();
+        bool testJsonWriter();
         bool testParser01();
         bool testParser02();
         bool testParser03();
         bool testParser04();
         bool testParser05();
+        bool testParser06();
+        bool testParser07();
+        bool testParser08();
+        bool testParser09();
+        bool testArena();
+        bool testAtoms();
+        bool testFlatMap();
+        bool testLazy();
+        bool testValueByPath();
         bool testAssignments01();
 };
 